@@ -0,0 +1,190 @@
+// BenchHarness.h
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * 호스트 마이크로벤치마크 하네스 (nanobench 스타일, 헤더 전용)
+ * - 측정 1회가 최소 시간(기본 10ms)을 넘도록 반복 횟수를 자동 보정
+ * - 여러 번 측정한 ns/op 의 중앙값을 결과로 사용 (잡음 완화)
+ * - 결과를 JSON 기준선으로 저장하고, 비교 모드에서는 임계값 초과 회귀 시 종료 코드 1
+ *   회귀는 비율(--threshold)과 절대 차이(--min-delta-ns)를 모두 넘어야 한다 (1 ns 남짓한 항목의 잡음을 회귀로 보지 않음)
+ *
+ * 사용법: bench [--filter 문자열] [--save baseline.json] [--compare baseline.json] [--threshold 퍼센트] [--min-delta-ns ns]
+ */
+namespace bench {
+
+// 컴파일러가 결과 계산을 제거하지 못하게 한다
+template <typename T>
+inline void doNotOptimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    double nsPerOp;
+    unsigned long iterations;
+};
+
+class Runner {
+public:
+    void add(const std::string& name, std::function<void()> body) {
+        cases.push_back({name, std::move(body)});
+    }
+
+    // 측정과 함께 나란히 볼 크기 (와이어 형식 비교 등). 시간 표 다음에 따로 출력한다
+    void addSize(const std::string& name, size_t bytes) {
+        sizes.push_back({name, bytes});
+    }
+
+    int run(int argc, char** argv) {
+        std::string filter, savePath, comparePath;
+        double threshold = 10.0;
+        double minDeltaNs = 5.0;
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+            else if ((strcmp(argv[i], "--save") == 0 || strcmp(argv[i], "--json") == 0) && i + 1 < argc) savePath = argv[++i];
+            else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) comparePath = argv[++i];
+            else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+            else if (strcmp(argv[i], "--min-delta-ns") == 0 && i + 1 < argc) minDeltaNs = atof(argv[++i]);
+            else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) samples = atoi(argv[++i]);
+        }
+
+        std::vector<Result> results;
+        printf("%-40s %14s %12s\n", "benchmark", "ns/op", "iterations");
+        for (auto& c : cases) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+            Result r = measure(c);
+            printf("%-40s %14.1f %12lu\n", r.name.c_str(), r.nsPerOp, r.iterations);
+            results.push_back(r);
+        }
+        bool sizeHeader = false;
+        for (const auto& sz : sizes) {
+            if (!filter.empty() && sz.first.find(filter) == std::string::npos) continue;
+            if (!sizeHeader) printf("\n%-40s %14s\n", "payload", "bytes");
+            sizeHeader = true;
+            printf("%-40s %14zu\n", sz.first.c_str(), sz.second);
+        }
+
+        if (!savePath.empty() && !save(savePath, results)) {
+            fprintf(stderr, "[bench] 기준선 저장 실패: %s\n", savePath.c_str());
+            return 2;
+        }
+        if (!comparePath.empty()) return compare(comparePath, results, threshold, minDeltaNs);
+        return 0;
+    }
+
+private:
+    std::vector<std::pair<std::string, size_t>> sizes;
+
+    struct Case {
+        std::string name;
+        std::function<void()> body;
+    };
+
+    using SteadyClock = std::chrono::steady_clock;
+
+    std::vector<Case> cases;
+    int samples = 11;
+    const double minSampleNs = 10e6;   // 측정 1회 최소 10ms
+
+    static double elapsedNs(Case& c, unsigned long iterations) {
+        auto start = SteadyClock::now();
+        for (unsigned long i = 0; i < iterations; ++i) c.body();
+        auto end = SteadyClock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    Result measure(Case& c) {
+        // 워밍업 겸 반복 횟수 보정: 최소 시간을 넘을 때까지 두 배씩 늘린다
+        unsigned long iterations = 1;
+        while (elapsedNs(c, iterations) < minSampleNs && iterations < (1ul << 30)) iterations *= 2;
+
+        std::vector<double> perOp;
+        for (int s = 0; s < samples; ++s) perOp.push_back(elapsedNs(c, iterations) / iterations);
+        std::sort(perOp.begin(), perOp.end());
+        return {c.name, perOp[perOp.size() / 2], iterations};
+    }
+
+    static bool save(const std::string& path, const std::vector<Result>& results) {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            char line[256];
+            snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"iterations\": %lu}%s\n",
+                     results[i].name.c_str(), results[i].nsPerOp, results[i].iterations,
+                     i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    // 기준선 파일에서 name → ns_per_op 를 읽는다 (save()가 쓰는 형식만 지원)
+    static bool load(const std::string& path, std::vector<Result>& baseline) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::stringstream ss;
+        ss << in.rdbuf();
+        const std::string text = ss.str();
+
+        size_t pos = 0;
+        while ((pos = text.find("\"name\"", pos)) != std::string::npos) {
+            size_t q1 = text.find('"', text.find(':', pos) + 1);
+            size_t q2 = text.find('"', q1 + 1);
+            size_t ns = text.find("\"ns_per_op\"", q2);
+            if (q1 == std::string::npos || q2 == std::string::npos || ns == std::string::npos) break;
+            double value = atof(text.c_str() + text.find(':', ns) + 1);
+            baseline.push_back({text.substr(q1 + 1, q2 - q1 - 1), value, 0});
+            pos = q2;
+        }
+        return true;
+    }
+
+    static int compare(const std::string& path, const std::vector<Result>& results, double threshold, double minDeltaNs) {
+        std::vector<Result> baseline;
+        if (!load(path, baseline)) {
+            fprintf(stderr, "[bench] 기준선 읽기 실패: %s\n", path.c_str());
+            return 2;
+        }
+
+        int regressions = 0;
+        printf("\n%-40s %12s %12s %9s\n", "benchmark", "base ns/op", "now ns/op", "delta");
+        for (const auto& r : results) {
+            auto it = std::find_if(baseline.begin(), baseline.end(),
+                                   [&](const Result& b) { return b.name == r.name; });
+            if (it == baseline.end() || it->nsPerOp <= 0) {
+                printf("%-40s %12s %12.1f %9s\n", r.name.c_str(), "-", r.nsPerOp, "new");
+                continue;
+            }
+            const double delta = (r.nsPerOp - it->nsPerOp) / it->nsPerOp * 100.0;
+            const bool regressed = delta > threshold && r.nsPerOp - it->nsPerOp > minDeltaNs;
+            if (regressed) ++regressions;
+            printf("%-40s %12.1f %12.1f %+8.1f%%%s\n", r.name.c_str(), it->nsPerOp, r.nsPerOp, delta,
+                   regressed ? "  << 회귀" : "");
+        }
+
+        if (regressions > 0) {
+            printf("\n[bench] %d개 항목이 %.1f%% 이상, %.1f ns 넘게 느려졌습니다.\n", regressions, threshold, minDeltaNs);
+            return 1;
+        }
+        printf("\n[bench] 회귀 없음 (임계값 %.1f%%, %.1f ns)\n", threshold, minDeltaNs);
+        return 0;
+    }
+};
+
+} // namespace bench
+
+#endif // BENCHHARNESS_H
@@ -0,0 +1,566 @@
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "BenchHarness.h"
+#include "Config.h"
+#include "MotionListener.h"
+#include "NativeDevices.h"
+#include "Platform.h"
+#include "RFIDController.h"
+#include "ServerService.h"
+#include "TagDedupCache.h"
+
+#include "model/PaymentBoard.h"
+#include "model/PaymentCache.h"
+#include "model/PaymentData.h"
+#include "web/StatusCache.h"
+#include "web/WebPages.h"
+
+// 벤치마크 입력 데이터 =================================================================================================
+namespace {
+
+// 실제 결제 내역 응답과 같은 형태 (paymentId + 상품명:[uid, 수량])
+String makePaymentJson(int itemCount) {
+    String json = "{\"paymentId\":\"PAY-20240601-0001\"";
+    for (int i = 0; i < itemCount; ++i) {
+        char entry[64];
+        snprintf(entry, sizeof(entry), ",\"상품%02d\":[\"a1b2c3%02x\",%d]", i, i, 1 + i % 3);
+        json += entry;
+    }
+    json += "}";
+    return json;
+}
+
+// 같은 문서를 MessagePack으로 (서버가 Accept: application/msgpack에 답하는 형식)
+String toMsgPack(const String& json) {
+    JsonDocument doc;
+    deserializeJson(doc, json);
+    String packed;
+    serializeMsgPack(doc, packed);
+    return packed;
+}
+
+// 서버가 돌려주는 원시 HTTP 응답
+String makeHttpResponse(const String& body) {
+    String response = "HTTP/1.1 200 OK\r\n";
+    response += "Content-Type: application/json\r\n";
+    response += "Content-Length: " + String(static_cast<unsigned int>(body.length())) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+// 쓴 바이트를 버리는 연결 (/events 클라이언트 자리)
+class SinkConnection : public TcpConnection {
+public:
+    bool connected() override { return true; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    size_t write(const uint8_t*, size_t length) override { return length; }
+    void stop() override {}
+};
+
+// 같은 클라이언트 프레임을 다시 넣을 수 있는 연결 (/ws 명령 하나 = 프레임 하나 읽고 응답 하나 씀)
+class FrameConnection : public TcpConnection {
+public:
+    void load(const String& next) { frame = next; pos = 0; }
+
+    bool connected() override { return true; }
+    int available() override { return static_cast<int>(frame.length() - pos); }
+    int read() override { return pos < frame.length() ? static_cast<uint8_t>(frame[pos++]) : -1; }
+    size_t write(const uint8_t*, size_t length) override { return length; }
+    void stop() override {}
+
+private:
+    String frame;
+    size_t pos = 0;
+};
+
+// 클라이언트가 보내는 마스킹된 텍스트 프레임
+String maskedTextFrame(const String& message) {
+    const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+    String frame;
+    frame += static_cast<char>(0x81);
+    frame += static_cast<char>(0x80 | message.length());
+    for (uint8_t m : mask) frame += static_cast<char>(m);
+    for (size_t i = 0; i < message.length(); ++i) frame += static_cast<char>(message[i] ^ mask[i & 3]);
+    return frame;
+}
+
+// 부를 때마다 flush 간격만큼 가는 시간원 (하네스가 재는 가상 시간은 건드리지 않음)
+class SteppingClock : public Clock {
+public:
+    explicit SteppingClock(uint32_t stepMs) : stepMs(stepMs) {}
+    uint32_t millis() override { return now += stepMs; }
+    uint32_t micros() override { return now * 1000; }
+    void delay(uint32_t ms) override { now += ms; }
+
+private:
+    uint32_t stepMs;
+    uint32_t now = 0;
+};
+
+// ========== 루프백 소켓 (GO 왕복을 커널의 TCP / UDP로) =====================================================
+sockaddr_in loopbackAddress(uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return address;
+}
+
+// 127.0.0.1:port에 묶은 소켓 (port 0 = 커널이 고름), 실패하면 -1. 묶인 포트를 bound에 돌려준다
+int bindLoopback(int type, uint16_t port, uint16_t& bound) {
+    const int fd = ::socket(AF_INET, type, 0);
+    if (fd < 0) return -1;
+    const int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = loopbackAddress(port);
+    socklen_t length = sizeof(address);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    bound = ntohs(address.sin_port);
+    return fd;
+}
+
+// 끝 표시가 올 때까지 (없으면 상대가 닫을 때까지) 받는다
+String receiveUntil(int fd, const char* end) {
+    String data;
+    char buffer[512];
+    while (!end || data.indexOf(end) < 0) {
+        const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; ++i) data += buffer[i];
+    }
+    return data;
+}
+
+// ESP32 WebServer가 하는 만큼만: 요청 줄을 메서드 / URI로 나누고, 빈 줄까지 헤더 줄을 이름 / 값으로 나눈다
+bool parseHttpRequest(const String& raw, HTTPMethod& method, String& uri, std::vector<std::pair<String, String>>& headers) {
+    int lineEnd = raw.indexOf("\r\n");
+    const int first = raw.indexOf(' ');
+    const int second = raw.indexOf(' ', first + 1);
+    if (lineEnd < 0 || first < 0 || second < 0 || second > lineEnd) return false;
+    const String name = raw.substring(0, first);
+    if (name == "GET") method = HTTP_GET;
+    else if (name == "POST") method = HTTP_POST;
+    else return false;
+    uri = raw.substring(first + 1, second);
+
+    int pos = lineEnd + 2;
+    while ((lineEnd = raw.indexOf("\r\n", pos)) > pos) {
+        const int colon = raw.indexOf(':', pos);
+        if (colon < 0 || colon > lineEnd) return false;
+        String value = raw.substring(colon + 1, lineEnd);
+        value.trim();
+        headers.emplace_back(raw.substring(pos, colon), value);
+        pos = lineEnd + 2;
+    }
+    return lineEnd == pos;
+}
+
+String formatHttpResponse(const WebServer::Response& response) {
+    String out = String("HTTP/1.1 ") + response.code + (response.code == 200 ? " OK" : " Error") + "\r\n";
+    for (const auto& header : response.headers) out += header.first + ": " + header.second + "\r\n";
+    if (response.contentType.length()) out += "Content-Type: " + response.contentType + "\r\n";
+    out += "Content-Length: " + String(static_cast<unsigned int>(response.body.length())) + "\r\n";
+    out += "Connection: close\r\n\r\n";
+    out += response.body;
+    return out;
+}
+
+// 실제 UDP 소켓에 묶인 DatagramSocket (ESP32의 WiFiUDP 자리). 기다리지 않고 읽는다
+class LoopbackDatagramSocket : public DatagramSocket {
+public:
+    ~LoopbackDatagramSocket() override { stop(); }
+
+    bool begin(uint16_t port) override {
+        uint16_t bound = 0;
+        fd = bindLoopback(SOCK_DGRAM, port, bound);
+        return fd >= 0;
+    }
+    void stop() override {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    int receive(uint8_t* buffer, size_t size, IPAddress& from, uint16_t& fromPort) override {
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        const ssize_t n = ::recvfrom(fd, buffer, size, MSG_DONTWAIT | MSG_TRUNC, reinterpret_cast<sockaddr*>(&address), &length);
+        if (n <= 0) return 0;
+        const uint32_t host = ntohl(address.sin_addr.s_addr);
+        from = IPAddress(host >> 24, host >> 16, host >> 8, host);
+        fromPort = ntohs(address.sin_port);
+        return static_cast<size_t>(n) > size ? -1 : static_cast<int>(n);
+    }
+    bool send(const IPAddress& to, uint16_t port, const uint8_t* data, size_t length) override {
+        sockaddr_in address = loopbackAddress(port);
+        address.sin_addr.s_addr = htonl((static_cast<uint32_t>(to[0]) << 24) | (to[1] << 16) | (to[2] << 8) | to[3]);
+        return ::sendto(fd, data, length, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == static_cast<ssize_t>(length);
+    }
+
+private:
+    int fd = -1;
+};
+
+void fillConfig(Config& c) {
+    c.ssid = "tracego-ap";
+    c.password = "password1234";
+    c.localIP = "192.168.0.42";
+    c.serverIP = "192.168.0.10";
+    c.serverPort = 8080;
+    c.serverHosts[0] = c.serverIP;
+    c.serverPorts[0] = c.serverPort;
+    c.serverHosts[1] = "backup.tracego.local";
+    c.serverPorts[1] = 8080;
+    c.serverCount = 2;
+    c.innerPort = 8081;
+    c.standPort = 8082;
+    c.motionPort = 47100;
+    c.motionKey = "000102030405060708090a0b0c0d0e0f";
+    c.firstSetWoringLists = "/api/robot/first-set";
+    c.resetWorkingLists = "/api/robot/reset";
+    c.getPayment = "/api/robot/payment";
+    c.addWorkingList = "/api/robot/working-list";
+    c.paymentPrefetchMs = 10000;
+    c.adminUID = "deadbeef";
+    c.masterKey = "master";
+    c.testKey = "test";
+    c.useRFID = true;
+    c.commRxPin = 16;
+    c.commTxPin = 17;
+    c.rcSdaPins[0] = 5;
+    c.rcSdaPins[1] = 21;
+    c.rcIrqPins[0] = 4;
+    c.rcIrqPins[1] = 15;
+    c.rcReaderCount = 2;
+    c.rcRstPin = 22;
+    c.tagDedupMs = 2000;
+    c.rfidInventory = true;
+    c.serialBaudrate = 115200;
+    c.serial2Baudrate = 9600;
+}
+
+} // namespace
+
+// 벤치마크 목록 ========================================================================================================
+int main(int argc, char** argv) {
+    bench::Runner runner;
+
+    const String paymentSmall = makePaymentJson(4);
+    const String paymentLarge = makePaymentJson(32);
+
+    runner.add("PaymentData::parseFromJson/4", [&]() {
+        PaymentData data;
+        bench::doNotOptimize(data.parseFromJson(paymentSmall));
+    });
+    runner.add("PaymentData::parseFromJson/32", [&]() {
+        PaymentData data;
+        bench::doNotOptimize(data.parseFromJson(paymentLarge));
+    });
+
+    // 같은 내역의 MessagePack 파싱 — JSON 파싱과 시간 / 크기를 나란히 비교
+    const String packedSmall = toMsgPack(paymentSmall);
+    const String packedLarge = toMsgPack(paymentLarge);
+    runner.add("PaymentData::parseFromMsgPack/4", [&]() {
+        PaymentData data;
+        bench::doNotOptimize(data.parseFromMsgPack(packedSmall));
+    });
+    runner.add("PaymentData::parseFromMsgPack/32", [&]() {
+        PaymentData data;
+        bench::doNotOptimize(data.parseFromMsgPack(packedLarge));
+    });
+    runner.addSize("payment/4 json", paymentSmall.length());
+    runner.addSize("payment/4 msgpack", packedSmall.length());
+    runner.addSize("payment/32 json", paymentLarge.length());
+    runner.addSize("payment/32 msgpack", packedLarge.length());
+
+    // 32개 중 2개만 바뀐 변경분 (추가 후 삭제라 반복 적용해도 내역이 같음) — 전체 파싱과 비교
+    PaymentData deltaData;
+    deltaData.setVersion("v1");
+    deltaData.parseFromJson(paymentLarge);
+    const String delta = "{\"paymentId\":\"PAY-20240601-0001\",\"base\":\"v1\","
+                         "\"added\":{\"추가\":[\"ffeeddcc\",1]},\"changed\":{\"상품05\":[\"a1b2c305\",4]},"
+                         "\"removed\":[\"추가\"]}";
+    runner.add("PaymentData::applyDelta/2-of-32", [&]() {
+        bench::doNotOptimize(deltaData.applyDelta(delta, "v1"));
+    });
+    const String packedDelta = toMsgPack(delta);
+    runner.add("PaymentData::applyDeltaMsgPack/2-of-32", [&]() {
+        bench::doNotOptimize(deltaData.applyDeltaMsgPack(packedDelta, "v1"));
+    });
+    runner.addSize("payment delta json", delta.length());
+    runner.addSize("payment delta msgpack", packedDelta.length());
+
+    // 매칭은 목록 끝쪽 UID(최악 경우)와 없는 UID를 번갈아 조회
+    PaymentData matchData;
+    matchData.parseFromJson(paymentLarge);
+    const String lastUid = "a1b2c31f";
+    const String unknownUid = "ffffffff";
+    runner.add("PaymentData::matchUID/32", [&]() {
+        String name;
+        bench::doNotOptimize(matchData.matchUID(lastUid, name));
+        bench::doNotOptimize(matchData.matchUID(unknownUid, name));
+    });
+
+    // 측정 도중 수량이 바닥나지 않도록 충분히 큰 수량으로 시작
+    PaymentData consumeData;
+    consumeData.parseFromJson("{\"paymentId\":\"PAY\",\"상품\":[\"a1b2c3d4\",2147483647]}");
+    const String consumeUid = "a1b2c3d4";
+    runner.add("PaymentData::consumeItem", [&]() {
+        bench::doNotOptimize(consumeData.consumeItem(consumeUid));
+    });
+
+    // 스캐너 경로: 게시된 스냅샷을 잠금 없이 읽어 매칭, 집은 수량은 원자 카운터로
+    PaymentBoard board;
+    board.publish(matchData);
+    runner.add("PaymentBoard::current+matchUID/32", [&]() {
+        String name;
+        const PaymentSnapshot& snapshot = board.current();
+        bench::doNotOptimize(snapshot.matchUID(lastUid, name));
+        bench::doNotOptimize(snapshot.matchUID(unknownUid, name));
+    });
+    PaymentBoard consumeBoard;
+    consumeBoard.publish(consumeData);
+    runner.add("PaymentBoard::consume", [&]() {
+        bench::doNotOptimize(consumeBoard.consume(consumeUid));
+    });
+
+    // 갱신 경로: 새 스냅샷 게시(집은 수량 이어받기) + 다음 quiescent에서 이전 스냅샷 회수
+    runner.add("PaymentBoard::publish+reclaim/32", [&]() {
+        board.publish(matchData);
+        board.quiescent();
+    });
+
+    // 플래시 보관 형식: 매 변경마다 encode, 부팅 시 decode
+    std::vector<uint8_t> manifest;
+    runner.add("PaymentCache::encode/32", [&]() {
+        bench::doNotOptimize(PaymentCache::encode(matchData, manifest));
+    });
+    PaymentCache::encode(matchData, manifest);
+    String decodedId;
+    String decodedVersion;
+    std::vector<PaymentItem> decodedItems;
+    runner.add("PaymentCache::decode/32", [&]() {
+        bench::doNotOptimize(PaymentCache::decode(manifest.data(), manifest.size(), decodedId, decodedVersion, decodedItems));
+    });
+
+    TagUid uid4 = {4, {0xA1, 0xB2, 0x03, 0xD4}};
+    TagUid uid7 = {7, {0x04, 0x5A, 0x1B, 0x82, 0xC3, 0x6F, 0x80}};
+    runner.add("RFIDController::formatUid/4", [&]() {
+        bench::doNotOptimize(RFIDController::formatUid(uid4));
+    });
+    runner.add("RFIDController::formatUid/7", [&]() {
+        bench::doNotOptimize(RFIDController::formatUid(uid7));
+    });
+
+    // 중복 억제: 같은 태그 반복(억제 경로)과 캐시보다 많은 태그 순환(밀어내기 경로)
+    TagDedupCache dedupHit(2000);
+    uint32_t dedupNow = 0;
+    runner.add("TagDedupCache::accept/duplicate", [&]() {
+        bench::doNotOptimize(dedupHit.accept(uid4, dedupNow++ & 0x3FF));
+    });
+    TagDedupCache dedupChurn(2000);
+    TagUid churnUid = {4, {0x5A, 0x17, 0x00, 0x00}};
+    runner.add("TagDedupCache::accept/evict", [&]() {
+        churnUid.bytes[3]++;
+        bench::doNotOptimize(dedupChurn.accept(churnUid, 0));
+    });
+
+    Config benchConfig;
+    fillConfig(benchConfig);
+    RuntimeStatus benchRuntime;
+    benchRuntime.tagsAccepted = 1200;
+    benchRuntime.tagsSuppressed = 5400;
+    benchRuntime.rfid.readerCount = 2;
+    runner.add("WebPages::buildStatusJson", [&]() {
+        bench::doNotOptimize(buildStatusJson(benchConfig, benchRuntime));
+    });
+    runner.add("WebPages::buildStatusMsgPack", [&]() {
+        bench::doNotOptimize(buildStatusMsgPack(benchConfig, benchRuntime));
+    });
+    // 캐시: 상태가 그대로인 폴링(버퍼 그대로) / 태그가 하나 더 읽혀 다시 만드는 폴링 — buildStatusJson과 비교
+    StatusCache statusCache;
+    RuntimeStatus cachedRuntime = benchRuntime;
+    runner.add("StatusCache::reply/unchanged", [&]() {
+        bench::doNotOptimize(statusCache.reply(WireFormat::Json, benchConfig, cachedRuntime).body);
+    });
+    runner.add("StatusCache::reply/changed", [&]() {
+        ++cachedRuntime.tagsAccepted;
+        bench::doNotOptimize(statusCache.reply(WireFormat::Json, benchConfig, cachedRuntime).body);
+    });
+    runner.add("ServerService::etagMatches", [&]() {
+        bench::doNotOptimize(ServerService::etagMatches("W/\"s41-j\", \"s42-j\"", "\"s42-j\""));
+    });
+    // /events: 연결이 없을 때 publish (태그 경로에 더해지는 비용) / 연결 3개에 이벤트 하나를 모아 쓰는 경로
+    EventStream idleEvents(hal::clock());
+    const String tagEvent = "{\"uid\":\"a1b2c3d4\",\"reader\":0,\"result\":\"matched\",\"name\":\"상품07\"}";
+    runner.add("EventStream::publish/no clients", [&]() {
+        idleEvents.publish("tag", tagEvent);
+    });
+    SteppingClock eventClock(EVENT_FLUSH_MS);
+    EventStream liveEvents(eventClock);
+    for (int i = 0; i < EVENT_MAX_CLIENTS; ++i) {
+        liveEvents.accept(std::unique_ptr<TcpConnection>(new SinkConnection()), "{}", "\"s1-j\"");
+    }
+    runner.add("EventStream::publish+flush/3 clients", [&]() {
+        liveEvents.publish("tag", tagEvent);
+        liveEvents.flush();
+    });
+    // /ws: 핸드셰이크 키 계산, 명령 프레임 하나 → 핸들러 → 응답 프레임 (핸들러는 바로 끝남, 바퀴 보드 대기 제외)
+    runner.add("CommandChannel::acceptKey", [&]() {
+        bench::doNotOptimize(CommandChannel::acceptKey("dGhlIHNhbXBsZSBub25jZQ=="));
+    });
+    CommandChannel channel(hal::clock());
+    channel.setDispatcher([](const String&, HandlerReply& reply) { reply.ok = true; return true; });
+    FrameConnection* frames = new FrameConnection();
+    channel.accept(std::unique_ptr<TcpConnection>(frames), "dGhlIHNhbXBsZSBub25jZQ==");
+    uint32_t benchSeq = 0;
+    runner.add("CommandChannel::poll/command", [&]() {   // 프레임 만들기 포함 (seq가 매번 달라야 실행 경로)
+        frames->load(maskedTextFrame(String("{\"session\":\"b1\",\"seq\":") + ++benchSeq + ",\"cmd\":\"go\"}"));
+        channel.poll();
+    });
+    const String duplicateFrame = maskedTextFrame("{\"session\":\"b1\",\"seq\":1,\"cmd\":\"go\"}");
+    runner.add("CommandChannel::poll/duplicate", [&]() {
+        frames->load(duplicateFrame);
+        channel.poll();
+    });
+    // GO 명령 왕복: 보내는 쪽 소켓 → 커널(127.0.0.1) → 코어 → 응답을 받아 해석하기까지 (핸들러는 바로 끝남, 바퀴 보드 대기 제외)
+    // HTTP: 요청마다 TCP 연결(3-way 핸드셰이크 / accept) → 요청 줄 / 헤더 파싱 → 내장 서버 핸들러 → 응답 쓰기 → 닫기
+    ServerService httpCore(9091, hal::transport(), hal::clock());
+    httpCore.setGoHandler([]() { HandlerReply reply; return reply; });
+    httpCore.begin();
+    WebServer* httpServer = WebServer::find(9091);
+    uint16_t httpPort = 0;
+    const int httpListener = bindLoopback(SOCK_STREAM, 0, httpPort);
+    if (httpListener >= 0 && ::listen(httpListener, 8) == 0) {
+        const sockaddr_in httpAddress = loopbackAddress(httpPort);
+        const String goRequest = String("GET /go HTTP/1.1\r\nHost: 127.0.0.1:") + httpPort + "\r\nConnection: close\r\n\r\n";
+        runner.add("GO round trip/HTTP loopback", [&, httpAddress, goRequest]() {
+            const int client = ::socket(AF_INET, SOCK_STREAM, 0);
+            ::connect(client, reinterpret_cast<const sockaddr*>(&httpAddress), sizeof(httpAddress));
+            ::send(client, goRequest.c_str(), goRequest.length(), 0);
+
+            const int accepted = ::accept(httpListener, nullptr, nullptr);
+            HTTPMethod method = HTTP_ANY;
+            String uri;
+            std::vector<std::pair<String, String>> headers;
+            String reply;
+            if (parseHttpRequest(receiveUntil(accepted, "\r\n\r\n"), method, uri, headers)) {
+                httpServer->inject(method, uri, String(), headers, [&](const WebServer::Response& response) {
+                    reply = formatHttpResponse(response);
+                });
+                httpCore.handle();
+            }
+            ::send(accepted, reply.c_str(), reply.length(), 0);
+            ::close(accepted);
+
+            bench::doNotOptimize(ServerService::parseStatusCode(receiveUntil(client, nullptr)));
+            ::close(client);
+        });
+    } else {
+        printf("루프백 TCP 소켓을 열 수 없어 GO round trip/HTTP loopback을 건너뜀\n");
+    }
+    // 수락 제어: 요청이 없는 loop 한 바퀴의 내장 서버 비용 (시간 예산 시작 / 끝 포함), 일반 요청 하나 수락 + 스캔 표시
+    runner.add("ServerService::handle/idle", [&]() {
+        httpCore.handle();
+    });
+    AdmissionControl admission(hal::clock());
+    runner.add("AdmissionControl::admit+markScanned", [&]() {
+        bench::doNotOptimize(admission.admit(false));
+        admission.markScanned();
+    });
+    // UDP: 명령 인코딩(MAC) → sendto → 코어 소켓 수신 / MAC 확인 / 재전송 창 → ACK(MAC) sendto → 보내는 쪽이 받아 ACK 확인
+    uint8_t motionKey[MOTION_KEY_SIZE];
+    MotionListener::parseKey(benchConfig.motionKey, motionKey);
+    LoopbackDatagramSocket motionSocket;
+    MemoryKVStore motionStore;
+    MotionListener motion(motionSocket, hal::clock(), motionStore);
+    motion.setHandler([](MotionType) { return true; });
+    uint16_t senderPort = 0;
+    const int sender = bindLoopback(SOCK_DGRAM, 0, senderPort);
+    const timeval ackTimeout = {1, 0};                      // ACK가 오지 않으면 멈추지 않고 다음 측정으로
+    if (sender >= 0) ::setsockopt(sender, SOL_SOCKET, SO_RCVTIMEO, &ackTimeout, sizeof(ackTimeout));
+    const sockaddr_in motionAddress = loopbackAddress(benchConfig.motionPort);
+    MotionFrame motionCommand;
+    motionCommand.type = MOTION_GO;
+    motionCommand.epoch = 1;
+    uint8_t datagram[MOTION_DATAGRAM_SIZE];
+    MotionFrame motionAck;
+    // 보내고, 코어가 받을 때까지 poll (루프백은 sendto가 끝나면 이미 도착), 돌아온 ACK를 해석
+    auto udpRoundTrip = [&](size_t length) {
+        ::sendto(sender, datagram, length, 0, reinterpret_cast<const sockaddr*>(&motionAddress), sizeof(motionAddress));
+        const uint32_t before = motion.stats().received;
+        while (motion.stats().received == before) motion.poll();
+        uint8_t ack[MOTION_ACK_SIZE];
+        const ssize_t n = ::recv(sender, ack, sizeof(ack), 0);
+        MotionListener::decodeAck(motionKey, ack, n > 0 ? static_cast<size_t>(n) : 0, motionAck);
+        bench::doNotOptimize(motionAck.status);
+    };
+    if (sender >= 0 && motion.begin(benchConfig.motionPort, benchConfig.motionKey)) {
+        ++motionCommand.seq;                                // 중복 측정이 먼저 돌아도 다시 보낼 명령이 있도록
+        udpRoundTrip(MotionListener::encodeCommand(motionKey, motionCommand, datagram));
+        runner.add("GO round trip/UDP loopback", [&]() {
+            ++motionCommand.seq;
+            udpRoundTrip(MotionListener::encodeCommand(motionKey, motionCommand, datagram));
+        });
+        runner.add("GO round trip/UDP loopback duplicate", [&]() {   // 잃어버린 ACK 때문에 같은 seq를 다시 보냄 → 실행 없이 기억한 ACK
+            udpRoundTrip(MOTION_DATAGRAM_SIZE);
+        });
+    } else {
+        printf("루프백 UDP 포트 %u를 열 수 없어 GO round trip/UDP loopback을 건너뜀\n", benchConfig.motionPort);
+    }
+    runner.add("MotionListener::siphash/12B", [&]() {
+        bench::doNotOptimize(MotionListener::siphash(motionKey, datagram, 12));
+    });
+    runner.addSize("GO request http", String("GET /go HTTP/1.1\r\nHost: 192.168.0.42:8081\r\nConnection: close\r\n\r\n").length());
+    runner.addSize("GO request udp", MOTION_DATAGRAM_SIZE);
+    runner.addSize("GO reply udp", MOTION_ACK_SIZE);
+
+    runner.addSize("status json", buildStatusJson(benchConfig, benchRuntime).length());
+    runner.addSize("status msgpack", buildStatusMsgPack(benchConfig, benchRuntime).length());
+    runner.add("ServerService::negotiate", [&]() {
+        bench::doNotOptimize(ServerService::negotiate("application/msgpack, application/json;q=0.5"));
+    });
+    runner.add("WebPages::renderAdvancedPage", [&]() {
+        bench::doNotOptimize(renderAdvancedPage(benchConfig));
+    });
+
+    const String response = makeHttpResponse(paymentSmall);
+    runner.add("ServerService::parseStatusCode", [&]() {
+        bench::doNotOptimize(ServerService::parseStatusCode(response));
+    });
+    runner.add("ServerService::extractBody", [&]() {
+        bench::doNotOptimize(ServerService::extractBody(response));
+    });
+
+
+    // 서킷 브레이커: 닫힌 상태의 결과 기록, 열린 엔드포인트 호출을 바로 실패시키는 경로
+    CircuitBreaker closedBreaker;
+    closedBreaker.setup("bench", "127.0.0.1", 8080, hal::clock());
+    runner.add("CircuitBreaker::allow+record/closed", [&]() {
+        closedBreaker.record(closedBreaker.allow(), 200, 40);
+    });
+    CircuitBreaker openBreaker;
+    openBreaker.setup("bench", "127.0.0.1", 8081, hal::clock());
+    for (int i = 0; i < BREAKER_MIN_CALLS; ++i) openBreaker.record(CircuitBreaker::Admitted, -1, 3000);
+    runner.add("CircuitBreaker::allow/open", [&]() {
+        bench::doNotOptimize(openBreaker.allow());
+    });
+
+    // DNS 캐시: TTL 안의 호스트 이름 조회 (연결마다 한 번)
+    DnsCache dnsCache(hal::fakes().resolver, hal::clock());
+    dnsCache.prefetch("oxxultus.kro.kr");
+    IPAddress resolved;
+    runner.add("DnsCache::lookup/hit", [&]() {
+        bench::doNotOptimize(dnsCache.lookup("oxxultus.kro.kr", resolved));
+    });
+
+    return runner.run(argc, argv);
+}
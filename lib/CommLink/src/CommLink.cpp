@@ -1,21 +1,11 @@
 #include "CommLink.h"
 
-#if defined(ESP32)
-CommLink::CommLink(HardwareSerial& hwSerial, int rx, int tx)
-    : serial(&hwSerial), rxPin(rx), txPin(tx) {}
-
-void CommLink::begin(long baudRate) {
-    serial->begin(baudRate, SERIAL_8N1, rxPin, txPin);
-}
-#else
-CommLink::CommLink(uint8_t rx, uint8_t tx) {
-    serial = new SoftwareSerial(rx, tx);
-}
+CommLink::CommLink(SerialPort& port, Clock& clock)
+    : serial(&port), clock(&clock) {}
 
 void CommLink::begin(long baudRate) {
     serial->begin(baudRate);
 }
-#endif
 
 // ✅ println() 사용으로 단일 메시지 전송 보장
 void CommLink::sendLine(const String& text) {
@@ -23,9 +13,18 @@ void CommLink::sendLine(const String& text) {
     serial->flush();           // 출력 버퍼 전송 완료까지 대기 (중요)
 }
 
-// ✅ '\n'까지 수신
+// ✅ '\n'까지 수신 (readStringUntil과 같이 바이트 사이 대기 시간 제한)
 String CommLink::receiveLine() {
-    return serial->readStringUntil('\n');
+    String line;
+    unsigned long last = clock->millis();
+    while (clock->millis() - last < lineTimeoutMs) {
+        int c = serial->read();
+        if (c < 0) continue;
+        if (c == '\n') break;
+        line += (char)c;
+        last = clock->millis();
+    }
+    return line;
 }
 
 // 데이터 수신 가능 여부 확인
@@ -36,8 +35,8 @@ bool CommLink::hasLine() {
 // 메시지 전송 후 ACK 대기
 bool CommLink::sendWithAck(const String& message) {
     sendLine(message);
-    unsigned long start = millis();
-    while (millis() - start < timeoutMs) {
+    unsigned long start = clock->millis();
+    while (clock->millis() - start < timeoutMs) {
         if (hasLine()) {
             String response = receiveLine();
             response.trim();
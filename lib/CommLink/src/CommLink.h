@@ -2,31 +2,24 @@
 #define COMMLINK_H
 
 #include <Arduino.h>
+#include "Clock.h"
+#include "SerialPort.h"
 
-#if defined(ESP32)
-  #include <HardwareSerial.h>
-#else
-  #include <SoftwareSerial.h>
-#endif
-
+/**
+ * CommLink 클래스
+ * - 보드 간 줄 단위 유선 통신 (바퀴 보드와 Serial2로 연결)
+ * - 포트와 시간원은 생성자에서 주입받는다 (ESP32: HardwareSerialPort, 호스트: FakeSerialPort)
+ */
 class CommLink {
 private:
-#if defined(ESP32)
-    HardwareSerial* serial;   // ESP32용 하드웨어 시리얼
-    int rxPin;
-    int txPin;
-#else
-    SoftwareSerial* serial;   // AVR용 소프트웨어 시리얼
-#endif
+    SerialPort* serial;
+    Clock* clock;
 
-    uint16_t timeoutMs = 2000;
+    uint16_t timeoutMs = 2000;      // ACK 대기 시간
+    uint16_t lineTimeoutMs = 1000;  // 한 줄 수신 대기 시간 (readStringUntil 기본값과 동일)
 
 public:
-#if defined(ESP32)
-    CommLink(HardwareSerial& hwSerial, int rx, int tx);
-#else
-    CommLink(uint8_t rx, uint8_t tx);
-#endif
+    CommLink(SerialPort& port, Clock& clock);
 
     void begin(long baudRate);
     void sendLine(const String& text);
@@ -1,10 +1,13 @@
 #include "Config.h"
-#include <Preferences.h>
 
-Preferences prefs;
 Config config;
 
+void Config::begin(KVStore& kvStore) {
+  store = &kvStore;
+}
+
 void Config::load() {
+  KVStore& prefs = *store;
   prefs.begin("settings", true);
 
   ssid            = prefs.getString("ssid", "");
@@ -14,6 +17,15 @@ void Config::load() {
   serverPort      = prefs.getInt("server_port", 8080);
   innerPort       = prefs.getInt("inner_port", 8081);
   standPort       = prefs.getInt("stand_port", 8082);
+  motionPort      = prefs.getInt("motion_port", 0);
+  motionKey       = prefs.getString("motion_key", "");
+  serverHosts[0]  = serverIP;
+  serverPorts[0]  = serverPort;
+  serverCount     = 1 + parseEndpoints(prefs.getString("server_bak", ""), serverHosts + 1, serverPorts + 1,
+                                       SERVER_MAX_HOSTS - 1, serverPort);
+  serverTls       = prefs.getBool("server_tls", false);
+  serverCa        = prefs.getString("server_ca", "");
+  serverTlsInsecure = prefs.getBool("tls_insecure", false);   // NVS 키는 15자까지
   
   localIP         = prefs.getString("localIP", ""); 
 
@@ -25,9 +37,19 @@ void Config::load() {
 
   commRxPin       = prefs.getInt("comm_rx", 16);
   commTxPin       = prefs.getInt("comm_tx", 17);
-  rcSdaPin        = prefs.getInt("rc_sda", 5);
   rcRstPin        = prefs.getInt("rc_rst", 22);
 
+  // 리더기 목록 (없으면 예전 단일 리더기 키 사용)
+  rcReaderCount   = parsePins(prefs.getString("rc_sdas", String(prefs.getInt("rc_sda", 5))), rcSdaPins, RFID_MAX_READERS);
+  if (rcReaderCount == 0) {
+    rcSdaPins[0]  = 5;
+    rcReaderCount = 1;
+  }
+  for (uint8_t i = 0; i < RFID_MAX_READERS; ++i) rcIrqPins[i] = -1;
+  parsePins(prefs.getString("rc_irqs", String(prefs.getInt("rc_irq", -1))), rcIrqPins, RFID_MAX_READERS);
+  tagDedupMs      = prefs.getInt("dedup_ms", 2000);
+  rfidInventory   = prefs.getBool("rc_inventory", true);
+
   serialBaudrate  = prefs.getInt("baudrate", 115200);
   serial2Baudrate = prefs.getInt("baudrate2", 9600);
 
@@ -35,11 +57,13 @@ void Config::load() {
   resetWorkingLists   = prefs.getString("rwl", "/bot/reset-working-list");
   getPayment          = prefs.getString("gpay", "/bot/payment");
   addWorkingList      = prefs.getString("awl", "/bot/add-working-list?uid=");
+  paymentPrefetchMs   = prefs.getInt("prefetch_ms", 10000);
 
   prefs.end();
 }
 
 void Config::save() {
+  KVStore& prefs = *store;
   prefs.begin("settings", false);
 
   prefs.putString("ssid", ssid);
@@ -49,6 +73,12 @@ void Config::save() {
   prefs.putInt("server_port", serverPort);
   prefs.putInt("inner_port", innerPort);
   prefs.putInt("stand_port", standPort);
+  prefs.putInt("motion_port", motionPort);
+  prefs.putString("motion_key", motionKey);
+  prefs.putString("server_bak", joinEndpoints(serverHosts + 1, serverPorts + 1, serverCount - 1));
+  prefs.putBool("server_tls", serverTls);
+  prefs.putString("server_ca", serverCa);
+  prefs.putBool("tls_insecure", serverTlsInsecure);
   prefs.putString("localIP", localIP);
 
   prefs.putString("admin_uid", adminUID);
@@ -59,8 +89,13 @@ void Config::save() {
 
   prefs.putInt("comm_rx", commRxPin);
   prefs.putInt("comm_tx", commTxPin);
-  prefs.putInt("rc_sda", rcSdaPin);
+  prefs.putInt("rc_sda", rcSdaPins[0]);
   prefs.putInt("rc_rst", rcRstPin);
+  prefs.putInt("rc_irq", rcIrqPins[0]);
+  prefs.putString("rc_sdas", joinPins(rcSdaPins, rcReaderCount));
+  prefs.putString("rc_irqs", joinPins(rcIrqPins, rcReaderCount));
+  prefs.putInt("dedup_ms", tagDedupMs);
+  prefs.putBool("rc_inventory", rfidInventory);
 
   prefs.putInt("baudrate", serialBaudrate);
   prefs.putInt("baudrate2", serial2Baudrate);
@@ -69,6 +104,61 @@ void Config::save() {
   prefs.putString("rwl", resetWorkingLists);
   prefs.putString("gpay", getPayment);
   prefs.putString("awl", addWorkingList);
+  prefs.putInt("prefetch_ms", paymentPrefetchMs);
 
   prefs.end();
-}
\ No newline at end of file
+}
+
+uint8_t Config::parsePins(const String& list, int* pins, uint8_t maxPins) {
+  uint8_t count = 0;
+  int start = 0;
+  while (start <= static_cast<int>(list.length()) && count < maxPins) {
+    int comma = list.indexOf(',', start);
+    if (comma == -1) comma = list.length();
+
+    String item = list.substring(start, comma);
+    item.trim();
+    if (item.length() > 0) pins[count++] = item.toInt();
+    start = comma + 1;
+  }
+  return count;
+}
+
+String Config::joinPins(const int* pins, uint8_t count) {
+  String list;
+  for (uint8_t i = 0; i < count; ++i) {
+    if (i > 0) list += ",";
+    list += String(pins[i]);
+  }
+  return list;
+}
+
+uint8_t Config::parseEndpoints(const String& list, String* hosts, int* ports, uint8_t maxHosts, int defaultPort) {
+  uint8_t count = 0;
+  int start = 0;
+  while (start <= static_cast<int>(list.length()) && count < maxHosts) {
+    int comma = list.indexOf(',', start);
+    if (comma == -1) comma = list.length();
+
+    String item = list.substring(start, comma);
+    item.trim();
+    if (item.length() > 0) {
+      const int colon = item.indexOf(':');
+      hosts[count] = colon == -1 ? item : item.substring(0, colon);
+      ports[count] = colon == -1 ? defaultPort : item.substring(colon + 1).toInt();
+      hosts[count].trim();
+      if (hosts[count].length() > 0 && ports[count] > 0) ++count;
+    }
+    start = comma + 1;
+  }
+  return count;
+}
+
+String Config::joinEndpoints(const String* hosts, const int* ports, uint8_t count) {
+  String list;
+  for (uint8_t i = 0; i < count; ++i) {
+    if (i > 0) list += ",";
+    list += hosts[i] + ":" + String(ports[i]);
+  }
+  return list;
+}
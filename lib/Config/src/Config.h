@@ -2,6 +2,15 @@
 #define CONFIG_H
 
 #include <Arduino.h>  
+#include "KVStore.h"
+
+// RC522 리더기 최대 수 (RFIDController와 같은 값)
+#ifndef RFID_MAX_READERS
+#define RFID_MAX_READERS 4
+#endif
+
+// 서버 엔드포인트 최대 수 (주 서버 + 대체 서버)
+#define SERVER_MAX_HOSTS 4
 
 struct Config {
   // Wi-Fi
@@ -10,16 +19,25 @@ struct Config {
   String localIP;
 
   // 서버 정보
-  String serverIP;
+  String serverIP;     // 주 서버 (요청은 이 주소로 보내고, ServerService가 묶음 안에서 빠른 곳을 고른다)
   int serverPort;
+  String serverHosts[SERVER_MAX_HOSTS];   // 주 서버(0번) + 대체 서버, 순서대로 - 저장: "server_bak" = "host:port,host"
+  int serverPorts[SERVER_MAX_HOSTS];
+  uint8_t serverCount;
+  bool serverTls;      // tracego-server(주 + 대체)에 HTTPS로 연결 (스탠드는 매장 안 장치라 HTTP 그대로)
+  String serverCa;     // 서버 인증서를 검증할 CA (PEM). 비어 있거나 읽을 수 없으면 HTTPS 연결을 하지 않음
+  bool serverTlsInsecure;   // CA 없이 검증하지 않고 암호화만 하도록 명시적으로 허용 (중간자가 내용을 볼 수 있음)
   int innerPort;
   int standPort;
+  int motionPort;      // UDP 모션 명령(GO/STOP) 수신 포트 (0 = 끔, 켜려면 motionKey도 있어야 함)
+  String motionKey;    // 모션 명령 MAC 키 (SipHash-2-4, 16진수 32자 - 중앙 서버와 같은 값)
 
   // 요청 api
   String firstSetWoringLists;
   String resetWorkingLists;
   String getPayment;
   String addWorkingList;
+  int paymentPrefetchMs;   // 결제 내역 백그라운드 재확인 주기 (0 = /start, 관리자 카드 때만)
 
   // UID 및 키
   String adminUID;
@@ -30,16 +48,32 @@ struct Config {
   bool useRFID;
   int commRxPin;
   int commTxPin;
-  int rcSdaPin;
+  int rcSdaPins[RFID_MAX_READERS];   // RC522 SS 핀 목록 (리더기마다 하나, SPI 버스/RST 공유) - 저장: "5,21"
+  int rcIrqPins[RFID_MAX_READERS];   // 리더기별 IRQ 핀 (-1 = 미연결 → 적응형 폴링)
+  uint8_t rcReaderCount;
   int rcRstPin;
+  int tagDedupMs;      // 같은 태그 재인식 억제 시간 (0 = 끔)
+  bool rfidInventory;  // 한 주기에 범위 안의 태그를 모두 읽음 (충돌 방지 인벤토리)
 
   // 시리얼 통신 속도
   int serialBaudrate;
   int serial2Baudrate;
 
+  // 저장소 (ESP32: Preferences, 호스트: 메모리)
+  KVStore* store = nullptr;
+
   // 저장 및 로딩 메서드
+  void begin(KVStore& kvStore);
   void load();
   void save();
+
+  // 핀 목록 문자열 ("5, 21") ↔ 배열
+  static uint8_t parsePins(const String& list, int* pins, uint8_t maxPins);
+  static String joinPins(const int* pins, uint8_t count);
+
+  // 엔드포인트 목록 문자열 ("a.example:8080, 10.0.0.2") ↔ 배열 (포트가 없으면 defaultPort)
+  static uint8_t parseEndpoints(const String& list, String* hosts, int* ports, uint8_t maxHosts, int defaultPort);
+  static String joinEndpoints(const String* hosts, const int* ports, uint8_t count);
 };
 
 extern Config config;
@@ -1,7 +1,5 @@
 #include "ConfigWebServer.h"
-#include <Preferences.h>
-
-extern Preferences prefs;
+#include "Platform.h"
 
 ConfigWebServer::ConfigWebServer(Config& cfg, int port)
     : server(port), config(cfg) {}
@@ -105,6 +103,7 @@ void ConfigWebServer::handleRoot() {
 }
 
 void ConfigWebServer::handleSave() {
+    KVStore& prefs = *config.store;
     prefs.begin("settings", false);
     prefs.putString("ssid", server.arg("ssid"));
     prefs.putString("password", server.arg("password"));
@@ -122,7 +121,7 @@ void ConfigWebServer::handleSave() {
     )rawliteral");
 
     delay(3000);
-    ESP.restart();  // 재부팅
+    hal::restart();  // 재부팅
 }
 
 void ConfigWebServer::handleNotFound() {
@@ -4,14 +4,12 @@
 
 #include <WiFi.h>
 #include <WebServer.h>
-#include <Preferences.h>
 #include "Config.h"
 
 class ConfigWebServer {
 private:
     WebServer server;
     Config& config;  // 외부에서 참조하는 Config 객체
-    Preferences prefs;
 
     void handleRoot();        // 설정 입력 폼
     void handleSave();        // 설정 저장 처리
@@ -0,0 +1,216 @@
+// ArduinoDevices.h
+#ifndef HAL_ARDUINODEVICES_H
+#define HAL_ARDUINODEVICES_H
+
+#if defined(ARDUINO)
+
+#include <HardwareSerial.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <lwip/sockets.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+#include "DatagramSocket.h"
+#include "HostResolver.h"
+#include "KVStore.h"
+#include "SerialPort.h"
+#include "TcpTransport.h"
+
+/**
+ * HardwareSerial 기반 SerialPort (ESP32 UART)
+ */
+class HardwareSerialPort : public SerialPort {
+public:
+    HardwareSerialPort(HardwareSerial& hwSerial, int rx, int tx);
+
+    void begin(unsigned long baudRate) override;
+    int available() override { return serial->available(); }
+    int read() override { return serial->read(); }
+    size_t write(const uint8_t* data, size_t length) override { return serial->write(data, length); }
+    void flush() override { serial->flush(); }
+
+private:
+    HardwareSerial* serial;
+    int rxPin;
+    int txPin;
+};
+
+/**
+ * Preferences(NVS) 기반 KVStore
+ */
+class PreferencesStore : public KVStore {
+public:
+    bool begin(const char* name, bool readOnly = false) override { return prefs.begin(name, readOnly); }
+    void end() override { prefs.end(); }
+    bool clear() override { return prefs.clear(); }
+    bool remove(const char* key) override { return prefs.remove(key); }
+    bool isKey(const char* key) override { return prefs.isKey(key); }
+
+    String getString(const char* key, const String& defaultValue = String()) override { return prefs.getString(key, defaultValue); }
+    size_t putString(const char* key, const String& value) override { return prefs.putString(key, value); }
+
+    int32_t getInt(const char* key, int32_t defaultValue = 0) override { return prefs.getInt(key, defaultValue); }
+    size_t putInt(const char* key, int32_t value) override { return prefs.putInt(key, value); }
+
+    bool getBool(const char* key, bool defaultValue = false) override { return prefs.getBool(key, defaultValue); }
+    size_t putBool(const char* key, bool value) override { return prefs.putBool(key, value); }
+
+    size_t getBytesLength(const char* key) override { return prefs.getBytesLength(key); }
+    size_t getBytes(const char* key, void* buffer, size_t maxLength) override { return prefs.getBytes(key, buffer, maxLength); }
+    size_t putBytes(const char* key, const void* value, size_t length) override { return prefs.putBytes(key, value, length); }
+
+private:
+    Preferences prefs;
+};
+
+/**
+ * 여러 백그라운드 태스크가 함께 쓰는 Preferences 핸들 (hal::journal)
+ * - 핸들 하나는 한 번에 한 네임스페이스만 열 수 있으므로 begin()~end() 사이를 뮤텍스로 묶는다.
+ *   begin()이 실패해도 end()까지 잡고 있으므로 부르는 쪽은 항상 end()를 불러야 한다.
+ */
+class SharedPreferencesStore : public PreferencesStore {
+public:
+    SharedPreferencesStore() : lock(xSemaphoreCreateMutex()) {}
+
+    bool begin(const char* name, bool readOnly = false) override {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        return PreferencesStore::begin(name, readOnly);
+    }
+    void end() override {
+        PreferencesStore::end();
+        xSemaphoreGive(lock);
+    }
+
+private:
+    SemaphoreHandle_t lock;
+};
+
+/**
+ * WiFiClient 기반 TcpConnection
+ */
+class WiFiConnection : public TcpConnection {
+public:
+    explicit WiFiConnection(const WiFiClient& client) : client(client) {}
+
+    bool connected() override { return client.connected(); }
+    int available() override { return client.available(); }
+    int read() override { return client.read(); }
+    size_t write(const uint8_t* data, size_t length) override { return client.write(data, length); }
+    void stop() override { client.stop(); }
+
+    // WiFiClient::write는 select로 기다리며 재시도하므로 소켓에 MSG_DONTWAIT로 바로 보낸다
+    size_t tryWrite(const uint8_t* data, size_t length) override {
+        const int fd = client.fd();
+        if (fd < 0) return 0;
+        const int sent = ::send(fd, data, length, MSG_DONTWAIT);
+        return sent > 0 ? static_cast<size_t>(sent) : 0;
+    }
+
+private:
+    WiFiClient client;
+};
+
+/**
+ * WiFiUDP 기반 DatagramSocket
+ * - parsePacket()으로 다음 데이터그램을 꺼내 한 번에 읽고, 남은 바이트는 flush()로 버린다.
+ */
+class WiFiDatagramSocket : public DatagramSocket {
+public:
+    bool begin(uint16_t port) override { return udp.begin(port) == 1; }
+    void stop() override { udp.stop(); }
+    int receive(uint8_t* buffer, size_t size, IPAddress& from, uint16_t& fromPort) override;
+    bool send(const IPAddress& to, uint16_t port, const uint8_t* data, size_t length) override;
+
+private:
+    WiFiUDP udp;
+};
+
+/**
+ * WiFiClient 위에 mbedTLS를 얹은 TcpConnection
+ * - WiFiClientSecure는 connect() 안에서 핸드셰이크까지 끝내 버려 세션을 넣을 틈이 없으므로 직접 mbedtls_ssl_context를 둔다.
+ * - 소켓 입출력은 WiFiClient를 그대로 쓰고(bio 콜백), 복호화한 바이트는 작은 버퍼에 모아 한 바이트씩 돌려준다.
+ */
+class TlsConnection : public TcpConnection {
+public:
+    TlsConnection(const WiFiClient& client, const mbedtls_ssl_config* conf, const char* host);
+    ~TlsConnection() override;
+
+    // 핸드셰이크 전에 부르면 그 세션으로 재개를 요청한다 (서버가 거절하면 mbedTLS가 알아서 전체 핸드셰이크)
+    bool offerSession(const mbedtls_ssl_session* session);
+    bool handshake(uint32_t timeoutMs);
+    bool exportSession(mbedtls_ssl_session* out) const;
+
+    bool connected() override;
+    int available() override;
+    int read() override;
+    size_t write(const uint8_t* data, size_t length) override;
+    void stop() override;
+
+private:
+    static int sendBio(void* ctx, const unsigned char* buf, size_t len);
+    static int recvBio(void* ctx, unsigned char* buf, size_t len);
+
+    WiFiClient client;
+    mbedtls_ssl_context ssl;
+    uint8_t rx[256];
+    size_t rxLen = 0;
+    size_t rxPos = 0;
+    bool ready = false;               // mbedtls_ssl_setup 성공
+    bool peerClosed = false;          // close_notify 또는 읽기 오류
+    bool closed = false;
+};
+
+/**
+ * WiFiClient로 연결을 여는 TcpTransport
+ * - 호스트 이름은 hal::dns() 캐시로 주소를 얻어 IP로 연결한다 (요청마다 DNS 왕복을 하지 않음).
+ * - connectSecure(): host:port마다 마지막 세션을 TLS_SESSION_SLOTS개까지 기억해 두고 재개를 요청한다.
+ *   세션 슬롯과 통계는 여러 태스크가 함께 쓰므로 뮤텍스로 보호한다 (세션 복사는 힙을 쓰므로 임계 구역에 넣지 않음).
+ */
+class WiFiTransport : public TcpTransport {
+public:
+    std::unique_ptr<TcpConnection> connect(const char* host, uint16_t port) override;
+    std::unique_ptr<TcpConnection> connectSecure(const char* host, uint16_t port) override;
+    bool setTrustAnchor(const String& caPem, bool allowUnverified) override;
+    TlsStats tlsStats() const override;
+
+private:
+    struct Session {
+        String host;
+        uint16_t port = 0;
+        uint32_t savedAt = 0;
+        bool valid = false;
+        mbedtls_ssl_session data;
+    };
+
+    int findSession(const char* host, uint16_t port) const;
+    int victimSession() const;
+
+    bool tlsReady = false;
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_x509_crt ca;
+    mbedtls_ssl_config conf;
+    SemaphoreHandle_t lock = nullptr;
+    Session sessions[TLS_SESSION_SLOTS];
+    TlsStats stats;
+};
+
+/**
+ * UDP로 DNS 서버(WiFi.dnsIP())에 A 레코드를 직접 질의하는 HostResolver
+ * - WiFi.hostByName()은 TTL을 알려주지 않으므로 응답의 TTL을 읽기 위해 직접 질의한다.
+ * - 응답이 없으면 WiFi.hostByName()으로 한 번 더 시도한다 (TTL은 모름 → 0).
+ */
+class UdpDnsResolver : public HostResolver {
+public:
+    bool resolve(const char* host, IPAddress& address, uint32_t& ttlSec) override;
+};
+
+#endif // ARDUINO
+
+#endif // HAL_ARDUINODEVICES_H
@@ -0,0 +1,185 @@
+#if defined(ARDUINO)
+
+#include <WebServer.h>
+#include <WiFiUdp.h>
+
+#include "ArduinoDevices.h"
+#include "Platform.h"
+
+namespace {
+
+const uint16_t DNS_PORT = 53;
+const uint32_t DNS_QUERY_TIMEOUT_MS = 1000;
+const size_t DNS_PACKET_MAX = 512;
+
+// 이름(라벨 또는 압축 포인터)을 건너뛴다. 범위를 벗어나면 false
+bool skipName(const uint8_t* packet, size_t length, size_t& pos) {
+    while (pos < length) {
+        const uint8_t label = packet[pos];
+        if ((label & 0xC0) == 0xC0) { pos += 2; return pos <= length; }
+        if (label == 0) { pos += 1; return true; }
+        pos += label + 1;
+    }
+    return false;
+}
+
+uint16_t readWord(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+
+// 질의 패킷: 헤더(ID, RD 플래그, 질문 1개) + 이름 라벨 + A / IN
+size_t buildQuery(const char* host, uint16_t id, uint8_t* packet) {
+    const uint8_t header[12] = {static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id), 0x01, 0x00, 0x00, 0x01, 0, 0, 0, 0, 0, 0};
+    memcpy(packet, header, sizeof(header));
+    size_t pos = sizeof(header);
+    for (const char* label = host; *label; ) {
+        const char* dot = strchr(label, '.');
+        const size_t n = dot ? static_cast<size_t>(dot - label) : strlen(label);
+        if (n == 0 || n > 63 || pos + n + 6 > DNS_PACKET_MAX) return 0;
+        packet[pos++] = static_cast<uint8_t>(n);
+        memcpy(packet + pos, label, n);
+        pos += n;
+        label += n + (dot ? 1 : 0);
+    }
+    const uint8_t tail[5] = {0, 0x00, 0x01, 0x00, 0x01};
+    memcpy(packet + pos, tail, sizeof(tail));
+    return pos + sizeof(tail);
+}
+
+// 응답에서 첫 A 레코드를 찾는다. CNAME을 거치면 지나온 레코드 중 가장 짧은 TTL을 쓴다
+bool parseAnswer(const uint8_t* packet, size_t length, uint16_t id, IPAddress& address, uint32_t& ttlSec) {
+    if (length < 12 || readWord(packet) != id || !(packet[2] & 0x80) || (packet[3] & 0x0F) != 0) return false;
+    const uint16_t questions = readWord(packet + 4);
+    const uint16_t answers = readWord(packet + 6);
+
+    size_t pos = 12;
+    for (uint16_t i = 0; i < questions; ++i) {
+        if (!skipName(packet, length, pos)) return false;
+        pos += 4;
+    }
+
+    uint32_t minTtl = UINT32_MAX;
+    for (uint16_t i = 0; i < answers; ++i) {
+        if (!skipName(packet, length, pos) || pos + 10 > length) return false;
+        const uint16_t type = readWord(packet + pos);
+        const uint16_t cls = readWord(packet + pos + 2);
+        const uint32_t ttl = (static_cast<uint32_t>(readWord(packet + pos + 4)) << 16) | readWord(packet + pos + 6);
+        const uint16_t rdLength = readWord(packet + pos + 8);
+        pos += 10;
+        if (pos + rdLength > length) return false;
+        if (cls == 1 && ttl < minTtl) minTtl = ttl;
+        if (type == 1 && cls == 1 && rdLength == 4) {
+            address = IPAddress(packet[pos], packet[pos + 1], packet[pos + 2], packet[pos + 3]);
+            ttlSec = minTtl;
+            return true;
+        }
+        pos += rdLength;
+    }
+    return false;
+}
+
+} // namespace
+
+// ========== 장치 구현 ======================================================================================
+HardwareSerialPort::HardwareSerialPort(HardwareSerial& hwSerial, int rx, int tx)
+    : serial(&hwSerial), rxPin(rx), txPin(tx) {}
+
+void HardwareSerialPort::begin(unsigned long baudRate) {
+    serial->begin(baudRate, SERIAL_8N1, rxPin, txPin);
+}
+
+std::unique_ptr<TcpConnection> WiFiTransport::connect(const char* host, uint16_t port) {
+    IPAddress address;
+    if (!hal::dns().lookup(host, address)) return nullptr;
+
+    WiFiClient client;
+    if (!client.connect(address, port)) return nullptr;
+    return std::unique_ptr<TcpConnection>(new WiFiConnection(client));
+}
+
+bool UdpDnsResolver::resolve(const char* host, IPAddress& address, uint32_t& ttlSec) {
+    uint8_t packet[DNS_PACKET_MAX];
+    const uint16_t id = static_cast<uint16_t>(esp_random());
+    const size_t queryLength = buildQuery(host, id, packet);
+
+    if (queryLength > 0) {
+        WiFiUDP udp;
+        if (udp.beginPacket(WiFi.dnsIP(0), DNS_PORT) && udp.write(packet, queryLength) == queryLength && udp.endPacket()) {
+            const uint32_t deadline = ::millis() + DNS_QUERY_TIMEOUT_MS;
+            while (static_cast<int32_t>(::millis() - deadline) < 0) {
+                if (udp.parsePacket() > 0) {
+                    const int length = udp.read(packet, sizeof(packet));
+                    if (length > 0 && parseAnswer(packet, length, id, address, ttlSec)) {
+                        udp.stop();
+                        return true;
+                    }
+                }
+                ::delay(5);
+            }
+        }
+        udp.stop();
+    }
+
+    ttlSec = 0;
+    return WiFi.hostByName(host, address) == 1;
+}
+
+int WiFiDatagramSocket::receive(uint8_t* buffer, size_t size, IPAddress& from, uint16_t& fromPort) {
+    const int length = udp.parsePacket();
+    if (length <= 0) return 0;
+    from = udp.remoteIP();
+    fromPort = udp.remotePort();
+    const int copied = static_cast<size_t>(length) > size ? -1 : udp.read(buffer, length);
+    udp.flush();                                          // 읽지 않은 나머지를 버려야 다음 parsePacket()이 새 데이터그램을 꺼냄
+    return copied;
+}
+
+bool WiFiDatagramSocket::send(const IPAddress& to, uint16_t port, const uint8_t* data, size_t length) {
+    return udp.beginPacket(to, port) && udp.write(data, length) == length && udp.endPacket();
+}
+
+// ========== 플랫폼 인스턴스 ================================================================================
+Clock& hal::clock() {
+    static SystemClock instance;
+    return instance;
+}
+
+KVStore& hal::settings() {
+    static PreferencesStore instance;
+    return instance;
+}
+
+KVStore& hal::journal() {
+    static SharedPreferencesStore instance;
+    return instance;
+}
+
+TcpTransport& hal::transport() {
+    static WiFiTransport instance;
+    return instance;
+}
+
+DnsCache& hal::dns() {
+    static UdpDnsResolver resolver;
+    static DnsCache instance(resolver, hal::clock());
+    return instance;
+}
+
+SerialPort& hal::wheelSerial(int rxPin, int txPin) {
+    static HardwareSerialPort instance(Serial2, rxPin, txPin);
+    return instance;
+}
+
+DatagramSocket& hal::motionSocket() {
+    static WiFiDatagramSocket instance;
+    return instance;
+}
+
+// WiFiClient는 복사해도 같은 소켓을 가리킨다. WebServer가 요청을 끝내며 자기 복사본을 버려도 소켓은 열려 있다
+std::unique_ptr<TcpConnection> hal::adoptClient(WebServer& server) {
+    return std::unique_ptr<TcpConnection>(new WiFiConnection(server.client()));
+}
+
+void hal::restart() {
+    ESP.restart();
+}
+
+#endif // ARDUINO
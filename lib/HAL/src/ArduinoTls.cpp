@@ -0,0 +1,237 @@
+#if defined(ARDUINO)
+
+#include <mbedtls/net_sockets.h>
+
+#include "ArduinoDevices.h"
+#include "Platform.h"
+
+// mbedTLS 3.x는 구조체 필드를 MBEDTLS_PRIVATE()로 감춘다. 2.x에서는 그대로 접근
+#if !defined(MBEDTLS_PRIVATE)
+  #define MBEDTLS_PRIVATE(member) member
+#endif
+
+namespace {
+
+// 재개에 성공하면 새 세션의 마스터 시크릿이 제시한 세션과 같다 (전체 핸드셰이크는 새로 만든다).
+// 세션 ID / 티켓 어느 쪽으로 재개해도 똑같이 판단할 수 있다
+bool sameMaster(const mbedtls_ssl_session& a, const mbedtls_ssl_session& b) {
+    return memcmp(a.MBEDTLS_PRIVATE(master), b.MBEDTLS_PRIVATE(master), sizeof(a.MBEDTLS_PRIVATE(master))) == 0;
+}
+
+} // namespace
+
+// ========== TlsConnection ==================================================================================
+TlsConnection::TlsConnection(const WiFiClient& socket, const mbedtls_ssl_config* conf, const char* host)
+    : client(socket) {
+    mbedtls_ssl_init(&ssl);
+    ready = mbedtls_ssl_setup(&ssl, conf) == 0 && mbedtls_ssl_set_hostname(&ssl, host) == 0;   // SNI + 인증서 이름 확인
+    mbedtls_ssl_set_bio(&ssl, &client, sendBio, recvBio, nullptr);
+}
+
+TlsConnection::~TlsConnection() {
+    stop();
+    mbedtls_ssl_free(&ssl);
+}
+
+bool TlsConnection::offerSession(const mbedtls_ssl_session* session) {
+    return ready && mbedtls_ssl_set_session(&ssl, session) == 0;
+}
+
+bool TlsConnection::handshake(uint32_t timeoutMs) {
+    if (!ready) return false;
+    const uint32_t startedAt = ::millis();
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) return false;
+        if (::millis() - startedAt > timeoutMs) return false;
+        ::delay(1);
+    }
+    return true;
+}
+
+bool TlsConnection::exportSession(mbedtls_ssl_session* out) const {
+    return mbedtls_ssl_get_session(&ssl, out) == 0;
+}
+
+bool TlsConnection::connected() {
+    if (rxPos < rxLen) return true;
+    if (closed || peerClosed) return false;
+    return client.connected() || client.available() > 0 || mbedtls_ssl_get_bytes_avail(&ssl) > 0;
+}
+
+int TlsConnection::available() {
+    if (rxPos < rxLen) return static_cast<int>(rxLen - rxPos);
+    if (closed || peerClosed) return 0;
+
+    const int n = mbedtls_ssl_read(&ssl, rx, sizeof(rx));
+    if (n > 0) {
+        rxPos = 0;
+        rxLen = static_cast<size_t>(n);
+        return n;
+    }
+    if (n != MBEDTLS_ERR_SSL_WANT_READ && n != MBEDTLS_ERR_SSL_WANT_WRITE) peerClosed = true;   // close_notify / 오류
+    return 0;
+}
+
+int TlsConnection::read() {
+    if (available() <= 0) return -1;
+    return rx[rxPos++];
+}
+
+size_t TlsConnection::write(const uint8_t* data, size_t length) {
+    if (closed) return 0;
+    size_t written = 0;
+    while (written < length) {
+        const int n = mbedtls_ssl_write(&ssl, data + written, length - written);
+        if (n > 0) {
+            written += static_cast<size_t>(n);
+        } else if (n != MBEDTLS_ERR_SSL_WANT_READ && n != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            break;
+        }
+    }
+    return written;
+}
+
+void TlsConnection::stop() {
+    if (closed) return;
+    closed = true;
+    if (ready && !peerClosed) mbedtls_ssl_close_notify(&ssl);
+    client.stop();
+}
+
+int TlsConnection::sendBio(void* ctx, const unsigned char* buf, size_t len) {
+    const size_t n = static_cast<WiFiClient*>(ctx)->write(buf, len);
+    return n > 0 ? static_cast<int>(n) : MBEDTLS_ERR_NET_SEND_FAILED;
+}
+
+// 받은 바이트가 없으면 WANT_READ로 돌려 호출한 쪽(핸드셰이크 루프 / available)이 다시 부르게 한다
+int TlsConnection::recvBio(void* ctx, unsigned char* buf, size_t len) {
+    WiFiClient* socket = static_cast<WiFiClient*>(ctx);
+    if (socket->available() <= 0) return socket->connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    const int n = socket->read(buf, len);
+    return n > 0 ? n : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+// ========== WiFiTransport: TLS =============================================================================
+bool WiFiTransport::setTrustAnchor(const String& caPem, bool allowUnverified) {
+    if (tlsReady) return true;
+    lock = xSemaphoreCreateMutex();
+    for (Session& s : sessions) mbedtls_ssl_session_init(&s.data);
+
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&drbg);
+    mbedtls_x509_crt_init(&ca);
+    mbedtls_ssl_config_init(&conf);
+
+    static const char personalization[] = "tracego-tls";
+    if (mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy,
+                              reinterpret_cast<const unsigned char*>(personalization), sizeof(personalization) - 1) != 0 ||
+        mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+        return false;
+    }
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    // PEM은 끝의 '\0'까지 길이에 넣어야 파싱된다. 읽을 수 없는 CA는 검증 없이 넘어가지 않고 TLS를 닫아 둔다
+    if (caPem.length() > 0) {
+        if (mbedtls_x509_crt_parse(&ca, reinterpret_cast<const unsigned char*>(caPem.c_str()), caPem.length() + 1) != 0) {
+            return false;
+        }
+        mbedtls_ssl_conf_ca_chain(&conf, &ca, nullptr);
+        mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    } else if (allowUnverified) {
+        mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_NONE);
+    } else {
+        return false;
+    }
+    tlsReady = true;
+    return true;
+}
+
+std::unique_ptr<TcpConnection> WiFiTransport::connectSecure(const char* host, uint16_t port) {
+    if (!tlsReady) return nullptr;
+    IPAddress address;
+    if (!hal::dns().lookup(host, address)) return nullptr;
+
+    const uint32_t startedAt = ::millis();
+    WiFiClient client;
+    if (!client.connect(address, port)) return nullptr;
+    std::unique_ptr<TlsConnection> tls(new TlsConnection(client, &conf, host));
+
+    // 기억해 둔 세션을 제시한다. mbedtls_ssl_set_session이 복사해 가므로 잠금은 복사하는 동안만 잡는다
+    mbedtls_ssl_session offered;
+    mbedtls_ssl_session_init(&offered);
+    bool resuming = false;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int slot = findSession(host, port);
+    if (slot >= 0 && sessions[slot].valid && ::millis() - sessions[slot].savedAt < TLS_SESSION_MAX_AGE_MS &&
+        tls->offerSession(&sessions[slot].data)) {
+        memcpy(offered.MBEDTLS_PRIVATE(master), sessions[slot].data.MBEDTLS_PRIVATE(master),
+               sizeof(offered.MBEDTLS_PRIVATE(master)));
+        resuming = true;
+    }
+    xSemaphoreGive(lock);
+
+    const bool ok = tls->handshake(TLS_HANDSHAKE_TIMEOUT_MS);   // 전체 핸드셰이크는 ESP32에서 1초 가까이 걸린다
+
+    if (!ok) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        ++stats.failures;
+        if (slot >= 0) sessions[slot].valid = false;   // 제시한 세션이 문제였을 수 있으므로 다음엔 전체 핸드셰이크
+        xSemaphoreGive(lock);
+        mbedtls_ssl_session_free(&offered);
+        return nullptr;
+    }
+
+    mbedtls_ssl_session fresh;
+    mbedtls_ssl_session_init(&fresh);
+    const bool exported = tls->exportSession(&fresh);
+    const bool wasResumed = resuming && exported && sameMaster(fresh, offered);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    stats.record(wasResumed, ::millis() - startedAt);
+    if (exported) {
+        const int target = slot >= 0 ? slot : victimSession();
+        Session& s = sessions[target];
+        mbedtls_ssl_session_free(&s.data);
+        s.data = fresh;                                // 소유권 이동 (fresh는 아래에서 해제하지 않음)
+        s.host = host;
+        s.port = port;
+        if (!wasResumed) s.savedAt = ::millis();       // 재개한 세션은 처음 만든 시각 기준으로 나이를 센다
+        s.valid = true;
+    }
+    xSemaphoreGive(lock);
+    if (!exported) mbedtls_ssl_session_free(&fresh);
+    mbedtls_ssl_session_free(&offered);
+    return std::unique_ptr<TcpConnection>(tls.release());
+}
+
+TlsStats WiFiTransport::tlsStats() const {
+    if (!tlsReady) return TlsStats();
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const TlsStats s = stats;
+    xSemaphoreGive(lock);
+    return s;
+}
+
+int WiFiTransport::findSession(const char* host, uint16_t port) const {
+    for (int i = 0; i < TLS_SESSION_SLOTS; ++i) {
+        if (sessions[i].port == port && sessions[i].host == host) return i;
+    }
+    return -1;
+}
+
+// 빈 슬롯, 없으면 가장 오래된 세션
+int WiFiTransport::victimSession() const {
+    int victim = 0;
+    for (int i = 0; i < TLS_SESSION_SLOTS; ++i) {
+        if (!sessions[i].valid && sessions[i].port == 0) return i;
+        if (::millis() - sessions[i].savedAt > ::millis() - sessions[victim].savedAt) victim = i;
+    }
+    return victim;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,60 @@
+#include "BackgroundTask.h"
+
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#else
+  #include <vector>
+#endif
+
+namespace {
+
+struct BackgroundTask {
+    const char* name;
+    std::function<void()> step;
+    uint32_t periodMs;
+    uint32_t lastRunMs;
+};
+
+#if defined(ESP32)
+void taskEntry(void* arg) {
+    BackgroundTask* task = static_cast<BackgroundTask*>(arg);
+    for (;;) {
+        task->step();
+        vTaskDelay(pdMS_TO_TICKS(task->periodMs ? task->periodMs : 1));
+    }
+}
+#else
+std::vector<BackgroundTask>& tasks() {
+    static std::vector<BackgroundTask> list;
+    return list;
+}
+#endif
+
+} // namespace
+
+void hal::startBackgroundTask(const char* name, std::function<void()> step, uint32_t periodMs,
+                              uint8_t priority, uint32_t stackSize) {
+#if defined(ESP32)
+    // 태스크 수명 동안 유지되어야 하므로 해제하지 않는다
+    BackgroundTask* task = new BackgroundTask{name, step, periodMs, 0};
+    xTaskCreate(taskEntry, name, stackSize, task, priority, nullptr);
+#else
+    (void)priority;
+    (void)stackSize;
+    tasks().push_back({name, step, periodMs, static_cast<uint32_t>(millis())});
+#endif
+}
+
+void hal::serviceBackgroundTasks() {
+#if !defined(ESP32)
+    // step 실행 중 새 작업이 등록될 수 있으므로 인덱스로 순회한다
+    for (size_t i = 0; i < tasks().size(); ++i) {
+        const uint32_t now = millis();
+        if (now - tasks()[i].lastRunMs < tasks()[i].periodMs) continue;
+        tasks()[i].lastRunMs = now;
+        std::function<void()> step = tasks()[i].step;
+        step();
+    }
+#endif
+}
@@ -0,0 +1,24 @@
+// BackgroundTask.h
+#ifndef HAL_BACKGROUNDTASK_H
+#define HAL_BACKGROUNDTASK_H
+
+#include <Arduino.h>
+#include <functional>
+
+namespace hal {
+
+/**
+ * 주기적으로 step을 실행하는 백그라운드 작업을 등록한다.
+ * - ESP32: 지정한 우선순위의 FreeRTOS 태스크에서 step → vTaskDelay(period) 를 반복
+ * - 호스트: serviceBackgroundTasks() 호출 시 주기가 된 step을 차례로 실행 (협조 방식)
+ * step 하나는 짧게 끝나야 하며, 긴 작업은 여러 번의 step으로 나눈다.
+ */
+void startBackgroundTask(const char* name, std::function<void()> step, uint32_t periodMs,
+                         uint8_t priority = 1, uint32_t stackSize = 4096);
+
+// 호스트 빌드에서 등록된 작업을 실행한다. ESP32에서는 아무 동작도 하지 않는다.
+void serviceBackgroundTasks();
+
+} // namespace hal
+
+#endif // HAL_BACKGROUNDTASK_H
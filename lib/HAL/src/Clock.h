@@ -0,0 +1,30 @@
+// Clock.h
+#ifndef HAL_CLOCK_H
+#define HAL_CLOCK_H
+
+#include <Arduino.h>
+
+/**
+ * 시간원 인터페이스
+ * - 타임아웃/대기 로직이 직접 millis()/delay()를 부르지 않고 주입된 Clock을 사용한다.
+ */
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    virtual uint32_t millis() = 0;
+    virtual uint32_t micros() = 0;
+    virtual void delay(uint32_t ms) = 0;
+};
+
+/**
+ * 플랫폼 기본 시간원 (ESP32: 하드웨어 타이머, 호스트: NativeCore 시간원)
+ */
+class SystemClock : public Clock {
+public:
+    uint32_t millis() override { return ::millis(); }
+    uint32_t micros() override { return ::micros(); }
+    void delay(uint32_t ms) override { ::delay(ms); }
+};
+
+#endif // HAL_CLOCK_H
@@ -0,0 +1,23 @@
+// DatagramSocket.h
+#ifndef HAL_DATAGRAMSOCKET_H
+#define HAL_DATAGRAMSOCKET_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+/**
+ * 수신 포트에 묶인 UDP 소켓 (WiFiUDP에 대응)
+ * - receive()는 기다리지 않는다. 받은 데이터그램이 없으면 0, size보다 큰 데이터그램은 잘라서 버린다 (-1).
+ * - send()는 보낸 곳(주소 / 포트)으로 답할 때 쓴다. 전달 여부는 알 수 없다 (UDP).
+ */
+class DatagramSocket {
+public:
+    virtual ~DatagramSocket() = default;
+
+    virtual bool begin(uint16_t port) = 0;
+    virtual void stop() = 0;
+    virtual int receive(uint8_t* buffer, size_t size, IPAddress& from, uint16_t& fromPort) = 0;
+    virtual bool send(const IPAddress& to, uint16_t port, const uint8_t* data, size_t length) = 0;
+};
+
+#endif // HAL_DATAGRAMSOCKET_H
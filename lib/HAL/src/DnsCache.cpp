@@ -0,0 +1,195 @@
+#include "DnsCache.h"
+#include "BackgroundTask.h"
+
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+#endif
+
+namespace {
+
+#if defined(ESP32)
+portMUX_TYPE cacheMux = portMUX_INITIALIZER_UNLOCKED;
+  #define CACHE_LOCK()   portENTER_CRITICAL(&cacheMux)
+  #define CACHE_UNLOCK() portEXIT_CRITICAL(&cacheMux)
+#else
+  #define CACHE_LOCK()   noInterrupts()
+  #define CACHE_UNLOCK() interrupts()
+#endif
+
+uint32_t clampTtlMs(uint32_t ttlSec) {
+    if (ttlSec == 0) ttlSec = DNS_DEFAULT_TTL_SEC;
+    if (ttlSec < DNS_MIN_TTL_SEC) ttlSec = DNS_MIN_TTL_SEC;
+    if (ttlSec > DNS_MAX_TTL_SEC) ttlSec = DNS_MAX_TTL_SEC;
+    return ttlSec * 1000;
+}
+
+} // namespace
+
+DnsCache::DnsCache(HostResolver& resolver, Clock& clock) : resolver(resolver), clock(&clock) {}
+
+void DnsCache::begin() {
+    hal::startBackgroundTask("dns-refresh", [this]() { step(); }, 1000, 1, 4096);
+}
+
+// ========== 조회 ==========================================================================================
+bool DnsCache::lookup(const char* host, IPAddress& address) {
+    if (parseNumeric(host, address)) return true;
+    if (strlen(host) >= DNS_HOST_MAX) {
+        uint32_t ttlMs;
+        return query(host, address, ttlMs);
+    }
+
+    const uint32_t now = clock->millis();
+    IPAddress stale;
+    bool haveStale = false;
+
+    CACHE_LOCK();
+    ++counters.lookups;
+    const int index = find(host);
+    if (index >= 0) {
+        Entry& e = entries[index];
+        e.lastUsed = now;
+        const uint32_t age = now - e.resolvedAt;
+        haveStale = age - e.ttlMs < DNS_STALE_SEC * 1000UL;
+        // TTL 안이면 그대로, 만료됐어도 최근 질의가 실패했으면 다시 기다리지 않고 이전 주소 (재질의는 백그라운드가 맡음)
+        if (age < e.ttlMs || (haveStale && static_cast<int32_t>(now - e.retryAt) < 0)) {
+            address = e.address;
+            if (age < e.ttlMs) ++counters.hits; else ++counters.staleServed;
+            CACHE_UNLOCK();
+            return true;
+        }
+        stale = e.address;
+    }
+    ++counters.misses;
+    CACHE_UNLOCK();
+
+    uint32_t ttlMs;
+    if (query(host, address, ttlMs)) {
+        CACHE_LOCK();
+        store(host, address, ttlMs, clock->millis());
+        CACHE_UNLOCK();
+        return true;
+    }
+
+    CACHE_LOCK();
+    const int failed = find(host);
+    if (failed >= 0) entries[failed].retryAt = clock->millis() + DNS_RETRY_MS;
+    if (haveStale) {
+        ++counters.staleServed;
+        address = stale;
+    } else {
+        ++counters.failures;
+    }
+    CACHE_UNLOCK();
+    return haveStale;
+}
+
+void DnsCache::prefetch(const char* host) {
+    IPAddress ignored;
+    lookup(host, ignored);
+}
+
+DnsStats DnsCache::stats() const {
+    CACHE_LOCK();
+    DnsStats s = counters;
+    s.entries = 0;
+    for (const Entry& e : entries) {
+        if (e.host[0]) ++s.entries;
+    }
+    CACHE_UNLOCK();
+    return s;
+}
+
+// ========== 백그라운드 갱신 ================================================================================
+// TTL의 마지막 구간에 들어섰거나 만료 후 이전 주소로 버티는 중인 항목 중, 최근에 쓴 것만 다시 질의한다 (한 번에 하나)
+void DnsCache::step() {
+    const uint32_t now = clock->millis();
+    char host[DNS_HOST_MAX] = "";
+
+    CACHE_LOCK();
+    for (Entry& e : entries) {
+        if (!e.host[0] || static_cast<int32_t>(now - e.retryAt) < 0) continue;
+        const uint32_t age = now - e.resolvedAt;
+        const uint32_t refreshAt = e.ttlMs - e.ttlMs / 100 * DNS_REFRESH_AHEAD_PCT;
+        const bool recentlyUsed = now - e.lastUsed < e.ttlMs;
+        const bool usable = age < e.ttlMs || age - e.ttlMs < DNS_STALE_SEC * 1000UL;
+        if (age >= refreshAt && usable && recentlyUsed) {
+            memcpy(host, e.host, sizeof(host));
+            e.retryAt = now + DNS_RETRY_MS;     // 질의하는 동안 같은 항목을 다시 고르지 않도록
+            break;
+        }
+    }
+    CACHE_UNLOCK();
+    if (!host[0]) return;
+
+    IPAddress address;
+    uint32_t ttlMs;
+    const bool ok = query(host, address, ttlMs);
+
+    CACHE_LOCK();
+    if (ok) {
+        store(host, address, ttlMs, clock->millis());
+        ++counters.refreshes;
+    } else {
+        ++counters.refreshFailures;
+    }
+    CACHE_UNLOCK();
+}
+
+// ========== 내부 ==========================================================================================
+bool DnsCache::query(const char* host, IPAddress& address, uint32_t& ttlMs) {
+    uint32_t ttlSec = 0;
+    if (!resolver.resolve(host, address, ttlSec)) return false;
+    ttlMs = clampTtlMs(ttlSec);
+    return true;
+}
+
+// 임계 구역 안에서 호출한다
+void DnsCache::store(const char* host, const IPAddress& address, uint32_t ttlMs, uint32_t now) {
+    int index = find(host);
+    if (index < 0) {
+        index = 0;
+        for (int i = 0; i < DNS_CACHE_SIZE; ++i) {
+            if (!entries[i].host[0]) { index = i; break; }
+            if (now - entries[i].lastUsed > now - entries[index].lastUsed) index = i;
+        }
+        strncpy(entries[index].host, host, DNS_HOST_MAX - 1);
+        entries[index].host[DNS_HOST_MAX - 1] = '\0';
+        entries[index].lastUsed = now;
+    }
+
+    Entry& e = entries[index];
+    e.address = address;
+    e.resolvedAt = now;
+    e.ttlMs = ttlMs;
+    e.retryAt = now;
+}
+
+int DnsCache::find(const char* host) const {
+    for (int i = 0; i < DNS_CACHE_SIZE; ++i) {
+        if (entries[i].host[0] && strcmp(entries[i].host, host) == 0) return i;
+    }
+    return -1;
+}
+
+// "a.b.c.d" 형식이면 질의 없이 바로 변환한다
+bool DnsCache::parseNumeric(const char* host, IPAddress& address) {
+    uint32_t octets[4] = {0, 0, 0, 0};
+    int part = 0;
+    int digits = 0;
+    for (const char* p = host; ; ++p) {
+        if (*p >= '0' && *p <= '9') {
+            octets[part] = octets[part] * 10 + (*p - '0');
+            if (++digits > 3 || octets[part] > 255) return false;
+        } else if ((*p == '.' || *p == '\0') && digits > 0) {
+            if (*p == '\0') break;
+            if (++part > 3) return false;
+            digits = 0;
+        } else {
+            return false;
+        }
+    }
+    if (part != 3) return false;
+    address = IPAddress(octets[0], octets[1], octets[2], octets[3]);
+    return true;
+}
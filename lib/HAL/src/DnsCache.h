@@ -0,0 +1,70 @@
+// DnsCache.h
+#ifndef HAL_DNSCACHE_H
+#define HAL_DNSCACHE_H
+
+#include <Arduino.h>
+#include "Clock.h"
+#include "HostResolver.h"
+
+#define DNS_CACHE_SIZE          4       // 기억할 호스트 수 (가득 차면 가장 오래 안 쓴 항목을 밀어냄)
+#define DNS_HOST_MAX            64      // 호스트 이름 최대 길이 (넘으면 캐시하지 않고 매번 질의)
+#define DNS_MIN_TTL_SEC         10      // 응답 TTL을 이 범위로 자른다 (TTL 0 / 모름 → DNS_DEFAULT_TTL_SEC)
+#define DNS_MAX_TTL_SEC         3600
+#define DNS_DEFAULT_TTL_SEC     300
+#define DNS_REFRESH_AHEAD_PCT   20      // TTL의 마지막 20%에 들어서면 백그라운드에서 미리 다시 질의
+#define DNS_STALE_SEC           3600    // 다시 질의가 실패하면 만료 후 이 시간까지는 이전 주소를 계속 씀
+#define DNS_RETRY_MS            5000    // 백그라운드 재질의 실패 후 다음 시도까지
+
+struct DnsStats {
+    uint32_t lookups = 0;             // 이름으로 들어온 조회 (숫자 주소 제외)
+    uint32_t hits = 0;                // 질의 없이 캐시에서 답함
+    uint32_t misses = 0;              // 처음 보거나 만료되어 호출한 쪽에서 질의
+    uint32_t refreshes = 0;           // 만료 전에 백그라운드에서 다시 질의해 갱신
+    uint32_t refreshFailures = 0;
+    uint32_t staleServed = 0;         // 질의 실패로 만료된 주소를 대신 씀
+    uint32_t failures = 0;            // 주소를 주지 못한 조회
+    uint8_t entries = 0;
+
+    uint32_t hitPct() const { return lookups ? (hits + staleServed) * 100 / lookups : 0; }
+};
+
+/**
+ * TTL을 지키는 DNS 결과 캐시 (TcpTransport 구현이 연결 직전에 사용)
+ * - 캐시에 있고 TTL 안이면 질의 없이 주소를 돌려준다.
+ * - TTL의 마지막 구간에 들어선 항목은 백그라운드 태스크가 미리 다시 질의하므로, 자주 쓰는 호스트는 호출한 쪽이 기다리지 않는다.
+ * - 만료 후 질의가 실패하면 DNS_STALE_SEC까지 이전 주소를 쓴다 (stale-while-revalidate).
+ * 여러 태스크에서 부르므로 항목은 짧은 임계 구역에서만 읽고 쓴다. 질의(네트워크)는 임계 구역 밖에서 한다.
+ */
+class DnsCache {
+public:
+    DnsCache(HostResolver& resolver, Clock& clock);
+
+    void begin();                                       // 백그라운드 갱신 태스크 시작
+    bool lookup(const char* host, IPAddress& address);  // 숫자 주소는 그대로 변환
+    void prefetch(const char* host);                    // 처음 쓰기 전에 미리 채워 둔다
+    DnsStats stats() const;
+
+    static bool parseNumeric(const char* host, IPAddress& address);
+
+private:
+    struct Entry {
+        char host[DNS_HOST_MAX] = "";
+        IPAddress address;
+        uint32_t resolvedAt = 0;
+        uint32_t ttlMs = 0;
+        uint32_t lastUsed = 0;
+        uint32_t retryAt = 0;           // 백그라운드 재질의 실패 후 다음 시도 시각
+    };
+
+    void step();                                        // 백그라운드 태스크 본문: 만료가 다가온 항목 하나를 다시 질의
+    bool query(const char* host, IPAddress& address, uint32_t& ttlMs);
+    void store(const char* host, const IPAddress& address, uint32_t ttlMs, uint32_t now);
+    int find(const char* host) const;
+
+    HostResolver& resolver;
+    Clock* clock;
+    Entry entries[DNS_CACHE_SIZE];
+    DnsStats counters;
+};
+
+#endif // HAL_DNSCACHE_H
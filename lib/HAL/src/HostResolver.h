@@ -0,0 +1,20 @@
+// HostResolver.h
+#ifndef HAL_HOSTRESOLVER_H
+#define HAL_HOSTRESOLVER_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+/**
+ * 호스트 이름 → IPv4 주소 질의 인터페이스
+ * - 캐시 없이 매번 DNS 서버에 묻는다 (캐시는 DnsCache가 맡음).
+ * - ttlSec에는 응답 레코드의 TTL을 돌려준다. 알 수 없으면 0.
+ */
+class HostResolver {
+public:
+    virtual ~HostResolver() = default;
+
+    virtual bool resolve(const char* host, IPAddress& address, uint32_t& ttlSec) = 0;
+};
+
+#endif // HAL_HOSTRESOLVER_H
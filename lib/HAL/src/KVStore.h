@@ -0,0 +1,35 @@
+// KVStore.h
+#ifndef HAL_KVSTORE_H
+#define HAL_KVSTORE_H
+
+#include <Arduino.h>
+
+/**
+ * 비휘발성 키-값 저장소 인터페이스
+ * - ESP32 Preferences와 같은 begin/end 네임스페이스 방식을 따른다.
+ */
+class KVStore {
+public:
+    virtual ~KVStore() = default;
+
+    virtual bool begin(const char* name, bool readOnly = false) = 0;
+    virtual void end() = 0;
+    virtual bool clear() = 0;
+    virtual bool remove(const char* key) = 0;
+    virtual bool isKey(const char* key) = 0;
+
+    virtual String getString(const char* key, const String& defaultValue = String()) = 0;
+    virtual size_t putString(const char* key, const String& value) = 0;
+
+    virtual int32_t getInt(const char* key, int32_t defaultValue = 0) = 0;
+    virtual size_t putInt(const char* key, int32_t value) = 0;
+
+    virtual bool getBool(const char* key, bool defaultValue = false) = 0;
+    virtual size_t putBool(const char* key, bool value) = 0;
+
+    virtual size_t getBytesLength(const char* key) = 0;
+    virtual size_t getBytes(const char* key, void* buffer, size_t maxLength) = 0;
+    virtual size_t putBytes(const char* key, const void* value, size_t length) = 0;
+};
+
+#endif // HAL_KVSTORE_H
@@ -0,0 +1,192 @@
+// NativeDevices.h
+#ifndef HAL_NATIVEDEVICES_H
+#define HAL_NATIVEDEVICES_H
+
+#if !defined(ARDUINO)
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "DatagramSocket.h"
+#include "HostResolver.h"
+#include "KVStore.h"
+#include "SerialPort.h"
+#include "TcpTransport.h"
+
+/**
+ * 메모리 기반 가짜 시리얼 포트
+ * - 코어가 쓴 바이트는 줄 단위로 onLine 콜백에 전달된다 (가짜 바퀴 보드가 응답 생성).
+ * - inject()로 넣은 바이트는 지정한 시각(µs) 이후에만 읽힌다 (ACK 지연 모델링).
+ */
+class FakeSerialPort : public SerialPort {
+public:
+    void begin(unsigned long baudRate) override { baud = baudRate; }
+    int available() override;
+    int read() override;
+    size_t write(const uint8_t* data, size_t length) override;
+    void flush() override {}
+
+    void inject(const String& data, uint64_t readyAtMicros = 0);
+    void onLine(std::function<void(const String& line)> handler) { lineHandler = handler; }
+
+private:
+    struct PendingByte {
+        uint64_t readyAt;
+        uint8_t value;
+    };
+
+    unsigned long baud = 0;
+    std::deque<PendingByte> rx;
+    String txLine;
+    std::function<void(const String&)> lineHandler = nullptr;
+};
+
+/**
+ * 메모리 기반 가짜 UDP 소켓
+ * - inject()로 넣은 데이터그램은 지정한 시각(µs) 이후에만 받는다. begin() 전에 넣은 것은 버린다 (받는 포트 없음).
+ * - 코어가 send()한 데이터그램은 onSend 콜백으로 바로 전달된다 (보낸 쪽이 ACK를 받음).
+ */
+struct FakeDatagram {
+    std::string data;
+    IPAddress peer;           // 받은 데이터그램이면 보낸 곳, 보낸 데이터그램이면 받는 곳
+    uint16_t port = 0;
+    uint64_t readyAt = 0;
+};
+
+class FakeDatagramSocket : public DatagramSocket {
+public:
+    bool begin(uint16_t port) override { boundPort = port; return port != 0; }
+    void stop() override { boundPort = 0; rx.clear(); }
+    int receive(uint8_t* buffer, size_t size, IPAddress& from, uint16_t& fromPort) override;
+    bool send(const IPAddress& to, uint16_t port, const uint8_t* data, size_t length) override;
+
+    bool inject(const uint8_t* data, size_t length, const IPAddress& from, uint16_t fromPort, uint64_t readyAtMicros = 0);
+    void onSend(std::function<void(const FakeDatagram& datagram)> handler) { sendHandler = handler; }
+    uint16_t port() const { return boundPort; }
+
+private:
+    uint16_t boundPort = 0;
+    std::deque<FakeDatagram> rx;
+    std::function<void(const FakeDatagram&)> sendHandler = nullptr;
+};
+
+/**
+ * 메모리 기반 키-값 저장소 (Preferences 대체)
+ */
+class MemoryKVStore : public KVStore {
+public:
+    bool begin(const char* name, bool readOnly = false) override;
+    void end() override { ns.clear(); }
+    bool clear() override;
+    bool remove(const char* key) override;
+    bool isKey(const char* key) override;
+
+    String getString(const char* key, const String& defaultValue = String()) override;
+    size_t putString(const char* key, const String& value) override;
+
+    int32_t getInt(const char* key, int32_t defaultValue = 0) override;
+    size_t putInt(const char* key, int32_t value) override;
+
+    bool getBool(const char* key, bool defaultValue = false) override;
+    size_t putBool(const char* key, bool value) override;
+
+    size_t getBytesLength(const char* key) override;
+    size_t getBytes(const char* key, void* buffer, size_t maxLength) override;
+    size_t putBytes(const char* key, const void* value, size_t length) override;
+
+private:
+    const std::string* find(const char* key);
+    size_t store(const char* key, const std::string& value);
+
+    std::map<std::string, std::map<std::string, std::string>> data;
+    std::string ns;
+    bool readOnly = false;
+};
+
+/**
+ * 프로세스 내부 가짜 서버로 연결되는 TcpTransport
+ * - registerEndpoint()로 host:port 마다 요청 → 응답 함수를 등록한다.
+ * - 요청이 완성되면(헤더 + Content-Length 본문) 핸들러를 호출하고,
+ *   응답은 latencyMs 이후부터 읽을 수 있다. 응답을 다 읽으면 서버가 연결을 닫는다.
+ *   keepAliveMs가 있으면 연결을 열어 두고 같은 연결로 다음 요청을 받는다 (그 시간 동안 요청이 없으면 닫음).
+ * - connectMs(TCP 연결 왕복)와 tls(핸드셰이크 왕복 + 계산 시간, 서버 쪽 세션 수명)만큼 가상 시간을 보낸 뒤 연결을 돌려준다.
+ */
+struct LoopbackReply {
+    String data;              // 원시 HTTP 응답 (상태줄 + 헤더 + 본문)
+    uint32_t latencyMs = 0;   // 응답 지연
+    bool drop = false;        // true면 응답 없이 연결을 끊는다
+    uint32_t keepAliveMs = 0; // 0이 아니면 응답 뒤에도 연결을 유지하는 시간 (서버의 keep-alive 타임아웃)
+};
+
+// 핸드셰이크 왕복 수 (TLS 1.2). 호스트의 mbedTLS 2.28 클라이언트를 코어와 같은 순서로 openssl s_server에 붙여 잰 값:
+// 전체는 ClientHello → 인증서 / ClientKeyExchange → Finished로 2번(약 2.8 KB), 티켓 / 세션 ID 재개는 1번(약 0.7 KB)
+#define LOOPBACK_TLS_FULL_ROUND_TRIPS     2
+#define LOOPBACK_TLS_RESUMED_ROUND_TRIPS  1
+
+// 가짜 TLS 서버 (모든 엔드포인트 공통). 핸드셰이크 = 왕복 수 × connectMs + 계산 시간
+struct LoopbackTls {
+    uint32_t fullCpuMs = 0;           // 전체 핸드셰이크의 계산 시간 (인증서 검증 + ECDHE, 왕복 제외)
+    uint32_t resumedCpuMs = 0;        // 세션 재개의 계산 시간 (공개키 연산 없이 대칭키만)
+    uint32_t sessionLifetimeSec = 300;// 서버가 세션 ID / 티켓을 받아 주는 시간 (발급 시각 기준, 0 = 재개 안 함)
+};
+
+/**
+ * 가짜 DNS 서버
+ * - 모든 이름을 127.0.0.1로 답한다. ttlSec / latencyMs(가상 시간) / failing으로 응답을 조절한다.
+ * - LoopbackTransport는 연결 전에 hal::dns()로 이름을 풀므로, 질의 수(queries)로 캐시 효과를 볼 수 있다.
+ */
+class FakeResolver : public HostResolver {
+public:
+    bool resolve(const char* host, IPAddress& address, uint32_t& ttlSec) override;
+
+    uint32_t ttlSec = 300;
+    uint32_t latencyMs = 0;
+    bool failing = false;
+    uint32_t queries = 0;
+};
+
+class LoopbackTransport : public TcpTransport {
+public:
+    using Handler = std::function<LoopbackReply(const String& request)>;
+
+    std::unique_ptr<TcpConnection> connect(const char* host, uint16_t port) override;
+    std::unique_ptr<TcpConnection> connectSecure(const char* host, uint16_t port) override;
+    bool setTrustAnchor(const String& caPem, bool allowUnverified) override;
+    TlsStats tlsStats() const override { return stats; }
+
+    void registerEndpoint(const String& host, uint16_t port, Handler handler);
+    void removeEndpoint(const String& host, uint16_t port);
+
+    uint32_t connectMs = 0;           // TCP 연결 한 번에 걸리는 시간 (가상 시간)
+    LoopbackTls tls;
+    uint32_t connects = 0;            // 새로 연 연결 수 (TLS 포함)
+
+private:
+    std::map<std::string, Handler> endpoints;
+    std::map<std::string, uint64_t> sessions;   // host:port → 세션 발급 시각 (µs)
+    String trustAnchor;
+    bool tlsReady = false;            // setTrustAnchor()가 받아들임 (아니면 connectSecure()는 nullptr)
+    TlsStats stats;
+};
+
+/**
+ * 호스트 빌드에서 사용하는 가짜 장치 모음 (시뮬레이터/벤치마크가 직접 조작)
+ */
+struct NativeFakes {
+    FakeSerialPort wheel;
+    MemoryKVStore settings;
+    MemoryKVStore journal;
+    LoopbackTransport transport;
+    FakeResolver resolver;
+    FakeDatagramSocket motion;
+};
+
+namespace hal {
+NativeFakes& fakes();
+}
+
+#endif // !ARDUINO
+
+#endif // HAL_NATIVEDEVICES_H
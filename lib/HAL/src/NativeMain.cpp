@@ -0,0 +1,34 @@
+#if !defined(ARDUINO) && !defined(NATIVE_CUSTOM_MAIN)
+
+#include <cstdlib>
+#include <cstring>
+
+#include "BackgroundTask.h"
+#include "NativeDevices.h"
+
+/**
+ * 호스트 빌드 진입점: setup() 후 loop()를 반복한다.
+ * 사용법: program [--loops N]   (N 생략 시 무한 반복)
+ */
+int main(int argc, char** argv) {
+    long maxLoops = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) maxLoops = atol(argv[++i]);
+    }
+
+    // 저장된 Wi-Fi 설정이 없으면 설정 모드(SoftAP)로 빠지므로 호스트용 기본값을 넣어둔다
+    KVStore& settings = hal::fakes().settings;
+    settings.begin("settings", false);
+    if (!settings.isKey("ssid")) settings.putString("ssid", "native");
+    settings.end();
+
+    setup();
+    for (long i = 0; maxLoops < 0 || i < maxLoops; ++i) {
+        loop();
+        hal::serviceBackgroundTasks();
+    }
+    hal::serviceBackgroundTasks();
+    return 0;
+}
+
+#endif // !ARDUINO && !NATIVE_CUSTOM_MAIN
@@ -0,0 +1,394 @@
+#if !defined(ARDUINO)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "NativeDevices.h"
+#include "Platform.h"
+#include "WebServer.h"
+
+namespace {
+
+std::string endpointKey(const String& host, uint16_t port) {
+    return std::string(host.c_str()) + ":" + std::to_string(port);
+}
+
+/**
+ * LoopbackTransport가 돌려주는 연결
+ */
+class LoopbackConnection : public TcpConnection {
+public:
+    explicit LoopbackConnection(LoopbackTransport::Handler handler) : handler(handler) {}
+
+    bool connected() override {
+        if (closed) return false;
+        poll();
+        if (!replied) return native::nowMicros() < idleUntil || idleUntil == 0;
+        // 응답을 모두 읽기 전까지는 연결 유지 (Connection: close 동작)
+        return readPos < reply.data.length() || native::nowMicros() < readyAt;
+    }
+
+    int available() override {
+        poll();
+        if (!replied || reply.drop || native::nowMicros() < readyAt) return 0;
+        return static_cast<int>(reply.data.length() - readPos);
+    }
+
+    int read() override {
+        if (available() <= 0) return -1;
+        const uint8_t value = static_cast<uint8_t>(reply.data[readPos++]);
+        if (readPos == reply.data.length() && reply.keepAliveMs > 0) {
+            // keep-alive: 다음 요청을 기다린다 (그 사이 요청이 없으면 서버가 닫음)
+            idleUntil = native::nowMicros() + static_cast<uint64_t>(reply.keepAliveMs) * 1000;
+            request = String();
+            reply = LoopbackReply();
+            readPos = 0;
+            replied = false;
+        }
+        return value;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        if (closed || replied) return 0;
+        if (idleUntil != 0 && native::nowMicros() >= idleUntil) {
+            closed = true;            // 서버가 이미 닫은 keep-alive 연결
+            return 0;
+        }
+        request.concat(reinterpret_cast<const char*>(data), length);
+        return length;
+    }
+
+    void stop() override { closed = true; }
+
+private:
+    // 요청이 완성되었으면 핸들러를 호출한다
+    void poll() {
+        if (replied) return;
+        int headerEnd = request.indexOf("\r\n\r\n");
+        if (headerEnd == -1) return;
+
+        size_t contentLength = 0;
+        String lower = request.substring(0, headerEnd);
+        lower.toLowerCase();
+        int cl = lower.indexOf("content-length:");
+        if (cl != -1) contentLength = static_cast<size_t>(lower.substring(cl + 15).toInt());
+        if (request.length() < headerEnd + 4 + contentLength) return;
+
+        reply = handler(request);
+        readyAt = native::nowMicros() + static_cast<uint64_t>(reply.latencyMs) * 1000;
+        replied = true;
+        idleUntil = 0;
+        if (reply.drop) reply.data = String();
+    }
+
+    LoopbackTransport::Handler handler;
+    String request;
+    LoopbackReply reply;
+    uint64_t readyAt = 0;
+    uint64_t idleUntil = 0;           // keep-alive로 다음 요청을 기다리는 중이면 서버가 닫는 시각
+    size_t readPos = 0;
+    bool replied = false;
+    bool closed = false;
+};
+
+/**
+ * 내장 서버 핸들러가 떼어 간 응답 연결 (hal::adoptClient)
+ * - 쓴 바이트는 WebServer::ClientStream에 쌓이고, 요청을 넣은 쪽(시뮬레이터)이 응답의 stream으로 읽는다.
+ * - 받는 쪽이 stream의 input에 넣은 바이트는 read()로 읽힌다 (WebSocket 프레임).
+ */
+class StreamConnection : public TcpConnection {
+public:
+    explicit StreamConnection(std::shared_ptr<WebServer::ClientStream> stream) : stream(stream) {}
+
+    bool connected() override { return !stream->serverClosed && !stream->clientClosed; }
+    int available() override {
+        if (stream->inputPos >= stream->input.length()) {
+            stream->input = String();             // 다 읽었으면 비워 둔다 (받는 쪽이 계속 덧붙임)
+            stream->inputPos = 0;
+            return 0;
+        }
+        return static_cast<int>(stream->input.length() - stream->inputPos);
+    }
+
+    int read() override {
+        if (available() <= 0) return -1;
+        return static_cast<uint8_t>(stream->input[stream->inputPos++]);
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        if (!connected()) return 0;
+        stream->data.concat(reinterpret_cast<const char*>(data), length);
+        return length;
+    }
+
+    // 받는 쪽이 읽지 않아 보내기 버퍼(sendBuffer)가 찼으면 들어갈 만큼만
+    size_t tryWrite(const uint8_t* data, size_t length) override {
+        if (!connected()) return 0;
+        if (stream->sendBuffer > 0) {
+            const size_t queued = stream->data.length();
+            const size_t room = queued < stream->sendBuffer ? stream->sendBuffer - queued : 0;
+            if (length > room) length = room;
+        }
+        stream->data.concat(reinterpret_cast<const char*>(data), length);
+        return length;
+    }
+
+    void stop() override { stream->serverClosed = true; }
+
+private:
+    std::shared_ptr<WebServer::ClientStream> stream;
+};
+
+} // namespace
+
+// ========== FakeSerialPort =================================================================================
+int FakeSerialPort::available() {
+    const uint64_t now = native::nowMicros();
+    int count = 0;
+    for (const auto& b : rx) {
+        if (b.readyAt > now) break;
+        ++count;
+    }
+    return count;
+}
+
+int FakeSerialPort::read() {
+    if (rx.empty() || rx.front().readyAt > native::nowMicros()) return -1;
+    uint8_t value = rx.front().value;
+    rx.pop_front();
+    return value;
+}
+
+size_t FakeSerialPort::write(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        const char c = static_cast<char>(data[i]);
+        if (c == '\n') {
+            String line = txLine;
+            line.trim();
+            txLine = String();
+            if (lineHandler) lineHandler(line);
+        } else {
+            txLine += c;
+        }
+    }
+    return length;
+}
+
+void FakeSerialPort::inject(const String& data, uint64_t readyAtMicros) {
+    // 도착 시각 순서를 유지한다 (먼저 보낸 바이트가 먼저 도착)
+    if (!rx.empty() && rx.back().readyAt > readyAtMicros) readyAtMicros = rx.back().readyAt;
+    for (size_t i = 0; i < data.length(); ++i) {
+        rx.push_back({readyAtMicros, static_cast<uint8_t>(data[i])});
+    }
+}
+
+// ========== FakeDatagramSocket =============================================================================
+int FakeDatagramSocket::receive(uint8_t* buffer, size_t size, IPAddress& from, uint16_t& fromPort) {
+    if (rx.empty() || rx.front().readyAt > native::nowMicros()) return 0;
+    const FakeDatagram datagram = rx.front();
+    rx.pop_front();
+    from = datagram.peer;
+    fromPort = datagram.port;
+    if (datagram.data.size() > size) return -1;
+    memcpy(buffer, datagram.data.data(), datagram.data.size());
+    return static_cast<int>(datagram.data.size());
+}
+
+bool FakeDatagramSocket::send(const IPAddress& to, uint16_t port, const uint8_t* data, size_t length) {
+    if (boundPort == 0) return false;
+    if (sendHandler) sendHandler({std::string(reinterpret_cast<const char*>(data), length), to, port, native::nowMicros()});
+    return true;
+}
+
+bool FakeDatagramSocket::inject(const uint8_t* data, size_t length, const IPAddress& from, uint16_t fromPort, uint64_t readyAtMicros) {
+    if (boundPort == 0) return false;
+    // 도착 시각 순서를 유지한다 (같은 경로로 보낸 데이터그램은 순서대로 도착한다고 본다)
+    if (!rx.empty() && rx.back().readyAt > readyAtMicros) readyAtMicros = rx.back().readyAt;
+    rx.push_back({std::string(reinterpret_cast<const char*>(data), length), from, fromPort, readyAtMicros});
+    return true;
+}
+
+// ========== MemoryKVStore ==================================================================================
+bool MemoryKVStore::begin(const char* name, bool ro) {
+    ns = name ? name : "";
+    readOnly = ro;
+    return true;
+}
+
+bool MemoryKVStore::clear() {
+    if (readOnly) return false;
+    data[ns].clear();
+    return true;
+}
+
+bool MemoryKVStore::remove(const char* key) {
+    if (readOnly) return false;
+    return data[ns].erase(key) > 0;
+}
+
+bool MemoryKVStore::isKey(const char* key) {
+    return find(key) != nullptr;
+}
+
+const std::string* MemoryKVStore::find(const char* key) {
+    auto nsIt = data.find(ns);
+    if (nsIt == data.end()) return nullptr;
+    auto it = nsIt->second.find(key);
+    return it == nsIt->second.end() ? nullptr : &it->second;
+}
+
+size_t MemoryKVStore::store(const char* key, const std::string& value) {
+    if (readOnly) return 0;
+    data[ns][key] = value;
+    return value.size();
+}
+
+String MemoryKVStore::getString(const char* key, const String& defaultValue) {
+    const std::string* v = find(key);
+    return v ? String(*v) : defaultValue;
+}
+
+size_t MemoryKVStore::putString(const char* key, const String& value) {
+    return store(key, value.str());
+}
+
+int32_t MemoryKVStore::getInt(const char* key, int32_t defaultValue) {
+    const std::string* v = find(key);
+    return v ? static_cast<int32_t>(strtol(v->c_str(), nullptr, 10)) : defaultValue;
+}
+
+size_t MemoryKVStore::putInt(const char* key, int32_t value) {
+    return store(key, std::to_string(value)) ? sizeof(value) : 0;
+}
+
+bool MemoryKVStore::getBool(const char* key, bool defaultValue) {
+    const std::string* v = find(key);
+    return v ? *v == "1" : defaultValue;
+}
+
+size_t MemoryKVStore::putBool(const char* key, bool value) {
+    return store(key, value ? "1" : "0");
+}
+
+size_t MemoryKVStore::getBytesLength(const char* key) {
+    const std::string* v = find(key);
+    return v ? v->size() : 0;
+}
+
+size_t MemoryKVStore::getBytes(const char* key, void* buffer, size_t maxLength) {
+    const std::string* v = find(key);
+    if (!v || v->size() > maxLength) return 0;
+    memcpy(buffer, v->data(), v->size());
+    return v->size();
+}
+
+size_t MemoryKVStore::putBytes(const char* key, const void* value, size_t length) {
+    return store(key, std::string(static_cast<const char*>(value), length));
+}
+
+// ========== LoopbackTransport ==============================================================================
+std::unique_ptr<TcpConnection> LoopbackTransport::connect(const char* host, uint16_t port) {
+    IPAddress address;
+    if (!hal::dns().lookup(host, address)) return nullptr;   // 이름을 못 풀면 연결 실패 (ESP32와 같은 경로)
+
+    auto it = endpoints.find(endpointKey(host, port));
+    if (it == endpoints.end()) return nullptr;
+    if (connectMs > 0) native::advanceMicros(static_cast<uint64_t>(connectMs) * 1000);
+    ++connects;
+    return std::unique_ptr<TcpConnection>(new LoopbackConnection(it->second));
+}
+
+// 인증서를 파싱하지는 않으므로 PEM 머리만 확인한다 (ESP32와 같이 읽을 수 없는 CA / 허용 없는 빈 CA는 닫힌 채로)
+bool LoopbackTransport::setTrustAnchor(const String& caPem, bool allowUnverified) {
+    trustAnchor = caPem;
+    tlsReady = caPem.isEmpty() ? allowUnverified : caPem.indexOf("-----BEGIN CERTIFICATE-----") >= 0;
+    return tlsReady;
+}
+
+// 세션을 기억하고 있고 서버 쪽 수명 안이면 재개, 아니면 전체 핸드셰이크 (ESP32 구현과 같은 판단을 가상 시간으로)
+std::unique_ptr<TcpConnection> LoopbackTransport::connectSecure(const char* host, uint16_t port) {
+    if (!tlsReady) return nullptr;
+    const uint64_t startedAt = native::nowMicros();
+    std::unique_ptr<TcpConnection> connection = connect(host, port);
+    if (!connection) return nullptr;
+
+    const std::string key = endpointKey(host, port);
+    const uint64_t now = native::nowMicros();
+    auto session = sessions.find(key);
+    const bool offered = session != sessions.end() && now - session->second < TLS_SESSION_MAX_AGE_MS * 1000ULL;
+    const bool resumed = offered && now - session->second < tls.sessionLifetimeSec * 1000000ULL;
+
+    const uint32_t handshakeMs = resumed ? LOOPBACK_TLS_RESUMED_ROUND_TRIPS * connectMs + tls.resumedCpuMs
+                                         : LOOPBACK_TLS_FULL_ROUND_TRIPS * connectMs + tls.fullCpuMs;
+    if (handshakeMs > 0) native::advanceMicros(static_cast<uint64_t>(handshakeMs) * 1000);
+    if (!resumed) sessions[key] = native::nowMicros();
+    stats.record(resumed, static_cast<uint32_t>((native::nowMicros() - startedAt) / 1000));
+    return connection;
+}
+
+void LoopbackTransport::registerEndpoint(const String& host, uint16_t port, Handler handler) {
+    endpoints[endpointKey(host, port)] = handler;
+}
+
+void LoopbackTransport::removeEndpoint(const String& host, uint16_t port) {
+    endpoints.erase(endpointKey(host, port));
+}
+
+// ========== FakeResolver ===================================================================================
+bool FakeResolver::resolve(const char*, IPAddress& address, uint32_t& ttl) {
+    ++queries;
+    if (latencyMs > 0) native::advanceMicros(static_cast<uint64_t>(latencyMs) * 1000);
+    if (failing) return false;
+    address = IPAddress(127, 0, 0, 1);
+    ttl = ttlSec;
+    return true;
+}
+
+// ========== 플랫폼 인스턴스 ================================================================================
+NativeFakes& hal::fakes() {
+    static NativeFakes instance;
+    return instance;
+}
+
+Clock& hal::clock() {
+    static SystemClock instance;
+    return instance;
+}
+
+KVStore& hal::settings() {
+    return fakes().settings;
+}
+
+KVStore& hal::journal() {
+    return fakes().journal;
+}
+
+TcpTransport& hal::transport() {
+    return fakes().transport;
+}
+
+DnsCache& hal::dns() {
+    static DnsCache instance(fakes().resolver, clock());
+    return instance;
+}
+
+SerialPort& hal::wheelSerial(int, int) {
+    return fakes().wheel;
+}
+
+DatagramSocket& hal::motionSocket() {
+    return fakes().motion;
+}
+
+std::unique_ptr<TcpConnection> hal::adoptClient(WebServer& server) {
+    return std::unique_ptr<TcpConnection>(new StreamConnection(server.detachClient()));
+}
+
+void hal::restart() {
+    Serial.println("[HAL] 재시작 요청 → 호스트 프로세스 종료");
+    Serial.flush();
+    exit(0);
+}
+
+#endif // !ARDUINO
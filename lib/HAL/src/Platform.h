@@ -0,0 +1,34 @@
+// Platform.h
+#ifndef HAL_PLATFORM_H
+#define HAL_PLATFORM_H
+
+#include "Clock.h"
+#include "DatagramSocket.h"
+#include "DnsCache.h"
+#include "KVStore.h"
+#include "SerialPort.h"
+#include "TcpTransport.h"
+
+class WebServer;
+
+/**
+ * 플랫폼별 장치 인스턴스 제공
+ * - ESP32: HardwareSerial / Preferences / WiFiClient 기반 구현
+ * - 호스트(native): 메모리 기반 가짜 장치 (NativeDevices.h)
+ * 각 클래스는 이 인터페이스를 생성자 또는 begin()으로 주입받는다.
+ */
+namespace hal {
+
+Clock& clock();
+KVStore& settings();
+KVStore& journal();                              // 백그라운드 태스크용 저장소 (settings()와 같은 NVS, 별도 핸들, 태스크끼리 begin~end 직렬화)
+TcpTransport& transport();
+DnsCache& dns();                                 // 아웃바운드 연결이 쓰는 호스트 이름 캐시 (begin()으로 백그라운드 갱신 시작)
+SerialPort& wheelSerial(int rxPin, int txPin);   // 바퀴 보드와 연결된 UART (Serial2)
+DatagramSocket& motionSocket();                  // 모션 명령 데이터그램을 받는 UDP 소켓 (MotionListener가 begin)
+std::unique_ptr<TcpConnection> adoptClient(WebServer& server);   // 처리 중인 요청의 연결을 넘겨받음 (핸들러는 send()하지 않음)
+void restart();                                  // 장치 재시작
+
+} // namespace hal
+
+#endif // HAL_PLATFORM_H
@@ -0,0 +1,28 @@
+// SerialPort.h
+#ifndef HAL_SERIALPORT_H
+#define HAL_SERIALPORT_H
+
+#include <Arduino.h>
+
+/**
+ * 바이트 단위 시리얼 포트 인터페이스 (보드 간 유선 통신용)
+ */
+class SerialPort {
+public:
+    virtual ~SerialPort() = default;
+
+    virtual void begin(unsigned long baudRate) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+    virtual void flush() = 0;
+
+    size_t print(const String& text) {
+        return write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length());
+    }
+    size_t println(const String& text) {
+        return print(text) + write(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+    }
+};
+
+#endif // HAL_SERIALPORT_H
@@ -0,0 +1,71 @@
+// TcpTransport.h
+#ifndef HAL_TCPTRANSPORT_H
+#define HAL_TCPTRANSPORT_H
+
+#include <Arduino.h>
+#include <memory>
+
+/**
+ * 하나의 TCP 연결 (WiFiClient에 대응)
+ */
+class TcpConnection {
+public:
+    virtual ~TcpConnection() = default;
+
+    virtual bool connected() = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+    virtual void stop() = 0;
+
+    // 기다리지 않는 쓰기: 보내기 버퍼에 들어간 만큼만 쓰고 바로 돌아온다 (0일 수 있음).
+    // write()는 상대가 받지 않으면 타임아웃까지 막히므로, loop에서 오래 붙잡아 두는 연결(SSE)은 이것으로 쓴다
+    virtual size_t tryWrite(const uint8_t* data, size_t length) { return write(data, length); }
+
+    size_t print(const String& text) {
+        return write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length());
+    }
+};
+
+#define TLS_SESSION_SLOTS        4          // 세션을 기억해 둘 서버(host:port) 수
+#define TLS_SESSION_MAX_AGE_MS   3600000UL  // 이보다 오래된 세션은 재개를 시도하지 않음 (서버가 먼저 거절하면 전체 핸드셰이크)
+#define TLS_HANDSHAKE_TIMEOUT_MS 5000
+
+// TLS 핸드셰이크 통계 (/status 용)
+struct TlsStats {
+    uint32_t handshakes = 0;          // 전체 핸드셰이크 (인증서 검증 + 키 교환)
+    uint32_t resumed = 0;             // 세션 재개 (세션 ID / 티켓)
+    uint32_t failures = 0;
+    uint32_t fullMsTotal = 0;
+    uint32_t resumedMsTotal = 0;
+    uint32_t lastMs = 0;
+
+    void record(bool wasResumed, uint32_t ms) {
+        if (wasResumed) { ++resumed; resumedMsTotal += ms; } else { ++handshakes; fullMsTotal += ms; }
+        lastMs = ms;
+    }
+    uint32_t fullAvgMs() const { return handshakes ? fullMsTotal / handshakes : 0; }
+    uint32_t resumedAvgMs() const { return resumed ? resumedMsTotal / resumed : 0; }
+    uint32_t resumePct() const { return handshakes + resumed ? resumed * 100 / (handshakes + resumed) : 0; }
+};
+
+/**
+ * 아웃바운드 TCP 연결 생성기
+ * - 연결 실패 시 nullptr을 반환한다.
+ * - connectSecure()는 TLS 핸드셰이크까지 마친 연결을 돌려준다. 서버마다 마지막 세션을 기억해 두었다가
+ *   다음 연결에서 재개를 요청하므로, 두 번째 연결부터는 인증서 검증과 키 교환을 건너뛴다.
+ */
+class TcpTransport {
+public:
+    virtual ~TcpTransport() = default;
+
+    virtual std::unique_ptr<TcpConnection> connect(const char* host, uint16_t port) = 0;
+    virtual std::unique_ptr<TcpConnection> connectSecure(const char* host, uint16_t port) = 0;
+
+    // 서버 인증서를 검증할 CA (PEM, setup에서 한 번). 실패하면 닫힌 채로 둔다: CA를 읽을 수 없거나, 비어 있는데
+    // allowUnverified(검증 없이 암호화만 하겠다는 명시적 설정)가 아니면 false를 돌려주고 connectSecure()는 nullptr
+    virtual bool setTrustAnchor(const String& caPem, bool allowUnverified) = 0;
+    virtual TlsStats tlsStats() const = 0;
+};
+
+#endif // HAL_TCPTRANSPORT_H
@@ -0,0 +1,289 @@
+#include "MotionListener.h"
+#include "TraceLog.h"
+
+namespace {
+
+const uint8_t MAGIC_0 = 'T';
+const uint8_t MAGIC_1 = 'G';
+const uint8_t VERSION = 1;
+const uint8_t ACK_BIT = 0x80;
+const size_t HEADER_SIZE = 12;        // 마법 2 + 버전 + 종류 + epoch + seq
+const size_t ACK_BODY_SIZE = 16;      // 머리 + 상태 + 0 + 경과ms
+
+void putWord(uint8_t* p, uint32_t value) {
+    p[0] = value >> 24; p[1] = value >> 16; p[2] = value >> 8; p[3] = value;
+}
+
+uint32_t getWord(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (p[2] << 8) | p[3];
+}
+
+void putMac(uint8_t* p, uint64_t mac) {
+    for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(mac >> (8 * i));
+}
+
+// 걸리는 시간이 어디서 틀렸는지에 따라 달라지지 않도록 끝까지 비교한다
+bool macMatches(const uint8_t* p, uint64_t mac) {
+    uint8_t diff = 0;
+    for (int i = 0; i < 8; ++i) diff |= p[i] ^ static_cast<uint8_t>(mac >> (8 * i));
+    return diff == 0;
+}
+
+void writeHeader(uint8_t* out, uint8_t type, uint32_t epoch, uint32_t seq) {
+    out[0] = MAGIC_0;
+    out[1] = MAGIC_1;
+    out[2] = VERSION;
+    out[3] = type;
+    putWord(out + 4, epoch);
+    putWord(out + 8, seq);
+}
+
+uint64_t rotl(uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+
+uint64_t load64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | p[i];
+    return value;
+}
+
+void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+    v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+}
+
+} // namespace
+
+MotionListener::MotionListener(DatagramSocket& socket, Clock& clock, KVStore& store)
+    : socket(&socket), clock(&clock), store(&store) {}
+
+// ========== 시작 ===========================================================================================
+bool MotionListener::begin(uint16_t port, const String& keyHex) {
+    if (port == 0) return false;
+    if (!parseKey(keyHex, key)) {
+        LOG_WARN("[MotionListener][OFF] motion_key가 16진수 32자가 아니라 UDP 모션 명령을 받지 않습니다");
+        return false;
+    }
+    if (!socket->begin(port)) {
+        LOG_ERROR("[MotionListener][OFF] UDP {} 포트를 열지 못했습니다", static_cast<unsigned>(port));
+        return false;
+    }
+
+    store->begin("motion", true);
+    const bool known = store->isKey("epoch");
+    const uint32_t saved = static_cast<uint32_t>(store->getInt("epoch", 0));
+    store->end();
+    epochFloor = known ? saved + 1 : 0;
+
+    active = true;
+    counters.port = port;
+    LOG_INFO("[MotionListener][1/1] UDP {} 포트에서 모션 명령 대기 (epoch {} 이상)", static_cast<unsigned>(port),
+             static_cast<unsigned>(epochFloor));
+    return true;
+}
+
+// ========== 수신 ===========================================================================================
+void MotionListener::poll() {
+    if (!active) return;
+    uint8_t buffer[MOTION_ACK_SIZE];
+    for (int i = 0; i < MOTION_POLL_BATCH; ++i) {
+        IPAddress from;
+        uint16_t fromPort = 0;
+        const int length = socket->receive(buffer, sizeof(buffer), from, fromPort);
+        if (length == 0) return;
+        ++counters.received;
+        if (length < 0) {                                  // 버퍼보다 큰 데이터그램
+            ++counters.malformed;
+            continue;
+        }
+        handleDatagram(buffer, static_cast<size_t>(length), from, fromPort);
+    }
+}
+
+void MotionListener::handleDatagram(const uint8_t* data, size_t length, const IPAddress& from, uint16_t fromPort) {
+    if (length != MOTION_DATAGRAM_SIZE || data[0] != MAGIC_0 || data[1] != MAGIC_1 || data[2] != VERSION ||
+        (data[3] & ACK_BIT)) {
+        ++counters.malformed;
+        return;
+    }
+    if (!macMatches(data + HEADER_SIZE, siphash(key, data, HEADER_SIZE))) {
+        ++counters.badMac;
+        return;
+    }
+
+    MotionFrame ack;
+    ack.type = data[3];
+    ack.epoch = getWord(data + 4);
+    ack.seq = getWord(data + 8);
+    if (ack.seq == 0) {                                    // seq는 1부터 (0은 빈 ACK 칸)
+        ++counters.malformed;
+        return;
+    }
+
+    switch (admit(ack.epoch, ack.seq)) {
+    case DUPLICATE: {
+        ++counters.duplicates;
+        const MotionFrame* remembered = findAck(ack.epoch, ack.seq);
+        if (remembered) ack = *remembered;
+        else ack.status = MOTION_STALE;                    // 실행은 했지만 결과를 잊음
+        ack.status |= MOTION_DUPLICATE;
+        reply(from, fromPort, ack);
+        return;
+    }
+    case STALE:
+        ++counters.stale;
+        ack.status = MOTION_STALE;
+        reply(from, fromPort, ack);
+        return;
+    case FRESH:
+        break;
+    }
+
+    const uint32_t startedAt = clock->millis();
+    if (ack.type != MOTION_GO && ack.type != MOTION_STOP) {
+        ++counters.malformed;
+        ack.status = MOTION_UNSUPPORTED;
+    } else {
+        LOG_INFO("[MotionListener][UDP] {} 명령 수신 (epoch {}, seq {})", ack.type == MOTION_GO ? "GO" : "STOP",
+                 static_cast<unsigned>(ack.epoch), static_cast<unsigned>(ack.seq));
+        const bool ok = handler && handler(static_cast<MotionType>(ack.type));
+        ++counters.executed;
+        if (!ok) ++counters.failed;
+        ack.status = ok ? MOTION_ACKED : MOTION_NO_ACK;
+    }
+    const uint32_t elapsed = clock->millis() - startedAt;
+    ack.elapsedMs = elapsed > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(elapsed);
+    counters.lastMs = elapsed;
+    if (elapsed > counters.maxMs) counters.maxMs = elapsed;
+
+    acks[ackNext] = ack;
+    ackNext = (ackNext + 1) % MOTION_ACK_SLOTS;
+    reply(from, fromPort, ack);
+}
+
+// ========== 재전송 방지 ====================================================================================
+MotionListener::Verdict MotionListener::admit(uint32_t commandEpoch, uint32_t seq) {
+    if (!epochOpen || commandEpoch > epoch) {
+        if (commandEpoch < epochFloor) return STALE;
+        openEpoch(commandEpoch, seq);
+        return FRESH;
+    }
+    if (commandEpoch < epoch) return STALE;
+
+    if (seq > highestSeq) {
+        const uint32_t shift = seq - highestSeq;
+        window = shift >= MOTION_WINDOW ? 1 : (window << shift) | 1;
+        highestSeq = seq;
+        return FRESH;
+    }
+    const uint32_t behind = highestSeq - seq;
+    if (behind >= MOTION_WINDOW) return STALE;
+    const uint64_t bit = 1ULL << behind;
+    if (window & bit) return DUPLICATE;
+    window |= bit;                                         // 늦게 도착한 (순서가 뒤바뀐) seq
+    return FRESH;
+}
+
+// 새 epoch(보내는 쪽 재시작)은 드물게 오므로 올 때마다 저장해 둔다
+void MotionListener::openEpoch(uint32_t commandEpoch, uint32_t seq) {
+    epoch = commandEpoch;
+    epochOpen = true;
+    highestSeq = seq;
+    window = 1;
+    counters.epoch = commandEpoch;
+
+    store->begin("motion", false);
+    store->putInt("epoch", static_cast<int32_t>(commandEpoch));
+    store->end();
+    LOG_INFO("[MotionListener][EPOCH] 새 epoch {} (seq {}부터)", static_cast<unsigned>(commandEpoch),
+             static_cast<unsigned>(seq));
+}
+
+const MotionFrame* MotionListener::findAck(uint32_t commandEpoch, uint32_t seq) const {
+    for (const MotionFrame& ack : acks) {
+        if (ack.seq == seq && ack.epoch == commandEpoch) return &ack;
+    }
+    return nullptr;
+}
+
+void MotionListener::reply(const IPAddress& to, uint16_t port, const MotionFrame& ack) {
+    uint8_t out[MOTION_ACK_SIZE];
+    writeHeader(out, ACK_BIT | ack.type, ack.epoch, ack.seq);
+    out[12] = ack.status;
+    out[13] = 0;
+    out[14] = ack.elapsedMs >> 8;
+    out[15] = ack.elapsedMs & 0xFF;
+    putMac(out + ACK_BODY_SIZE, siphash(key, out, ACK_BODY_SIZE));
+    socket->send(to, port, out, sizeof(out));
+}
+
+MotionStats MotionListener::stats() const {
+    MotionStats s = counters;
+    s.enabled = active;
+    return s;
+}
+
+// ========== 인코딩 =========================================================================================
+bool MotionListener::parseKey(const String& hex, uint8_t out[MOTION_KEY_SIZE]) {
+    if (hex.length() != MOTION_KEY_SIZE * 2) return false;
+    for (size_t i = 0; i < MOTION_KEY_SIZE * 2; ++i) {
+        const char c = hex[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else return false;
+        if (i % 2 == 0) out[i / 2] = nibble << 4;
+        else out[i / 2] |= nibble;
+    }
+    return true;
+}
+
+size_t MotionListener::encodeCommand(const uint8_t commandKey[MOTION_KEY_SIZE], const MotionFrame& command, uint8_t* out) {
+    writeHeader(out, command.type, command.epoch, command.seq);
+    putMac(out + HEADER_SIZE, siphash(commandKey, out, HEADER_SIZE));
+    return MOTION_DATAGRAM_SIZE;
+}
+
+bool MotionListener::decodeAck(const uint8_t ackKey[MOTION_KEY_SIZE], const uint8_t* data, size_t length, MotionFrame& ack) {
+    if (length != MOTION_ACK_SIZE || data[0] != MAGIC_0 || data[1] != MAGIC_1 || data[2] != VERSION || !(data[3] & ACK_BIT)) {
+        return false;
+    }
+    if (!macMatches(data + ACK_BODY_SIZE, siphash(ackKey, data, ACK_BODY_SIZE))) return false;
+    ack.type = data[3] & ~ACK_BIT;
+    ack.epoch = getWord(data + 4);
+    ack.seq = getWord(data + 8);
+    ack.status = data[12];
+    ack.elapsedMs = (data[14] << 8) | data[15];
+    return true;
+}
+
+// SipHash-2-4 (64비트 출력). 짧은 메시지용 MAC이라 한 데이터그램에 1µs 남짓
+uint64_t MotionListener::siphash(const uint8_t macKey[MOTION_KEY_SIZE], const uint8_t* data, size_t length) {
+    const uint64_t k0 = load64(macKey);
+    const uint64_t k1 = load64(macKey + 8);
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    const size_t whole = length - length % 8;
+    for (size_t i = 0; i < whole; i += 8) {
+        const uint64_t m = load64(data + i);
+        v3 ^= m;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+    uint64_t last = static_cast<uint64_t>(length) << 56;
+    for (size_t i = whole; i < length; ++i) last |= static_cast<uint64_t>(data[i]) << (8 * (i - whole));
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; ++i) sipRound(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
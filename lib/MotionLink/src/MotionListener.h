@@ -0,0 +1,113 @@
+#ifndef MOTION_LISTENER_H
+#define MOTION_LISTENER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "Clock.h"
+#include "DatagramSocket.h"
+#include "KVStore.h"
+
+#define MOTION_DATAGRAM_SIZE   20       // 명령: 머리 12 + MAC 8
+#define MOTION_ACK_SIZE        24       // ACK: 머리 12 + 상태 4 + MAC 8
+#define MOTION_KEY_SIZE        16       // SipHash-2-4 키 (설정: motion_key = 16진수 32자)
+#define MOTION_WINDOW          64       // 같은 epoch 안에서 순서가 뒤바뀌어도 받아 주는 seq 범위
+#define MOTION_ACK_SLOTS       8        // 다시 온 seq에 실행 없이 답하려고 기억해 두는 최근 ACK 수
+#define MOTION_POLL_BATCH      4        // poll() 한 번에 처리하는 데이터그램 상한 (loop 한 바퀴를 붙잡지 않음)
+
+enum MotionType : uint8_t {
+    MOTION_GO   = 1,
+    MOTION_STOP = 2,
+};
+
+// ACK의 상태 바이트 (다시 온 seq에 기억해 둔 ACK로 답하면 MOTION_DUPLICATE가 더해짐)
+enum MotionStatus : uint8_t {
+    MOTION_ACKED       = 0,           // 바퀴 보드가 ACK
+    MOTION_NO_ACK      = 1,           // 바퀴 보드 ACK 없음 (재시도까지 실패)
+    MOTION_STALE       = 2,           // 지난 epoch / 창보다 오래된 seq → 실행하지 않음 (보내는 쪽은 epoch을 올려 다시 보냄)
+    MOTION_UNSUPPORTED = 3,           // 모르는 명령
+    MOTION_DUPLICATE   = 0x80,
+};
+
+// 명령 / ACK 한 개 (ACK만 status / elapsedMs를 씀)
+struct MotionFrame {
+    uint8_t type = 0;
+    uint32_t epoch = 0;
+    uint32_t seq = 0;
+    uint8_t status = 0;
+    uint16_t elapsedMs = 0;           // 데이터그램을 받은 뒤 → 바퀴 보드 응답까지
+};
+
+struct MotionStats {
+    bool enabled = false;
+    uint16_t port = 0;
+    uint32_t epoch = 0;               // 지금 받고 있는 epoch
+    uint32_t received = 0;            // 받은 데이터그램 (모두)
+    uint32_t executed = 0;            // 바퀴 보드로 보낸 명령
+    uint32_t failed = 0;              //   그중 ACK 없음
+    uint32_t duplicates = 0;          // 이미 실행한 seq라 기억해 둔 ACK로 답함
+    uint32_t stale = 0;               // 지난 epoch / 창 밖의 seq (재전송 공격 포함)
+    uint32_t badMac = 0;              // MAC이 맞지 않아 답 없이 버림
+    uint32_t malformed = 0;           // 길이 / 머리 / 명령이 잘못됨
+    uint32_t lastMs = 0;
+    uint32_t maxMs = 0;
+};
+
+/**
+ * UDP 모션 명령 수신기 (GO / STOP)
+ * - 중앙 서버가 20바이트 데이터그램 하나로 명령을 보내면 TCP 연결 / HTTP 파싱 없이 loop 한 바퀴 안에 바퀴 보드로 넘기고,
+ *   바퀴 보드 ACK 결과를 24바이트 ACK 데이터그램으로 보낸 곳에 돌려준다. 잃어버린 것은 보내는 쪽이 같은 seq로 다시 보낸다.
+ * - 명령: 'T' 'G' 버전 종류 | epoch(u32 BE) | seq(u32 BE) | MAC(SipHash-2-4, 앞 12바이트)
+ *   ACK:  'T' 'G' 버전 0x80|종류 | epoch | seq | 상태 0 경과ms(u16 BE) | MAC(앞 16바이트)
+ * - MAC이 맞지 않으면 답하지 않고 버린다 (키를 모르는 쪽에는 아무것도 알려 주지 않음).
+ * - 재전송 방지: epoch은 줄어들 수 없고, 같은 epoch 안에서는 가장 큰 seq 아래 MOTION_WINDOW개를 비트맵으로 기억한다.
+ *   이미 받은 seq는 실행하지 않고 기억해 둔 ACK로 답하며(멱등), 창 밖이면 MOTION_STALE로 답한다.
+ *   마지막 epoch은 저장해 두고 재부팅 후에는 그보다 큰 epoch만 받는다 (창이 비어 지난 seq를 다시 받지 않도록).
+ * loop에서만 쓴다 (handler가 바퀴 보드 ACK를 기다리는 동안 다음 데이터그램은 소켓에 남아 있음).
+ */
+class MotionListener {
+public:
+    using Handler = std::function<bool(MotionType type)>;   // 바퀴 보드 ACK를 받았으면 true
+
+    MotionListener(DatagramSocket& socket, Clock& clock, KVStore& store);
+
+    bool begin(uint16_t port, const String& keyHex);   // 포트가 0이거나 키가 잘못되면 false (꺼 둠)
+    void setHandler(const Handler& motionHandler) { handler = motionHandler; }
+    void poll();
+
+    bool enabled() const { return active; }
+    MotionStats stats() const;
+
+    // 보내는 쪽(중앙 서버 / 시뮬레이터 / 벤치마크)과 같은 인코딩
+    static bool parseKey(const String& hex, uint8_t key[MOTION_KEY_SIZE]);
+    static size_t encodeCommand(const uint8_t key[MOTION_KEY_SIZE], const MotionFrame& command, uint8_t* out);
+    static bool decodeAck(const uint8_t key[MOTION_KEY_SIZE], const uint8_t* data, size_t length, MotionFrame& ack);
+    static uint64_t siphash(const uint8_t key[MOTION_KEY_SIZE], const uint8_t* data, size_t length);
+
+private:
+    enum Verdict : uint8_t { FRESH, DUPLICATE, STALE };
+
+    void handleDatagram(const uint8_t* data, size_t length, const IPAddress& from, uint16_t fromPort);
+    Verdict admit(uint32_t epoch, uint32_t seq);
+    void openEpoch(uint32_t epoch, uint32_t seq);
+    void reply(const IPAddress& to, uint16_t port, const MotionFrame& ack);
+    const MotionFrame* findAck(uint32_t epoch, uint32_t seq) const;
+
+    DatagramSocket* socket;
+    Clock* clock;
+    KVStore* store;
+    Handler handler = nullptr;
+    uint8_t key[MOTION_KEY_SIZE] = {};
+    bool active = false;
+
+    uint32_t epochFloor = 0;          // 이보다 작은 epoch은 받지 않음 (부팅 후: 저장된 epoch + 1)
+    uint32_t epoch = 0;
+    bool epochOpen = false;
+    uint32_t highestSeq = 0;
+    uint64_t window = 0;              // 비트 i = (highestSeq - i)를 받음
+
+    MotionFrame acks[MOTION_ACK_SLOTS];
+    uint8_t ackNext = 0;
+    MotionStats counters;
+};
+
+#endif // MOTION_LISTENER_H
@@ -0,0 +1,140 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+
+namespace {
+
+bool virtualTime = false;
+uint64_t virtualNowUs = 0;
+uint32_t spinQuantumUs = 10;
+
+const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+std::mt19937 rng(0x7ace60);
+
+} // namespace
+
+// ========== 시간 ===========================================================================================
+void native::useVirtualTime(bool enabled) {
+    if (enabled && !virtualTime) virtualNowUs = nowMicros();
+    virtualTime = enabled;
+}
+
+bool native::isVirtualTime() {
+    return virtualTime;
+}
+
+void native::setSpinQuantumMicros(uint32_t us) {
+    spinQuantumUs = us;
+}
+
+uint64_t native::nowMicros() {
+    if (virtualTime) return virtualNowUs;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count());
+}
+
+void native::advanceMicros(uint64_t us) {
+    if (virtualTime) {
+        virtualNowUs += us;
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+unsigned long millis() {
+    if (virtualTime) virtualNowUs += spinQuantumUs;
+    return static_cast<unsigned long>(static_cast<uint32_t>(native::nowMicros() / 1000));
+}
+
+unsigned long micros() {
+    if (virtualTime) virtualNowUs += spinQuantumUs;
+    return static_cast<unsigned long>(static_cast<uint32_t>(native::nowMicros()));
+}
+
+void delay(uint32_t ms) {
+    native::advanceMicros(static_cast<uint64_t>(ms) * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    native::advanceMicros(us);
+}
+
+void yield() {}
+
+// ========== 난수 ===========================================================================================
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return static_cast<long>(rng() % static_cast<unsigned long>(howbig));
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    rng.seed(static_cast<uint32_t>(seed));
+}
+
+// ========== Print / Stream =================================================================================
+size_t Print::printf(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    return write(buffer, static_cast<size_t>(len) < sizeof(buffer) ? static_cast<size_t>(len) : sizeof(buffer) - 1);
+}
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String out;
+    int c = timedRead();
+    while (c >= 0 && c != terminator) {
+        out += static_cast<char>(c);
+        c = timedRead();
+    }
+    return out;
+}
+
+String Stream::readString() {
+    String out;
+    int c = timedRead();
+    while (c >= 0) {
+        out += static_cast<char>(c);
+        c = timedRead();
+    }
+    return out;
+}
+
+// ========== 표준 출력 시리얼 ===============================================================================
+void HardwareSerial::begin(unsigned long, uint32_t, int8_t, int8_t) {}
+
+size_t HardwareSerial::write(uint8_t c) {
+    fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
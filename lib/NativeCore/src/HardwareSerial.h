@@ -0,0 +1,29 @@
+// HardwareSerial.h (native)
+#ifndef NATIVE_HARDWARESERIAL_H
+#define NATIVE_HARDWARESERIAL_H
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+/**
+ * 호스트의 표준 출력에 연결된 시리얼 포트 (입력은 없음)
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_HARDWARESERIAL_H
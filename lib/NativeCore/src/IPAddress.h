@@ -0,0 +1,25 @@
+// IPAddress.h (native)
+#ifndef NATIVE_IPADDRESS_H
+#define NATIVE_IPADDRESS_H
+
+#include <cstring>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return octets[index]; }
+    bool operator==(const IPAddress& other) const {
+        return memcmp(octets, other.octets, sizeof(octets)) == 0;
+    }
+    String toString() const {
+        return String(octets[0]) + "." + String(octets[1]) + "." + String(octets[2]) + "." + String(octets[3]);
+    }
+
+private:
+    uint8_t octets[4] = {0, 0, 0, 0};
+};
+
+#endif // NATIVE_IPADDRESS_H
@@ -0,0 +1,24 @@
+// NativeTime.h
+#ifndef NATIVE_TIME_H
+#define NATIVE_TIME_H
+
+#include <cstdint>
+
+/**
+ * 호스트 빌드의 시간원
+ * - 기본: 실제 단조 시계 (steady_clock)
+ * - 가상 시간 모드: delay()는 즉시 시간을 앞당기고, millis()/micros() 호출마다
+ *   spinQuantum 만큼 시간이 흐른다 (바쁜 대기 루프가 영원히 돌지 않도록).
+ */
+namespace native {
+
+void useVirtualTime(bool enabled);
+bool isVirtualTime();
+void setSpinQuantumMicros(uint32_t us);
+
+uint64_t nowMicros();                 // 부팅 후 경과 시간 (µs, 64비트)
+void advanceMicros(uint64_t us);      // 가상 시간 진행 (실시간 모드에서는 sleep)
+
+} // namespace native
+
+#endif // NATIVE_TIME_H
@@ -0,0 +1,46 @@
+// Print.h (native)
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "WString.h"
+
+/**
+ * Arduino Print 호환 기본 클래스 (호스트 빌드 전용)
+ * - 파생 클래스는 write(uint8_t)만 구현하면 된다.
+ */
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write(reinterpret_cast<const uint8_t*>(buffer), size); }
+    virtual void flush() {}
+
+    size_t print(const String& s)                 { return write(s.c_str(), s.length()); }
+    size_t print(const char* s)                   { return write(s); }
+    size_t print(char c)                          { return write(static_cast<uint8_t>(c)); }
+    size_t print(int n, int base = DEC)           { return print(String(n, static_cast<unsigned char>(base))); }
+    size_t print(unsigned int n, int base = DEC)  { return print(String(n, static_cast<unsigned char>(base))); }
+    size_t print(long n, int base = DEC)          { return print(String(n, static_cast<unsigned char>(base))); }
+    size_t print(unsigned long n, int base = DEC) { return print(String(n, static_cast<unsigned char>(base))); }
+    size_t print(double n, int digits = 2)        { return print(String(n, static_cast<unsigned int>(digits))); }
+
+    size_t println()                              { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value)                { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format)    { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#endif // NATIVE_PRINT_H
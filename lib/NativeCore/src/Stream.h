@@ -0,0 +1,25 @@
+// Stream.h (native)
+#ifndef NATIVE_STREAM_H
+#define NATIVE_STREAM_H
+
+#include "Print.h"
+
+/**
+ * Arduino Stream 호환 클래스 (호스트 빌드 전용)
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+    String readStringUntil(char terminator);
+    String readString();
+
+protected:
+    int timedRead();
+    unsigned long timeout = 1000;
+};
+
+#endif // NATIVE_STREAM_H
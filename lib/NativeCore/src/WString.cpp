@@ -0,0 +1,172 @@
+#include "WString.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::string toBase(unsigned long value, unsigned char base) {
+    if (base < 2 || base > 16) base = DEC;
+    if (value == 0) return "0";
+    char digits[sizeof(unsigned long) * 8 + 1];
+    int pos = 0;
+    while (value > 0) {
+        digits[pos++] = "0123456789abcdef"[value % base];
+        value /= base;
+    }
+    std::string out;
+    while (pos > 0) out += digits[--pos];
+    return out;
+}
+
+std::string toFixed(double value, unsigned int decimalPlaces) {
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%.*f", static_cast<int>(decimalPlaces), value);
+    return tmp;
+}
+
+} // namespace
+
+// ========== 생성자 =========================================================================================
+String::String(const char* cstr) : buf(cstr ? cstr : "") {}
+String::String(const char* cstr, size_t length) : buf(cstr ? std::string(cstr, length) : std::string()) {}
+String::String(const std::string& str) : buf(str) {}
+String::String(char c) : buf(1, c) {}
+String::String(unsigned char value, unsigned char base) : buf(toBase(value, base)) {}
+String::String(unsigned int value, unsigned char base) : buf(toBase(value, base)) {}
+String::String(unsigned long value, unsigned char base) : buf(toBase(value, base)) {}
+String::String(float value, unsigned int decimalPlaces) : buf(toFixed(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : buf(toFixed(value, decimalPlaces)) {}
+
+String::String(int value, unsigned char base) {
+    if (value < 0 && base == DEC) buf = "-" + toBase(static_cast<unsigned long>(-static_cast<long>(value)), base);
+    else buf = toBase(static_cast<unsigned int>(value), base);
+}
+
+String::String(long value, unsigned char base) {
+    if (value < 0 && base == DEC) buf = "-" + toBase(0UL - static_cast<unsigned long>(value), base);
+    else buf = toBase(static_cast<unsigned long>(value), base);
+}
+
+String& String::operator=(const char* cstr) {
+    buf = cstr ? cstr : "";
+    return *this;
+}
+
+// ========== 연결 ===========================================================================================
+bool String::concat(const String& str)                 { buf += str.buf; return true; }
+bool String::concat(const char* cstr)                  { if (cstr) buf += cstr; return true; }
+bool String::concat(const char* cstr, size_t length)   { if (cstr) buf.append(cstr, length); return true; }
+bool String::concat(char c)                            { buf += c; return true; }
+bool String::concat(int value)                         { buf += String(value).buf; return true; }
+bool String::concat(unsigned int value)                { buf += String(value).buf; return true; }
+bool String::concat(long value)                        { buf += String(value).buf; return true; }
+bool String::concat(unsigned long value)               { buf += String(value).buf; return true; }
+bool String::concat(double value)                      { buf += String(value).buf; return true; }
+
+// ========== 비교 ===========================================================================================
+bool String::equalsIgnoreCase(const String& other) const {
+    if (buf.size() != other.buf.size()) return false;
+    for (size_t i = 0; i < buf.size(); ++i) {
+        if (tolower(static_cast<unsigned char>(buf[i])) != tolower(static_cast<unsigned char>(other.buf[i]))) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return buf.compare(0, prefix.buf.size(), prefix.buf) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return buf.size() >= suffix.buf.size() &&
+           buf.compare(buf.size() - suffix.buf.size(), suffix.buf.size(), suffix.buf) == 0;
+}
+
+// ========== 검색 ===========================================================================================
+int String::indexOf(char c, unsigned int fromIndex) const {
+    size_t pos = buf.find(c, fromIndex);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    size_t pos = buf.find(str.buf, fromIndex);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = buf.rfind(c);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int String::lastIndexOf(const String& str) const {
+    size_t pos = buf.rfind(str.buf);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, static_cast<unsigned int>(buf.size()));
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+    if (beginIndex >= buf.size()) return String();
+    if (endIndex > buf.size()) endIndex = static_cast<unsigned int>(buf.size());
+    return String(buf.substr(beginIndex, endIndex - beginIndex));
+}
+
+// ========== 수정 ===========================================================================================
+void String::replace(char find, char replace) {
+    std::replace(buf.begin(), buf.end(), find, replace);
+}
+
+void String::replace(const String& find, const String& replace) {
+    if (find.buf.empty()) return;
+    size_t pos = 0;
+    while ((pos = buf.find(find.buf, pos)) != std::string::npos) {
+        buf.replace(pos, find.buf.size(), replace.buf);
+        pos += replace.buf.size();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < buf.size()) buf.erase(index);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < buf.size()) buf.erase(index, count);
+}
+
+void String::toLowerCase() {
+    for (auto& c : buf) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+}
+
+void String::toUpperCase() {
+    for (auto& c : buf) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+}
+
+void String::trim() {
+    size_t begin = 0;
+    while (begin < buf.size() && isspace(static_cast<unsigned char>(buf[begin]))) ++begin;
+    size_t end = buf.size();
+    while (end > begin && isspace(static_cast<unsigned char>(buf[end - 1]))) --end;
+    buf = buf.substr(begin, end - begin);
+}
+
+// ========== 변환 ===========================================================================================
+long String::toInt() const     { return strtol(buf.c_str(), nullptr, 10); }
+float String::toFloat() const  { return strtof(buf.c_str(), nullptr); }
+double String::toDouble() const { return strtod(buf.c_str(), nullptr); }
+
+// ========== 연산자 =========================================================================================
+String operator+(const String& lhs, const String& rhs) { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, const char* rhs)   { String out(lhs); out.concat(rhs); return out; }
+String operator+(const char* lhs, const String& rhs)   { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, char rhs)          { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, int rhs)           { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, unsigned int rhs)  { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, long rhs)          { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, unsigned long rhs) { String out(lhs); out.concat(rhs); return out; }
+String operator+(const String& lhs, double rhs)        { String out(lhs); out.concat(rhs); return out; }
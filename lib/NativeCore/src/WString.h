@@ -0,0 +1,112 @@
+// WString.h (native)
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/**
+ * Arduino String 호환 클래스 (호스트 빌드 전용)
+ * - 코어/라이브러리에서 실제로 사용하는 API만 구현한다.
+ */
+class String {
+public:
+    String(const char* cstr = "");
+    String(const char* cstr, size_t length);
+    String(const std::string& str);
+    String(const String& other) = default;
+    String(String&& other) noexcept = default;
+    explicit String(char c);
+    explicit String(int value, unsigned char base = DEC);
+    explicit String(unsigned int value, unsigned char base = DEC);
+    explicit String(long value, unsigned char base = DEC);
+    explicit String(unsigned long value, unsigned char base = DEC);
+    explicit String(unsigned char value, unsigned char base = DEC);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    String& operator=(const String& other) = default;
+    String& operator=(String&& other) noexcept = default;
+    String& operator=(const char* cstr);
+
+    // 연결
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, size_t length);
+    bool concat(char c);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(double value);
+
+    template <typename T>
+    String& operator+=(const T& value) { concat(value); return *this; }
+
+    // 조회
+    const char* c_str() const { return buf.c_str(); }
+    size_t length() const { return buf.size(); }
+    bool isEmpty() const { return buf.empty(); }
+    bool reserve(size_t size) { buf.reserve(size); return true; }
+    char charAt(size_t index) const { return index < buf.size() ? buf[index] : 0; }
+    void setCharAt(size_t index, char c) { if (index < buf.size()) buf[index] = c; }
+    char operator[](size_t index) const { return charAt(index); }
+    char& operator[](size_t index) { return buf[index]; }
+
+    // 비교
+    bool equals(const String& other) const { return buf == other.buf; }
+    bool equals(const char* cstr) const { return buf == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& other) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& other) const { return buf < other.buf; }
+
+    // 검색
+    int indexOf(char c, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String& str) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    // 수정
+    void replace(char find, char replace);
+    void replace(const String& find, const String& replace);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    // 변환
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+    const std::string& str() const { return buf; }
+
+private:
+    std::string buf;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, double rhs);
+
+#endif // NATIVE_WSTRING_H
@@ -0,0 +1,154 @@
+#include "WebServer.h"
+
+#include <algorithm>
+
+#include "NativeTime.h"
+
+namespace {
+
+String urlDecode(const String& in) {
+    String out;
+    for (size_t i = 0; i < in.length(); ++i) {
+        char c = in[i];
+        if (c == '+') {
+            out += ' ';
+        } else if (c == '%' && i + 2 < in.length()) {
+            char hex[3] = { in[i + 1], in[i + 2], 0 };
+            out += static_cast<char>(strtol(hex, nullptr, 16));
+            i += 2;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void parseQuery(const String& query, std::vector<std::pair<String, String>>& args) {
+    int start = 0;
+    while (start < static_cast<int>(query.length())) {
+        int end = query.indexOf('&', start);
+        if (end == -1) end = query.length();
+        String pair = query.substring(start, end);
+        int eq = pair.indexOf('=');
+        if (eq == -1) args.emplace_back(urlDecode(pair), String());
+        else args.emplace_back(urlDecode(pair.substring(0, eq)), urlDecode(pair.substring(eq + 1)));
+        start = end + 1;
+    }
+}
+
+} // namespace
+
+WebServer::WebServer(int port) : port(port) {
+    instances().push_back(this);
+}
+
+WebServer::~WebServer() {
+    auto& list = instances();
+    list.erase(std::remove(list.begin(), list.end(), this), list.end());
+}
+
+std::vector<WebServer*>& WebServer::instances() {
+    static std::vector<WebServer*> list;
+    return list;
+}
+
+WebServer* WebServer::find(int port) {
+    for (WebServer* server : instances()) {
+        if (server->port == port) return server;
+    }
+    return nullptr;
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    routes.push_back({uri, method, fn});
+}
+
+void WebServer::handleClient() {
+    if (!started || queue.empty()) return;
+
+    PendingRequest req = queue.front();
+    queue.pop_front();
+    Response res = dispatch(req);
+    if (costModel) native::advanceMicros(costModel(req.uri, res.code));
+    if (req.onResponse) req.onResponse(res);
+}
+
+void WebServer::inject(HTTPMethod method, const String& uri, const String& body,
+                       const std::vector<std::pair<String, String>>& headers,
+                       std::function<void(const Response&)> onResponse) {
+    queue.push_back({method, uri, body, headers, onResponse});
+}
+
+WebServer::Response WebServer::request(HTTPMethod method, const String& uri, const String& body,
+                                       const std::vector<std::pair<String, String>>& headers) {
+    return dispatch({method, uri, body, headers, nullptr});
+}
+
+WebServer::Response WebServer::dispatch(const PendingRequest& req) {
+    currentMethod = req.method;
+    currentHeaders = req.headers;
+    currentArgs.clear();
+    pendingResponseHeaders.clear();
+    currentResponse = Response();
+
+    int q = req.uri.indexOf('?');
+    currentUri = q == -1 ? req.uri : req.uri.substring(0, q);
+    if (q != -1) parseQuery(req.uri.substring(q + 1), currentArgs);
+
+    String contentType = header("Content-Type");
+    if (contentType.startsWith("application/x-www-form-urlencoded")) parseQuery(req.body, currentArgs);
+    currentArgs.emplace_back("plain", req.body);
+
+    for (const auto& route : routes) {
+        if (route.uri == currentUri && (route.method == HTTP_ANY || route.method == req.method)) {
+            route.fn();
+            return currentResponse;
+        }
+    }
+
+    if (notFoundHandler) notFoundHandler();
+    else send(404, "text/plain", "Not found");
+    return currentResponse;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    currentResponse.code = code;
+    currentResponse.contentType = contentType ? contentType : "";
+    currentResponse.body = content;
+    currentResponse.headers = pendingResponseHeaders;
+    pendingResponseHeaders.clear();
+}
+
+std::shared_ptr<WebServer::ClientStream> WebServer::detachClient() {
+    currentResponse.stream = std::make_shared<ClientStream>();
+    return currentResponse.stream;
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength) {
+    send(code, contentType, String(content, contentLength));
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    if (first) pendingResponseHeaders.insert(pendingResponseHeaders.begin(), {name, value});
+    else pendingResponseHeaders.emplace_back(name, value);
+}
+
+String WebServer::arg(const String& name) const {
+    for (const auto& a : currentArgs) if (a.first == name) return a.second;
+    return String();
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const auto& a : currentArgs) if (a.first == name) return true;
+    return false;
+}
+
+String WebServer::header(const String& name) const {
+    for (const auto& h : currentHeaders) if (h.first.equalsIgnoreCase(name)) return h.second;
+    return String();
+}
+
+bool WebServer::hasHeader(const String& name) const {
+    for (const auto& h : currentHeaders) if (h.first.equalsIgnoreCase(name)) return true;
+    return false;
+}
@@ -0,0 +1,131 @@
+// WebServer.h (native)
+#ifndef NATIVE_WEBSERVER_H
+#define NATIVE_WEBSERVER_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+#include "WiFi.h"
+
+typedef enum {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+} HTTPMethod;
+
+/**
+ * 호스트 빌드용 WebServer 대체 구현
+ * - 소켓을 열지 않고, inject()로 넣은 요청을 handleClient()에서 하나씩 처리한다.
+ * - 라우팅/응답 API는 ESP32 WebServer와 같은 형태를 유지한다.
+ */
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    // 네이티브 전용: 핸들러가 응답 대신 떼어 간 연결 (SSE / WebSocket처럼 핸들러가 끝난 뒤에도 계속 쓰는 연결)
+    struct ClientStream {
+        String data;                  // 서버가 쓴 바이트 (받는 쪽이 읽고 비운다)
+        String input;                 // 받는 쪽이 보낸 바이트 (서버가 read()로 소비)
+        size_t inputPos = 0;
+        bool serverClosed = false;
+        bool clientClosed = false;    // 받는 쪽이 끊음 → 서버 쪽 connected()가 false
+        size_t sendBuffer = 0;        // 받는 쪽이 읽지 않은 data가 이만큼 차면 tryWrite()가 더 받지 않음 (0 = 제한 없음)
+    };
+
+    struct Response {
+        int code = 0;
+        String contentType;
+        String body;
+        std::vector<std::pair<String, String>> headers;
+        std::shared_ptr<ClientStream> stream;   // 핸들러가 detachClient()를 불렀으면 설정됨 (code는 0)
+    };
+
+    explicit WebServer(int port = 80);
+    ~WebServer();
+
+    void begin() { started = true; }
+    void close() { started = false; }
+    void handleClient();
+
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void onNotFound(THandlerFunction fn) { notFoundHandler = fn; }
+
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength);
+    void sendHeader(const String& name, const String& value, bool first = false);
+
+    String arg(const String& name) const;
+    bool hasArg(const String& name) const;
+    String header(const String& name) const;
+    bool hasHeader(const String& name) const;
+    void collectHeaders(const char* headerKeys[], size_t headerKeysCount) { (void)headerKeys; (void)headerKeysCount; }
+    String uri() const { return currentUri; }
+    HTTPMethod method() const { return currentMethod; }
+
+    // 네이티브 전용: 요청을 큐에 넣는다. handleClient() 호출 시 처리되고 응답이 콜백으로 전달된다.
+    void inject(HTTPMethod method, const String& uri, const String& body = String(),
+                const std::vector<std::pair<String, String>>& headers = {},
+                std::function<void(const Response&)> onResponse = nullptr);
+
+    // 네이티브 전용: 요청을 즉시 처리하고 응답을 반환한다.
+    Response request(HTTPMethod method, const String& uri, const String& body = String(),
+                     const std::vector<std::pair<String, String>>& headers = {});
+
+    // 네이티브 전용: 처리 중인 요청의 연결을 떼어 낸다 (ESP32에서 client()를 복사해 두는 것과 같음)
+    std::shared_ptr<ClientStream> detachClient();
+
+    // 네이티브 전용: 요청 하나를 처리하는 데 걸리는 시간 (µs, 응답 코드로 정함). handleClient()가 가상 시간에 더한다.
+    // 시뮬레이터가 연결 수락 / 파싱 / 본문 생성 / 응답 쓰기 비용을 모델링한다 (없으면 0)
+    void setCostModel(std::function<uint32_t(const String& uri, int code)> model) { costModel = model; }
+
+    size_t pendingRequests() const { return queue.size(); }
+    int listenPort() const { return port; }
+
+    // 네이티브 전용: 생성된 모든 서버 (생성 순서). 시뮬레이터가 포트로 찾아 요청을 넣는다.
+    static std::vector<WebServer*>& instances();
+    static WebServer* find(int port);
+
+private:
+    struct Route {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+    };
+
+    struct PendingRequest {
+        HTTPMethod method;
+        String uri;
+        String body;
+        std::vector<std::pair<String, String>> headers;
+        std::function<void(const Response&)> onResponse;
+    };
+
+    Response dispatch(const PendingRequest& req);
+
+    int port;
+    bool started = false;
+    std::vector<Route> routes;
+    THandlerFunction notFoundHandler = nullptr;
+    std::deque<PendingRequest> queue;
+    std::function<uint32_t(const String&, int)> costModel = nullptr;
+
+    // 처리 중인 요청 상태
+    HTTPMethod currentMethod = HTTP_GET;
+    String currentUri;
+    std::vector<std::pair<String, String>> currentArgs;
+    std::vector<std::pair<String, String>> currentHeaders;
+    std::vector<std::pair<String, String>> pendingResponseHeaders;
+    Response currentResponse;
+};
+
+#endif // NATIVE_WEBSERVER_H
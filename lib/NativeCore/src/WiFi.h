@@ -0,0 +1,42 @@
+// WiFi.h (native)
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+/**
+ * 호스트 빌드용 Wi-Fi 스텁
+ * - 호스트의 네트워크를 그대로 쓴다고 가정하고 begin() 즉시 연결 상태가 된다.
+ */
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* = nullptr) {
+        status_ = (ssid && *ssid) ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+        return status_;
+    }
+    wl_status_t status() const { return status_; }
+    bool mode(wifi_mode_t m) { mode_ = m; return true; }
+    bool softAP(const char*, const char* = nullptr) { return true; }
+    IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+    IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+    bool disconnect() { status_ = WL_DISCONNECTED; return true; }
+
+private:
+    wl_status_t status_ = WL_IDLE_STATUS;
+    wifi_mode_t mode_ = WIFI_STA;
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
@@ -0,0 +1,64 @@
+#if !defined(ARDUINO)
+
+#include "FakeTagReader.h"
+#include <algorithm>
+
+FakeTagReader::FakeTagReader(uint8_t ssPin, uint8_t)
+    : ss(ssPin) {
+    instances().push_back(this);
+}
+
+FakeTagReader::~FakeTagReader() {
+    auto& list = instances();
+    list.erase(std::remove(list.begin(), list.end(), this), list.end());
+}
+
+std::vector<FakeTagReader*>& FakeTagReader::instances() {
+    static std::vector<FakeTagReader*> list;
+    return list;
+}
+
+bool FakeTagReader::isNewCardPresent() {
+    ++polls;
+    return hasCurrent || nextCard(Probe::Poll);
+}
+
+// 인터럽트 모드: 카드가 응답하면 ISR 대신 바로 이벤트를 넣는다
+void FakeTagReader::armRequest() {
+    ++polls;
+    if (!irqEnabled || hasCurrent) return;
+    if (nextCard(Probe::Arm)) irqEvents.push(micros());
+}
+
+bool FakeTagReader::nextCard(Probe probe) {
+    if (!queue.empty()) {
+        current = queue.front();
+        queue.pop_front();
+        hasCurrent = true;
+    } else if (source) {
+        hasCurrent = source(current, probe);
+    }
+    return hasCurrent;
+}
+
+bool FakeTagReader::readCardSerial(TagUid& uid) {
+    if (!hasCurrent) return false;
+    uid = current;
+    hasCurrent = false;
+    return true;
+}
+
+void FakeTagReader::present(const String& hexUid) {
+    TagUid uid;
+    for (size_t i = 0; i + 1 < hexUid.length() && uid.size < sizeof(uid.bytes); i += 2) {
+        char hex[3] = { hexUid[i], hexUid[i + 1], 0 };
+        uid.bytes[uid.size++] = static_cast<uint8_t>(strtol(hex, nullptr, 16));
+    }
+    queue.push_back(uid);
+}
+
+TagReader* createTagReader(uint8_t ssPin, uint8_t rstPin) {
+    return new FakeTagReader(ssPin, rstPin);
+}
+
+#endif // !ARDUINO
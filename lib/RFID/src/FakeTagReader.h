@@ -0,0 +1,61 @@
+// FakeTagReader.h
+#ifndef FAKETAGREADER_H
+#define FAKETAGREADER_H
+
+#if !defined(ARDUINO)
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "TagReader.h"
+#include "IrqEventQueue.h"
+
+/**
+ * 호스트 빌드용 가짜 리더기
+ * - present()로 넣은 UID를 차례로 돌려준다.
+ * - setSource()로 공급 함수를 지정하면 큐가 비었을 때 그 함수에 묻는다 (시뮬레이터용).
+ * - enableIrq()에 연결된 핀을 주면 인터럽트 모드: armRequest() 시점에 카드가 있으면 이벤트를 넣는다.
+ */
+class FakeTagReader : public TagReader {
+public:
+    enum class Probe { Poll, Arm };   // 공급 함수가 호출된 경로 (시뮬레이터가 비용을 다르게 매긴다)
+    using Source = std::function<bool(TagUid& uid, Probe probe)>;
+
+    FakeTagReader(uint8_t ssPin, uint8_t rstPin);
+    ~FakeTagReader() override;
+
+    void begin() override {}
+    bool isNewCardPresent() override;
+    bool readCardSerial(TagUid& uid) override;
+    void halt() override {}
+
+    bool enableIrq(int irqPin) override { irqEnabled = irqPin >= 0; return irqEnabled; }
+    void armRequest() override;
+    bool takeIrqEvent(uint32_t& atMicros) override { return irqEvents.pop(atMicros); }
+
+    void present(const String& hexUid);
+    void setSource(Source source) { this->source = source; }
+
+    uint8_t ssPin() const { return ss; }
+    uint32_t pollCount() const { return polls; }
+
+    // 생성된 모든 가짜 리더기 (생성 순서)
+    static std::vector<FakeTagReader*>& instances();
+
+private:
+    uint8_t ss;
+    std::deque<TagUid> queue;
+    Source source = nullptr;
+    TagUid current;
+    bool hasCurrent = false;
+    uint32_t polls = 0;
+    bool irqEnabled = false;
+    IrqEventQueue irqEvents;
+
+    bool nextCard(Probe probe);
+};
+
+#endif // !ARDUINO
+
+#endif // FAKETAGREADER_H
@@ -0,0 +1,352 @@
+#if defined(ARDUINO)
+
+#include "FastMFRC522Reader.h"
+
+namespace {
+
+// RC522 레지스터 / 명령 (데이터시트 9.2, 10.3)
+enum : uint8_t {
+    CommandReg    = 0x01,
+    ComIEnReg     = 0x02,
+    ComIrqReg     = 0x04,
+    ErrorReg      = 0x06,
+    FIFODataReg   = 0x09,
+    FIFOLevelReg  = 0x0A,
+    ControlReg    = 0x0C,
+    BitFramingReg = 0x0D,
+    CollReg       = 0x0E,
+    ModeReg       = 0x11,
+    TxModeReg     = 0x12,
+    RxModeReg     = 0x13,
+    TxControlReg  = 0x14,
+    TxASKReg      = 0x15,
+    ModWidthReg   = 0x24,
+    TModeReg      = 0x2A,
+    TPrescalerReg = 0x2B,
+    TReloadRegH   = 0x2C,
+    TReloadRegL   = 0x2D,
+};
+
+enum : uint8_t {
+    CMD_IDLE       = 0x00,
+    CMD_TRANSMIT   = 0x04,
+    CMD_TRANSCEIVE = 0x0C,
+};
+
+enum : uint8_t {
+    PICC_REQA = 0x26,
+    PICC_HLTA = 0x50,
+    PICC_CT   = 0x88,   // 캐스케이드 태그 (UID가 다음 단계로 이어짐)
+};
+
+// 타이머: 13.56MHz / (2 * 0x43 + 1) ≈ 100kHz → 틱당 약 10µs
+const uint8_t TIMER_PRESCALER = 0x43;
+const uint16_t TIMER_RELOAD = RFID_RESPONSE_TIMEOUT_US / 10;
+
+const uint8_t FIFO_SIZE = 64;
+
+inline uint8_t writeAddress(uint8_t reg) { return (reg << 1) & 0x7E; }
+inline uint8_t readAddress(uint8_t reg)  { return 0x80 | ((reg << 1) & 0x7E); }
+
+} // namespace
+
+// 같은 버스의 다른 리더기가 초기화되는 동안 선택되지 않도록 SS를 먼저 HIGH로 둔다
+FastMFRC522Reader::FastMFRC522Reader(uint8_t ssPin, uint8_t rstPin)
+    : ss(ssPin), rst(rstPin), spiSettings(RFID_SPI_HZ, MSBFIRST, SPI_MODE0) {
+    pinMode(ss, OUTPUT);
+    digitalWrite(ss, HIGH);
+}
+
+FastMFRC522Reader::~FastMFRC522Reader() {
+    if (irqPin >= 0) detachInterrupt(digitalPinToInterrupt(irqPin));
+}
+
+// ========== 초기화: 하드 리셋 → 타이머/변조 설정 → 안테나 켜기 =================================================
+// RST 핀을 여러 리더기가 공유하면 처음 한 번만 리셋한다 (뒤에서 리셋하면 앞서 설정한 리더기가 초기화됨)
+void FastMFRC522Reader::begin() {
+    static uint64_t resetPins = 0;
+
+    SPI.begin();
+
+    const uint64_t rstBit = 1ULL << (rst & 63);
+    if (!(resetPins & rstBit)) {
+        resetPins |= rstBit;
+        pinMode(rst, OUTPUT);
+        digitalWrite(rst, LOW);
+        delayMicroseconds(2);
+        digitalWrite(rst, HIGH);
+        delay(50);                                   // 발진기 안정화
+    }
+
+    SPI.beginTransaction(spiSettings);
+    writeReg(TxModeReg, 0x00);                       // 106 kBd
+    writeReg(RxModeReg, 0x00);
+    writeReg(ModWidthReg, 0x26);
+    writeReg(TModeReg, 0x80);                        // 송신이 끝나면 타이머 자동 시작
+    writeReg(TPrescalerReg, TIMER_PRESCALER);
+    writeReg(TReloadRegH, TIMER_RELOAD >> 8);
+    writeReg(TReloadRegL, TIMER_RELOAD & 0xFF);
+    writeReg(TxASKReg, 0x40);                        // 100% ASK
+    writeReg(ModeReg, 0x3D);                         // CRC 초기값 0x6363
+    writeReg(CollReg, 0x00);                         // 충돌 이후 수신 비트 지움
+    const uint8_t tx = readReg(TxControlReg);
+    if ((tx & 0x03) != 0x03) writeReg(TxControlReg, tx | 0x03);
+    SPI.endTransaction();
+}
+
+// ========== 감지 / UID 읽기 ================================================================================
+bool FastMFRC522Reader::isNewCardPresent() {
+    armed = false;
+    SPI.beginTransaction(spiSettings);
+    const Status st = request();
+    SPI.endTransaction();
+    return st == OK || st == COLLISION;              // ATQA 충돌 = 카드 여러 장 (존재함)
+}
+
+bool FastMFRC522Reader::readCardSerial(TagUid& uid) {
+    static const uint8_t cascades[3] = { 0x93, 0x95, 0x97 };
+    armed = false;
+
+    bool complete = false;
+    uid.size = 0;
+    SPI.beginTransaction(spiSettings);
+    for (uint8_t level = 0; level < 3 && !complete; ++level) {
+        uint8_t part[4];
+        uint8_t sak = 0;
+        if (selectLevel(cascades[level], part, sak) != OK) break;
+
+        if (sak & 0x04) {                            // UID 미완성: CT 다음 3바이트만 UID
+            if (part[0] != PICC_CT) break;
+            memcpy(uid.bytes + uid.size, part + 1, 3);
+            uid.size += 3;
+        } else {
+            memcpy(uid.bytes + uid.size, part, 4);
+            uid.size += 4;
+            complete = true;
+        }
+    }
+    SPI.endTransaction();
+
+    if (!complete) uid.size = 0;
+    return complete;
+}
+
+// HLTA는 송신만 하고 응답을 기다리지 않는다 (정상 카드는 응답하지 않음)
+void FastMFRC522Reader::halt() {
+    uint8_t frame[4] = { PICC_HLTA, 0x00, 0, 0 };
+    const uint16_t crc = crcA(frame, 2);
+    frame[2] = crc & 0xFF;
+    frame[3] = crc >> 8;
+
+    SPI.beginTransaction(spiSettings);
+    writeReg(CommandReg, CMD_IDLE);
+    writeReg(ComIrqReg, 0x7F);
+    writeReg(FIFOLevelReg, 0x80);
+    writeFifo(frame, sizeof(frame));
+    writeReg(BitFramingReg, 0x00);
+    writeReg(CommandReg, CMD_TRANSMIT);
+
+    // 송신 완료(TxIRq)까지만 기다린다. 다음 명령의 Idle이 송신을 끊지 않도록.
+    const uint32_t start = micros();
+    while (!(readReg(ComIrqReg) & 0x40) && micros() - start < 1000) {}
+    SPI.endTransaction();
+}
+
+// ========== ISO 14443A 절차 ================================================================================
+FastMFRC522Reader::Status FastMFRC522Reader::request() {
+    const uint8_t reqa = PICC_REQA;
+    uint8_t atqa[2];
+    uint8_t len = sizeof(atqa);
+    const Status st = transceive(&reqa, 1, 7, 0, atqa, len);   // 7비트 short frame
+    if (st == OK && len != 2) return ERROR;
+    return st;
+}
+
+// 한 캐스케이드 단계: 비트 단위 충돌 방지(UID 4바이트 + BCC) → 선택(SAK)
+// 카드 여러 장이 응답하면 CollReg가 알려주는 첫 충돌 비트를 1로 정해 다시 보낸다.
+// 정해진 비트와 맞지 않는 카드는 응답을 멈추므로, 충돌이 없어질 때까지 반복하면 카드 하나만 남는다.
+FastMFRC522Reader::Status FastMFRC522Reader::selectLevel(uint8_t cascade, uint8_t* uidPart, uint8_t& sak) {
+    uint8_t frame[9] = { cascade, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint8_t knownBits = 0;                           // 이 단계 UID 중 정해진 비트 수 (0~32)
+
+    while (knownBits < 32) {
+        const uint8_t txLastBits = knownBits % 8;
+        const uint8_t index = 2 + knownBits / 8;     // 응답이 들어갈 위치 (부분 바이트는 이어 받음)
+        frame[1] = (index << 4) | txLastBits;        // NVB: 보내는 바이트 수 + 비트 수
+
+        uint8_t len = sizeof(frame) - index;
+        uint8_t coll = 0;
+        const Status st = transceive(frame, index + (txLastBits ? 1 : 0), txLastBits, txLastBits,
+                                     frame + index, len, &coll);
+        if (st == OK) break;
+        if (st != COLLISION) return st;
+
+        // 충돌 위치 (1 = 첫 비트, 0 = 32번째 비트). 위치가 유효하지 않거나 진전이 없으면 포기
+        if (coll & 0x20) return ERROR;
+        const uint8_t position = (coll & 0x1F) ? (coll & 0x1F) : 32;
+        if (position <= knownBits) return ERROR;
+        knownBits = position;
+        frame[1 + (knownBits + 7) / 8] |= 1 << ((knownBits - 1) % 8);
+    }
+
+    const uint8_t* uid = frame + 2;
+    if ((uid[0] ^ uid[1] ^ uid[2] ^ uid[3]) != uid[4]) return ERROR;
+
+    frame[1] = 0x70;
+    const uint16_t crc = crcA(frame, 7);
+    frame[7] = crc & 0xFF;
+    frame[8] = crc >> 8;
+
+    uint8_t sakResp[3];
+    uint8_t len = sizeof(sakResp);
+    const Status st = transceive(frame, sizeof(frame), 0, 0, sakResp, len);
+    if (st != OK) return st;
+    if (len != 3 || crcA(sakResp, 1) != (sakResp[1] | (sakResp[2] << 8))) return ERROR;
+
+    memcpy(uidPart, uid, 4);
+    sak = sakResp[0];
+    return OK;
+}
+
+// FIFO 적재 → Transceive + StartSend → 수신/타이머 인터럽트 대기 → 상태 레지스터 일괄 읽기 → FIFO 일괄 읽기
+// rxAlign: 첫 수신 비트를 놓을 위치 (부분 바이트에 이어 받을 때), 그 아래 비트는 recv[0]의 기존 값을 유지한다.
+// 충돌이 나도 받은 데이터는 읽어 두고 COLLISION을 돌려준다 (collReg에 CollReg 값).
+FastMFRC522Reader::Status FastMFRC522Reader::transceive(const uint8_t* send, uint8_t sendLen, uint8_t txLastBits,
+                                                        uint8_t rxAlign, uint8_t* recv, uint8_t& recvLen,
+                                                        uint8_t* collReg) {
+    writeReg(CommandReg, CMD_IDLE);
+    writeReg(ComIrqReg, 0x7F);
+    writeReg(FIFOLevelReg, 0x80);
+    writeFifo(send, sendLen);
+    writeReg(CommandReg, CMD_TRANSCEIVE);
+    writeReg(BitFramingReg, 0x80 | (rxAlign << 4) | txLastBits);
+
+    const uint32_t start = micros();
+    for (;;) {
+        const uint8_t irq = readReg(ComIrqReg);
+        if (irq & 0x30) break;                       // RxIRq | IdleIRq
+        if (irq & 0x01) return TIMEOUT;              // TimerIRq: 응답 없음
+        if (micros() - start > 2 * RFID_RESPONSE_TIMEOUT_US + 1000) return TIMEOUT;
+    }
+
+    static const uint8_t statusRegs[3] = { ErrorReg, FIFOLevelReg, CollReg };
+    uint8_t status[3];
+    readRegs(statusRegs, status, 3);
+    if (status[0] & 0x13) return ERROR;              // BufferOvfl | ParityErr | ProtocolErr
+
+    const uint8_t n = status[1];
+    if (n > recvLen) return ERROR;
+    const uint8_t kept = recv[0];
+    readFifo(recv, n);
+    if (rxAlign && n > 0) {
+        const uint8_t mask = static_cast<uint8_t>(0xFF << rxAlign);
+        recv[0] = (kept & ~mask) | (recv[0] & mask);
+    }
+    recvLen = n;
+
+    if (collReg) *collReg = status[2];
+    return (status[0] & 0x08) ? COLLISION : OK;
+}
+
+// CRC_A (ISO/IEC 14443-3 부록 B), 하위 바이트가 먼저 전송된다
+uint16_t FastMFRC522Reader::crcA(const uint8_t* data, uint8_t length) {
+    uint16_t crc = 0x6363;
+    for (uint8_t i = 0; i < length; ++i) {
+        uint8_t ch = data[i] ^ static_cast<uint8_t>(crc & 0xFF);
+        ch ^= static_cast<uint8_t>(ch << 4);
+        crc = (crc >> 8) ^ (static_cast<uint16_t>(ch) << 8) ^ (static_cast<uint16_t>(ch) << 3) ^ (ch >> 4);
+    }
+    return crc;
+}
+
+// ========== SPI 레지스터 접근 ===============================================================================
+// 쓰기는 주소 1개 + 데이터 (FIFO는 같은 주소로 연속 기록)
+void FastMFRC522Reader::writeReg(uint8_t reg, uint8_t value) {
+    const uint8_t frame[2] = { writeAddress(reg), value };
+    digitalWrite(ss, LOW);
+    SPI.writeBytes(frame, sizeof(frame));
+    digitalWrite(ss, HIGH);
+}
+
+void FastMFRC522Reader::writeFifo(const uint8_t* data, uint8_t length) {
+    uint8_t frame[FIFO_SIZE + 1];
+    if (length > FIFO_SIZE) length = FIFO_SIZE;
+    frame[0] = writeAddress(FIFODataReg);
+    memcpy(frame + 1, data, length);
+    digitalWrite(ss, LOW);
+    SPI.writeBytes(frame, length + 1);
+    digitalWrite(ss, HIGH);
+}
+
+uint8_t FastMFRC522Reader::readReg(uint8_t reg) {
+    uint8_t out;
+    readRegs(&reg, &out, 1);
+    return out;
+}
+
+// 읽기는 한 프레임에 여러 주소를 이어 보낼 수 있다: 각 바이트의 응답이 직전 주소의 값
+void FastMFRC522Reader::readRegs(const uint8_t* regs, uint8_t* out, uint8_t count) {
+    uint8_t tx[FIFO_SIZE + 1];
+    uint8_t rx[FIFO_SIZE + 1];
+    for (uint8_t i = 0; i < count; ++i) tx[i] = readAddress(regs[i]);
+    tx[count] = 0;
+
+    digitalWrite(ss, LOW);
+    SPI.transferBytes(tx, rx, count + 1);
+    digitalWrite(ss, HIGH);
+    memcpy(out, rx + 1, count);
+}
+
+void FastMFRC522Reader::readFifo(uint8_t* out, uint8_t length) {
+    if (length == 0) return;
+    uint8_t regs[FIFO_SIZE];
+    if (length > FIFO_SIZE) length = FIFO_SIZE;
+    memset(regs, FIFODataReg, length);
+    readRegs(regs, out, length);
+}
+
+// ========== 인터럽트 감지 ===================================================================================
+bool FastMFRC522Reader::enableIrq(int pin) {
+    if (pin < 0) return false;
+    irqPin = pin;
+
+    pinMode(irqPin, INPUT_PULLUP);
+    SPI.beginTransaction(spiSettings);
+    writeReg(ComIEnReg, 0xA0);                       // IRqInv | RxIEn: 수신 완료 시 IRQ 핀 LOW
+    writeReg(ComIrqReg, 0x7F);
+    SPI.endTransaction();
+    attachInterruptArg(digitalPinToInterrupt(irqPin), onIrq, this, FALLING);
+    return true;
+}
+
+void FastMFRC522Reader::armRequest() {
+    const uint8_t reqa = PICC_REQA;
+    SPI.beginTransaction(spiSettings);
+    writeReg(CommandReg, CMD_IDLE);
+    writeReg(ComIrqReg, 0x7F);
+    writeReg(FIFOLevelReg, 0x80);
+    writeFifo(&reqa, 1);
+    writeReg(CommandReg, CMD_TRANSCEIVE);
+    armed = true;
+    writeReg(BitFramingReg, 0x87);                   // StartSend + 7비트 short frame
+    SPI.endTransaction();
+}
+
+bool FastMFRC522Reader::takeIrqEvent(uint32_t& atMicros) {
+    return irqEvents.pop(atMicros);
+}
+
+void IRAM_ATTR FastMFRC522Reader::onIrq(void* arg) {
+    FastMFRC522Reader* self = static_cast<FastMFRC522Reader*>(arg);
+    if (!self->armed) return;
+    self->armed = false;
+    self->irqEvents.push(micros());
+}
+
+#if RFID_FAST_PATH
+TagReader* createTagReader(uint8_t ssPin, uint8_t rstPin) {
+    return new FastMFRC522Reader(ssPin, rstPin);
+}
+#endif
+
+#endif // ARDUINO
@@ -0,0 +1,71 @@
+// FastMFRC522Reader.h
+#ifndef FASTMFRC522READER_H
+#define FASTMFRC522READER_H
+
+#if defined(ARDUINO)
+
+#include <SPI.h>
+#include "TagReader.h"
+#include "IrqEventQueue.h"
+
+// RC522 SPI 최대 클럭 (데이터시트: 10 Mbit/s)
+#ifndef RFID_SPI_HZ
+#define RFID_SPI_HZ 10000000
+#endif
+
+// 카드 응답 대기 타이머 (µs). REQA/선택 응답은 수백 µs 안에 오므로 라이브러리 기본값(25ms)보다 짧게 둔다.
+#ifndef RFID_RESPONSE_TIMEOUT_US
+#define RFID_RESPONSE_TIMEOUT_US 1500
+#endif
+
+/**
+ * UID 읽기 전용 경량 RC522 드라이버
+ * - SPI 트랜잭션(최대 클럭)으로 버스를 잡고 레지스터를 직접 다룬다 (MFRC522 라이브러리 미사용).
+ * - FIFO는 주소를 연속으로 보내는 한 프레임으로 읽고, 상태 레지스터도 한 프레임에 묶어 읽는다.
+ * - REQA → 충돌 방지 → 선택(캐스케이드 1~3)만 수행, CRC_A는 소프트웨어로 계산.
+ * - 카드가 여러 장이면 비트 단위 충돌 방지로 한 장을 고른다 (나머지는 HLTA 후 다음 REQA에서 응답).
+ * - HLTA는 응답을 기다리지 않고 송신만 한다. 인증을 쓰지 않으므로 StopCrypto1 생략.
+ */
+class FastMFRC522Reader : public TagReader {
+public:
+    FastMFRC522Reader(uint8_t ssPin, uint8_t rstPin);
+    ~FastMFRC522Reader() override;
+
+    void begin() override;
+    bool isNewCardPresent() override;
+    bool readCardSerial(TagUid& uid) override;
+    void halt() override;
+
+    bool enableIrq(int irqPin) override;
+    void armRequest() override;
+    bool takeIrqEvent(uint32_t& atMicros) override;
+
+private:
+    enum Status : uint8_t { OK, TIMEOUT, COLLISION, ERROR };
+
+    // 레지스터 접근 (SPI 트랜잭션 안에서만 호출)
+    void writeReg(uint8_t reg, uint8_t value);
+    void writeFifo(const uint8_t* data, uint8_t length);
+    uint8_t readReg(uint8_t reg);
+    void readRegs(const uint8_t* regs, uint8_t* out, uint8_t count);
+    void readFifo(uint8_t* out, uint8_t length);
+
+    Status transceive(const uint8_t* send, uint8_t sendLen, uint8_t txLastBits, uint8_t rxAlign,
+                      uint8_t* recv, uint8_t& recvLen, uint8_t* collReg = nullptr);
+    Status request();
+    Status selectLevel(uint8_t cascade, uint8_t* uidPart, uint8_t& sak);
+
+    static uint16_t crcA(const uint8_t* data, uint8_t length);
+    static void onIrq(void* arg);
+
+    uint8_t ss;
+    uint8_t rst;
+    SPISettings spiSettings;
+    int irqPin = -1;
+    volatile bool armed = false;
+    IrqEventQueue irqEvents;
+};
+
+#endif // ARDUINO
+
+#endif // FASTMFRC522READER_H
@@ -0,0 +1,47 @@
+// IrqEventQueue.h
+#ifndef IRQEVENTQUEUE_H
+#define IRQEVENTQUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * ISR → 루프 태스크로 감지 시각을 넘기는 단일 생산자/단일 소비자 링 버퍼
+ * - push()는 ISR에서만, pop()은 루프에서만 호출한다 (잠금 없음).
+ * - 가득 차면 새 이벤트를 버리고 overflows 를 올린다.
+ */
+class IrqEventQueue {
+public:
+    static const uint8_t CAPACITY = 8;   // 2의 거듭제곱
+
+    bool push(uint32_t atMicros) {
+        const uint8_t h = head.load(std::memory_order_relaxed);
+        const uint8_t next = (h + 1) & (CAPACITY - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            ++overflowCount;
+            return false;
+        }
+        stamps[h] = atMicros;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(uint32_t& atMicros) {
+        const uint8_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        atMicros = stamps[t];
+        tail.store((t + 1) & (CAPACITY - 1), std::memory_order_release);
+        return true;
+    }
+
+    void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+    uint32_t overflows() const { return overflowCount; }
+
+private:
+    uint32_t stamps[CAPACITY];
+    std::atomic<uint8_t> head{0};
+    std::atomic<uint8_t> tail{0};
+    volatile uint32_t overflowCount = 0;
+};
+
+#endif // IRQEVENTQUEUE_H
@@ -0,0 +1,76 @@
+#if defined(ARDUINO)
+
+#include "MFRC522Reader.h"
+#include <SPI.h>
+
+MFRC522Reader::MFRC522Reader(uint8_t ssPin, uint8_t rstPin)
+    : rfid(ssPin, rstPin) {}
+
+MFRC522Reader::~MFRC522Reader() {
+    if (irqPin >= 0) detachInterrupt(digitalPinToInterrupt(irqPin));
+}
+
+void MFRC522Reader::begin() {
+    SPI.begin();            // 기본 SPI 핀으로 시작
+    rfid.PCD_Init();        // RFID 초기화
+}
+
+bool MFRC522Reader::isNewCardPresent() {
+    armed = false;          // 폴링 중의 수신 인터럽트는 무시
+    return rfid.PICC_IsNewCardPresent();
+}
+
+bool MFRC522Reader::readCardSerial(TagUid& uid) {
+    armed = false;          // 선택 과정의 수신 인터럽트는 감지 이벤트가 아니다
+    if (!rfid.PICC_ReadCardSerial()) return false;
+    uid.size = rfid.uid.size;
+    memcpy(uid.bytes, rfid.uid.uidByte, uid.size);
+    return true;
+}
+
+void MFRC522Reader::halt() {
+    rfid.PICC_HaltA();
+    rfid.PCD_StopCrypto1();
+}
+
+// ========== 인터럽트 감지 ===================================================================================
+bool MFRC522Reader::enableIrq(int pin) {
+    if (pin < 0) return false;
+    irqPin = pin;
+
+    pinMode(irqPin, INPUT_PULLUP);
+    rfid.PCD_WriteRegister(MFRC522::ComIEnReg, 0xA0);   // IRqInv | RxIEn: 수신 완료 시 IRQ 핀 LOW
+    rfid.PCD_WriteRegister(MFRC522::ComIrqReg, 0x7F);   // 남아 있는 요청 비트 지움
+    attachInterruptArg(digitalPinToInterrupt(irqPin), onIrq, this, FALLING);
+    return true;
+}
+
+// REQA를 FIFO에 넣고 송신만 시작한다. 카드가 ATQA로 응답하면 RxIRq → onIrq()
+void MFRC522Reader::armRequest() {
+    rfid.PCD_WriteRegister(MFRC522::CommandReg, MFRC522::PCD_Idle);
+    rfid.PCD_WriteRegister(MFRC522::ComIrqReg, 0x7F);
+    rfid.PCD_WriteRegister(MFRC522::FIFOLevelReg, 0x80);                 // FIFO 비우기
+    rfid.PCD_WriteRegister(MFRC522::FIFODataReg, MFRC522::PICC_CMD_REQA);
+    rfid.PCD_WriteRegister(MFRC522::CommandReg, MFRC522::PCD_Transceive);
+    armed = true;
+    rfid.PCD_WriteRegister(MFRC522::BitFramingReg, 0x87);                // StartSend + 7비트 short frame
+}
+
+bool MFRC522Reader::takeIrqEvent(uint32_t& atMicros) {
+    return irqEvents.pop(atMicros);
+}
+
+void IRAM_ATTR MFRC522Reader::onIrq(void* arg) {
+    MFRC522Reader* self = static_cast<MFRC522Reader*>(arg);
+    if (!self->armed) return;
+    self->armed = false;
+    self->irqEvents.push(micros());
+}
+
+#if !RFID_FAST_PATH
+TagReader* createTagReader(uint8_t ssPin, uint8_t rstPin) {
+    return new MFRC522Reader(ssPin, rstPin);
+}
+#endif
+
+#endif // ARDUINO
@@ -0,0 +1,40 @@
+// MFRC522Reader.h
+#ifndef MFRC522READER_H
+#define MFRC522READER_H
+
+#if defined(ARDUINO)
+
+#include <MFRC522.h>
+#include "TagReader.h"
+#include "IrqEventQueue.h"
+
+/**
+ * MFRC522 라이브러리 기반 TagReader
+ * - IRQ 핀이 연결되어 있으면 수신 인터럽트(RxIRq)로 카드 응답을 감지한다.
+ */
+class MFRC522Reader : public TagReader {
+public:
+    MFRC522Reader(uint8_t ssPin, uint8_t rstPin);
+    ~MFRC522Reader() override;
+
+    void begin() override;
+    bool isNewCardPresent() override;
+    bool readCardSerial(TagUid& uid) override;
+    void halt() override;
+
+    bool enableIrq(int irqPin) override;
+    void armRequest() override;
+    bool takeIrqEvent(uint32_t& atMicros) override;
+
+private:
+    static void onIrq(void* arg);     // ISR: 무장된 상태에서만 감지 시각을 큐에 넣는다
+
+    MFRC522 rfid;
+    int irqPin = -1;
+    volatile bool armed = false;      // REQA 송신 후 아직 응답이 오지 않음
+    IrqEventQueue irqEvents;
+};
+
+#endif // ARDUINO
+
+#endif // MFRC522READER_H
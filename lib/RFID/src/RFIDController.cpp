@@ -1,60 +1,233 @@
 #include "RFIDController.h"
-#include <SPI.h>
+#include "TraceLog.h"
 
-// 생성자: 포인터 초기화
-RFIDController::RFIDController(uint8_t ssPin, uint8_t rstPin)
-    : ssPin(ssPin), rstPin(rstPin), rfid(nullptr), debug(nullptr) {}
+// 생성자: 첫 번째 리더기(ID 0)의 소유권을 넘겨받는다
+RFIDController::RFIDController(TagReader* reader)
+    : debug(nullptr) {
+    addReader(reader);
+}
 
 // 소멸자: 메모리 해제
 RFIDController::~RFIDController() {
-    if (rfid) {
-        delete rfid;
-        rfid = nullptr;
+    for (uint8_t i = 0; i < readers; ++i) {
+        delete slots[i].reader;
+        slots[i].reader = nullptr;
     }
 }
 
+// 같은 SPI 버스의 리더기 추가
+bool RFIDController::addReader(TagReader* reader) {
+    if (!reader || readers >= RFID_MAX_READERS) return false;
+    slots[readers].reader = reader;
+    rfidStats.readers[readers] = RFIDReaderStats();
+    rfidStats.readerCount = ++readers;
+    return true;
+}
+
 // 디버깅 없이 초기화
 void RFIDController::begin() {
-    if (rfid == nullptr) {
-        rfid = new MFRC522(ssPin, rstPin);
-    }
-
-    SPI.begin();            // 기본 SPI 핀으로 시작
-    rfid->PCD_Init();       // RFID 초기화
+    for (uint8_t i = 0; i < readers; ++i) slots[i].reader->begin();   // RFID 초기화
+    startedMs = millis();
+    const uint32_t now = micros();
+    for (uint8_t i = 0; i < readers; ++i) slots[i].lastEmptyUs = now;
 }
 
 // 디버깅용 시리얼 포함 초기화
-void RFIDController::begin(HardwareSerial &debugSerial) {
+void RFIDController::begin(Print &debugSerial) {
     debug = &debugSerial;
-    if (debug) debug->println("[RFIDController][1/2] RFID 리더기 사용");
-
-    if (rfid == nullptr) {
-        rfid = new MFRC522(ssPin, rstPin);
-    }
+    if (debug) debug->println("[RFIDController][1/2] RFID 리더기 사용 (" + String(readers) + "대)");
 
-    SPI.begin();            // SPI 시작
-    rfid->PCD_Init();       // RFID 초기화
+    begin();
 
     if (debug) debug->println("[RFIDController][2/2] RFID 리더기 초기화 완료\n");
 }
 
+// 인터럽트 감지 사용 (리더기가 지원하지 않거나 핀이 없으면 폴링 유지)
+bool RFIDController::useIrq(int irqPin, uint8_t readerId) {
+    if (readerId >= readers) return false;
+    RFIDReaderStats& st = rfidStats.readers[readerId];
+    st.irqMode = slots[readerId].reader->enableIrq(irqPin);
+    if (debug) debug->println("[RFIDController] 리더기 " + String(readerId) + (st.irqMode ? ": IRQ 감지 모드" : ": 적응형 폴링 모드"));
+    return st.irqMode;
+}
+
 // UID 감지
-String RFIDController::getUID() {
-    if (!rfid || !rfid->PICC_IsNewCardPresent() || !rfid->PICC_ReadCardSerial()) {
+String RFIDController::getUID(uint8_t* readerId) {
+    TagUid uid;
+    uint8_t id = 0;
+    if (collect(&uid, 1, id) == 0) {
         return "";
     }
 
-    String uidStr;
-    for (byte i = 0; i < rfid->uid.size; i++) {
-        if (rfid->uid.uidByte[i] < 0x10) uidStr += "0";
-        uidStr += String(rfid->uid.uidByte[i], HEX);
+    // 서행 중 같은 태그가 반복해서 읽히면 STOP/작업 요청이 중복되므로 여기서 걸러낸다 (리더기 구분 없음)
+    if (!dedupCache.accept(uid, millis())) {
+        return "";
     }
 
-    uidStr.toLowerCase();
+    if (readerId) *readerId = id;
+    String uidStr = formatUid(uid);
+    LOG_DEBUG("[RFID] 감지된 UID: {} (리더기 {})", uidStr, id);
+    return uidStr;
+}
+
+// 이번 주기에 읽은 UID 전부 (중복 억제 후)
+uint8_t RFIDController::getUIDs(TagInventory& out) {
+    out.count = 0;
+
+    TagUid uids[RFID_INVENTORY_MAX];
+    uint8_t id = 0;
+    const uint8_t found = collect(uids, inventoryMode ? RFID_INVENTORY_MAX : 1, id);
+
+    const uint32_t nowMs = millis();
+    out.readerId = id;
+    for (uint8_t i = 0; i < found; ++i) {
+        if (!dedupCache.accept(uids[i], nowMs)) continue;
+        out.uids[out.count] = formatUid(uids[i]);
+        LOG_DEBUG("[RFID] 감지된 UID: {} (리더기 {}, {}/{})", out.uids[out.count], id, i + 1, found);
+        ++out.count;
+    }
+    return out.count;
+}
+
+// 첫 카드는 평소처럼 탐지하고, 인벤토리면 같은 리더기에서 남은 카드를 이어서 읽는다 (모두 HALT 상태로 남음)
+uint8_t RFIDController::collect(TagUid* uids, uint8_t maxUids, uint8_t& readerId) {
+    if (!scan(uids[0], readerId)) return 0;
+
+    TagReader* reader = slots[readerId].reader;
+    reader->halt();
+
+    uint8_t found = 1;
+    if (maxUids > 1) {
+        found += reader->inventory(uids + 1, maxUids - 1);
+        rfidStats.inventoryExtra += found - 1;
+    }
+    rfidStats.readTimeTotalUs += micros() - readStartUs;
+    return found;
+}
+
+// ========== 감지 ===========================================================================================
+// 라운드 로빈: 차례가 된 리더기부터 살펴보고, 실제로 버스를 쓴 리더기 하나에서 멈춘다.
+// 다음 호출은 그 다음 리더기부터 시작하므로 리더기마다 같은 몫의 버스 시간을 받는다.
+bool RFIDController::scan(TagUid& uid, uint8_t& readerId) {
+    for (uint8_t n = 0; n < readers; ++n) {
+        const uint8_t id = (cursor + n) % readers;
+        const Scan result = detect(id, uid);
+        if (result == Scan::Idle) continue;
+
+        cursor = (id + 1) % readers;
+        readerId = id;
+        return result == Scan::Found;
+    }
+    return false;
+}
+
+RFIDController::Scan RFIDController::detect(uint8_t id, TagUid& uid) {
+    const uint32_t now = micros();
+    return rfidStats.readers[id].irqMode ? detectIrq(id, uid, now) : detectPoll(id, uid, now);
+}
+
+// 인터럽트: ISR 이벤트가 있으면 UID만 읽고, 없으면 주기마다 REQA를 다시 걸어둔다
+RFIDController::Scan RFIDController::detectIrq(uint8_t id, TagUid& uid, uint32_t now) {
+    ReaderSlot& slot = slots[id];
+    RFIDReaderStats& st = rfidStats.readers[id];
+    Scan result = Scan::Idle;
+
+    uint32_t irqAt;
+    if (slot.reader->takeIrqEvent(irqAt)) {
+        ++rfidStats.irqEvents;
+        readStartUs = micros();
+        if (slot.reader->readCardSerial(uid)) {
+            recordDetection(id);
+            return Scan::Found;
+        }
+        result = Scan::Empty;
+    }
+
+    // 교차 확인: IRQ 배선 불량이면 폴링에서만 카드가 보인다
+    if (now - slot.lastVerifyUs >= RFID_IRQ_VERIFY_US) {
+        slot.lastVerifyUs = now;
+        readStartUs = now;
+        if (slot.reader->isNewCardPresent() && slot.reader->readCardSerial(uid)) {
+            ++rfidStats.irqMisses;
+            if (++slot.consecutiveMisses >= 3) {
+                st.irqMode = false;
+                LOG_WARN("[RFIDController] 리더기 {} IRQ 응답 없음 → 적응형 폴링으로 전환", id);
+            }
+            recordDetection(id);
+            return Scan::Found;
+        }
+        slot.consecutiveMisses = 0;
+        slot.armedOnce = false;                   // 폴링이 REQA를 덮어썼으므로 다시 무장
+        result = Scan::Empty;
+    }
+
+    // 직전 무장에 응답이 없었으므로 그 시각까지는 카드 없음
+    if (!slot.armedOnce || now - slot.lastArmUs >= RFID_ARM_INTERVAL_US) {
+        if (slot.armedOnce) slot.lastEmptyUs = slot.lastArmUs;
+        slot.reader->armRequest();
+        ++rfidStats.probes;
+        ++st.probes;
+        slot.lastArmUs = now;
+        slot.armedOnce = true;
+        rfidStats.idleBusyUs += micros() - now;
+        result = Scan::Empty;
+    }
+    return result;
+}
 
-    rfid->PICC_HaltA();
-    rfid->PCD_StopCrypto1();
+// 적응형 폴링: 카드가 없을수록 간격을 늘려 SPI/CPU 사용을 줄이고, 감지되면 최소 간격으로 되돌린다
+RFIDController::Scan RFIDController::detectPoll(uint8_t id, TagUid& uid, uint32_t now) {
+    ReaderSlot& slot = slots[id];
+    RFIDReaderStats& st = rfidStats.readers[id];
+    if (now - slot.lastProbeUs < st.pollIntervalUs) return Scan::Idle;
+    slot.lastProbeUs = now;
+    readStartUs = now;
+    ++rfidStats.probes;
+    ++st.probes;
 
-    if (debug) debug->println("[RFID] 감지된 UID: " + uidStr);
+    if (slot.reader->isNewCardPresent() && slot.reader->readCardSerial(uid)) {
+        recordDetection(id);
+        st.pollIntervalUs = RFID_POLL_MIN_US;
+        return Scan::Found;
+    }
+
+    rfidStats.idleBusyUs += micros() - now;
+    slot.lastEmptyUs = now;
+    const uint32_t next = st.pollIntervalUs * 2;
+    st.pollIntervalUs = next > RFID_POLL_MAX_US ? RFID_POLL_MAX_US : next;
+    return Scan::Empty;
+}
+
+void RFIDController::recordDetection(uint8_t id) {
+    const uint32_t latency = micros() - slots[id].lastEmptyUs;
+    ++rfidStats.detections;
+    ++rfidStats.readers[id].detections;
+    rfidStats.latencyTotalUs += latency;
+    if (latency > rfidStats.latencyMaxUs) rfidStats.latencyMaxUs = latency;
+}
+
+const char* RFIDStats::modeName() const {
+    uint8_t irq = 0;
+    for (uint8_t i = 0; i < readerCount; ++i) {
+        if (readers[i].irqMode) ++irq;
+    }
+    if (irq == 0) return "poll";
+    return irq == readerCount ? "irq" : "mixed";
+}
+
+float RFIDController::idleLoadPercent() const {
+    const uint32_t elapsedMs = millis() - startedMs;
+    return elapsedMs ? static_cast<float>(rfidStats.idleBusyUs) / (10.0f * elapsedMs) : 0.0f;
+}
+
+// UID 바이트 → 소문자 hex 문자열
+String RFIDController::formatUid(const TagUid& uid) {
+    String uidStr;
+    for (byte i = 0; i < uid.size; i++) {
+        if (uid.bytes[i] < 0x10) uidStr += "0";
+        uidStr += String(uid.bytes[i], HEX);
+    }
+
+    uidStr.toLowerCase();
     return uidStr;
-}
\ No newline at end of file
+}
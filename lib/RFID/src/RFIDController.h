@@ -3,26 +3,155 @@
 #define RFIDCONTROLLER_H
 
 #include <Arduino.h>
-#include <MFRC522.h>
+#include "TagReader.h"
+#include "TagDedupCache.h"
+
+// 인터럽트 모드: REQA 재무장 주기 (µs)
+#ifndef RFID_ARM_INTERVAL_US
+#define RFID_ARM_INTERVAL_US 5000
+#endif
+
+// 인터럽트 모드: 이 주기마다 한 번 폴링으로 교차 확인, IRQ가 놓친 카드가 연속 3번 나오면 폴링으로 전환 (µs)
+#ifndef RFID_IRQ_VERIFY_US
+#define RFID_IRQ_VERIFY_US 500000
+#endif
+
+// 폴링 모드: 빈 폴링마다 주기를 두 배로 늘리고, 감지되면 최소값으로 되돌린다 (µs)
+#ifndef RFID_POLL_MIN_US
+#define RFID_POLL_MIN_US 1000
+#endif
+#ifndef RFID_POLL_MAX_US
+#define RFID_POLL_MAX_US 8000
+#endif
+
+// 인벤토리 모드에서 한 번에 읽는 최대 태그 수
+#ifndef RFID_INVENTORY_MAX
+#define RFID_INVENTORY_MAX 4
+#endif
+
+// 한 SPI 버스에 물릴 수 있는 리더기 수 (SS 핀만 리더기마다 따로)
+#ifndef RFID_MAX_READERS
+#define RFID_MAX_READERS 4
+#endif
+
+/**
+ * 리더기별 감지 상태 / 통계
+ */
+struct RFIDReaderStats {
+    bool irqMode = false;
+    uint32_t probes = 0;             // 폴링 또는 REQA 무장 횟수
+    uint32_t detections = 0;         // UID 읽기 성공 (중복 억제 전)
+    uint32_t pollIntervalUs = RFID_POLL_MIN_US;   // 현재 적응형 폴링 주기
+};
+
+/**
+ * 감지 통계 (모든 리더기 합계 + 리더기별)
+ * - 감지 지연: 마지막으로 "카드 없음"을 확인한 시점 → UID 준비 (카드 진입 → 감지의 상한)
+ * - 유휴 부하: 카드가 없을 때 리더기 호출(SPI)에 쓴 시간
+ * - 읽기 시간: 카드 확인(폴링 시작 / IRQ 이벤트) → UID 읽기 → HALT 까지 리더기 호출에 쓴 시간
+ */
+struct RFIDStats {
+    uint32_t probes = 0;             // 폴링 또는 REQA 무장 횟수
+    uint32_t irqEvents = 0;          // ISR이 넣은 감지 이벤트
+    uint32_t irqMisses = 0;          // IRQ 없이 교차 확인 폴링에서 발견된 카드
+    uint32_t detections = 0;         // UID 읽기 성공
+    uint64_t latencyTotalUs = 0;
+    uint32_t latencyMaxUs = 0;
+    uint64_t readTimeTotalUs = 0;
+    uint64_t idleBusyUs = 0;
+    uint32_t inventoryExtra = 0;     // 인벤토리로 한 주기에 더 읽은 태그 (첫 태그 제외)
+
+    uint8_t readerCount = 0;
+    RFIDReaderStats readers[RFID_MAX_READERS];
+
+    uint32_t latencyAvgUs() const { return detections ? static_cast<uint32_t>(latencyTotalUs / detections) : 0; }
+    uint32_t readAvgUs() const { return detections ? static_cast<uint32_t>(readTimeTotalUs / detections) : 0; }
+    const char* modeName() const;    // "irq" / "poll" / "mixed" (리더기마다 다를 수 있음)
+};
+
+/**
+ * 한 탐지 주기에 새로 읽힌 태그들 (중복 억제 후, 같은 리더기)
+ */
+struct TagInventory {
+    uint8_t count = 0;
+    uint8_t readerId = 0;
+    String uids[RFID_INVENTORY_MAX];
+};
 
 /**
  * @class RFIDController
- * @brief MFRC522 기반 RFID 리더기 제어 클래스 (포인터 기반)
+ * @brief TagReader 기반 RFID 리더기 제어 클래스 (리더기는 생성자 / addReader()로 주입, 소유)
+ * - 같은 SPI 버스의 리더기 여러 대(SS 핀만 다름)를 라운드 로빈으로 돌아가며 탐지한다.
+ *   getUID() 한 번에 버스를 쓰는 리더기는 하나뿐이고, 리더기마다 자기 주기로 탐지하므로
+ *   전체 탐지 횟수는 리더기 수에 비례한다.
+ * - 모든 리더기의 읽기는 하나의 중복 억제 캐시를 거친다 → 양쪽 리더기가 같은 태그를 읽어도 한 번만 나온다.
+ *   억제 창 안에 다시 읽힌 같은 UID는 getUID()에서 빈 문자열로 걸러진다 (TagDedupCache).
+ * - useIrq()로 IRQ 핀을 지정한 리더기는 인터럽트 감지, 아니면 적응형 주기 폴링으로 동작한다.
+ * - 인벤토리 모드의 getUIDs()는 카드를 찾은 리더기에서 범위 안의 나머지 카드까지 한 주기에 모두 읽는다.
  */
 class RFIDController {
 public:
-    RFIDController(uint8_t ssPin, uint8_t rstPin);
+    explicit RFIDController(TagReader* reader);
     ~RFIDController();
 
+    bool addReader(TagReader* reader);            // 같은 버스의 리더기 추가 (ID = 추가 순서), 가득 차면 false (소유권은 호출자에 남음)
+    uint8_t readerCount() const { return readers; }
+
     void begin();
-    void begin(HardwareSerial &debugSerial);
-    String getUID();
+    void begin(Print &debugSerial);
+    String getUID(uint8_t* readerId = nullptr);   // 새 UID (없으면 빈 문자열), readerId에 읽은 리더기 ID
+    uint8_t getUIDs(TagInventory& out);           // 이번 주기의 새 UID 전부 (인벤토리 모드가 아니면 최대 1개)
+
+    void setInventoryMode(bool enabled) { inventoryMode = enabled; }
+    bool inventoryEnabled() const { return inventoryMode; }
+
+    bool useIrq(int irqPin, uint8_t readerId = 0);   // IRQ 핀 연결 (-1 또는 실패 시 폴링 유지)
+    const RFIDStats& stats() const { return rfidStats; }
+    float idleLoadPercent() const;                // 시작 후 경과 시간 대비 유휴 리더기 호출 시간
+
+    void setDedupWindow(uint32_t ms) { dedupCache.setWindow(ms); }   // 0 = 중복 억제 끔
+    void resetDedup() { dedupCache.clear(); }                         // 같은 태그를 다시 받아야 할 때
+    const TagDedupCache& dedup() const { return dedupCache; }
+
+    static String formatUid(const TagUid& uid);   // UID 바이트 → 소문자 hex 문자열
 
 private:
-    uint8_t ssPin;
-    uint8_t rstPin;
-    MFRC522* rfid = nullptr;
-    HardwareSerial* debug = nullptr;
+    // 리더기 한 대의 탐지 일정
+    struct ReaderSlot {
+        TagReader* reader = nullptr;
+        uint32_t lastProbeUs = 0;                 // 폴링: 마지막 폴링 시각
+        uint32_t lastEmptyUs = 0;                 // 마지막으로 카드 없음을 확인한 시각
+        uint32_t lastArmUs = 0;                   // 인터럽트: 마지막 무장 시각
+        uint32_t lastVerifyUs = 0;                // 인터럽트: 마지막 교차 확인 시각
+        uint8_t consecutiveMisses = 0;
+        bool armedOnce = false;
+    };
+
+    // 리더기 한 대를 탐지한 결과
+    enum class Scan : uint8_t {
+        Idle,       // 차례가 아님 (버스 사용 없음)
+        Empty,      // 탐지했지만 카드 없음
+        Found,      // UID 읽음
+    };
+
+    Print* debug = nullptr;
+    TagDedupCache dedupCache;
+
+    uint8_t collect(TagUid* uids, uint8_t maxUids, uint8_t& readerId);   // 탐지 → HALT → (인벤토리) 읽은 수
+    bool scan(TagUid& uid, uint8_t& readerId);    // 라운드 로빈으로 한 대 탐지 (UID를 읽었으면 true)
+    Scan detect(uint8_t id, TagUid& uid);         // 모드별 감지
+    Scan detectIrq(uint8_t id, TagUid& uid, uint32_t now);
+    Scan detectPoll(uint8_t id, TagUid& uid, uint32_t now);
+    void recordDetection(uint8_t id);
+
+    ReaderSlot slots[RFID_MAX_READERS];
+    uint8_t readers = 0;
+    uint8_t cursor = 0;                           // 다음 getUID()가 먼저 살펴볼 리더기
+    bool inventoryMode = false;
+
+    RFIDStats rfidStats;
+    uint32_t startedMs = 0;
+    uint32_t readStartUs = 0;                     // 이번 UID 읽기 시작 시각
 };
 
-#endif // RFIDCONTROLLER_H
\ No newline at end of file
+#endif // RFIDCONTROLLER_H
@@ -0,0 +1,108 @@
+#include "TagDedupCache.h"
+
+// 생성자: 버킷/LRU 초기화
+TagDedupCache::TagDedupCache(uint32_t windowMs)
+    : windowMs(windowMs) {
+    clear();
+}
+
+void TagDedupCache::clear() {
+    for (uint8_t i = 0; i < BUCKETS; ++i) buckets[i] = NONE;
+    head = tail = NONE;
+    used = 0;
+}
+
+// ========== 판정 ===========================================================================================
+bool TagDedupCache::accept(const TagUid& uid, uint32_t nowMs) {
+    if (windowMs == 0) {
+        ++accepted;
+        return true;
+    }
+
+    const uint8_t bucket = hashOf(uid);
+    int8_t index = find(uid, bucket);
+
+    if (index != NONE) {
+        Slot& slot = slots[index];
+        const bool duplicate = nowMs - slot.lastSeenMs < windowMs;
+        slot.lastSeenMs = nowMs;
+        unlinkLru(index);
+        pushFront(index);
+        if (duplicate) {
+            ++suppressed;
+            return false;
+        }
+        ++accepted;
+        return true;
+    }
+
+    index = allocate();
+    Slot& slot = slots[index];
+    slot.uid = uid;
+    slot.lastSeenMs = nowMs;
+    slot.bucket = bucket;
+    slot.nextInBucket = buckets[bucket];
+    buckets[bucket] = index;
+    pushFront(index);
+
+    ++accepted;
+    return true;
+}
+
+// ========== 해시 / 버킷 ====================================================================================
+// FNV-1a (UID 최대 10바이트)
+uint8_t TagDedupCache::hashOf(const TagUid& uid) {
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < uid.size; ++i) {
+        h ^= uid.bytes[i];
+        h *= 16777619u;
+    }
+    return static_cast<uint8_t>(h % BUCKETS);
+}
+
+bool TagDedupCache::sameUid(const TagUid& a, const TagUid& b) {
+    return a.size == b.size && memcmp(a.bytes, b.bytes, a.size) == 0;
+}
+
+int8_t TagDedupCache::find(const TagUid& uid, uint8_t bucket) const {
+    for (int8_t i = buckets[bucket]; i != NONE; i = slots[i].nextInBucket) {
+        if (sameUid(slots[i].uid, uid)) return i;
+    }
+    return NONE;
+}
+
+void TagDedupCache::unlinkBucket(int8_t index) {
+    int8_t* link = &buckets[slots[index].bucket];
+    while (*link != NONE && *link != index) link = &slots[*link].nextInBucket;
+    if (*link == index) *link = slots[index].nextInBucket;
+}
+
+// ========== LRU 목록 =======================================================================================
+int8_t TagDedupCache::allocate() {
+    if (used < CAPACITY) return static_cast<int8_t>(used++);
+
+    // 가득 참: 가장 오래 전에 본 태그를 밀어낸다
+    const int8_t victim = tail;
+    unlinkLru(victim);
+    unlinkBucket(victim);
+    ++evictions;
+    return victim;
+}
+
+void TagDedupCache::unlinkLru(int8_t index) {
+    Slot& slot = slots[index];
+    if (slot.prev != NONE) slots[slot.prev].next = slot.next;
+    else head = slot.next;
+    if (slot.next != NONE) slots[slot.next].prev = slot.prev;
+    else tail = slot.prev;
+    slot.prev = slot.next = NONE;
+}
+
+void TagDedupCache::pushFront(int8_t index) {
+    Slot& slot = slots[index];
+    slot.prev = NONE;
+    slot.next = head;
+    if (head != NONE) slots[head].prev = index;
+    head = index;
+    if (tail == NONE) tail = index;
+}
@@ -0,0 +1,75 @@
+// TagDedupCache.h
+#ifndef TAGDEDUPCACHE_H
+#define TAGDEDUPCACHE_H
+
+#include <Arduino.h>
+#include "TagReader.h"
+
+// 최근 본 태그를 기억하는 슬롯 수 (가득 차면 가장 오래 전에 본 태그를 밀어낸다)
+#ifndef TAG_DEDUP_CAPACITY
+#define TAG_DEDUP_CAPACITY 16
+#endif
+
+static_assert(TAG_DEDUP_CAPACITY > 0 && TAG_DEDUP_CAPACITY <= 63, "TAG_DEDUP_CAPACITY는 1~63 (int8_t 인덱스, 버킷 2배)");
+
+/**
+ * @class TagDedupCache
+ * @brief 시간 창 기반 중복 태그 억제 캐시 (고정 크기, 힙 할당 없음)
+ *
+ * - 같은 UID가 창(windowMs) 안에 다시 읽히면 중복으로 판정한다.
+ * - 중복으로 읽힐 때마다 마지막 시각을 갱신한다 → 태그 위에 머무는 동안은 계속 억제.
+ * - 해시 버킷 + 이중 연결 LRU 목록으로 조회/삽입/제거 모두 상수 시간.
+ * - windowMs = 0 이면 억제하지 않는다.
+ */
+class TagDedupCache {
+public:
+    explicit TagDedupCache(uint32_t windowMs = 2000);
+
+    bool accept(const TagUid& uid, uint32_t nowMs);   // true: 새 태그(또는 창 만료), false: 중복 → 억제
+    void clear();
+
+    void setWindow(uint32_t ms) { windowMs = ms; }
+    uint32_t window() const { return windowMs; }
+
+    // 통계
+    uint32_t acceptedCount() const { return accepted; }
+    uint32_t suppressedCount() const { return suppressed; }
+    uint32_t evictionCount() const { return evictions; }
+    size_t size() const { return used; }
+
+private:
+    static const uint8_t CAPACITY = TAG_DEDUP_CAPACITY;
+    static const uint8_t BUCKETS = CAPACITY * 2;
+    static const int8_t NONE = -1;
+
+    struct Slot {
+        TagUid uid;
+        uint32_t lastSeenMs;
+        uint8_t bucket;
+        int8_t nextInBucket;
+        int8_t prev;    // LRU: 더 최근 쪽
+        int8_t next;    // LRU: 더 오래된 쪽
+    };
+
+    static uint8_t hashOf(const TagUid& uid);
+    static bool sameUid(const TagUid& a, const TagUid& b);
+
+    int8_t find(const TagUid& uid, uint8_t bucket) const;
+    int8_t allocate();                 // 빈 슬롯 또는 LRU 꼬리 슬롯 회수
+    void unlinkBucket(int8_t index);
+    void unlinkLru(int8_t index);
+    void pushFront(int8_t index);
+
+    Slot slots[CAPACITY];
+    int8_t buckets[BUCKETS];
+    int8_t head = NONE;                // 가장 최근
+    int8_t tail = NONE;                // 가장 오래됨
+    uint8_t used = 0;
+
+    uint32_t windowMs;
+    uint32_t accepted = 0;
+    uint32_t suppressed = 0;
+    uint32_t evictions = 0;
+};
+
+#endif // TAGDEDUPCACHE_H
@@ -0,0 +1,61 @@
+// TagReader.h
+#ifndef TAGREADER_H
+#define TAGREADER_H
+
+#include <Arduino.h>
+
+/**
+ * ISO 14443A 카드 UID (최대 10바이트)
+ */
+struct TagUid {
+    uint8_t size = 0;
+    uint8_t bytes[10] = {0};
+};
+
+/**
+ * RFID 리더기 인터페이스
+ * - ESP32: FastMFRC522Reader (SPI 연결 RC522, 레지스터 직접 제어) / MFRC522Reader (MFRC522 라이브러리)
+ * - 호스트: FakeTagReader (메모리 큐 / 시뮬레이터 공급 함수)
+ *
+ * 감지 방식
+ * - 폴링: isNewCardPresent() → readCardSerial() (REQA 송신 후 응답을 기다림)
+ * - 인터럽트: armRequest()로 REQA만 걸어두고 즉시 반환, 카드가 응답하면 ISR이 이벤트를 넣는다.
+ *   takeIrqEvent()로 이벤트를 꺼낸 뒤 readCardSerial()로 UID를 읽는다.
+ *
+ * 인벤토리: 범위 안의 카드를 한 번에 모두 읽는다. 읽은 카드를 HLTA로 재운 뒤 다시 REQA를 보내면
+ * 아직 깨어 있는 카드만 응답하므로, 응답이 없을 때까지 선택(충돌 방지) → HLTA를 반복한다.
+ */
+class TagReader {
+public:
+    virtual ~TagReader() = default;
+
+    virtual void begin() = 0;
+    virtual bool isNewCardPresent() = 0;
+    virtual bool readCardSerial(TagUid& uid) = 0;
+    virtual void halt() = 0;
+
+    // 인터럽트 감지 (지원하지 않는 리더기는 기본 구현 → 폴링만 사용)
+    virtual bool enableIrq(int irqPin) { (void)irqPin; return false; }   // IRQ 핀 연결, 성공 시 true
+    virtual void armRequest() {}                                          // REQA 송신만 걸어둠 (대기 없음)
+    virtual bool takeIrqEvent(uint32_t& atMicros) { (void)atMicros; return false; }
+
+    // 남은 카드를 최대 maxUids장까지 읽고 HLTA로 재운다 (읽은 수 반환)
+    virtual uint8_t inventory(TagUid* uids, uint8_t maxUids) {
+        uint8_t count = 0;
+        while (count < maxUids && isNewCardPresent() && readCardSerial(uids[count])) {
+            halt();
+            ++count;
+        }
+        return count;
+    }
+};
+
+// ESP32에서 경량 드라이버(FastMFRC522Reader)를 쓸지 여부. 0이면 MFRC522 라이브러리 기반 리더기 (비교용)
+#ifndef RFID_FAST_PATH
+#define RFID_FAST_PATH 1
+#endif
+
+// 플랫폼에 맞는 리더기를 생성한다 (소유권은 호출자에게 있음)
+TagReader* createTagReader(uint8_t ssPin, uint8_t rstPin);
+
+#endif // TAGREADER_H
@@ -0,0 +1,81 @@
+#include "AdmissionControl.h"
+#include "TraceLog.h"
+
+AdmissionControl::AdmissionControl(Clock& clock) : clock(&clock) {
+    refilledAtMs = clock.millis();
+}
+
+// ========== 한 바퀴 =======================================================================================
+void AdmissionControl::beginIteration() {
+    iterationStartUs = clock->micros();
+
+    const uint32_t nowMs = clock->millis();
+    const uint32_t elapsedMs = nowMs - refilledAtMs;
+    refilledAtMs = nowMs;
+    const uint32_t capacity = HTTP_QUEUE_MAX * 1000U;
+    const uint32_t refill = elapsedMs >= capacity ? capacity : elapsedMs * HTTP_ADMIT_PER_SEC;   // 1 ms마다 토큰 HTTP_ADMIT_PER_SEC / 1000개
+    tokenMilli = tokenMilli + refill >= capacity ? capacity : tokenMilli + refill;
+}
+
+bool AdmissionControl::keepServing(uint8_t served) const {
+    if (served >= HTTP_QUEUE_MAX) return false;
+    const uint32_t now = clock->micros();
+    if (now - iterationStartUs >= HTTP_BUDGET_US) return false;
+    return !scanning || now - scannedAtUs < RFID_MAX_GAP_MS * 1000UL;   // 다음 스캔이 늦기 전에 돌려줌
+}
+
+void AdmissionControl::endIteration() {
+    const uint32_t used = clock->micros() - iterationStartUs;
+    counters.lastIterationUs = used;
+    if (used > counters.maxIterationUs) counters.maxIterationUs = used;
+
+    if (used > HTTP_BUDGET_US) {
+        ++counters.overruns;
+        const uint32_t debt = counters.debtUs + (used - HTTP_BUDGET_US);
+        counters.debtUs = debt > HTTP_DEBT_MAX_US ? HTTP_DEBT_MAX_US : debt;
+        LOG_DEBUG("[AdmissionControl][1/2] 내장 서버가 {} us 사용 (예산 {} us), 빚 {} us", used, HTTP_BUDGET_US,
+                  counters.debtUs);
+    } else {
+        const uint32_t spare = HTTP_BUDGET_US - used;
+        counters.debtUs = counters.debtUs > spare ? counters.debtUs - spare : 0;
+    }
+}
+
+// ========== 요청 하나 =====================================================================================
+bool AdmissionControl::admit(bool control) {
+    if (control) {
+        ++counters.admitted;
+        return true;
+    }
+    if (counters.debtUs > 0) {
+        ++counters.shedBudget;
+        return false;
+    }
+    if (scanLate) {
+        ++counters.shedScan;
+        return false;
+    }
+    if (tokenMilli < 1000) {
+        ++counters.shedQueue;
+        return false;
+    }
+    tokenMilli -= 1000;
+    ++counters.admitted;
+    return true;
+}
+
+// ========== RFID 스캔 =====================================================================================
+void AdmissionControl::markScanned() {
+    const uint32_t now = clock->micros();
+    if (scanning) {
+        const uint32_t gap = now - scannedAtUs;
+        if (gap > counters.scanGapMaxUs) counters.scanGapMaxUs = gap;
+        scanLate = gap > RFID_MAX_GAP_MS * 1000UL;
+        if (scanLate) {
+            ++counters.scanLate;
+            LOG_DEBUG("[AdmissionControl][2/2] RFID 스캔 간격 {} us (상한 {} ms)", gap, RFID_MAX_GAP_MS);
+        }
+    }
+    scanning = true;
+    scannedAtUs = now;
+}
@@ -0,0 +1,63 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+#define HTTP_BUDGET_US         4000     // loop 한 바퀴에서 내장 서버가 쓸 수 있는 시간 (넘은 만큼은 다음 바퀴들이 갚음)
+#define HTTP_DEBT_MAX_US       (HTTP_BUDGET_US * 16)   // 빚 상한 (요청 하나가 아주 길어도 일반 요청을 오래 막지 않음)
+#define HTTP_QUEUE_MAX         4        // 한꺼번에 받아 줄 수 있는 일반 요청 (토큰 상한, 한 바퀴에 처리하는 요청 상한)
+#define HTTP_ADMIT_PER_SEC     10       // 일반 요청 토큰이 다시 차는 속도
+#define HTTP_RETRY_SEC         1        // 미룬 요청의 Retry-After
+#define RFID_MAX_GAP_MS        25       // RFID 스캔 사이의 최대 간격 (태그가 인식 범위에 머무는 시간보다 충분히 짧게)
+
+struct AdmissionStats {
+    uint32_t admitted = 0;            // 처리한 요청 (제어 요청 포함)
+    uint32_t shedBudget = 0;          // 시간 예산을 넘겨 갚는 중이라 503으로 미룬 일반 요청
+    uint32_t shedQueue = 0;           // 토큰이 없어 503으로 미룬 일반 요청 (한꺼번에 몰린 요청)
+    uint32_t shedScan = 0;            // 직전 RFID 스캔 간격이 늦어 503으로 미룬 일반 요청
+    uint32_t overruns = 0;            // 시간 예산을 넘긴 바퀴
+    uint32_t debtUs = 0;              // 아직 갚지 못한 초과 시간
+    uint32_t lastIterationUs = 0;     // 마지막 바퀴에서 내장 서버가 쓴 시간
+    uint32_t maxIterationUs = 0;
+    uint32_t scanGapMaxUs = 0;        // markScanned() 사이의 최대 간격
+    uint32_t scanLate = 0;            //   RFID_MAX_GAP_MS를 넘은 간격 수
+};
+
+/**
+ * 내장 HTTP 서버 수락 제어 (loop 한 바퀴의 시간 예산)
+ * - 요청 처리가 loop를 붙잡으면 그동안 RFID 스캔이 멈춰 태그가 인식 범위를 그냥 지나간다.
+ *   그래서 내장 서버는 한 바퀴에 HTTP_BUDGET_US만 쓰고, 넘긴 시간은 빚으로 남겨 다음 바퀴들이 갚는다.
+ * - 빚이 있거나, 토큰이 없거나, 직전 스캔 간격이 늦었으면 일반 요청(페이지 / 상태 / 설정)은 만들지 않고
+ *   503 + Retry-After로 돌려보낸다. 제어 요청(/start /go /stop /reset, /ws)은 카트를 움직이므로 항상 받는다.
+ * - 요청 하나는 끊을 수 없으므로 한 바퀴의 상한은 "예산 + 요청 하나"이고, 빚이 남은 동안에는 일반 요청을 받지 않는다.
+ * - ESP32 WebServer는 연결 대기열을 보여 주지 않으므로, 대기열 상한은 받아 준 일반 요청의 토큰 버킷으로 대신한다.
+ * loop에서만 쓴다 (ServerService::handle / 라우트 핸들러 / main의 loop).
+ */
+class AdmissionControl {
+public:
+    explicit AdmissionControl(Clock& clock);
+
+    void beginIteration();                        // handle() 시작: 시각 기록, 토큰 보충
+    bool keepServing(uint8_t served) const;       // 같은 바퀴에서 요청을 더 받아도 됨 (예산 / 스캔 마감 / 상한 안)
+    void endIteration();                          // 쓴 시간 → 빚 / 초과 집계
+    bool admit(bool control);                     // 요청 하나. false면 호출한 쪽이 503으로 답함
+    void markScanned();                           // loop가 RFID 스캔을 마침
+
+    uint32_t served() const { return counters.admitted + shedTotal(); }   // 라우트까지 온 요청 (503 포함)
+    AdmissionStats stats() const { return counters; }
+
+private:
+    uint32_t shedTotal() const { return counters.shedBudget + counters.shedQueue + counters.shedScan; }
+
+    Clock* clock;
+    uint32_t iterationStartUs = 0;
+    uint32_t refilledAtMs = 0;
+    uint32_t tokenMilli = HTTP_QUEUE_MAX * 1000U;  // 토큰 × 1000 (ms 단위 보충의 나머지를 버리지 않음)
+    bool scanning = false;                         // markScanned()가 한 번이라도 불림 (RFID를 쓰지 않으면 간격을 보지 않음)
+    bool scanLate = false;                         // 직전 간격이 RFID_MAX_GAP_MS를 넘음
+    uint32_t scannedAtUs = 0;
+    AdmissionStats counters;
+};
+
+#endif // ADMISSION_CONTROL_H
@@ -0,0 +1,164 @@
+#include "CircuitBreaker.h"
+#include "TraceLog.h"
+
+namespace {
+
+const uint32_t OUTCOME_MASK = (1u << BREAKER_WINDOW) - 1;
+const uint32_t COUNT_SHIFT = 24;
+
+uint32_t countOf(uint32_t window) { return window >> COUNT_SHIFT; }
+
+uint32_t failuresOf(uint32_t window) {
+    uint32_t bits = window & OUTCOME_MASK;
+    uint32_t n = 0;
+    for (; bits; bits &= bits - 1) ++n;
+    return n;
+}
+
+} // namespace
+
+static_assert(BREAKER_WINDOW <= 24, "결과 비트는 하위 24비트에 담는다");
+
+CircuitBreaker::CircuitBreaker()
+    : current(BreakerState::Closed), window(0), probing(false), openedAt(0), openFor(BREAKER_OPEN_MS),
+      lastLatency(0), trips(0), probes(0), rejected(0) {}
+
+// setup()은 요청을 보내기 전(setup 단계)에만 호출한다
+void CircuitBreaker::setup(const char* name, const String& endpointHost, uint16_t endpointPort, Clock& c) {
+    label = name;
+    host = endpointHost;
+    port = endpointPort;
+    clock = &c;
+}
+
+bool CircuitBreaker::matches(const char* otherHost, uint16_t otherPort) const {
+    return clock && port == otherPort && host == otherHost;
+}
+
+// ========== 호출 허용 =====================================================================================
+CircuitBreaker::Admission CircuitBreaker::allow() {
+    switch (current.load(std::memory_order_acquire)) {
+        case BreakerState::Closed:
+            return Admitted;
+
+        case BreakerState::Open: {
+            if (clock->millis() - openedAt.load(std::memory_order_relaxed) < openFor.load(std::memory_order_relaxed)) break;
+            bool expected = false;
+            if (!probing.compare_exchange_strong(expected, true)) break;   // 다른 태스크가 먼저 탐침을 가져감
+            current.store(BreakerState::HalfOpen, std::memory_order_release);
+            probes.fetch_add(1, std::memory_order_relaxed);
+            LOG_INFO("[CircuitBreaker] {} 반열림 → 탐침 호출 1회", label);
+            return Probe;
+        }
+
+        case BreakerState::HalfOpen:
+            break;
+    }
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return Rejected;
+}
+
+bool CircuitBreaker::ready() const {
+    switch (current.load(std::memory_order_acquire)) {
+        case BreakerState::Closed: return true;
+        case BreakerState::Open:
+            return clock->millis() - openedAt.load(std::memory_order_relaxed) >= openFor.load(std::memory_order_relaxed);
+        default:                   return false;
+    }
+}
+
+// ========== 결과 기록 =====================================================================================
+void CircuitBreaker::record(Admission admission, int statusCode, uint32_t latencyMs) {
+    if (admission == Rejected) return;
+    lastLatency.store(latencyMs, std::memory_order_relaxed);
+    const bool failed = isFailure(statusCode, latencyMs);
+
+    if (admission == Probe) {
+        if (failed) {
+            const uint32_t next = openFor.load(std::memory_order_relaxed) * 2;
+            trip(next > BREAKER_OPEN_MAX_MS ? BREAKER_OPEN_MAX_MS : next);
+            LOG_WARN("[CircuitBreaker] {} 탐침 실패 (응답 {}, {}ms) → {}ms 동안 차단", label, statusCode,
+                     static_cast<unsigned>(latencyMs), static_cast<unsigned>(openFor.load()));
+        } else {
+            close();
+            LOG_INFO("[CircuitBreaker] {} 탐침 성공 ({}ms) → 닫힘", label, static_cast<unsigned>(latencyMs));
+        }
+        probing.store(false, std::memory_order_release);
+        return;
+    }
+
+    // 열린 뒤에 끝난 호출은 창에 넣지 않는다 (닫힐 때 창을 비우므로)
+    if (current.load(std::memory_order_acquire) != BreakerState::Closed) return;
+
+    uint32_t before = window.load(std::memory_order_relaxed);
+    uint32_t after;
+    do {
+        const uint32_t count = countOf(before) < BREAKER_WINDOW ? countOf(before) + 1 : BREAKER_WINDOW;
+        after = (count << COUNT_SHIFT) | (((before << 1) | (failed ? 1u : 0u)) & OUTCOME_MASK);
+    } while (!window.compare_exchange_weak(before, after, std::memory_order_relaxed));
+
+    const uint32_t calls = countOf(after);
+    const uint32_t failures = failuresOf(after);
+    if (!failed || calls < BREAKER_MIN_CALLS || failures * 100 < calls * BREAKER_FAILURE_PCT) return;
+
+    BreakerState expected = BreakerState::Closed;
+    openedAt.store(clock->millis(), std::memory_order_relaxed);
+    openFor.store(BREAKER_OPEN_MS, std::memory_order_relaxed);
+    if (current.compare_exchange_strong(expected, BreakerState::Open, std::memory_order_acq_rel)) {
+        trips.fetch_add(1, std::memory_order_relaxed);
+        LOG_WARN("[CircuitBreaker] {} 열림: 최근 {}회 중 {}회 실패 → {}ms 동안 바로 실패 처리", label,
+                 static_cast<unsigned>(calls), static_cast<unsigned>(failures), static_cast<unsigned>(BREAKER_OPEN_MS));
+    }
+}
+
+void CircuitBreaker::cancel(Admission admission) {
+    if (admission != Probe) return;
+    current.store(BreakerState::Open, std::memory_order_release);   // openedAt은 그대로라 다음 allow()가 바로 탐침
+    probing.store(false, std::memory_order_release);
+}
+
+void CircuitBreaker::trip(uint32_t openMs) {
+    openedAt.store(clock->millis(), std::memory_order_relaxed);
+    openFor.store(openMs, std::memory_order_relaxed);
+    current.store(BreakerState::Open, std::memory_order_release);
+}
+
+void CircuitBreaker::close() {
+    window.store(0, std::memory_order_relaxed);
+    openFor.store(BREAKER_OPEN_MS, std::memory_order_relaxed);
+    current.store(BreakerState::Closed, std::memory_order_release);
+}
+
+// ========== 상태 조회 =====================================================================================
+BreakerStats CircuitBreaker::stats() const {
+    BreakerStats s;
+    s.name = label;
+    s.port = port;
+    s.state = state();
+    const uint32_t w = window.load(std::memory_order_relaxed);
+    s.calls = countOf(w);
+    s.failures = failuresOf(w);
+    s.lastLatencyMs = lastLatency.load(std::memory_order_relaxed);
+    s.trips = trips.load(std::memory_order_relaxed);
+    s.probes = probes.load(std::memory_order_relaxed);
+    s.rejected = rejected.load(std::memory_order_relaxed);
+    if (s.state == BreakerState::Open && clock) {
+        const uint32_t elapsed = clock->millis() - openedAt.load(std::memory_order_relaxed);
+        const uint32_t openMs = openFor.load(std::memory_order_relaxed);
+        s.retryInMs = elapsed < openMs ? openMs - elapsed : 0;
+    }
+    return s;
+}
+
+// 응답이 없거나(-1) 5xx거나 너무 느리면 실패. 4xx는 엔드포인트가 살아 있다는 뜻이므로 성공으로 본다
+bool CircuitBreaker::isFailure(int statusCode, uint32_t latencyMs) {
+    return statusCode <= 0 || statusCode >= 500 || latencyMs >= BREAKER_SLOW_CALL_MS;
+}
+
+const char* CircuitBreaker::stateName(BreakerState state) {
+    switch (state) {
+        case BreakerState::Open:     return "open";
+        case BreakerState::HalfOpen: return "half_open";
+        default:                     return "closed";
+    }
+}
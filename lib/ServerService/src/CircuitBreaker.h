@@ -0,0 +1,92 @@
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Clock.h"
+
+#define BREAKER_WINDOW         20       // 오류율을 계산할 최근 호출 수 (최대 24)
+#define BREAKER_MIN_CALLS      5        // 창에 이만큼 쌓여야 열림 여부를 판단
+#define BREAKER_FAILURE_PCT    50       // 창 안의 실패 비율이 이 이상이면 열림
+#define BREAKER_SLOW_CALL_MS   1500     // 이보다 오래 걸린 호출은 응답이 와도 실패로 셈
+#define BREAKER_OPEN_MS        5000     // 열린 뒤 첫 탐침까지 (탐침이 실패할 때마다 두 배)
+#define BREAKER_OPEN_MAX_MS    30000
+
+enum class BreakerState : uint8_t {
+    Closed,                           // 정상: 모든 호출 통과
+    Open,                             // 차단: 호출하지 않고 바로 실패
+    HalfOpen                          // 탐침 호출 하나만 통과, 결과로 닫힘/열림 결정
+};
+
+struct BreakerStats {
+    const char* name = "";
+    uint16_t port = 0;
+    BreakerState state = BreakerState::Closed;
+    uint32_t calls = 0;               // 창 안의 호출 수
+    uint32_t failures = 0;            // 창 안의 실패 수
+    uint32_t lastLatencyMs = 0;
+    uint32_t trips = 0;               // 닫힘 → 열림 횟수
+    uint32_t probes = 0;              // 반열림에서 보낸 탐침 수
+    uint32_t rejected = 0;            // 열려 있어 바로 실패시킨 호출
+    uint32_t retryInMs = 0;           // 열림: 다음 탐침까지 남은 시간
+
+    uint32_t failurePct() const { return calls ? failures * 100 / calls : 0; }
+};
+
+/**
+ * 엔드포인트(host:port) 하나의 서킷 브레이커
+ * - 닫힘: 최근 BREAKER_WINDOW번의 결과를 비트로 쌓는다. 연결 실패 / 응답 없음 / 5xx / 느린 응답이 실패.
+ *   BREAKER_MIN_CALLS번 이상 쌓였고 실패 비율이 BREAKER_FAILURE_PCT% 이상이면 열린다.
+ * - 열림: allow()가 원자 변수 몇 개만 읽고 Rejected를 돌려준다 (타임아웃을 기다리지 않음).
+ * - 열린 시간이 지나면 처음 온 호출 하나만 탐침으로 통과시킨다. 성공하면 닫히고, 실패하면 더 오래 연다.
+ * loop / 프리페치 / 보관함 태스크가 함께 부르므로 상태는 모두 원자 변수로 둔다 (창은 비트 + 개수를 32비트 하나에).
+ */
+class CircuitBreaker {
+public:
+    enum Admission : uint8_t {
+        Rejected,                     // 호출하지 말 것
+        Admitted,                     // 보통 호출
+        Probe                         // 반열림 탐침 (결과를 반드시 record로 알려야 함)
+    };
+
+    CircuitBreaker();
+
+    void setup(const char* name, const String& host, uint16_t port, Clock& clock);
+    bool matches(const char* host, uint16_t port) const;
+    bool configured() const { return clock != nullptr; }
+    const char* name() const { return label; }
+    const String& endpointHost() const { return host; }
+    uint16_t endpointPort() const { return port; }
+    bool ready() const;                   // 닫힘, 또는 열린 시간이 지나 탐침을 보낼 수 있음
+
+    Admission allow();
+    void record(Admission admission, int statusCode, uint32_t latencyMs);   // statusCode: 응답 없음이면 -1
+    void cancel(Admission admission);     // 결과를 모른 채 그만둔 호출 (헤지 요청이 먼저 끝남). 탐침이면 다음 호출이 다시 탐침
+
+    BreakerState state() const { return current.load(std::memory_order_acquire); }
+    BreakerStats stats() const;
+
+    static bool isFailure(int statusCode, uint32_t latencyMs);
+    static const char* stateName(BreakerState state);
+
+private:
+    void trip(uint32_t openMs);
+    void close();
+
+    const char* label = "";
+    String host;
+    uint16_t port = 0;
+    Clock* clock = nullptr;
+
+    std::atomic<BreakerState> current;
+    std::atomic<uint32_t> window;         // 하위 24비트: 결과 (1 = 실패, 최근이 bit0), 상위 8비트: 쌓인 개수
+    std::atomic<bool> probing;            // 탐침 호출이 진행 중
+    std::atomic<uint32_t> openedAt;
+    std::atomic<uint32_t> openFor;        // 이번 열림 유지 시간
+    std::atomic<uint32_t> lastLatency;
+    std::atomic<uint32_t> trips;
+    std::atomic<uint32_t> probes;
+    std::atomic<uint32_t> rejected;
+};
+
+#endif // CIRCUIT_BREAKER_H
@@ -0,0 +1,308 @@
+#include <ArduinoJson.h>
+#include <vector>
+#include "CommandChannel.h"
+#include "TraceLog.h"
+
+namespace {
+
+const char WEBSOCKET_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+// 프레임 opcode (RFC 6455 5.2)
+const uint8_t OP_CONTINUATION = 0x0;
+const uint8_t OP_TEXT         = 0x1;
+const uint8_t OP_BINARY       = 0x2;
+const uint8_t OP_CLOSE        = 0x8;
+const uint8_t OP_PING         = 0x9;
+const uint8_t OP_PONG         = 0xA;
+
+// 닫기 코드 (RFC 6455 7.4.1)
+const uint16_t CLOSE_NORMAL      = 1000;
+const uint16_t CLOSE_GOING_AWAY  = 1001;
+const uint16_t CLOSE_PROTOCOL    = 1002;
+const uint16_t CLOSE_UNSUPPORTED = 1003;
+const uint16_t CLOSE_TOO_BIG     = 1009;
+
+// 핸드셰이크에 한 번 쓰는 SHA-1 (mbedTLS가 없는 호스트 빌드와 같은 코드를 쓰려고 직접 구현)
+void sha1(const uint8_t* data, size_t length, uint8_t out[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const uint64_t bitLength = static_cast<uint64_t>(length) * 8;
+    const size_t total = ((length + 8) / 64 + 1) * 64;
+
+    for (size_t block = 0; block < total; block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            uint32_t word = 0;
+            for (int j = 0; j < 4; ++j) {
+                const size_t at = block + i * 4 + j;
+                uint8_t byte = 0;
+                if (at < length) byte = data[at];
+                else if (at == length) byte = 0x80;
+                else if (at >= total - 8) byte = static_cast<uint8_t>(bitLength >> ((total - 1 - at) * 8));
+                word = (word << 8) | byte;
+            }
+            w[i] = word;
+        }
+        for (int i = 16; i < 80; ++i) {
+            const uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = (x << 1) | (x >> 31);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            const uint32_t t = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = (b << 30) | (b >> 2);
+            b = a;
+            a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+    for (int i = 0; i < 20; ++i) out[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+}
+
+String base64(const uint8_t* data, size_t length) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    String out;
+    for (size_t i = 0; i < length; i += 3) {
+        const uint32_t n = (static_cast<uint32_t>(data[i]) << 16) | (i + 1 < length ? data[i + 1] << 8 : 0) |
+                           (i + 2 < length ? data[i + 2] : 0);
+        out += alphabet[(n >> 18) & 0x3F];
+        out += alphabet[(n >> 12) & 0x3F];
+        out += i + 1 < length ? alphabet[(n >> 6) & 0x3F] : '=';
+        out += i + 2 < length ? alphabet[n & 0x3F] : '=';
+    }
+    return out;
+}
+
+} // namespace
+
+CommandChannel::CommandChannel(Clock& clock) : clock(&clock) {}
+
+String CommandChannel::acceptKey(const String& key) {
+    const String source = key + WEBSOCKET_GUID;
+    uint8_t digest[20];
+    sha1(reinterpret_cast<const uint8_t*>(source.c_str()), source.length(), digest);
+    return base64(digest, sizeof(digest));
+}
+
+// ========== 연결 ===========================================================================================
+bool CommandChannel::accept(std::unique_ptr<TcpConnection> client, const String& key) {
+    if (!client || full()) {
+        ++counters.rejected;
+        if (client) client->stop();
+        return false;
+    }
+
+    String head = "HTTP/1.1 101 Switching Protocols\r\n"
+                  "Upgrade: websocket\r\n"
+                  "Connection: Upgrade\r\n"
+                  "Sec-WebSocket-Accept: ";
+    head += acceptKey(key);
+    head += "\r\n\r\n";
+    if (client->tryWrite(reinterpret_cast<const uint8_t*>(head.c_str()), head.length()) != head.length()) {
+        client->stop();
+        ++counters.disconnects;
+        return false;
+    }
+
+    Client& slot = clients[clientTotal++];
+    slot.connection = std::move(client);
+    slot.rxLen = 0;
+    slot.heardAt = slot.pingedAt = clock->millis();
+    slot.id = nextClientId++;
+    ++counters.accepted;
+    LOG_INFO("[CommandChannel][+] /ws 연결 ({} / {})", static_cast<unsigned>(clientTotal),
+             static_cast<unsigned>(COMMAND_MAX_CLIENTS));
+    return true;
+}
+
+void CommandChannel::drop(uint8_t index) {
+    clients[index].connection->stop();
+    if (index != clientTotal - 1) clients[index] = std::move(clients[clientTotal - 1]);
+    clients[--clientTotal].connection.reset();
+    ++counters.disconnects;
+    LOG_INFO("[CommandChannel][-] /ws 연결 닫음 (남은 연결 {})", static_cast<unsigned>(clientTotal));
+}
+
+void CommandChannel::poll() {
+    for (uint8_t i = clientTotal; i-- > 0;) {
+        if (!service(clients[i])) drop(i);
+    }
+}
+
+// ========== 프레임 =========================================================================================
+// 받은 바이트를 모아 완성된 프레임을 차례로 처리하고, 조용한 연결에는 ping을 보낸다
+bool CommandChannel::service(Client& client) {
+    TcpConnection& connection = *client.connection;
+    if (!connection.connected()) return false;
+    const uint32_t now = clock->millis();
+
+    while (client.rxLen < COMMAND_FRAME_MAX && connection.available() > 0) {
+        const int value = connection.read();
+        if (value < 0) break;
+        client.rx[client.rxLen++] = static_cast<uint8_t>(value);
+        client.heardAt = now;
+    }
+
+    while (client.rxLen >= 2) {
+        const uint8_t* rx = client.rx;
+        const bool fin = rx[0] & 0x80;
+        const uint8_t opcode = rx[0] & 0x0F;
+        size_t header = 2;
+        size_t length = rx[1] & 0x7F;
+        if (length == 127) {                             // 64비트 길이: 명령 채널에서는 받을 일이 없음
+            closeWith(client, CLOSE_TOO_BIG);
+            return false;
+        }
+        if (length == 126) {
+            if (client.rxLen < 4) break;
+            length = (static_cast<size_t>(rx[2]) << 8) | rx[3];
+            header = 4;
+        }
+        if (!(rx[1] & 0x80)) {                           // 클라이언트가 보내는 프레임은 반드시 마스킹
+            closeWith(client, CLOSE_PROTOCOL);
+            return false;
+        }
+        header += 4;
+        if (header + length > COMMAND_FRAME_MAX) {
+            closeWith(client, CLOSE_TOO_BIG);
+            return false;
+        }
+        if (client.rxLen < header + length) break;        // 나머지는 다음 poll에서
+
+        uint8_t* payload = client.rx + header;
+        const uint8_t* mask = client.rx + header - 4;
+        for (size_t i = 0; i < length; ++i) payload[i] ^= mask[i & 3];
+
+        if (!fin || opcode == OP_CONTINUATION) {          // 명령은 짧으므로 조각난 메시지는 받지 않음
+            closeWith(client, CLOSE_UNSUPPORTED);
+            return false;
+        }
+        if (!handleFrame(client, opcode, payload, length)) return false;
+
+        const size_t used = header + length;
+        memmove(client.rx, client.rx + used, client.rxLen - used);
+        client.rxLen -= used;
+    }
+
+    if (now - client.heardAt >= COMMAND_IDLE_MS) {
+        closeWith(client, CLOSE_GOING_AWAY);
+        return false;
+    }
+    if (now - client.heardAt >= COMMAND_PING_MS && now - client.pingedAt >= COMMAND_PING_MS) {
+        client.pingedAt = now;
+        return sendFrame(client, OP_PING, nullptr, 0);
+    }
+    return true;
+}
+
+bool CommandChannel::handleFrame(Client& client, uint8_t opcode, const uint8_t* payload, size_t length) {
+    switch (opcode) {
+        case OP_TEXT: {
+            String message;
+            message.reserve(length);
+            for (size_t i = 0; i < length; ++i) message += static_cast<char>(payload[i]);
+            const String reply = execute(message, client);
+            return sendFrame(client, OP_TEXT, reinterpret_cast<const uint8_t*>(reply.c_str()), reply.length());
+        }
+        case OP_PING:
+            return sendFrame(client, OP_PONG, payload, length);
+        case OP_PONG:
+            return true;
+        case OP_CLOSE:
+            closeWith(client, CLOSE_NORMAL);
+            return false;
+        case OP_BINARY:
+            closeWith(client, CLOSE_UNSUPPORTED);
+            return false;
+        default:
+            closeWith(client, CLOSE_PROTOCOL);
+            return false;
+    }
+}
+
+// 서버가 보내는 프레임은 마스킹하지 않는다. 헤더와 본문을 한 번에 써서 세그먼트 하나로 나가게 한다
+// 기다리지 않고 쓴다 (tryWrite). 보내기 버퍼에 다 들어가지 않으면 false → 호출한 쪽이 느린 클라이언트로 보고 끊는다
+bool CommandChannel::sendFrame(Client& client, uint8_t opcode, const uint8_t* payload, size_t length) {
+    std::vector<uint8_t> frame;
+    frame.reserve(length + 4);
+    frame.push_back(0x80 | opcode);
+    if (length < 126) {
+        frame.push_back(static_cast<uint8_t>(length));
+    } else {
+        frame.push_back(126);
+        frame.push_back(static_cast<uint8_t>(length >> 8));
+        frame.push_back(static_cast<uint8_t>(length));
+    }
+    frame.insert(frame.end(), payload, payload + length);
+    return client.connection->tryWrite(frame.data(), frame.size()) == frame.size();
+}
+
+void CommandChannel::closeWith(Client& client, uint16_t code) {
+    const uint8_t payload[2] = {static_cast<uint8_t>(code >> 8), static_cast<uint8_t>(code)};
+    sendFrame(client, OP_CLOSE, payload, sizeof(payload));
+}
+
+// ========== 명령 ===========================================================================================
+// {"session":"a1","seq":12,"cmd":"stop"} → 핸들러 실행 → {"seq":12,"cmd":"stop","ok":true,"code":200,"ms":43}
+String CommandChannel::execute(const String& message, const Client& client) {
+    JsonDocument doc;
+    if (deserializeJson(doc, message)) {
+        ++counters.invalid;
+        return "{\"ok\":false,\"error\":\"JSON 파싱 실패\"}";
+    }
+    const uint32_t seq = doc["seq"] | 0u;
+    const String command = doc["cmd"] | "";
+    if (seq == 0 || command.isEmpty()) {
+        ++counters.invalid;
+        return String("{\"seq\":") + seq + ",\"ok\":false,\"error\":\"seq / cmd 필요\"}";
+    }
+
+    String session = doc["session"] | "";
+    if (session.isEmpty()) session = String("#") + client.id;   // 보내는 쪽 세션이 없으면 이 연결 안에서만 중복을 봄
+
+    for (const Replay& replay : replays) {
+        if (replay.seq != seq || replay.command != command || replay.session != session) continue;
+        ++counters.duplicates;
+        LOG_INFO("[CommandChannel][DUP] seq {} 는 이미 실행함 → 기억해 둔 응답", static_cast<unsigned>(seq));
+        return replay.reply.substring(0, replay.reply.length() - 1) + ",\"duplicate\":true}";
+    }
+
+    HandlerReply result;
+    const uint32_t startedAt = clock->millis();
+    if (!dispatch || !dispatch(command, result)) {        // 명령 이름은 되돌려 쓰지 않음 (검증 안 된 문자열)
+        ++counters.invalid;
+        return String("{\"seq\":") + seq + ",\"ok\":false,\"error\":\"알 수 없는 명령\"}";
+    }
+    const uint32_t elapsed = clock->millis() - startedAt;
+
+    ++counters.commands;
+    if (!result.ok) ++counters.failed;
+    counters.lastMs = elapsed;
+    if (elapsed > counters.maxMs) counters.maxMs = elapsed;
+
+    String reply = String("{\"seq\":") + seq + ",\"cmd\":\"" + command + "\",\"ok\":" + (result.ok ? "true" : "false") +
+                   ",\"code\":" + result.code + ",\"ms\":" + elapsed;
+    if (!result.body.isEmpty()) reply += ",\"reply\":" + result.body;
+    reply += "}";
+
+    Replay& slot = replays[replayNext];
+    replayNext = (replayNext + 1) % COMMAND_REPLAY_SLOTS;
+    slot.session = session;
+    slot.seq = seq;
+    slot.command = command;
+    slot.reply = reply;
+    return reply;
+}
+
+CommandChannelStats CommandChannel::stats() const {
+    CommandChannelStats s = counters;
+    s.clients = clientTotal;
+    return s;
+}
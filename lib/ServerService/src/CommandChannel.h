@@ -0,0 +1,104 @@
+#ifndef COMMAND_CHANNEL_H
+#define COMMAND_CHANNEL_H
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+#include "Clock.h"
+#include "TcpTransport.h"
+
+#define COMMAND_MAX_CLIENTS    2        // 동시에 열어 둘 수 있는 /ws 연결 (넘으면 503)
+#define COMMAND_FRAME_MAX      256      // 받을 수 있는 프레임 하나의 최대 크기 (헤더 포함, 넘으면 1009로 닫음)
+#define COMMAND_REPLAY_SLOTS   8        // 다시 보낸 seq에 실행 없이 답하려고 기억해 두는 최근 응답 수
+#define COMMAND_PING_MS        20000    // 받은 것이 없으면 이 간격으로 ping
+#define COMMAND_IDLE_MS        60000    // 이만큼 아무것도 받지 못하면 (pong 포함) 연결을 닫음
+#define COMMAND_RETRY_SEC      5        // 가득 찼을 때 Retry-After
+
+// 핸들러가 상태 코드와 본문을 직접 정하는 응답 (본문이 비면 기본 메시지)
+// ok는 명령이 실제로 끝났는지(바퀴 보드 ACK 등)로, HTTP 응답에는 쓰지 않고 /ws 응답에만 실린다
+struct HandlerReply {
+    int code = 200;
+    String body;
+    bool ok = true;
+};
+
+struct CommandChannelStats {
+    uint8_t clients = 0;              // 지금 열린 연결
+    uint32_t accepted = 0;
+    uint32_t rejected = 0;            // 가득 차 503으로 거절
+    uint32_t disconnects = 0;         // close / 오류 / 유휴로 닫은 연결
+    uint32_t commands = 0;            // 실행한 명령
+    uint32_t failed = 0;              //   그중 ok = false
+    uint32_t duplicates = 0;          // 이미 실행한 seq라 기억해 둔 응답으로 답한 명령
+    uint32_t invalid = 0;             // JSON / seq / 명령 이름이 잘못된 메시지
+    uint32_t lastMs = 0;              // 마지막 명령의 실행 시간 (프레임을 다 받은 뒤 → 응답을 쓰기 전)
+    uint32_t maxMs = 0;
+};
+
+/**
+ * WebSocket 명령 채널 (/ws)
+ * - 중앙 서버가 연결 하나를 열어 두고 텍스트 프레임으로 {"seq":12,"cmd":"stop"}을 보낸다.
+ *   요청마다 TCP 연결과 HTTP 파싱을 새로 하지 않으므로 loop 한 바퀴 안에 명령이 handlers로 전달된다.
+ * - 응답은 같은 연결로 {"seq":12,"cmd":"stop","ok":true,"code":200,"ms":43}. ok는 바퀴 보드 ACK 같은 실제 완료 여부이고,
+ *   핸들러가 본문을 정했으면 "reply"에 그대로 붙는다 (/start의 202 작업 ID 등).
+ * - 최근 COMMAND_REPLAY_SLOTS개의 명령을 (세션, seq, cmd)로 기억한다. 같은 세션에서 다시 보낸 명령은 실행하지 않고
+ *   기억해 둔 응답에 "duplicate":true를 붙여 돌려준다 (START를 두 번 보내지 않음).
+ *   세션은 보내는 쪽이 정하는 "session"(재시작마다 새 값)이다. 연결이 끊겨도 같은 세션으로 다시 보내면 중복을 알아보고,
+ *   재시작해 seq를 1부터 다시 세면 새 세션이라 기억과 겹치지 않는다. "session"이 없으면 연결 하나가 세션이다.
+ * - 서버 쪽 제어 프레임: ping에는 pong, close에는 close로 답하고 닫는다. 조각난 프레임 / 바이너리는 1003으로 닫는다.
+ * - 쓰기는 기다리지 않는다(tryWrite). 프레임이 보내기 버퍼에 다 들어가지 않는 연결은 멈춘 클라이언트로 보고 끊는다
+ *   (읽지 않는 클라이언트 하나가 loop를 붙잡지 않음).
+ * loop에서만 쓴다 (ServerService::handle이 poll()을 부름).
+ */
+class CommandChannel {
+public:
+    using Dispatcher = std::function<bool(const String& command, HandlerReply& reply)>;   // 모르는 명령이면 false
+
+    explicit CommandChannel(Clock& clock);
+
+    void setDispatcher(const Dispatcher& dispatcher) { dispatch = dispatcher; }
+    bool full() const { return clientTotal >= COMMAND_MAX_CLIENTS; }
+    void reject() { ++counters.rejected; }
+
+    // 101 Switching Protocols를 쓰고 연결을 붙잡아 둔다 (key: 요청의 Sec-WebSocket-Key)
+    bool accept(std::unique_ptr<TcpConnection> client, const String& key);
+    void poll();
+
+    CommandChannelStats stats() const;
+
+    static String acceptKey(const String& key);   // base64(SHA-1(key + GUID))
+
+private:
+    struct Client {
+        std::unique_ptr<TcpConnection> connection;
+        uint8_t rx[COMMAND_FRAME_MAX];
+        size_t rxLen = 0;
+        uint32_t heardAt = 0;         // 마지막으로 바이트를 받은 시각
+        uint32_t id = 0;              // 연결 번호 ("session"이 없는 명령의 세션)
+        uint32_t pingedAt = 0;
+    };
+    struct Replay {
+        String session;
+        uint32_t seq = 0;             // 0 = 비어 있음
+        String command;
+        String reply;
+    };
+
+    bool service(Client& client);                 // false면 닫음
+    bool handleFrame(Client& client, uint8_t opcode, const uint8_t* payload, size_t length);
+    String execute(const String& message, const Client& client);
+    bool sendFrame(Client& client, uint8_t opcode, const uint8_t* payload, size_t length);
+    void closeWith(Client& client, uint16_t code);
+    void drop(uint8_t index);
+
+    Clock* clock;
+    Dispatcher dispatch = nullptr;
+    Client clients[COMMAND_MAX_CLIENTS];
+    uint8_t clientTotal = 0;
+    uint32_t nextClientId = 1;
+    Replay replays[COMMAND_REPLAY_SLOTS];
+    uint8_t replayNext = 0;
+    CommandChannelStats counters;
+};
+
+#endif // COMMAND_CHANNEL_H
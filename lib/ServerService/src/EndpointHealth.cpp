@@ -0,0 +1,50 @@
+#include "EndpointHealth.h"
+#include <algorithm>
+
+EndpointHealth::EndpointHealth() : ewmaX8(0), health(1000), count(0) {
+    for (auto& slot : ring) slot.store(0, std::memory_order_relaxed);
+}
+
+void EndpointHealth::record(bool failed, bool hasLatency, uint32_t latencyMs) {
+    const uint32_t target = failed ? 0 : 1000;
+    uint32_t h = health.load(std::memory_order_relaxed);
+    while (!health.compare_exchange_weak(h, h - (h >> HEALTH_EWMA_SHIFT) + (target >> HEALTH_EWMA_SHIFT),
+                                         std::memory_order_relaxed)) {}
+
+    if (!hasLatency) return;
+    const uint32_t sample = latencyMs > 0xFFFF ? 0xFFFF : latencyMs;
+    ring[count.fetch_add(1, std::memory_order_relaxed) % HEALTH_SAMPLES].store(static_cast<uint16_t>(sample),
+                                                                               std::memory_order_relaxed);
+
+    // 첫 표본은 그대로, 이후에는 1/8씩 따라간다 (× 8 고정소수점)
+    uint32_t e = ewmaX8.load(std::memory_order_relaxed);
+    uint32_t next;
+    do {
+        next = e == 0 ? (sample << 3) | 1 : e - (e >> HEALTH_EWMA_SHIFT) + sample;
+    } while (!ewmaX8.compare_exchange_weak(e, next, std::memory_order_relaxed));
+}
+
+uint32_t EndpointHealth::ewmaMs() const {
+    return ewmaX8.load(std::memory_order_relaxed) >> 3;
+}
+
+uint32_t EndpointHealth::p95Ms() const {
+    const uint32_t n = std::min<uint32_t>(samples(), HEALTH_SAMPLES);
+    if (n < HEALTH_MIN_SAMPLES) return 0;
+
+    uint16_t sorted[HEALTH_SAMPLES];
+    for (uint32_t i = 0; i < n; ++i) sorted[i] = ring[i].load(std::memory_order_relaxed);
+    std::sort(sorted, sorted + n);
+    return sorted[(n * 95 + 99) / 100 - 1];
+}
+
+uint32_t EndpointHealth::healthPct() const {
+    return health.load(std::memory_order_relaxed) / 10;
+}
+
+uint32_t EndpointHealth::score() const {
+    const uint32_t e = ewmaX8.load(std::memory_order_relaxed);
+    if (e == 0) return UINT32_MAX;
+    const uint32_t h = health.load(std::memory_order_relaxed);
+    return static_cast<uint32_t>(static_cast<uint64_t>(e) * 1000 / (h > 10 ? h : 10));
+}
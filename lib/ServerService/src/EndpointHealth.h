@@ -0,0 +1,37 @@
+#ifndef ENDPOINT_HEALTH_H
+#define ENDPOINT_HEALTH_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define HEALTH_SAMPLES      32      // p95 계산에 쓰는 최근 응답 지연 수
+#define HEALTH_EWMA_SHIFT   3       // EWMA 가중치 1/8
+#define HEALTH_MIN_SAMPLES  8       // 이보다 적으면 p95를 믿지 않음
+
+/**
+ * 엔드포인트 하나의 응답 지연 / 건강도 추적
+ * - 지연: 응답을 받은(또는 타임아웃까지 기다린) 호출의 EWMA와 최근 HEALTH_SAMPLES개의 p95.
+ * - 건강도: 성공 1000 / 실패 0 의 EWMA (0~1000). 연결 실패처럼 빨리 끝난 실패는 지연에 넣지 않고 건강도만 깎는다.
+ * - score()는 지연 ÷ 건강도로, 작을수록 먼저 고른다. 표본이 없으면 UINT32_MAX (목록 순서대로 고르게 됨).
+ * 여러 태스크가 함께 기록하므로 모두 원자 변수로 둔다.
+ */
+class EndpointHealth {
+public:
+    EndpointHealth();
+
+    void record(bool failed, bool hasLatency, uint32_t latencyMs);
+
+    uint32_t ewmaMs() const;              // 0 = 표본 없음
+    uint32_t p95Ms() const;               // 표본이 HEALTH_MIN_SAMPLES보다 적으면 0
+    uint32_t healthPct() const;
+    uint32_t samples() const { return count.load(std::memory_order_relaxed); }
+    uint32_t score() const;
+
+private:
+    std::atomic<uint32_t> ewmaX8;         // 지연 EWMA × 8 (0 = 표본 없음)
+    std::atomic<uint32_t> health;         // 0~1000
+    std::atomic<uint32_t> count;          // 지금까지 넣은 지연 표본 수 (다음 칸 = count % HEALTH_SAMPLES)
+    std::atomic<uint16_t> ring[HEALTH_SAMPLES];
+};
+
+#endif // ENDPOINT_HEALTH_H
@@ -0,0 +1,148 @@
+#include "EventStream.h"
+#include "TraceLog.h"
+
+namespace {
+
+const char EVENT_HEAD[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "\r\n";
+
+// 보내기 버퍼에 다 들어가지 않으면 실패 (기다리지 않음) → 호출한 쪽이 느린 소비자로 보고 끊는다
+bool writeAll(TcpConnection& client, const String& data) {
+    return client.tryWrite(reinterpret_cast<const uint8_t*>(data.c_str()), data.length()) == data.length();
+}
+
+} // namespace
+
+EventStream::EventStream(Clock& clock) : clock(&clock) {}
+
+// ========== 연결 ===========================================================================================
+bool EventStream::accept(std::unique_ptr<TcpConnection> client, const String& snapshot, const String& snapshotTag) {
+    if (!client || full()) {
+        ++counters.rejected;
+        if (client) client->stop();
+        return false;
+    }
+
+    String batch(EVENT_HEAD);
+    batch += "retry: ";
+    batch += EVENT_RETRY_MS;
+    batch += "\n\n";
+    append(batch, "status", snapshot, nextId++);
+    if (!writeAll(*client, batch)) {
+        client->stop();
+        ++counters.disconnects;
+        return false;
+    }
+
+    if (clientTotal == 0) statusTag = snapshotTag;          // 첫 연결이면 같은 상태를 곧바로 다시 보내지 않음
+    clients[clientTotal++] = std::move(client);
+    ++counters.accepted;
+    counters.bytes += batch.length();
+    wroteAt = clock->millis();
+    LOG_INFO("[EventStream][+] /events 연결 ({} / {})", static_cast<unsigned>(clientTotal),
+             static_cast<unsigned>(EVENT_MAX_CLIENTS));
+    return true;
+}
+
+void EventStream::drop(uint8_t index) {
+    clients[index]->stop();
+    clients[index] = std::move(clients[--clientTotal]);   // 순서는 상관없으므로 마지막 연결로 메움
+    ++counters.disconnects;
+    LOG_INFO("[EventStream][-] /events 연결 정리 (남은 연결 {})", static_cast<unsigned>(clientTotal));
+
+    if (clientTotal == 0) {                                // 받을 곳이 없으면 쌓아 둘 이유도 없음
+        count = 0;
+        statusQueued = false;
+        statusTag = String();
+    }
+}
+
+// ========== 이벤트 =========================================================================================
+void EventStream::publish(const char* type, const String& data) {
+    if (clientTotal == 0) return;
+    if (count == EVENT_QUEUE_SIZE) {                       // 가장 오래된 것을 버린다 (status가 곧 상태를 맞춤)
+        head = (head + 1) % EVENT_QUEUE_SIZE;
+        --count;
+        ++counters.dropped;
+    }
+    Pending& slot = queue[(head + count) % EVENT_QUEUE_SIZE];
+    slot.type = type;
+    slot.data = data;
+    slot.id = nextId++;
+    ++count;
+    ++counters.published;
+}
+
+bool EventStream::statusDue() const {
+    return clientTotal > 0 && clock->millis() - statusCheckedAt >= EVENT_STATUS_MIN_MS;
+}
+
+void EventStream::publishStatus(const String& data, const String& tag) {
+    statusCheckedAt = clock->millis();
+    if (clientTotal == 0 || tag == statusTag) return;
+    if (statusQueued) ++counters.coalesced;
+    status = data;
+    statusTag = tag;
+    statusId = nextId++;
+    statusQueued = true;
+    ++counters.published;
+}
+
+// EVENT_FLUSH_MS마다 모인 이벤트를 묶음 하나로 만들어 연결마다 한 번에 쓴다
+void EventStream::flush() {
+    if (clientTotal == 0) return;
+    const uint32_t now = clock->millis();
+    if (now - flushedAt < EVENT_FLUSH_MS) return;
+    flushedAt = now;
+
+    String batch;
+    for (; count > 0; --count) {
+        const Pending& event = queue[head];
+        append(batch, event.type, event.data, event.id);
+        head = (head + 1) % EVENT_QUEUE_SIZE;
+    }
+    if (statusQueued) {
+        append(batch, "status", status, statusId);
+        statusQueued = false;
+    }
+    if (batch.isEmpty() && now - wroteAt >= EVENT_HEARTBEAT_MS) batch = ": ping\n\n";   // EventSource는 주석을 무시
+
+    for (uint8_t i = clientTotal; i-- > 0;) {
+        if (!clients[i]->connected() || (!batch.isEmpty() && !writeAll(*clients[i], batch))) {
+            drop(i);
+            continue;
+        }
+        if (!batch.isEmpty()) counters.bytes += batch.length();
+    }
+    if (batch.isEmpty()) return;
+    ++counters.flushes;
+    wroteAt = now;
+}
+
+// 본문에 줄바꿈이 있으면 줄마다 data:로 나눈다 (받는 쪽이 다시 \n으로 이어 붙임)
+void EventStream::append(String& batch, const char* type, const String& data, uint32_t id) const {
+    batch += "event: ";
+    batch += type;
+    batch += "\nid: ";
+    batch += id;
+    int start = 0;
+    for (;;) {
+        const int end = data.indexOf('\n', start);
+        batch += "\ndata: ";
+        batch += end < 0 ? data.substring(start) : data.substring(start, end);
+        if (end < 0) break;
+        start = end + 1;
+    }
+    batch += "\n\n";
+}
+
+EventStreamStats EventStream::stats() const {
+    EventStreamStats s = counters;
+    s.clients = clientTotal;
+    return s;
+}
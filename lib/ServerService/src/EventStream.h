@@ -0,0 +1,88 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <memory>
+#include "Clock.h"
+#include "TcpTransport.h"
+
+#define EVENT_MAX_CLIENTS      3        // 동시에 열어 둘 수 있는 /events 연결 (넘으면 503)
+#define EVENT_QUEUE_SIZE       16       // 아직 내보내지 않은 이벤트 (넘치면 가장 오래된 것부터 버림)
+#define EVENT_FLUSH_MS         200      // 이벤트를 모아 연결마다 한 번에 쓰는 간격
+#define EVENT_STATUS_MIN_MS    5000     // status 이벤트(전체 상태)는 바뀌어도 이보다 자주 보내지 않음 (사건은 개별 이벤트로 바로 감)
+#define EVENT_HEARTBEAT_MS     15000    // 보낼 것이 없으면 이 간격으로 주석 줄을 써서 끊긴 연결을 찾음
+#define EVENT_RETRY_MS         3000     // 브라우저 EventSource의 재연결 대기 (retry:)
+
+struct EventStreamStats {
+    uint8_t clients = 0;              // 지금 열린 연결
+    uint32_t accepted = 0;            // 받아들인 연결
+    uint32_t rejected = 0;            // 가득 차 503으로 거절한 연결
+    uint32_t disconnects = 0;         // 쓰기 실패 / 상대가 끊어 정리한 연결
+    uint32_t published = 0;           // 큐에 넣은 이벤트 (status 포함)
+    uint32_t coalesced = 0;           // 내보내기 전에 새 status로 대체된 status
+    uint32_t dropped = 0;             // 큐가 넘쳐 버린 이벤트
+    uint32_t flushes = 0;             // 연결에 실제로 쓴 묶음 수 (하트비트 포함)
+    uint32_t bytes = 0;               // 모든 연결에 쓴 바이트 합계
+};
+
+/**
+ * Server-Sent Events 스트림 (/events)
+ * - 대시보드가 연결을 열어 두면 상태 변화와 피킹 이벤트를 바로 밀어 준다. 폴링 주기와 상관없이
+ *   사건이 있을 때만 쓰므로, 대시보드 부하는 사건 수에 비례하고 상한은 EVENT_MAX_CLIENTS로 막는다.
+ * - publish()는 큐에만 넣고, flush()가 EVENT_FLUSH_MS마다 모인 이벤트를 "event:/id:/data:" 묶음 하나로
+ *   연결마다 한 번에 쓴다 (작은 TCP 세그먼트를 여러 번 보내지 않음).
+ * - status는 최신 하나만 들고 있다가 보낸다 (내보내기 전에 들어온 새 status가 이전 것을 대체).
+ * - 쓰기는 기다리지 않는다(tryWrite). 묶음이 보내기 버퍼에 다 들어가지 않는 연결은 느린 소비자로 보고 끊는다
+ *   (멈춘 연결 하나가 WiFiClient의 쓰기 재시도로 loop와 RFID 스캔을 몇 초씩 붙잡지 않도록). 브라우저는 retry: 뒤에 다시 연결하고
+ *   처음에 받는 status로 상태를 맞춘다 (Last-Event-ID로 지난 이벤트를 다시 보내지는 않음).
+ * loop에서만 쓴다 (ServerService::handle / 핸들러 / main의 loop 함수들).
+ */
+class EventStream {
+public:
+    explicit EventStream(Clock& clock);
+
+    bool full() const { return clientTotal >= EVENT_MAX_CLIENTS; }
+    bool active() const { return clientTotal > 0; }
+    void reject() { ++counters.rejected; }
+
+    // 응답 헤더 + retry: + 현재 상태를 바로 쓰고 연결을 붙잡아 둔다. 가득 찼거나 쓰기에 실패하면 false
+    bool accept(std::unique_ptr<TcpConnection> client, const String& snapshot, const String& snapshotTag);
+
+    void publish(const char* type, const String& data);   // 연결이 없으면 버림
+    bool statusDue() const;                                 // 연결이 있고 EVENT_STATUS_MIN_MS가 지남
+    void publishStatus(const String& data, const String& tag);   // tag(ETag)가 지난번과 같으면 보내지 않음
+    void flush();
+
+    EventStreamStats stats() const;
+
+private:
+    struct Pending {
+        const char* type = "";
+        String data;
+        uint32_t id = 0;
+    };
+
+    void append(String& batch, const char* type, const String& data, uint32_t id) const;
+    void drop(uint8_t index);
+
+    Clock* clock;
+    std::unique_ptr<TcpConnection> clients[EVENT_MAX_CLIENTS];
+    uint8_t clientTotal = 0;
+
+    Pending queue[EVENT_QUEUE_SIZE];
+    uint8_t head = 0;
+    uint8_t count = 0;
+    uint32_t nextId = 1;
+
+    String status;                    // 아직 내보내지 않은 최신 status (statusQueued일 때)
+    String statusTag;                 // 마지막으로 큐에 넣은 status의 ETag
+    uint32_t statusId = 0;
+    bool statusQueued = false;
+    uint32_t statusCheckedAt = 0;
+
+    uint32_t flushedAt = 0;
+    uint32_t wroteAt = 0;
+    EventStreamStats counters;
+};
+
+#endif // EVENT_STREAM_H
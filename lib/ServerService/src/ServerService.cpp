@@ -1,14 +1,57 @@
 #include <functional>
+#include <stdlib.h>
+#include <strings.h>
 #include <WString.h>
 #include "ServerService.h"
 #include "Config.h"
+#include "Platform.h"
 
-#include <Preferences.h>
-extern Preferences prefs;
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+#endif
+
+namespace {
+
+// 열어 둔 연결 슬롯은 loop / 프리페치 / 보관함 태스크가 함께 쓴다 (포인터만 옮기므로 짧은 임계 구역)
+#if defined(ESP32)
+portMUX_TYPE poolMux = portMUX_INITIALIZER_UNLOCKED;
+  #define POOL_LOCK()   portENTER_CRITICAL(&poolMux)
+  #define POOL_UNLOCK() portEXIT_CRITICAL(&poolMux)
+#else
+  #define POOL_LOCK()   noInterrupts()
+  #define POOL_UNLOCK() interrupts()
+#endif
+
+// Transfer-Encoding의 마지막 코딩이 chunked (keep-alive 응답에서 Content-Length 대신 쓰임)
+bool isChunked(const String& response) {
+    String coding = ServerService::extractHeader(response, "Transfer-Encoding");
+    coding.toLowerCase();
+    return coding.endsWith("chunked");
+}
+
+// pos(본문 시작)부터 크기 줄 + 데이터 + CRLF를 건너뛰어 마지막 청크(크기 0)와 트레일러 끝까지의 길이.
+// 덜 왔으면 0, 크기 줄이 16진수가 아니면 -1
+int chunkedEnd(const String& response, int pos) {
+    while (true) {
+        const int lineEnd = response.indexOf("\r\n", pos);
+        if (lineEnd == -1) return 0;
+        char* digitsEnd = nullptr;
+        const long size = strtol(response.c_str() + pos, &digitsEnd, 16);
+        if (digitsEnd == response.c_str() + pos || size < 0) return -1;
+        if (size == 0) {
+            const int end = response.indexOf("\r\n\r\n", lineEnd);   // 트레일러가 없으면 바로 빈 줄
+            return end == -1 ? 0 : end + 4;
+        }
+        pos = lineEnd + 2 + size + 2;
+        if (pos > static_cast<int>(response.length())) return 0;
+    }
+}
+
+} // namespace
 
 // ========== 생성자: 포인터 생성 ==========================================================================
-ServerService::ServerService(const int serverPort)
-    : serverPort(serverPort)
+ServerService::ServerService(const int serverPort, TcpTransport& transport, Clock& clock)
+    : serverPort(serverPort), transport(&transport), clock(&clock), events(clock), commands(clock), admission(clock)
 {
     server = new WebServer(serverPort);
 }
@@ -23,108 +66,554 @@ ServerService::~ServerService() {
 
 // ========== 서버 시작: 라우팅 등록 및 시작 ================================================================
 void ServerService::begin() {
+    // WebServer는 등록한 요청 헤더만 보관한다 (내용 협상 / 조건부 요청 / WebSocket 업그레이드)
+    static const char* collected[] = {"Accept", "If-None-Match", "Upgrade", "Sec-WebSocket-Key", "Sec-WebSocket-Version"};
+    server->collectHeaders(collected, sizeof(collected) / sizeof(collected[0]));
+    commands.setDispatcher([this](const String& command, HandlerReply& reply) { return dispatchCommand(command, reply); });
     setupRoutes();
     server->begin();
     Serial.println("[ServerService][1/2] TraceGo의 내장 HTTP 서버가 시작되었습니다.");
 }
 
+// 요청은 예산 / RFID 스캔 마감 / HTTP_QUEUE_MAX 안에서만 이어서 받는다 (첫 요청은 항상 받고, 넘긴 시간은 빚으로 남김)
 void ServerService::handle() {
-    server->handleClient();
+    admission.beginIteration();
+    uint8_t served = 0;
+    do {
+        const uint32_t before = admission.served();
+        server->handleClient();
+        if (admission.served() == before) break;   // 기다리는 요청 없음
+    } while (admission.keepServing(++served));
+
+    if (statusHandler && events.statusDue()) {
+        const CachedReply reply = statusHandler(WireFormat::Json);   // 캐시가 그대로면 ETag도 그대로라 보내지 않음
+        events.publishStatus(*reply.body, *reply.etag);
+    }
+    events.flush();
+    commands.poll();
+    admission.endIteration();
+}
+
+// 일반 요청(페이지 / 상태 / 설정) 수락. 미루면 여기서 503 + Retry-After로 답한다
+bool ServerService::admitGeneral() {
+    if (admission.admit(false)) return true;
+    server->sendHeader("Access-Control-Allow-Origin", "*");
+    server->sendHeader("Retry-After", String(HTTP_RETRY_SEC));
+    server->send(503, "application/json", "{\"message\":\"RFID 스캔 중이라 잠시 뒤에 다시 요청하세요\"}");
+    return false;
 }
 
 // ========== 핸들러 등록 ====================================================================================
-void ServerService::setStartHandler(const std::function<void()> &handler) { startHandler = handler; }            // 카트 조작
-void ServerService::setGoHandler(const std::function<void()> &handler)    { goHandler = handler; }               // 카트 조작
-void ServerService::setStopHandler(const std::function<void()> &handler)  { stopHandler = handler; }             // 카트 조작
-void ServerService::setResetHandler(const std::function<void()> &handler) { resetHandler = handler; }            // 카트 조작
+void ServerService::setStartHandler(const std::function<HandlerReply()> &handler) { startHandler = handler; }    // 카트 조작
+void ServerService::setGoHandler(const std::function<HandlerReply()> &handler)    { goHandler = handler; }       // 카트 조작
+void ServerService::setStopHandler(const std::function<HandlerReply()> &handler)  { stopHandler = handler; }     // 카트 조작
+void ServerService::setResetHandler(const std::function<HandlerReply()> &handler) { resetHandler = handler; }    // 카트 조작
 void ServerService::setPostHandler(const std::function<void(const String&)> &handler) { postHandler = handler; } // 카트 조작
 
 // 설정 페이지 조작
 void ServerService::setResetConfigHandler(const std::function<void()> &handler) { resetConfigHandler = handler; }
-void ServerService::setStatusHandler(const std::function<String(void)> &handler) { statusHandler = handler; }
+void ServerService::setStatusHandler(const std::function<CachedReply(WireFormat)> &handler) { statusHandler = handler; }
 void ServerService::setMainPageHandler(std::function<String(void)> handler) { mainPageHandler = handler; }
 void ServerService::setUpdateConfigHandler(std::function<String(String)> handler) { updateConfigHandler = handler; }
 void ServerService::setAdvancedPageHandler(std::function<String(void)> handler) { advancedPageHandler = handler; }
 void ServerService::setStatusViewHandler(std::function<String(void)> handler) { statusViewHandler = handler; }
 // ========== GET/POST 요청 전송 =============================================================================
-String ServerService::sendGETRequest(const char* host, const uint16_t port, const String& pathWithParams) {
-    String response = "";
-    WiFiClient client;
-    if (client.connect(host, port)) {
-        client.print(String("GET ") + pathWithParams + " HTTP/1.1\r\n" +
-                     "Host: " + host + "\r\n" +
-                     "Connection: close\r\n\r\n");
-
-        unsigned long timeout = millis() + 3000;
-        while (client.connected() && millis() < timeout) {
-            while (client.available()) {
-                response += (char)client.read();
+String ServerService::sendGETRequest(const char* host, const uint16_t port, const String& pathWithParams,
+                                     const String& extraHeaders, bool idempotent) {
+    return exchange(host, port, String("GET ") + pathWithParams + " HTTP/1.1\r\n", extraHeaders, "", idempotent);
+}
+
+String ServerService::sendPostRequest(const char* host, uint16_t port, const String& path, const JsonDocument& jsonDoc) {
+    String jsonString;
+    serializeJson(jsonDoc, jsonString);
+    return exchange(host, port, String("POST ") + path + " HTTP/1.1\r\n",
+                    String("Content-Type: application/json\r\n") +
+                    "Content-Length: " + jsonString.length() + "\r\n",
+                    jsonString, false);
+}
+
+// ========== 엔드포인트 선택 / 헤지 요청 =====================================================================
+// 진행 중인 요청 하나 (주 요청 또는 헤지 요청)
+struct ServerService::Attempt {
+    int endpoint = -1;
+    CircuitBreaker::Admission admission = CircuitBreaker::Rejected;
+    std::unique_ptr<TcpConnection> client;
+    String response;
+    int expected = 0;                           // expectedLength() 결과 (0 = 헤더 대기)
+    uint32_t startedAt = 0;
+    bool reused = false;                        // keep-alive 연결을 다시 씀
+    bool active = false;
+};
+
+// 묶음에 등록된 엔드포인트면 가장 좋은 곳부터 보내고, 응답이 p95보다 늦으면(다시 보내도 되는 요청만) 다음 곳에 헤지 요청을 보낸다.
+// 먼저 5xx가 아닌 응답을 준 쪽을 쓰고 나머지는 끊는다. 응답을 Content-Length / 마지막 청크까지 다 읽은 연결은 닫지 않고 다음 요청에 쓴다.
+// 등록되지 않은 주소는 예전처럼 한 번만 보내고 닫는다.
+String ServerService::exchange(const char* host, uint16_t port, const String& head, const String& headers,
+                               const String& body, bool idempotent) {
+    const int first = findEndpoint(host, port);
+    if (first < 0) {
+        String response = "";
+        std::unique_ptr<TcpConnection> client = transport->connect(host, port);
+        if (client) {
+            client->print(head + "Host: " + host + "\r\n" + headers + "Connection: close\r\n\r\n" + body);
+            unsigned long timeout = clock->millis() + SERVER_TIMEOUT_MS;
+            while ((client->connected() || client->available()) && clock->millis() < timeout) {
+                while (client->available()) {
+                    response += (char)client->read();
+                }
             }
+            client->stop();
         }
-        client.stop();
+        decodeChunked(response);
+        return response;
     }
-    return response;
-}
 
-String ServerService::sendPostRequest(const char* host, uint16_t port, const String& path, const JsonDocument& jsonDoc) {
-    String response = "";
-    WiFiClient client;
-    if (client.connect(host, port)) {
-        String jsonString;
-        serializeJson(jsonDoc, jsonString);
-
-        client.print(String("POST ") + path + " HTTP/1.1\r\n" +
-                     "Host: " + host + "\r\n" +
-                     "Content-Type: application/json\r\n" +
-                     "Content-Length: " + jsonString.length() + "\r\n\r\n" +
-                     jsonString);
-
-        while (client.connected() || client.available()) {
-            if (client.available()) {
-                response += client.readStringUntil('\n');
+    const String request = headers + "Connection: keep-alive\r\n\r\n" + body;   // 요청줄 + Host 뒤에 붙음
+    const uint8_t group = endpoints[first].group;
+    const uint32_t startedAt = clock->millis();
+    Attempt attempts[2];                        // 0 = 주 요청, 1 = 헤지 요청
+    uint32_t tried = 0;
+    if (!launch(group, tried, head, request, attempts[0])) {
+        if (requestObserver) requestObserver(endpoints[group].breaker.name(), clock->millis() - startedAt, -1);
+        return "";
+    }
+    endpoints[attempts[0].endpoint].selected.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t hedgeAfter = UINT32_MAX;
+    if (idempotent) {
+        const uint32_t p95 = endpoints[attempts[0].endpoint].health.p95Ms();
+        hedgeAfter = p95 == 0 ? SERVER_HEDGE_DEFAULT_MS
+                   : p95 < SERVER_HEDGE_MIN_MS ? SERVER_HEDGE_MIN_MS
+                   : p95 > SERVER_HEDGE_MAX_MS ? SERVER_HEDGE_MAX_MS : p95;
+    }
+
+    int winner = -1;
+    int lastFinished = 0;
+    bool hedged = false;
+    while (clock->millis() - startedAt < SERVER_TIMEOUT_MS) {
+        bool anyActive = false;
+        for (int i = 0; i < 2 && winner < 0; ++i) {
+            Attempt& a = attempts[i];
+            if (!a.active) continue;
+            while (a.client->available()) {
+                a.response += (char)a.client->read();
+            }
+            if (a.expected == 0) a.expected = expectedLength(a.response);
+            const bool complete = a.expected > 0 && static_cast<int>(a.response.length()) >= a.expected;
+            if (!complete && (a.client->connected() || a.client->available())) {
+                anyActive = true;
+                continue;
+            }
+            // 재사용한 연결을 서버가 먼저 닫았으면(받은 것이 없음) 요청이 처리되지 않은 것이므로 새 연결로 다시 보낸다
+            if (!complete && a.reused && a.response.isEmpty() && start(a.endpoint, head, request, false, a)) {
+                anyActive = true;
+                continue;
+            }
+
+            // 응답 끝 (다 읽었거나 서버가 연결을 닫음)
+            a.active = false;
+            lastFinished = i;
+            const int status = parseStatusCode(a.response);
+            const uint32_t latency = clock->millis() - a.startedAt;
+            Endpoint& e = endpoints[a.endpoint];
+            if (complete) decodeChunked(a.response);
+            if (complete && !extractHeader(a.response, "Connection").equalsIgnoreCase("close")) {
+                keepAlive(e, std::move(a.client));
+            } else {
+                a.client->stop();
+            }
+            e.breaker.record(a.admission, status, latency);
+            e.health.record(CircuitBreaker::isFailure(status, latency), status > 0, latency);
+            if (status > 0 && status < 500) {
+                winner = i;
+            } else if (idempotent && !hedged && launch(group, tried, head, request, attempts[1])) {
+                hedged = true;                  // 실패 응답이면 기다리지 않고 다음 엔드포인트로
+                endpoints[attempts[1].endpoint].hedges.fetch_add(1, std::memory_order_relaxed);
+                anyActive = true;
+            }
+        }
+        if (winner >= 0 || !anyActive) break;
+
+        if (!hedged && clock->millis() - attempts[0].startedAt >= hedgeAfter) {
+            hedged = true;
+            if (launch(group, tried, head, request, attempts[1])) {
+                endpoints[attempts[1].endpoint].hedges.fetch_add(1, std::memory_order_relaxed);
             }
         }
-        client.stop();
     }
-    return response;
+
+    // 이긴 쪽이 있으면 나머지는 결과를 모른 채 끊고, 시간이 다 됐으면 남은 요청을 모두 실패로 기록한다
+    for (Attempt& a : attempts) {
+        if (!a.active) continue;
+        a.client->stop();
+        Endpoint& e = endpoints[a.endpoint];
+        if (winner >= 0) {
+            e.breaker.cancel(a.admission);
+        } else {
+            const uint32_t latency = clock->millis() - a.startedAt;
+            e.breaker.record(a.admission, -1, latency);
+            e.health.record(true, true, latency);
+        }
+    }
+    if (winner == 1) endpoints[attempts[1].endpoint].hedgeWins.fetch_add(1, std::memory_order_relaxed);
+
+    const Attempt& result = attempts[winner >= 0 ? winner : lastFinished];
+    if (requestObserver) {
+        requestObserver(endpoints[group].breaker.name(), clock->millis() - startedAt, parseStatusCode(result.response));
+    }
+    return result.response;
+}
+
+// 아직 시도하지 않은 엔드포인트 중 가장 좋은 곳에 요청을 보낸다. 연결이 안 되면 (보낸 것이 없으므로) 다음 곳으로
+bool ServerService::launch(uint8_t group, uint32_t& tried, const String& head, const String& request, Attempt& attempt) {
+    for (int index = pickEndpoint(group, tried); index >= 0; index = pickEndpoint(group, tried)) {
+        tried |= 1u << index;
+        Endpoint& e = endpoints[index];
+        const CircuitBreaker::Admission admission = e.breaker.allow();
+        if (admission == CircuitBreaker::Rejected) continue;
+
+        attempt.admission = admission;
+        attempt.startedAt = clock->millis();
+        if (start(index, head, request, true, attempt)) return true;
+
+        const uint32_t latency = clock->millis() - attempt.startedAt;
+        e.breaker.record(admission, -1, latency);
+        e.health.record(true, latency >= BREAKER_SLOW_CALL_MS, latency);
+    }
+    return false;
+}
+
+// 엔드포인트 하나에 연결(열어 둔 연결이 있으면 재사용)하고 요청을 쓴다. admission / startedAt은 부른 쪽이 정한다
+bool ServerService::start(int index, const String& head, const String& request, bool allowReuse, Attempt& attempt) {
+    Endpoint& e = endpoints[index];
+    std::unique_ptr<TcpConnection> client;
+    if (allowReuse) {
+        POOL_LOCK();
+        if (e.idle && clock->millis() - e.idleSince < SERVER_KEEPALIVE_MS) client = std::move(e.idle);
+        std::unique_ptr<TcpConnection> expired = std::move(e.idle);
+        POOL_UNLOCK();
+        if (expired) expired->stop();
+        if (client && !client->connected()) {
+            client->stop();
+            client.reset();
+        }
+    }
+
+    attempt.reused = client != nullptr;
+    if (client) {
+        e.reuses.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        const String& host = e.breaker.endpointHost();
+        client = e.secure ? transport->connectSecure(host.c_str(), e.breaker.endpointPort())
+                          : transport->connect(host.c_str(), e.breaker.endpointPort());
+        if (!client) return false;
+        e.connects.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    client->print(head + "Host: " + e.breaker.endpointHost() + "\r\n" + request);
+    attempt.endpoint = index;
+    attempt.client = std::move(client);
+    attempt.response = "";
+    attempt.expected = 0;
+    attempt.active = true;
+    return true;
+}
+
+// 응답을 다 읽은 연결을 엔드포인트에 하나 남겨 둔다 (이미 있으면 오래된 쪽을 닫음)
+void ServerService::keepAlive(Endpoint& endpoint, std::unique_ptr<TcpConnection> client) {
+    POOL_LOCK();
+    std::swap(endpoint.idle, client);
+    endpoint.idleSince = clock->millis();
+    POOL_UNLOCK();
+    if (client) client->stop();
+}
+
+// 서킷 브레이커가 보낼 수 있다고 하는 엔드포인트 중 점수(지연 ÷ 건강도)가 가장 작은 곳. 같으면 등록 순서
+int ServerService::pickEndpoint(uint8_t group, uint32_t tried) const {
+    int best = -1;
+    uint32_t bestScore = 0;
+    for (uint8_t i = group; i < endpointTotal; ++i) {
+        if (endpoints[i].group != group || (tried & (1u << i)) || !endpoints[i].breaker.ready()) continue;
+        const uint32_t score = endpoints[i].health.score();
+        if (best < 0 || score < bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// ========== 엔드포인트 등록 / 조회 ==========================================================================
+bool ServerService::watchEndpoint(const char* name, const String& host, uint16_t port, bool secure) {
+    if (findEndpoint(host.c_str(), port) >= 0) return true;
+    if (endpointTotal >= SERVER_MAX_ENDPOINTS) return false;
+
+    Endpoint& e = endpoints[endpointTotal];
+    e.breaker.setup(name, host, port, *clock);
+    e.secure = secure;
+    e.group = endpointTotal;
+    for (uint8_t i = 0; i < endpointTotal; ++i) {
+        if (strcmp(endpoints[i].breaker.name(), name) == 0) {
+            e.group = endpoints[i].group;
+            break;
+        }
+    }
+    ++endpointTotal;
+    return true;
+}
+
+bool ServerService::endpointAvailable(const char* host, uint16_t port) {
+    const int index = findEndpoint(host, port);
+    return index < 0 || pickEndpoint(endpoints[index].group, 0) >= 0;
+}
+
+EndpointStats ServerService::endpointStats(uint8_t index) const {
+    const Endpoint& e = endpoints[index];
+    EndpointStats s;
+    s.host = e.breaker.endpointHost();
+    s.breaker = e.breaker.stats();
+    s.ewmaMs = e.health.ewmaMs();
+    s.p95Ms = e.health.p95Ms();
+    s.healthPct = e.health.healthPct();
+    s.selected = e.selected.load(std::memory_order_relaxed);
+    s.hedges = e.hedges.load(std::memory_order_relaxed);
+    s.hedgeWins = e.hedgeWins.load(std::memory_order_relaxed);
+    s.secure = e.secure;
+    s.connects = e.connects.load(std::memory_order_relaxed);
+    s.reuses = e.reuses.load(std::memory_order_relaxed);
+    return s;
+}
+
+int ServerService::findEndpoint(const char* host, uint16_t port) const {
+    for (uint8_t i = 0; i < endpointTotal; ++i) {
+        if (endpoints[i].breaker.matches(host, port)) return i;
+    }
+    return -1;
+}
+
+// ========== HTTP 응답 파싱 =================================================================================
+// 상태줄("HTTP/1.1 200 OK")에서 상태 코드를 꺼낸다. 응답이 없거나 형식이 다르면 -1
+int ServerService::parseStatusCode(const String& response) {
+    if (!response.startsWith("HTTP/")) return -1;
+    int space = response.indexOf(' ');
+    if (space == -1) return -1;
+    return response.substring(space + 1, space + 4).toInt();
+}
+
+// 헤더와 본문을 구분하는 빈 줄 이후를 반환한다. 구분자가 없으면 빈 문자열
+String ServerService::extractBody(const String& response) {
+    int headerEnd = response.indexOf("\r\n\r\n");
+    if (headerEnd == -1) return "";
+    return response.substring(headerEnd + 4);
+}
+
+// 헤더 블록에서 이름이 같은(대소문자 무시) 첫 헤더 값을 앞뒤 공백 없이 반환한다
+String ServerService::extractHeader(const String& response, const char* name) {
+    int headerEnd = response.indexOf("\r\n\r\n");
+    if (headerEnd == -1) return "";
+
+    const size_t nameLength = strlen(name);
+    int lineStart = response.indexOf("\r\n");   // 상태줄 건너뜀
+    while (lineStart != -1 && lineStart < headerEnd) {
+        lineStart += 2;
+        int lineEnd = response.indexOf("\r\n", lineStart);
+        if (lineEnd == -1) lineEnd = headerEnd;
+
+        const int colon = response.indexOf(':', lineStart);
+        if (colon != -1 && colon < lineEnd && static_cast<size_t>(colon - lineStart) == nameLength &&
+            strncasecmp(response.c_str() + lineStart, name, nameLength) == 0) {
+            String value = response.substring(colon + 1, lineEnd);
+            value.trim();
+            return value;
+        }
+        lineStart = lineEnd;
+    }
+    return "";
+}
+
+// 상태줄 + 헤더가 다 왔으면 응답 전체 길이. 본문이 없는 상태(1xx/204/304)는 헤더까지,
+// 청크 본문이면 마지막 청크까지 왔을 때의 길이(덜 왔으면 0), 둘 다 없으면(닫힐 때까지 본문) -1이라 연결을 재사용하지 않는다
+int ServerService::expectedLength(const String& response) {
+    const int headerEnd = response.indexOf("\r\n\r\n");
+    if (headerEnd == -1) return 0;
+    const int status = parseStatusCode(response);
+    if ((status >= 100 && status < 200) || status == 204 || status == 304) return headerEnd + 4;
+    if (isChunked(response)) return chunkedEnd(response, headerEnd + 4);
+    const String length = extractHeader(response, "Content-Length");
+    if (length.isEmpty()) return -1;
+    return headerEnd + 4 + length.toInt();
+}
+
+// 청크 본문을 이어 붙이고 Transfer-Encoding 줄을 Content-Length로 바꾼다 (청크가 아니면 그대로).
+// 부르는 쪽의 extractBody / expectedLength가 일반 응답과 똑같이 동작한다
+void ServerService::decodeChunked(String& response) {
+    const int headerEnd = response.indexOf("\r\n\r\n");
+    if (headerEnd == -1 || !isChunked(response)) return;
+
+    String body;
+    int pos = headerEnd + 4;
+    while (true) {
+        const int lineEnd = response.indexOf("\r\n", pos);
+        if (lineEnd == -1) break;
+        const long size = strtol(response.c_str() + pos, nullptr, 16);
+        if (size <= 0 || lineEnd + 2 + size > static_cast<long>(response.length())) break;
+        body += response.substring(lineEnd + 2, lineEnd + 2 + size);
+        pos = lineEnd + 2 + size + 2;
+    }
+
+    int lineStart = response.indexOf("\r\n") + 2;      // 상태줄 뒤
+    String decoded = response.substring(0, lineStart);
+    while (lineStart < headerEnd) {
+        const int lineEnd = response.indexOf("\r\n", lineStart);
+        if (strncasecmp(response.c_str() + lineStart, "Transfer-Encoding:", 18) != 0) {
+            decoded += response.substring(lineStart, lineEnd + 2);
+        }
+        lineStart = lineEnd + 2;
+    }
+    decoded += String("Content-Length: ") + static_cast<unsigned int>(body.length()) + "\r\n\r\n" + body;
+    response = decoded;
+}
+
+// ========== 내용 협상 =====================================================================================
+// "application/msgpack, application/json;q=0.5" 같은 목록을 항목별로 본다. JSON의 q는 가장 구체적인 항목
+// (application/json > application/* > */*)을 따르고, 아무것도 없으면 1로 친다. 같으면 작은 쪽(MessagePack)을 고른다
+WireFormat ServerService::negotiate(const String& accept) {
+    int msgpackQ = -1;                            // 1000분율, -1 = 목록에 없음
+    int jsonQ[3] = {-1, -1, -1};                  // application/json, application/*, */*
+
+    int start = 0;
+    while (start < static_cast<int>(accept.length())) {
+        int end = accept.indexOf(',', start);
+        if (end == -1) end = accept.length();
+        String item = accept.substring(start, end);
+        start = end + 1;
+
+        int q = 1000;
+        const int semi = item.indexOf(';');
+        String type = semi == -1 ? item : item.substring(0, semi);
+        if (semi != -1) {
+            const int qAt = item.indexOf("q=", semi);
+            if (qAt != -1) q = static_cast<int>(item.substring(qAt + 2).toFloat() * 1000 + 0.5f);
+        }
+        type.trim();
+        type.toLowerCase();
+
+        if (type == "application/msgpack" || type == "application/x-msgpack") msgpackQ = q;
+        else if (type == "application/json") jsonQ[0] = q;
+        else if (type == "application/*")    jsonQ[1] = q;
+        else if (type == "*/*")              jsonQ[2] = q;
+    }
+
+    int json = 1000;
+    for (int q : jsonQ) {
+        if (q >= 0) {
+            json = q;
+            break;
+        }
+    }
+    return msgpackQ > 0 && msgpackQ >= json ? WireFormat::MsgPack : WireFormat::Json;
+}
+
+const char* ServerService::contentType(WireFormat format) {
+    return format == WireFormat::MsgPack ? "application/msgpack" : "application/json";
+}
+
+// 약한 비교 (RFC 9110 13.1.2): 목록 중 하나가 W/를 뗀 뒤 같으면 일치
+bool ServerService::etagMatches(const String& ifNoneMatch, const String& etag) {
+    if (ifNoneMatch.isEmpty() || etag.isEmpty()) return false;
+    int start = 0;
+    while (start < static_cast<int>(ifNoneMatch.length())) {
+        int end = ifNoneMatch.indexOf(',', start);
+        if (end == -1) end = ifNoneMatch.length();
+        String tag = ifNoneMatch.substring(start, end);
+        start = end + 1;
+        tag.trim();
+        if (tag.startsWith("W/")) tag.remove(0, 2);
+        if (tag == "*" || tag == etag) return true;
+    }
+    return false;
+}
+
+// ========== /ws 명령 → 핸들러 ===============================================================================
+bool ServerService::dispatchCommand(const String& command, HandlerReply& reply) {
+    const std::function<HandlerReply()>* handler = nullptr;
+    if (command == "start")      handler = &startHandler;
+    else if (command == "go")    handler = &goHandler;
+    else if (command == "stop")  handler = &stopHandler;
+    else if (command == "reset") handler = &resetHandler;
+    if (!handler || !*handler) return false;
+    reply = (*handler)();
+    return true;
 }
 
 // ========== 라우팅 등록 =====================================================================================
 void ServerService::setupRoutes() {
     if (startHandler) {
         server->on("/start", HTTP_GET, [this]() {
-            startHandler();
+            admission.admit(true);
+            const HandlerReply reply = startHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
-            server->send(200, "application/json", "{\"message\":\"Handled GET /start\"}");
+            server->send(reply.code, "application/json",
+                         reply.body.isEmpty() ? String("{\"message\":\"Handled GET /start\"}") : reply.body);
         });
     }
 
     if (goHandler) {
         server->on("/go", HTTP_GET, [this]() {
-            goHandler();
+            admission.admit(true);
+            const HandlerReply reply = goHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
-            server->send(200, "application/json", "{\"message\":\"Handled GET /go\"}");
+            server->send(reply.code, "application/json",
+                         reply.body.isEmpty() ? String("{\"message\":\"Handled GET /go\"}") : reply.body);
         });
     }
 
     if (stopHandler) {
         server->on("/stop", HTTP_GET, [this]() {
-            stopHandler();
+            admission.admit(true);
+            const HandlerReply reply = stopHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
-            server->send(200, "application/json", "{\"message\":\"Handled GET /stop\"}");
+            server->send(reply.code, "application/json",
+                         reply.body.isEmpty() ? String("{\"message\":\"Handled GET /stop\"}") : reply.body);
         });
     }
 
     if (resetHandler) {
         server->on("/reset", HTTP_GET, [this]() {
-            resetHandler();
+            admission.admit(true);
+            const HandlerReply reply = resetHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
-            server->send(200, "application/json", "{\"message\":\"Handled GET /reset\"}");
+            server->send(reply.code, "application/json",
+                         reply.body.isEmpty() ? String("{\"message\":\"Handled GET /reset\"}") : reply.body);
         });
     }
     
+    // 제어 명령 채널: 업그레이드 요청이면 101로 답하고 연결을 넘겨받는다 (이후 프레임은 handle()에서)
+    if (startHandler || goHandler || stopHandler || resetHandler) {
+        server->on("/ws", HTTP_GET, [this]() {
+            admission.admit(true);
+            const String key = server->header("Sec-WebSocket-Key");
+            if (!server->header("Upgrade").equalsIgnoreCase("websocket") || key.isEmpty() ||
+                server->header("Sec-WebSocket-Version") != "13") {
+                server->sendHeader("Access-Control-Allow-Origin", "*");
+                server->sendHeader("Sec-WebSocket-Version", "13");
+                server->send(426, "application/json", "{\"message\":\"WebSocket 업그레이드 요청이 아닙니다\"}");
+                return;
+            }
+            if (commands.full()) {
+                commands.reject();
+                server->sendHeader("Access-Control-Allow-Origin", "*");
+                server->sendHeader("Retry-After", String(COMMAND_RETRY_SEC));
+                server->send(503, "application/json", "{\"message\":\"명령 채널 연결이 가득 찼습니다\"}");
+                return;
+            }
+            commands.accept(hal::adoptClient(*server), key);
+        });
+    }
+
     if (postHandler) {
         server->on("/post", HTTP_POST, [this]() {
+            if (!admitGeneral()) return;
             String body = server->arg("plain");
             postHandler(body);
             server->sendHeader("Access-Control-Allow-Origin", "*");
@@ -134,25 +623,51 @@ void ServerService::setupRoutes() {
 
     if (statusHandler) {
         server->on("/status", HTTP_GET, [this]() {
-            String json = statusHandler();
+            if (!admitGeneral()) return;
+            const WireFormat format = negotiate(server->header("Accept"));
+            const CachedReply reply = statusHandler(format);
             server->sendHeader("Access-Control-Allow-Origin", "*");
-            server->send(200, "application/json", json);
+            server->sendHeader("Vary", "Accept");       // 같은 주소가 Accept에 따라 다른 형식을 돌려줌 (캐시 구분)
+            server->sendHeader("Cache-Control", "no-cache");   // 저장은 하되 매번 ETag로 다시 확인
+            if (reply.etag) server->sendHeader("ETag", *reply.etag);
+            if (reply.etag && etagMatches(server->header("If-None-Match"), *reply.etag)) {
+                ++statusNotModified;
+                server->send(304);
+                return;
+            }
+            server->send(200, contentType(format), *reply.body);   // 캐시 버퍼를 그대로 씀 (send가 복사하지 않음)
+        });
+
+        // 대시보드 푸시: 응답을 끝내지 않고 연결을 넘겨받아 EventStream이 계속 쓴다
+        server->on("/events", HTTP_GET, [this]() {
+            if (!admitGeneral()) return;
+            if (events.full()) {
+                events.reject();
+                server->sendHeader("Access-Control-Allow-Origin", "*");
+                server->sendHeader("Retry-After", String(EVENT_RETRY_MS / 1000));
+                server->send(503, "application/json", "{\"message\":\"이벤트 연결이 가득 찼습니다\"}");
+                return;
+            }
+            const CachedReply snapshot = statusHandler(WireFormat::Json);
+            events.accept(hal::adoptClient(*server), *snapshot.body, *snapshot.etag);
         });
     }
 
     if (resetConfigHandler) {
         server->on("/reset-config", HTTP_GET, [this]() {
+            if (!admitGeneral()) return;
             resetConfigHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
             server->send(200, "application/json", "{\"message\":\"설정 초기화됨. 재시작합니다.\"}");
             delay(1000);
-            ESP.restart();
+            hal::restart();
         });
     }
 
 
     if (mainPageHandler) {
         server->on("/", HTTP_GET, [this]() {
+            if (!admitGeneral()) return;
             String html = mainPageHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
             server->send(200, "text/html; charset=utf-8", html);
@@ -161,6 +676,7 @@ void ServerService::setupRoutes() {
 
     if (advancedPageHandler) {
         server->on("/advanced", HTTP_GET, [this]() {
+            if (!admitGeneral()) return;
             String html = advancedPageHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
             server->send(200, "text/html; charset=utf-8", html);
@@ -169,17 +685,19 @@ void ServerService::setupRoutes() {
 
     if (updateConfigHandler) {
     server->on("/update-config", HTTP_POST, [this]() {
+        if (!admitGeneral()) return;
         String body = server->arg("plain");
         String result = updateConfigHandler(body);  // ← 여기서 전달
         server->sendHeader("Access-Control-Allow-Origin", "*");
         server->send(200, "application/json", result);
         delay(3000);
-        ESP.restart();
+        hal::restart();
     });
 }
 
     if (statusViewHandler) {
         server->on("/status-view", HTTP_GET, [this]() {
+            if (!admitGeneral()) return;
             String html = statusViewHandler();
             server->sendHeader("Access-Control-Allow-Origin", "*");
             server->send(200, "text/html; charset=utf-8", html);
@@ -476,7 +994,7 @@ void ServerService::setupRoutes() {
         html.replace("%USE_RFID%", config.useRFID ? "checked" : "");
         html.replace("%COMM_RX%", String(config.commRxPin));
         html.replace("%COMM_TX%", String(config.commTxPin));
-        html.replace("%RC_SDA%", String(config.rcSdaPin));
+        html.replace("%RC_SDA%", String(config.rcSdaPins[0]));
         html.replace("%RC_RST%", String(config.rcRstPin));
         html.replace("%BAUDRATE%", String(config.serialBaudrate));
         html.replace("%BAUDRATE2%", String(config.serial2Baudrate));
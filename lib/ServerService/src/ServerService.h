@@ -4,8 +4,50 @@
 #include <WiFi.h>
 #include <WebServer.h>
 #include <ArduinoJson.h>
+#include <atomic>
 #include <functional>
 #include <WString.h>
+#include "Clock.h"
+#include "TcpTransport.h"
+#include "AdmissionControl.h"
+#include "CircuitBreaker.h"
+#include "CommandChannel.h"
+#include "EndpointHealth.h"
+#include "EventStream.h"
+
+#define SERVER_MAX_ENDPOINTS    6       // 감시할 수 있는 아웃바운드 엔드포인트 수 (서비스 전체)
+#define SERVER_TIMEOUT_MS       3000    // 요청 하나의 응답 대기 시간 (헤지 요청 포함)
+#define SERVER_HEDGE_MIN_MS     50      // 헤지 요청까지의 대기 = 고른 엔드포인트의 p95 (이 범위로 자름)
+#define SERVER_HEDGE_MAX_MS     1000
+#define SERVER_HEDGE_DEFAULT_MS 500     // 지연 표본이 적을 때
+#define SERVER_KEEPALIVE_MS     15000   // 이보다 오래 놀던 keep-alive 연결은 재사용하지 않음 (서버가 먼저 닫았을 수 있음)
+
+// 엔드포인트 하나의 상태 (/status 용)
+struct EndpointStats {
+    String host;
+    BreakerStats breaker;             // 이름(서비스), 포트, 서킷 브레이커 상태
+    uint32_t ewmaMs = 0;              // 응답 지연 EWMA (0 = 표본 없음)
+    uint32_t p95Ms = 0;
+    uint32_t healthPct = 100;         // 성공률 EWMA
+    uint32_t selected = 0;            // 주 요청으로 고른 횟수
+    uint32_t hedges = 0;              // 헤지 요청을 받은 횟수
+    uint32_t hedgeWins = 0;           // 헤지 요청이 먼저 끝난 횟수
+    bool secure = false;              // TLS
+    uint32_t connects = 0;            // 새로 연 연결 (TLS면 핸드셰이크 포함)
+    uint32_t reuses = 0;              // keep-alive 연결을 재사용한 요청
+};
+
+// 응답 본문 형식 (요청의 Accept 헤더로 고름)
+enum class WireFormat : uint8_t {
+    Json,
+    MsgPack                           // application/msgpack
+};
+
+// 핸들러가 들고 있는 버퍼를 복사 없이 보내는 응답. etag가 요청의 If-None-Match와 같으면 본문 없이 304
+struct CachedReply {
+    const String* body = nullptr;
+    const String* etag = nullptr;     // 따옴표 포함 ("\"...\"")
+};
 
 /**
  * WebService 클래스
@@ -16,15 +58,41 @@ class ServerService {
 private:
     int serverPort;                   // HTTP 서버 포트
     WebServer* server = nullptr;     // WebServer 인스턴스를 포인터로 변경
+    TcpTransport* transport;          // 아웃바운드 요청용 연결 생성기 (주입)
+    Clock* clock;                     // 타임아웃 계산용 시간원 (주입)
+
+    // 아웃바운드 엔드포인트: 같은 서비스 이름끼리 등록 순서대로 한 묶음 (첫 엔드포인트 주소로 요청하면 묶음 안에서 고름)
+    struct Endpoint {
+        CircuitBreaker breaker;
+        EndpointHealth health;
+        uint8_t group = 0;                       // 묶음의 첫 엔드포인트 인덱스
+        std::atomic<uint32_t> selected{0};
+        std::atomic<uint32_t> hedges{0};
+        std::atomic<uint32_t> hedgeWins{0};
+        bool secure = false;                     // connectSecure()로 연결
+        std::unique_ptr<TcpConnection> idle;     // 응답을 다 읽고 열어 둔 연결 (다음 요청이 재사용)
+        uint32_t idleSince = 0;
+        std::atomic<uint32_t> connects{0};
+        std::atomic<uint32_t> reuses{0};
+    };
+    struct Attempt;
+
+    Endpoint endpoints[SERVER_MAX_ENDPOINTS];
+    uint8_t endpointTotal = 0;
+    std::function<void(const char*, uint32_t, int)> requestObserver = nullptr;
 
     // 라우팅 핸들러 콜백 함수들
-    std::function<void()> startHandler = nullptr;
-    std::function<void()> goHandler = nullptr;
-    std::function<void()> stopHandler = nullptr;
-    std::function<void()> resetHandler = nullptr;
+    std::function<HandlerReply()> startHandler = nullptr;     // 202 Accepted(작업 ID)를 돌려줄 수 있음
+    std::function<HandlerReply()> goHandler = nullptr;        // ok: 바퀴 보드가 ACK함 (/ws 응답)
+    std::function<HandlerReply()> stopHandler = nullptr;
+    std::function<HandlerReply()> resetHandler = nullptr;
     std::function<void(const String&)> postHandler = nullptr;
 
-    std::function<String(void)> statusHandler = nullptr;
+    std::function<CachedReply(WireFormat)> statusHandler = nullptr;
+    uint32_t statusNotModified = 0;   // /status에 304로 답한 횟수
+    EventStream events;               // /events (SSE) 연결과 보낼 이벤트
+    CommandChannel commands;          // /ws (WebSocket) 명령 채널
+    AdmissionControl admission;       // loop 한 바퀴의 시간 예산 / 일반 요청 수락
     std::function<void()> resetConfigHandler = nullptr;
 
     std::function<String(void)> mainPageHandler = nullptr;
@@ -33,22 +101,46 @@ private:
     std::function<String(void)> statusViewHandler = nullptr;
 
     void setupRoutes();       // 라우팅 등록
+    bool dispatchCommand(const String& command, HandlerReply& reply);   // /ws 명령 → 같은 핸들러
+    bool admitGeneral();      // 일반 요청 수락 (미루면 503을 보내고 false)
+    int findEndpoint(const char* host, uint16_t port) const;
+    int pickEndpoint(uint8_t group, uint32_t tried) const;
+    bool launch(uint8_t group, uint32_t& tried, const String& head, const String& request, Attempt& attempt);
+    bool start(int index, const String& head, const String& request, bool allowReuse, Attempt& attempt);
+    void keepAlive(Endpoint& endpoint, std::unique_ptr<TcpConnection> client);
+    String exchange(const char* host, uint16_t port, const String& head, const String& headers, const String& body,
+                    bool idempotent);
 
 public:
-    explicit ServerService(int serverPort);    // 생성자
+    ServerService(int serverPort, TcpTransport& transport, Clock& clock);    // 생성자
     ~ServerService();                          // 소멸자
 
     void begin();
     void handle();
 
     // 핸들러 등록 메서드
-    void setStartHandler(const std::function<void()> &handler);
-    void setGoHandler(const std::function<void()> &handler);
-    void setStopHandler(const std::function<void()> &handler);
-    void setResetHandler(const std::function<void()> &handler);
+    void setStartHandler(const std::function<HandlerReply()> &handler);
+    void setGoHandler(const std::function<HandlerReply()> &handler);
+    void setStopHandler(const std::function<HandlerReply()> &handler);
+    void setResetHandler(const std::function<HandlerReply()> &handler);
     void setPostHandler(const std::function<void(const String&)> &handler);
 
-    void setStatusHandler(const std::function<String(void)> &handler);
+    void setStatusHandler(const std::function<CachedReply(WireFormat)> &handler);   // 요청이 고른 형식의 캐시된 본문
+    uint32_t statusNotModifiedCount() const { return statusNotModified; }
+
+    // /events (SSE): 상태 핸들러가 있으면 열린다. status는 handle()이 상태 핸들러의 ETag가 바뀔 때만 밀어 주고,
+    // 피킹 이벤트는 loop에서 publishEvent()로 넣는다 (data는 한 줄 JSON). 연결이 없으면 아무것도 하지 않는다
+    void publishEvent(const char* type, const String& data) { events.publish(type, data); }
+    bool eventsActive() const { return events.active(); }
+    EventStreamStats eventStats() const { return events.stats(); }
+
+    // /ws (WebSocket): 제어 핸들러(/start /go /stop /reset)가 하나라도 있으면 열린다. 명령은 handle()에서 같은 핸들러로 실행
+    CommandChannelStats commandStats() const { return commands.stats(); }
+
+    // 수락 제어: handle()은 한 바퀴에 HTTP_BUDGET_US 안에서만 요청을 받고, 넘기면 일반 요청을 503으로 미룬다.
+    // loop는 RFID 스캔을 마칠 때마다 markScanned()를 불러 스캔 간격을 알린다 (부르지 않으면 간격은 보지 않음)
+    void markScanned() { admission.markScanned(); }
+    AdmissionStats admissionStats() const { return admission.stats(); }
     void setResetConfigHandler(const std::function<void()> &handler);
 
     void setMainPageHandler(std::function<String(void)> handler);
@@ -57,8 +149,34 @@ public:
     void setStatusViewHandler(std::function<String(void)> handler);
 
     // HTTP 요청 전송 메서드
-    static String sendGETRequest(const char* host, uint16_t port, const String& pathWithParams);
-    static String sendPostRequest(const char* host, uint16_t port, const String& path, const JsonDocument& jsonDoc);
+    // idempotent: 다시 보내도 되는 요청(조회, 멱등 키가 붙은 요청)이면 응답이 늦을 때 같은 묶음의 다른 엔드포인트에 헤지 요청을 보낸다
+    String sendGETRequest(const char* host, uint16_t port, const String& pathWithParams,
+                          const String& extraHeaders = "", bool idempotent = false);    // extraHeaders: "Name: value\r\n" 여러 줄
+    String sendPostRequest(const char* host, uint16_t port, const String& path, const JsonDocument& jsonDoc);
+
+    // 아웃바운드 엔드포인트 감시 (setup에서 등록). 같은 이름으로 여러 번 등록하면 순서대로 대체 엔드포인트가 된다.
+    // 묶음은 서킷 브레이커가 열리지 않은 엔드포인트 중 지연 EWMA ÷ 건강도가 가장 작은 곳으로 보낸다 (표본이 없으면 등록 순서).
+    // 묶음이 모두 열려 있으면 요청 함수는 바로 빈 응답을 반환한다.
+    // 등록한 엔드포인트는 keep-alive로 연결을 재사용한다. secure면 TLS로 연결한다 (세션 재개는 전송 계층이 맡음)
+    bool watchEndpoint(const char* name, const String& host, uint16_t port, bool secure = false);
+    bool endpointAvailable(const char* host, uint16_t port);     // 묶음 중 하나라도 보낼 수 있음
+    uint8_t endpointCount() const { return endpointTotal; }
+    EndpointStats endpointStats(uint8_t index) const;
+    void setRequestObserver(std::function<void(const char* service, uint32_t latencyMs, int statusCode)> observer) {
+        requestObserver = observer;    // 요청 하나가 끝날 때마다 (헤지 포함 전체 지연)
+    }
+
+    // HTTP 응답 파싱
+    static int parseStatusCode(const String& response);
+    static String extractBody(const String& response);
+    static String extractHeader(const String& response, const char* name);   // 없으면 빈 문자열
+    static int expectedLength(const String& response);   // 헤더 + Content-Length / 청크 본문. 덜 왔으면 0, 닫힐 때까지 읽어야 하면 -1
+    static void decodeChunked(String& response);         // 청크 본문을 풀어 Content-Length 응답으로 (청크가 아니면 그대로)
+
+    // 내용 협상: Accept에 MessagePack이 JSON 이상의 q 값으로 있으면 MsgPack, 그 밖에는 모두 JSON
+    static WireFormat negotiate(const String& accept);
+    static const char* contentType(WireFormat format);
+    static bool etagMatches(const String& ifNoneMatch, const String& etag);   // If-None-Match 목록 / "*" / W/ 접두사
 
     // 핸들러 등록 여부 확인
     [[nodiscard]] bool isStartHandlerSet() const;
@@ -0,0 +1,222 @@
+#include "TraceLog.h"
+
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#else
+  #include "BackgroundTask.h"
+#endif
+
+namespace {
+
+// 링 버퍼에 기록되는 레코드 헤더 (인자 영역이 바로 뒤에 이어진다)
+struct RecordHeader {
+    const TraceLogFormat* format;
+    uint32_t timestampMs;
+    uint16_t payloadLen;
+    uint8_t argc;
+};
+
+uint8_t ring[TRACE_LOG_BUFFER_SIZE];
+size_t head = 0;          // 다음 쓰기 위치
+size_t tail = 0;          // 다음 읽기 위치
+size_t used = 0;          // 사용 중인 바이트 수
+uint32_t droppedCount = 0;
+Print* output = nullptr;
+
+#if defined(ESP32)
+portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t drainTaskHandle = nullptr;
+  #define RING_LOCK()   portENTER_CRITICAL_SAFE(&ringMux)
+  #define RING_UNLOCK() portEXIT_CRITICAL_SAFE(&ringMux)
+#else
+  #define RING_LOCK()   noInterrupts()
+  #define RING_UNLOCK() interrupts()
+#endif
+
+// 끝을 넘어가는 경우 두 번의 memcpy로 나눠 복사한다
+void ringWrite(const void* src, size_t n) {
+    const uint8_t* p = static_cast<const uint8_t*>(src);
+    const size_t room = TRACE_LOG_BUFFER_SIZE - head;
+    const size_t first = n < room ? n : room;
+    memcpy(ring + head, p, first);
+    memcpy(ring, p + first, n - first);
+    head = (head + n) % TRACE_LOG_BUFFER_SIZE;
+    used += n;
+}
+
+void ringRead(void* dst, size_t n) {
+    uint8_t* p = static_cast<uint8_t*>(dst);
+    const size_t room = TRACE_LOG_BUFFER_SIZE - tail;
+    const size_t first = n < room ? n : room;
+    memcpy(p, ring + tail, first);
+    memcpy(p + first, ring, n - first);
+    tail = (tail + n) % TRACE_LOG_BUFFER_SIZE;
+    used -= n;
+}
+
+uint32_t readWord(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// 레코드 하나를 포맷팅하여 출력한다. "{}" 마다 다음 인자를 치환한다.
+void formatRecord(const RecordHeader& hdr, const uint8_t* payload) {
+    char line[256];
+    size_t n = 0;
+    size_t pos = 0;
+    uint8_t argIndex = 0;
+
+    auto append = [&](const char* s, size_t len) {
+        if (len > sizeof(line) - n) len = sizeof(line) - n;
+        memcpy(line + n, s, len);
+        n += len;
+    };
+
+#ifdef TRACE_LOG_TIMESTAMP
+    char ts[16];
+    int tsLen = snprintf(ts, sizeof(ts), "[%lu] ", static_cast<unsigned long>(hdr.timestampMs));
+    append(ts, tsLen);
+#endif
+
+    for (const char* f = hdr.format->fmt; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}' && argIndex < hdr.argc && pos < hdr.payloadLen) {
+            const uint8_t tag = payload[pos++];
+            char num[12];
+            if (tag == tracelog_detail::ARG_STR) {
+                const uint8_t len = payload[pos++];
+                append(reinterpret_cast<const char*>(payload + pos), len);
+                pos += len;
+            } else if (tag == tracelog_detail::ARG_INT) {
+                int len = snprintf(num, sizeof(num), "%ld", static_cast<long>(static_cast<int32_t>(readWord(payload + pos))));
+                append(num, len);
+                pos += 4;
+            } else {
+                int len = snprintf(num, sizeof(num), "%lu", static_cast<unsigned long>(readWord(payload + pos)));
+                append(num, len);
+                pos += 4;
+            }
+            ++argIndex;
+            ++f;
+            continue;
+        }
+        append(f, 1);
+    }
+
+    output->write(reinterpret_cast<const uint8_t*>(line), n);
+    output->write('\n');
+}
+
+#if defined(ESP32)
+// 드레인 태스크: 기록 알림이 오거나 주기적으로 깨어나 버퍼를 비운다
+void drainTask(void*) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+        TraceLog::drain();
+    }
+}
+#endif
+
+} // namespace
+
+// ========== 인코더 ========================================================================================
+void tracelog_detail::Encoder::putWord(uint8_t tag, uint32_t value) {
+    if (len + 5u > sizeof(buf)) return;
+    buf[len++] = tag;
+    buf[len++] = value & 0xFF;
+    buf[len++] = (value >> 8) & 0xFF;
+    buf[len++] = (value >> 16) & 0xFF;
+    buf[len++] = (value >> 24) & 0xFF;
+    ++argc;
+}
+
+void tracelog_detail::Encoder::putString(const char* str, size_t n) {
+    if (n > TRACE_LOG_MAX_STRING) n = TRACE_LOG_MAX_STRING;
+    if (len + 2u + n > sizeof(buf)) return;
+    buf[len++] = ARG_STR;
+    buf[len++] = static_cast<uint8_t>(n);
+    if (n) memcpy(buf + len, str, n);
+    len += n;
+    ++argc;
+}
+
+// ========== 시작: 출력 대상 지정 및 드레인 태스크 생성 ===============================================================
+void TraceLog::begin(Print& out) {
+    output = &out;
+#if defined(ESP32)
+    if (drainTaskHandle == nullptr) {
+        // 루프 태스크보다 낮은 우선순위 → UART 대기는 드레인 태스크만 부담한다
+        xTaskCreatePinnedToCore(drainTask, "tracelog", 3072, nullptr, tskIDLE_PRIORITY, &drainTaskHandle, 0);
+    }
+#else
+    static bool registered = false;
+    if (!registered) {
+        hal::startBackgroundTask("tracelog", []() { TraceLog::drain(); }, 0);
+        registered = true;
+    }
+#endif
+}
+
+// ========== 기록: 헤더 + 인자를 링 버퍼에 복사 (공간 부족 시 버림) =================================================
+void TraceLog::commit(const TraceLogFormat* format, const tracelog_detail::Encoder& e) {
+    RecordHeader hdr;
+    hdr.format = format;
+    hdr.timestampMs = millis();
+    hdr.payloadLen = e.len;
+    hdr.argc = e.argc;
+
+    const size_t total = sizeof(hdr) + e.len;
+    bool stored = false;
+
+    RING_LOCK();
+    if (TRACE_LOG_BUFFER_SIZE - used >= total) {
+        ringWrite(&hdr, sizeof(hdr));
+        ringWrite(e.buf, e.len);
+        stored = true;
+    } else {
+        ++droppedCount;
+    }
+    RING_UNLOCK();
+
+#if defined(ESP32)
+    if (stored && drainTaskHandle) xTaskNotifyGive(drainTaskHandle);
+#else
+    (void)stored;
+#endif
+}
+
+// ========== 출력: 레코드를 하나씩 꺼내 잠금 밖에서 포맷팅 ==========================================================
+void TraceLog::drain(size_t maxRecords) {
+    if (!output) return;
+
+    size_t count = 0;
+    while (maxRecords == 0 || count < maxRecords) {
+        RecordHeader hdr;
+        uint8_t payload[TRACE_LOG_MAX_PAYLOAD];
+
+        RING_LOCK();
+        if (used < sizeof(hdr)) {
+            RING_UNLOCK();
+            break;
+        }
+        ringRead(&hdr, sizeof(hdr));
+        ringRead(payload, hdr.payloadLen);
+        RING_UNLOCK();
+
+        formatRecord(hdr, payload);
+        ++count;
+    }
+}
+
+void TraceLog::flush() {
+    drain();
+    if (output) output->flush();
+}
+
+uint32_t TraceLog::dropped() {
+    return droppedCount;
+}
+
+size_t TraceLog::pending() {
+    return used;
+}
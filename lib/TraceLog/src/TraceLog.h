@@ -0,0 +1,133 @@
+// TraceLog.h
+#ifndef TRACELOG_H
+#define TRACELOG_H
+
+#include <Arduino.h>
+
+// 로그 레벨 ============================================================================================================
+#define TRACE_LOG_LEVEL_DEBUG 0
+#define TRACE_LOG_LEVEL_INFO  1
+#define TRACE_LOG_LEVEL_WARN  2
+#define TRACE_LOG_LEVEL_ERROR 3
+#define TRACE_LOG_LEVEL_NONE  4
+
+// 빌드 플래그로 변경 가능 (예: -DTRACE_LOG_LEVEL=2). 기준 미만 레벨은 호출 자체가 컴파일되지 않는다.
+#ifndef TRACE_LOG_LEVEL
+#define TRACE_LOG_LEVEL TRACE_LOG_LEVEL_INFO
+#endif
+
+// 링 버퍼 크기 (바이트). 가득 차면 새 레코드는 버려지고 dropped 카운터가 증가한다.
+#ifndef TRACE_LOG_BUFFER_SIZE
+#define TRACE_LOG_BUFFER_SIZE 4096
+#endif
+
+// 레코드 하나의 최대 인자 영역 크기 / 문자열 인자 최대 길이
+#define TRACE_LOG_MAX_PAYLOAD 96
+#define TRACE_LOG_MAX_STRING  48
+
+/**
+ * 호출 지점마다 하나씩 생성되는 정적 포맷 정보.
+ * 이 객체의 주소가 곧 포맷 ID이며, 링 버퍼에는 주소와 원시 인자만 기록된다.
+ * 포맷 문자열의 "{}" 자리에 인자가 순서대로 치환된다.
+ */
+struct TraceLogFormat {
+    const char* fmt;
+    uint8_t level;
+};
+
+namespace tracelog_detail {
+
+// 인자 타입 태그
+enum : uint8_t { ARG_INT = 'i', ARG_UINT = 'u', ARG_STR = 's' };
+
+// 호출 스택에서 레코드의 인자 영역을 만든다 (힙 할당 없음)
+struct Encoder {
+    uint8_t buf[TRACE_LOG_MAX_PAYLOAD];
+    uint16_t len = 0;
+    uint8_t argc = 0;
+
+    void putWord(uint8_t tag, uint32_t value);
+    void putString(const char* str, size_t n);
+};
+
+inline void encodeArg(Encoder& e, int v)                { e.putWord(ARG_INT, static_cast<uint32_t>(v)); }
+inline void encodeArg(Encoder& e, long v)               { e.putWord(ARG_INT, static_cast<uint32_t>(v)); }
+inline void encodeArg(Encoder& e, unsigned int v)       { e.putWord(ARG_UINT, v); }
+inline void encodeArg(Encoder& e, unsigned long v)      { e.putWord(ARG_UINT, static_cast<uint32_t>(v)); }
+inline void encodeArg(Encoder& e, bool v)               { e.putWord(ARG_UINT, v ? 1 : 0); }
+inline void encodeArg(Encoder& e, const char* v)        { e.putString(v, v ? strlen(v) : 0); }
+inline void encodeArg(Encoder& e, const String& v)      { e.putString(v.c_str(), v.length()); }
+
+inline void encodeArgs(Encoder&) {}
+
+template <typename T, typename... Rest>
+inline void encodeArgs(Encoder& e, const T& first, const Rest&... rest) {
+    encodeArg(e, first);
+    encodeArgs(e, rest...);
+}
+
+} // namespace tracelog_detail
+
+/**
+ * TraceLog 클래스
+ * - 핫 패스에서는 포맷 ID + 원시 인자만 링 버퍼에 기록 (문자열 조립/UART 대기 없음)
+ * - 낮은 우선순위 태스크가 버퍼를 꺼내 포맷팅 후 출력
+ */
+class TraceLog {
+public:
+    static void begin(Print& output);         // 출력 대상 지정 및 드레인 태스크 시작
+    static void drain(size_t maxRecords = 0); // 버퍼에 쌓인 레코드 출력 (0 = 전부)
+    static void flush();                      // 재시작 등 직전에 남은 로그를 모두 출력
+
+    static uint32_t dropped();                // 버퍼 부족으로 버려진 레코드 수
+    static size_t pending();                  // 출력 대기 중인 바이트 수
+
+    template <typename... Args>
+    static void record(const TraceLogFormat* format, const Args&... args) {
+        tracelog_detail::Encoder e;
+        tracelog_detail::encodeArgs(e, args...);
+        commit(format, e);
+    }
+
+private:
+    static void commit(const TraceLogFormat* format, const tracelog_detail::Encoder& e);
+};
+
+// 로그 매크로 ===========================================================================================================
+#define TRACE_LOG_RECORD(lvl, fmtStr, ...)                                          \
+    do {                                                                            \
+        static const TraceLogFormat traceLogFormat_ = { fmtStr, lvl };              \
+        TraceLog::record(&traceLogFormat_, ##__VA_ARGS__);                          \
+    } while (0)
+
+// 꺼진 레벨: 인자를 계산하지 않지만 컴파일은 한다 (로그에서만 쓰는 변수가 미사용 경고를 내지 않도록, 형식 오류도 그대로 잡힘)
+#define TRACE_LOG_DISCARD(lvl, fmtStr, ...)                                         \
+    do {                                                                            \
+        if (0) TRACE_LOG_RECORD(lvl, fmtStr, ##__VA_ARGS__);                        \
+    } while (0)
+
+#if TRACE_LOG_LEVEL <= TRACE_LOG_LEVEL_DEBUG
+  #define LOG_DEBUG(fmtStr, ...) TRACE_LOG_RECORD(TRACE_LOG_LEVEL_DEBUG, fmtStr, ##__VA_ARGS__)
+#else
+  #define LOG_DEBUG(fmtStr, ...) TRACE_LOG_DISCARD(TRACE_LOG_LEVEL_DEBUG, fmtStr, ##__VA_ARGS__)
+#endif
+
+#if TRACE_LOG_LEVEL <= TRACE_LOG_LEVEL_INFO
+  #define LOG_INFO(fmtStr, ...)  TRACE_LOG_RECORD(TRACE_LOG_LEVEL_INFO, fmtStr, ##__VA_ARGS__)
+#else
+  #define LOG_INFO(fmtStr, ...)  TRACE_LOG_DISCARD(TRACE_LOG_LEVEL_INFO, fmtStr, ##__VA_ARGS__)
+#endif
+
+#if TRACE_LOG_LEVEL <= TRACE_LOG_LEVEL_WARN
+  #define LOG_WARN(fmtStr, ...)  TRACE_LOG_RECORD(TRACE_LOG_LEVEL_WARN, fmtStr, ##__VA_ARGS__)
+#else
+  #define LOG_WARN(fmtStr, ...)  TRACE_LOG_DISCARD(TRACE_LOG_LEVEL_WARN, fmtStr, ##__VA_ARGS__)
+#endif
+
+#if TRACE_LOG_LEVEL <= TRACE_LOG_LEVEL_ERROR
+  #define LOG_ERROR(fmtStr, ...) TRACE_LOG_RECORD(TRACE_LOG_LEVEL_ERROR, fmtStr, ##__VA_ARGS__)
+#else
+  #define LOG_ERROR(fmtStr, ...) TRACE_LOG_DISCARD(TRACE_LOG_LEVEL_ERROR, fmtStr, ##__VA_ARGS__)
+#endif
+
+#endif // TRACELOG_H
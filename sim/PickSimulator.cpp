@@ -0,0 +1,952 @@
+#include "PickSimulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include <WebServer.h>
+
+#include "BackgroundTask.h"
+#include "Config.h"
+#include "FakeTagReader.h"
+#include "NativeTime.h"
+#include "Platform.h"
+#include "model/Outbox.h"
+#include "RFIDController.h"
+#include "ServerService.h"
+#include "web/StatusCache.h"
+
+extern RFIDController* rfidController;   // main.cpp
+extern Outbox* outbox;
+extern ServerService* serverService;
+extern StatusCache* statusCache;
+extern MotionListener* motionListener;
+
+#define SIM_MOTION_PORT     47100
+#define SIM_SENDER_PORT     47101
+#define SIM_MOTION_ATTEMPTS 10                                   // 중앙 서버가 같은 seq를 보내는 최대 횟수
+#define SIM_MOTION_KEY      "000102030405060708090a0b0c0d0e0f"
+#define SIM_CHUNK_BYTES     256                                  // --server-chunked 응답의 청크 크기
+
+namespace {
+
+// 대체 서버 인스턴스 i의 호스트 이름 (가짜 DNS는 어떤 이름이든 풀어 준다)
+String backupHost(int instance) {
+    return String("backup-") + instance + ".tracego.local";
+}
+
+} // namespace
+
+// ========== 생성자 =========================================================================================
+PickSimulator::PickSimulator(const SimOptions& options)
+    : opt(options), rng(options.seed) {}
+
+// ========== 실행: 가짜 장치 연결 → setup() → loop() 반복 =====================================================
+SimReport PickSimulator::run() {
+    native::useVirtualTime(true);
+    opt.servers = std::max(1, std::min(opt.servers, SERVER_MAX_HOSTS));
+
+    // 저장된 설정이 없으면 설정 모드로 빠지므로 시뮬레이터용 값을 넣어둔다
+    KVStore& settings = hal::fakes().settings;
+    settings.begin("settings", false);
+    settings.putString("ssid", "sim");
+    settings.putString("server_ip", "tracego-server.sim");
+    String backups;
+    for (int i = 1; i < opt.servers; ++i) {
+        if (i > 1) backups += ",";
+        backups += backupHost(i);
+    }
+    settings.putString("server_bak", backups);
+    settings.putBool("server_tls", opt.serverTls != 0);
+    settings.putBool("tls_insecure", true);                  // 가짜 서버에는 검증할 인증서가 없음
+    settings.putBool("use_rfid", true);
+    if (opt.dedupMs >= 0) settings.putInt("dedup_ms", opt.dedupMs);
+    if (opt.inventory >= 0) settings.putBool("rc_inventory", opt.inventory != 0);
+    // 리더기마다 SS / IRQ 핀 하나씩 (가짜 리더기는 핀 번호를 구분만 한다)
+    String sdaPins, irqPins;
+    for (int r = 0; r < opt.readers; ++r) {
+        if (r > 0) { sdaPins += ","; irqPins += ","; }
+        sdaPins += String(5 + r);
+        irqPins += String(opt.irqPin < 0 ? -1 : opt.irqPin + r);
+    }
+    settings.putString("rc_sdas", sdaPins);
+    settings.putString("rc_irqs", irqPins);
+    if (opt.motionUdp) {
+        settings.putInt("motion_port", SIM_MOTION_PORT);
+        settings.putString("motion_key", SIM_MOTION_KEY);
+        MotionListener::parseKey(SIM_MOTION_KEY, motionKey);
+    }
+    settings.end();
+
+    hal::fakes().resolver.ttlSec = opt.dnsTtlSec;
+    hal::fakes().resolver.latencyMs = opt.dnsLatencyMs;
+    hal::fakes().transport.connectMs = opt.connectMs;
+    hal::fakes().transport.tls.fullCpuMs = opt.tlsFullCpuMs;
+    hal::fakes().transport.tls.resumedCpuMs = opt.tlsResumeCpuMs;
+    hal::fakes().transport.tls.sessionLifetimeSec = opt.tlsSessionSec;
+    setup();
+
+    buildAisle();
+    hal::fakes().wheel.onLine([this](const String& line) { onWheelLine(line); });
+    hal::fakes().motion.onSend([this](const FakeDatagram& datagram) { onMotionAck(datagram); });
+    for (int i = 0; i < opt.servers; ++i) {
+        hal::fakes().transport.registerEndpoint(i == 0 ? config.serverIP : backupHost(i), config.serverPort,
+            [this, i](const String& request) { return onServerRequest(request, i); });
+    }
+    serverService->setRequestObserver([this](const char* service, uint32_t latencyMs, int) {
+        if (strcmp(service, "server") == 0) report.serverCallMs.push_back(latencyMs);
+    });
+    hal::fakes().transport.registerEndpoint(config.serverIP, config.standPort,
+        [this](const String& request) { return onStandRequest(request); });
+    const int sides = opt.shelfSides > 0 ? opt.shelfSides : 1;
+    int readerIndex = 0;
+    for (FakeTagReader* reader : FakeTagReader::instances()) {
+        const int side = readerIndex++ % sides;
+        reader->setSource([this, side](TagUid& uid, FakeTagReader::Probe probe) { return readTag(uid, probe, side); });
+    }
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    const uint64_t startUs = native::nowMicros();
+    startedUs = startUs;
+    const uint64_t endUs = startUs + static_cast<uint64_t>(opt.hours * 3600.0 * 1e6);
+
+    if (WebServer* inner = WebServer::find(config.innerPort)) {
+        inner->setCostModel([this](const String& uri, int code) {
+            const bool page = uri == "/" || uri == "/advanced" || uri == "/status-view" || uri.startsWith("/status?") ||
+                              uri == "/status";
+            return page && code == 200 ? opt.pageCostUs : opt.httpCostUs;
+        });
+    }
+
+    startOrder();
+    if (opt.httpBurst > 0) schedule(startUs + static_cast<uint64_t>(opt.httpBurstSec * 1e6), [this]() { burstHttp(); });
+    if (opt.dashboardMs > 0) schedule(startUs + opt.dashboardMs * 1000ULL, [this]() { pollDashboard(); });
+    if (opt.dashboardSse > 0) openEventStreams();
+    if (opt.commandWs) openCommandChannel();
+    while (native::nowMicros() < endUs) {
+        runDueEvents();
+        loop();
+        hal::serviceBackgroundTasks();
+        advanceCart();
+        watchdog();
+        if (commandStream) readCommandReplies();
+    }
+    hal::serviceBackgroundTasks();
+    readEventStreams();
+
+    if (rfidController) {
+        report.tagsSuppressed = rfidController->dedup().suppressedCount();
+        report.rfid = rfidController->stats();
+        report.rfidIdleLoadPct = rfidController->idleLoadPercent();
+    }
+    if (outbox) {
+        report.outboxDelivered = outbox->stats().delivered;
+        report.outboxRetries = outbox->stats().retries;
+        report.outboxPending = outbox->pending();
+    }
+    if (statusCache) report.statusBuilds = statusCache->buildCount();
+    if (motionListener) report.motion = motionListener->stats();
+    if (serverService) report.http = serverService->admissionStats();
+    report.dnsQueries = hal::fakes().resolver.queries;
+    report.dns = hal::dns().stats();
+    report.tls = hal::fakes().transport.tlsStats();
+    for (uint8_t i = 0; serverService && i < serverService->endpointCount(); ++i) {
+        const EndpointStats e = serverService->endpointStats(i);
+        report.breakerTrips += e.breaker.trips;
+        report.breakerRejected += e.breaker.rejected;
+        report.hedges += e.hedges;
+        report.hedgeWins += e.hedgeWins;
+        if (strcmp(e.breaker.name, "server") != 0) continue;
+        report.serverConnects += e.connects;
+        report.serverReuses += e.reuses;
+    }
+    report.simulatedSec = (native::nowMicros() - startUs) / 1e6;
+    report.wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return report;
+}
+
+// ========== 통로 / 카트 ====================================================================================
+void PickSimulator::buildAisle() {
+    tags.clear();
+    const int perSpot = opt.tagsPerSpot > 0 ? opt.tagsPerSpot : 1;
+    for (int i = 0; i < opt.tagCount; ++i) {
+        TagState tag;
+        tag.spot = i / perSpot;
+        tag.position = opt.firstTagM + tag.spot * opt.tagSpacingM;
+        tag.side = opt.shelfSides > 1 ? i % opt.shelfSides : 0;
+
+        TagUid uid;
+        uid.size = 4;
+        uid.bytes[0] = 0x5A;
+        uid.bytes[1] = 0x17;
+        uid.bytes[2] = static_cast<uint8_t>(i >> 8);
+        uid.bytes[3] = static_cast<uint8_t>(i & 0xFF);
+        tag.uid = RFIDController::formatUid(uid);
+        tags.push_back(tag);
+    }
+    const int spots = tags.empty() ? 0 : tags.back().spot + 1;
+    aisleEndM = opt.firstTagM + spots * opt.tagSpacingM + 1.0;
+}
+
+// 마지막 갱신 이후 이동한 거리를 반영하고, 그 사이 인식 범위 진입 / 지나친 대상 태그를 판정한다
+void PickSimulator::advanceCart() {
+    const uint64_t now = native::nowMicros();
+    if (cartMoving && now > cartUpdatedUs) {
+        const double from = cartPos;
+        const double to = from + opt.cartSpeedMps * (now - cartUpdatedUs) / 1e6;
+
+        for (auto& tag : tags) {
+            const double enter = tag.position - opt.readRangeM;
+            if (tag.enteredUs == 0 && from < enter && enter <= to) {
+                tag.enteredUs = cartUpdatedUs + static_cast<uint64_t>((enter - from) / opt.cartSpeedMps * 1e6);
+            }
+            if (tag.target && !tag.resolved && to > tag.position + opt.stopToleranceM) {
+                tag.resolved = true;
+                ++report.missedTags;
+            }
+        }
+
+        cartPos = to;
+        if (cartPos >= aisleEndM) {
+            cartPos = aisleEndM;
+            cartMoving = false;
+            finishOrder();
+        }
+    }
+    cartUpdatedUs = now;
+}
+
+int PickSimulator::nearestSpot(double position) const {
+    if (tags.empty()) return -1;
+    long i = std::lround((position - opt.firstTagM) / opt.tagSpacingM);
+    if (i < 0) i = 0;
+    if (i > tags.back().spot) i = tags.back().spot;
+    return static_cast<int>(i);
+}
+
+// 자리에 놓인 태그의 인덱스 범위 [begin, end)
+int PickSimulator::spotBegin(int spot) const {
+    return spot * (opt.tagsPerSpot > 0 ? opt.tagsPerSpot : 1);
+}
+
+int PickSimulator::spotEnd(int spot) const {
+    return std::min(spotBegin(spot + 1), static_cast<int>(tags.size()));
+}
+
+// 리더기 폴링 1회: 인식 범위 안의 자기 쪽 태그는 통과 1회당 한 번 읽힌다 (halt 이후 재선택 안 됨)
+// rereadMs 지정 시 범위 안에 머무는 동안 그 간격으로 다시 읽힌다 (서행/정지 중 반복 인식)
+// 비용: 폴링은 카드가 없어도 응답 대기 시간을 쓰고, 인터럽트 무장은 레지스터 쓰기만 한다
+bool PickSimulator::readTag(TagUid& uid, FakeTagReader::Probe probe, int side) {
+    if (probe == FakeTagReader::Probe::Arm) native::advanceMicros(opt.armCostUs);
+    advanceCart();
+    const uint64_t now = native::nowMicros();
+    const int spot = nearestSpot(cartPos);
+
+    // 같은 자리에 여러 장이 있으면 아직 깨어 있는(읽히지 않은) 카드 중 하나가 선택된다
+    for (int i = spot < 0 ? 0 : spotBegin(spot); spot >= 0 && i < spotEnd(spot); ++i) {
+        TagState& tag = tags[i];
+        const bool inRange = tag.side == side && std::fabs(cartPos - tag.position) <= opt.readRangeM;
+        const bool readable = inRange && (!tag.reported ||
+            (opt.rereadMs > 0 && now - tag.lastReadUs >= static_cast<uint64_t>(opt.rereadMs) * 1000));
+        if (!readable) continue;
+
+        tag.reported = true;
+        tag.lastReadUs = now;
+        ++report.tagReads;
+
+        uid.size = 4;
+        for (uint8_t b = 0; b < 4; ++b) {
+            char hex[3] = { tag.uid[b * 2], tag.uid[b * 2 + 1], 0 };
+            uid.bytes[b] = static_cast<uint8_t>(strtol(hex, nullptr, 16));
+        }
+        native::advanceMicros(opt.readCostUs);
+        return true;
+    }
+    if (probe == FakeTagReader::Probe::Poll) native::advanceMicros(opt.pollCostUs);
+    return false;
+}
+
+// ========== 바퀴 보드 ======================================================================================
+void PickSimulator::onWheelLine(const String& line) {
+    advanceCart();
+    const uint64_t now = native::nowMicros();
+    ++report.wheelCommands;
+
+    if (line == "STOP") {
+        if (cartMoving) {
+            cartMoving = false;
+            idleSinceUs = now;
+            stoppedSpot = -1;
+
+            // 자리 하나에 대상 상품이 여러 개면 한 번의 정지로 모두 집을 수 있다
+            const int spot = nearestSpot(cartPos);
+            for (int i = spot < 0 ? 0 : spotBegin(spot); spot >= 0 && i < spotEnd(spot); ++i) {
+                TagState& tag = tags[i];
+                if (tag.target && !tag.resolved && std::fabs(cartPos - tag.position) <= opt.stopToleranceM) {
+                    tag.resolved = true;
+                    stoppedSpot = spot;
+                    report.tagToStopMs.push_back((now - tag.enteredUs) / 1000.0);
+                }
+            }
+            if (stoppedSpot < 0) ++report.misalignedStops;
+        }
+    } else if (line == "FINISH") {
+        if (orderActive) finishRequested = true;
+    } else if (line == "START" || line == "GO") {
+        if (orderActive && !cartMoving && finishRequested && line == "GO") {
+            ++report.finishedEarly;
+            report.skippedAisleM += aisleEndM - cartPos;
+            cartPos = aisleEndM;
+            finishOrder();
+        } else if (orderActive && !cartMoving) {
+            cartMoving = true;
+            stoppedSpot = -1;
+        }
+    }
+
+    // 명령은 실행되고 ACK만 유실될 수 있다 (코어는 재전송)
+    if (chance(opt.ackLoss)) {
+        ++report.acksLost;
+        return;
+    }
+    hal::fakes().wheel.inject("ACK\n", now + static_cast<uint64_t>(jitter(opt.ackLatencyMs, opt.ackJitterMs)) * 1000);
+}
+
+// ========== tracego-server / 스탠드 ========================================================================
+namespace {
+
+String requestPath(const String& request) {
+    int start = request.indexOf(' ');
+    int end = request.indexOf(' ', start + 1);
+    if (start == -1 || end == -1) return "";
+    return request.substring(start + 1, end);
+}
+
+const char* reasonPhrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 226: return "IM Used";
+        case 304: return "Not Modified";
+        case 404: return "Not Found";
+        default:  return "Internal Server Error";
+    }
+}
+
+} // namespace
+
+LoopbackReply PickSimulator::reply(int code, const String& body, uint32_t latencyMs, uint32_t jitterMs,
+                                   const String& extraHeaders, const char* contentType) {
+    LoopbackReply r;
+    r.data = String("HTTP/1.1 ") + code + " " + reasonPhrase(code) + "\r\n" +
+             "Content-Type: " + contentType + "\r\n" + extraHeaders;
+    if (opt.serverChunked && code != 304) {
+        // 직렬화하면서 바로 내보내는 서버처럼 SIM_CHUNK_BYTES씩 나눠 보내고 크기 0 청크로 끝낸다
+        r.data += "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n";
+        for (unsigned int at = 0; at < body.length(); at += SIM_CHUNK_BYTES) {
+            const String chunk = body.substring(at, at + SIM_CHUNK_BYTES);
+            char size[12];
+            snprintf(size, sizeof(size), "%x\r\n", static_cast<unsigned int>(chunk.length()));
+            r.data += String(size) + chunk + "\r\n";
+        }
+        r.data += "0\r\n\r\n";
+    } else {
+        r.data += String("Content-Length: ") + static_cast<unsigned int>(body.length()) + "\r\n" +
+                  "Connection: close\r\n\r\n" + body;
+    }
+    r.latencyMs = jitter(latencyMs, jitterMs);
+    return r;
+}
+
+LoopbackReply PickSimulator::onServerRequest(const String& request, int instance) {
+    ++report.serverRequests;
+    if (instance > 0) ++report.backupRequests;
+
+    const double minute = (native::nowMicros() - startedUs) / 60e6;
+    if (instance == 0 && opt.serverOutageAtMin >= 0 && minute >= opt.serverOutageAtMin &&
+        minute < opt.serverOutageAtMin + opt.serverOutageMin) {
+        ++report.serverTimeouts;
+        LoopbackReply hung;
+        hung.drop = true;             // 연결은 되지만 응답이 오지 않음
+        hung.latencyMs = 10000;
+        return hung;
+    }
+    LoopbackReply r = routeServerRequest(request);
+    if (chance(opt.serverSlowRate)) {
+        ++report.serverSlow;
+        r.latencyMs += opt.serverSlowMs;
+    }
+    // keep-alive를 요청하면 연결을 열어 둔다 (서버 쪽 타임아웃이 지나면 닫힘)
+    if (opt.keepAliveSec > 0 && request.indexOf("Connection: keep-alive\r\n") != -1) {
+        r.data.replace("Connection: close\r\n", "Connection: keep-alive\r\n");
+        r.keepAliveMs = opt.keepAliveSec * 1000;
+    }
+    return r;
+}
+
+// 모든 인스턴스가 같은 데이터를 가진다 (대체 서버는 같은 DB를 보는 복제본)
+LoopbackReply PickSimulator::routeServerRequest(const String& request) {
+    const String path = requestPath(request);
+    if (chance(opt.serverErrorRate)) {
+        ++report.serverErrors;
+        return reply(500, "서버 오류", opt.serverLatencyMs, opt.serverJitterMs);
+    }
+    if (path == config.getPayment) {
+        return onPaymentRequest(request);
+    }
+    if (path == config.firstSetWoringLists) {
+        return reply(200, "초기 작업 리스트 생성 완료", opt.serverLatencyMs, opt.serverJitterMs);
+    }
+    if (path.startsWith(config.addWorkingList)) {
+        return reply(200, "작업 항목이 성공적으로 추가되었습니다.", opt.serverLatencyMs, opt.serverJitterMs);
+    }
+    if (path == config.resetWorkingLists) {
+        return reply(200, "작업 리스트를 초기화했습니다", opt.serverLatencyMs, opt.serverJitterMs);
+    }
+    return reply(404, "없는 경로", opt.serverLatencyMs, opt.serverJitterMs);
+}
+
+// 결제 내역: If-None-Match가 현재 ETag면 304, 직전 ETag이고 A-IM으로 변경분을 받겠다고 하면 226, 그 외 200 전체
+LoopbackReply PickSimulator::onPaymentRequest(const String& request) {
+    if (!opt.serverEtag) {
+        ++report.paymentFull;
+        return paymentReply(200, buildPaymentJson(), request, "");
+    }
+
+    String known = ServerService::extractHeader(request, "If-None-Match");
+    known.replace("\"", "");
+    const String etagHeader = String("ETag: \"") + paymentEtag + "\"\r\n";
+
+    if (known == paymentEtag) {
+        ++report.paymentNotModified;
+        return reply(304, "", opt.serverLatencyMs, opt.serverJitterMs, etagHeader);
+    }
+    if (!known.isEmpty() && known == previousEtag &&
+        ServerService::extractHeader(request, "A-IM").indexOf("payment-delta") != -1) {
+        ++report.paymentDelta;
+        return paymentReply(226, buildPaymentDelta(), request, etagHeader + "IM: payment-delta\r\n");
+    }
+
+    ++report.paymentFull;
+    return paymentReply(200, buildPaymentJson(), request, etagHeader);
+}
+
+// 서버가 MessagePack을 지원하고 요청의 Accept가 고르면 같은 문서를 MessagePack으로 바꿔 보낸다
+LoopbackReply PickSimulator::paymentReply(int code, const String& json, const String& request,
+                                          const String& extraHeaders) {
+    report.paymentJsonBytes += json.length();
+    if (opt.serverMsgPack &&
+        ServerService::negotiate(ServerService::extractHeader(request, "Accept")) == WireFormat::MsgPack) {
+        JsonDocument doc;
+        deserializeJson(doc, json);
+        String body;
+        serializeMsgPack(doc, body);
+        ++report.paymentMsgPack;
+        report.paymentBytes += body.length();
+        return reply(code, body, opt.serverLatencyMs, opt.serverJitterMs, extraHeaders, "application/msgpack");
+    }
+    report.paymentBytes += json.length();
+    return reply(code, json, opt.serverLatencyMs, opt.serverJitterMs, extraHeaders, "application/json");
+}
+
+String PickSimulator::buildPaymentJson() const {
+    String json = String("{\"paymentId\":\"") + paymentId + "\"";
+    for (const auto& entry : orderItems) {
+        json += String(",\"상품") + entry.first + "\":[\"" + tags[entry.first].uid + "\"," + entry.second + "]";
+    }
+    return json + "}";
+}
+
+// 직전 버전 → 현재 버전의 변경분 (같은 결제 ID 안에서만 만들어진다)
+String PickSimulator::buildPaymentDelta() const {
+    String added, changed, removed;
+    for (const auto& entry : orderItems) {
+        auto before = previousItems.find(entry.first);
+        if (before != previousItems.end() && before->second == entry.second) continue;
+        String& section = before == previousItems.end() ? added : changed;
+        if (!section.isEmpty()) section += ",";
+        section += String("\"상품") + entry.first + "\":[\"" + tags[entry.first].uid + "\"," + entry.second + "]";
+    }
+    for (const auto& entry : previousItems) {
+        if (orderItems.count(entry.first)) continue;
+        if (!removed.isEmpty()) removed += ",";
+        removed += String("\"상품") + entry.first + "\"";
+    }
+    return String("{\"paymentId\":\"") + paymentId + "\",\"base\":\"" + previousEtag + "\"" +
+           ",\"added\":{" + added + "},\"changed\":{" + changed + "},\"removed\":[" + removed + "]}";
+}
+
+// 스탠드: 작업을 받을 때마다 pickSec × 수량(qty)씩 이어서 처리하고, 모두 끝나면 코어에 /go 를 보내 카트를 다시 출발시킨다
+LoopbackReply PickSimulator::onStandRequest(const String& request) {
+    ++report.standRequests;
+    const String path = requestPath(request);
+
+    if (!path.startsWith("/start-stand")) {
+        return reply(404, "없는 경로", opt.standLatencyMs, opt.standJitterMs);
+    }
+    if (chance(opt.standErrorRate)) {
+        ++report.standErrors;
+        return reply(500, "스탠드 오류", opt.standLatencyMs, opt.standJitterMs);
+    }
+
+    LoopbackReply r = reply(200, "스탠드 작업 시작", opt.standLatencyMs, opt.standJitterMs);
+
+    // /start-stand?uid=<UID>&qty=<수량>
+    const int uidAt = path.indexOf("uid=");
+    const int qtyAt = path.indexOf("&qty=");
+    const String uid = uidAt == -1 ? String() : path.substring(uidAt + 4, qtyAt == -1 ? path.length() : qtyAt);
+    const int quantity = qtyAt == -1 ? 1 : std::max(1L, path.substring(qtyAt + 5).toInt());
+
+    // 정지한 자리의 대상 상품이면 작업 목록에 올린다 (같은 상품의 중복 요청은 무시)
+    TagState* target = nullptr;
+    for (int i = stoppedSpot < 0 ? 0 : spotBegin(stoppedSpot); stoppedSpot >= 0 && i < spotEnd(stoppedSpot); ++i) {
+        if (tags[i].target && !tags[i].staged && tags[i].uid == uid) target = &tags[i];
+    }
+    if (!target && resumePending) return r;   // 이미 작업 중 (중복 요청)
+
+    const uint64_t startUs = std::max(standDoneUs, native::nowMicros() + static_cast<uint64_t>(r.latencyMs) * 1000);
+    standDoneUs = startUs + static_cast<uint64_t>(opt.pickSec * quantity * 1e6);
+    if (target) {
+        target->staged = true;
+        ++stagedPicks;
+    }
+    if (!resumePending) {
+        resumePending = true;
+        schedule(standDoneUs, [this]() { finishStand(); });
+    }
+    return r;
+}
+
+// 스탠드 작업 완료 시점: 그 사이 작업이 더 들어왔으면 끝날 때까지 미룬다
+void PickSimulator::finishStand() {
+    if (native::nowMicros() < standDoneUs) {
+        schedule(standDoneUs, [this]() { finishStand(); });
+        return;
+    }
+    report.picks += stagedPicks;
+    if (stagedPicks > 1) ++report.multiPickStops;
+    stagedPicks = 0;
+    resumePending = false;
+    sendCoreRequest("/go");
+}
+
+// ========== 주문 흐름 ======================================================================================
+void PickSimulator::startOrder() {
+    // 통로 상태 초기화 후 주문 상품을 무작위로 고른다
+    std::vector<int> indices(tags.size());
+    for (size_t i = 0; i < indices.size(); ++i) indices[i] = static_cast<int>(i);
+    std::shuffle(indices.begin(), indices.end(), rng);
+    const int count = std::min<int>(opt.orderItems, static_cast<int>(indices.size()));
+
+    // 직전 결제를 고친 주문: 같은 결제 ID로 상품 하나를 바꾸고 다른 하나의 수량을 늘린다.
+    // 이미 집은 상품은 다시 집지 않으므로 새로 들어온 상품과 늘어난 수량만 이번 통과의 대상이다.
+    const bool amend = !orderItems.empty() && count > 1 && chance(opt.amendRate);
+    previousItems = orderItems;
+    previousEtag = amend ? paymentEtag : "";   // 변경분은 같은 결제 ID 안에서만
+    if (amend) {
+        int replaced = -1;
+        for (int index : indices) {
+            if (!orderItems.count(index)) {
+                replaced = index;
+                break;
+            }
+        }
+        if (replaced >= 0) {
+            orderItems.erase(orderItems.begin());
+            orderItems[replaced] = 1;
+        }
+        ++orderItems.rbegin()->second;
+        ++paymentRevision;
+    } else {
+        orderItems.clear();
+        for (int k = 0; k < count; ++k) orderItems[indices[k]] = 1;
+        paymentId = String("SIM-") + (report.ordersStarted + 1);
+        paymentRevision = 1;
+    }
+    paymentEtag = paymentId + "." + paymentRevision;
+
+    for (auto& tag : tags) {
+        tag.target = false;
+        tag.reported = false;
+        tag.resolved = false;
+        tag.staged = false;
+        tag.enteredUs = 0;
+        tag.lastReadUs = 0;
+    }
+
+    ++report.ordersStarted;
+    for (const auto& entry : orderItems) {
+        auto before = amend ? previousItems.find(entry.first) : previousItems.end();
+        if (before != previousItems.end() && before->second >= entry.second) continue;
+        tags[entry.first].target = true;
+        ++report.targetTags;
+    }
+
+    cartPos = 0;
+    cartMoving = false;
+    cartUpdatedUs = native::nowMicros();
+    stoppedSpot = -1;
+    orderActive = true;
+    sendCoreRequest("/start");
+}
+
+void PickSimulator::finishOrder() {
+    orderActive = false;
+    finishRequested = false;
+    ++report.ordersCompleted;
+    resumePending = true;
+    schedule(native::nowMicros() + static_cast<uint64_t>(opt.turnaroundSec * 1e6), [this]() {
+        resumePending = false;
+        startOrder();
+    });
+}
+
+// 코어의 내장 서버에 요청을 넣는다 (다음 loop()의 handle()에서 처리)
+void PickSimulator::sendCoreRequest(const String& uri) {
+    idleSinceUs = native::nowMicros();
+    if (opt.motionUdp && uri == "/go") {          // 모션 명령은 데이터그램으로 (/start는 결제 내역이 필요하므로 HTTP / ws)
+        sendMotion(MOTION_GO);
+        return;
+    }
+    if (commandStream) {                          // 명령 채널이 열려 있으면 같은 명령을 프레임으로
+        sendCommand(uri.substring(1));
+        return;
+    }
+    WebServer* server = WebServer::find(config.innerPort);
+    if (!server) return;
+    if (uri != "/go") {
+        server->inject(HTTP_GET, uri);
+        return;
+    }
+    const uint64_t sentUs = native::nowMicros();
+    server->inject(HTTP_GET, uri, String(), {}, [this, sentUs](const WebServer::Response&) {
+        report.httpGoMs.push_back((native::nowMicros() - sentUs) / 1000.0);
+    });
+}
+
+// 대시보드: 마지막으로 받은 ETag로 /status를 조건부로 묻는다 (브라우저의 Cache-Control: no-cache 재검증과 같음)
+void PickSimulator::pollDashboard() {
+    WebServer* server = WebServer::find(config.innerPort);
+    if (server) {
+        std::vector<std::pair<String, String>> headers;
+        if (!dashboardEtag.isEmpty()) headers.emplace_back("If-None-Match", dashboardEtag);
+        server->inject(HTTP_GET, "/status", String(), headers, [this](const WebServer::Response& response) {
+            ++report.statusPolls;
+            if (response.code == 304) ++report.statusNotModified;
+            report.statusBytes += response.body.length();
+            for (const auto& h : response.headers) {
+                if (h.first.equalsIgnoreCase("ETag")) dashboardEtag = h.second;
+            }
+        });
+    }
+    schedule(native::nowMicros() + opt.dashboardMs * 1000ULL, [this]() { pollDashboard(); });
+}
+
+// 요청 폭주: 여러 브라우저 / 모니터링이 한꺼번에 페이지와 /status를 연다 (조건부 요청 아님)
+void PickSimulator::burstHttp() {
+    static const char* const uris[] = { "/status", "/", "/status-view", "/advanced" };
+    WebServer* server = WebServer::find(config.innerPort);
+    for (uint32_t i = 0; server && i < opt.httpBurst; ++i) {
+        const uint64_t sentUs = native::nowMicros();
+        ++report.burstRequests;
+        server->inject(HTTP_GET, uris[i % 4], String(), {}, [this, sentUs](const WebServer::Response& response) {
+            if (response.code == 503) ++report.burstShed;
+            else if (response.code == 200) ++report.burstServed;
+            report.burstMs.push_back((native::nowMicros() - sentUs) / 1000.0);
+        });
+    }
+    schedule(native::nowMicros() + static_cast<uint64_t>(opt.httpBurstSec * 1e6), [this]() { burstHttp(); });
+}
+
+// 대시보드: /events를 열어 두고 코어가 밀어 주는 이벤트만 받는다 (폴링하지 않음)
+void PickSimulator::openEventStreams() {
+    WebServer* server = WebServer::find(config.innerPort);
+    if (!server) return;
+    for (uint32_t i = 0; i < opt.dashboardSse; ++i) {
+        server->inject(HTTP_GET, "/events", String(), {}, [this](const WebServer::Response& response) {
+            ++report.sseOpened;
+            if (response.stream) dashboardStreams.push_back(response.stream);
+            else if (response.code == 503) ++report.sseRejected;
+        });
+    }
+    schedule(native::nowMicros() + 1000000ULL, [this]() { readEventStreams(); });
+}
+
+// 받은 바이트를 비우며 이벤트 수를 센다 (1초마다, 끝날 때 한 번 더)
+void PickSimulator::readEventStreams() {
+    for (const auto& stream : dashboardStreams) {
+        for (int at = stream->data.indexOf("event: "); at != -1; at = stream->data.indexOf("event: ", at + 7)) {
+            ++report.sseEvents;
+            if (stream->data.substring(at + 7, at + 13) == "status") ++report.sseStatusEvents;
+        }
+        report.sseBytes += stream->data.length();
+        stream->data = String();
+    }
+    if (!dashboardStreams.empty()) schedule(native::nowMicros() + 1000000ULL, [this]() { readEventStreams(); });
+}
+
+// 중앙 서버: /ws로 업그레이드하고 연결을 열어 둔다. 101을 받기 전의 명령은 HTTP로 간다
+void PickSimulator::openCommandChannel() {
+    WebServer* server = WebServer::find(config.innerPort);
+    if (!server) return;
+    std::vector<std::pair<String, String>> headers = {
+        {"Upgrade", "websocket"}, {"Connection", "Upgrade"},
+        {"Sec-WebSocket-Key", "dGhlIHNhbXBsZSBub25jZQ=="}, {"Sec-WebSocket-Version", "13"}};
+    server->inject(HTTP_GET, "/ws", String(), headers, [this](const WebServer::Response& response) {
+        if (response.stream && response.stream->data.startsWith("HTTP/1.1 101")) {
+            commandStream = response.stream;
+            commandStream->data = commandStream->data.substring(commandStream->data.indexOf("\r\n\r\n") + 4);
+        }
+    });
+}
+
+// 클라이언트 프레임: FIN + 텍스트, 마스킹 필수
+void PickSimulator::sendCommand(const String& command) {
+    const String message = String("{\"session\":\"sim-") + opt.seed + "\",\"seq\":" + ++commandSeq + ",\"cmd\":\"" + command + "\"}";
+    const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+    String frame;
+    frame += static_cast<char>(0x81);
+    frame += static_cast<char>(0x80 | message.length());      // 명령은 125바이트보다 짧다
+    for (uint8_t m : mask) frame += static_cast<char>(m);
+    for (size_t i = 0; i < message.length(); ++i) frame += static_cast<char>(message[i] ^ mask[i & 3]);
+    commandStream->input += frame;
+    commandSentUs[commandSeq] = native::nowMicros();
+    ++report.wsCommands;
+}
+
+// 서버 프레임은 마스킹하지 않는다. 응답 JSON에서 seq / ok만 본다
+void PickSimulator::readCommandReplies() {
+    String& data = commandStream->data;
+    while (data.length() >= 2) {
+        size_t length = static_cast<uint8_t>(data[1]) & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (data.length() < 4) return;
+            length = (static_cast<size_t>(static_cast<uint8_t>(data[2])) << 8) | static_cast<uint8_t>(data[3]);
+            header = 4;
+        }
+        if (data.length() < header + length) return;
+        const uint8_t opcode = static_cast<uint8_t>(data[0]) & 0x0F;
+        const String payload = data.substring(header, header + length);
+        data = data.substring(header + length);
+        if (opcode != 0x1) continue;
+
+        const int at = payload.indexOf("\"seq\":");
+        const uint32_t seq = at < 0 ? 0 : static_cast<uint32_t>(payload.substring(at + 6).toInt());
+        auto sent = commandSentUs.find(seq);
+        if (sent == commandSentUs.end()) continue;
+        ++report.wsReplies;
+        if (payload.indexOf("\"ok\":false") != -1) ++report.wsFailed;
+        report.wsReplyMs.push_back((native::nowMicros() - sent->second) / 1000.0);
+        commandSentUs.erase(sent);
+    }
+}
+
+// 중앙 서버: 모션 명령 하나에 seq 하나. ACK가 올 때까지 같은 seq로 다시 보낸다 (코어는 한 번만 실행)
+void PickSimulator::sendMotion(uint8_t type) {
+    const uint32_t seq = ++motionSeq;
+    motionPending[seq] = {type, native::nowMicros(), 0};
+    ++report.udpCommands;
+    transmitMotion(seq);
+}
+
+void PickSimulator::transmitMotion(uint32_t seq) {
+    auto pending = motionPending.find(seq);
+    if (pending == motionPending.end()) return;           // 이미 ACK를 받음
+    if (pending->second.attempts >= SIM_MOTION_ATTEMPTS) {
+        ++report.udpGaveUp;
+        motionPending.erase(pending);
+        return;
+    }
+    if (pending->second.attempts++ > 0) ++report.udpRetransmits;
+
+    MotionFrame command;
+    command.type = pending->second.type;
+    command.epoch = motionEpoch;
+    command.seq = seq;
+    uint8_t datagram[MOTION_DATAGRAM_SIZE];
+    const size_t length = MotionListener::encodeCommand(motionKey, command, datagram);
+    if (!chance(opt.motionLoss)) hal::fakes().motion.inject(datagram, length, IPAddress(10, 0, 0, 2), SIM_SENDER_PORT);
+    schedule(native::nowMicros() + opt.motionRetryMs * 1000ULL, [this, seq]() { transmitMotion(seq); });
+}
+
+// 코어가 보낸 ACK (유실될 수 있음). 같은 seq의 두 번째 ACK는 늦게 온 답이라 버린다
+void PickSimulator::onMotionAck(const FakeDatagram& datagram) {
+    if (chance(opt.motionLoss)) return;
+    MotionFrame ack;
+    if (!MotionListener::decodeAck(motionKey, reinterpret_cast<const uint8_t*>(datagram.data.data()),
+                                   datagram.data.size(), ack)) return;
+    auto pending = motionPending.find(ack.seq);
+    if (pending == motionPending.end() || ack.epoch != motionEpoch) return;
+
+    const uint8_t status = ack.status & ~MOTION_DUPLICATE;
+    if (status == MOTION_STALE && !(ack.status & MOTION_DUPLICATE)) {   // 코어가 재부팅해 지난 epoch을 받지 않음
+        ++motionEpoch;
+        return;                                           // 다음 재전송이 새 epoch으로 감
+    }
+    ++report.udpAcks;
+    if (ack.status & MOTION_DUPLICATE) ++report.udpDuplicateAcks;
+    if (status != MOTION_ACKED) ++report.udpFailed;
+    report.udpAckMs.push_back((native::nowMicros() - pending->second.sentUs) / 1000.0);
+    motionPending.erase(pending);
+}
+
+void PickSimulator::schedule(uint64_t atUs, std::function<void()> action) {
+    events.emplace(atUs, std::move(action));
+}
+
+void PickSimulator::runDueEvents() {
+    while (!events.empty() && events.begin()->first <= native::nowMicros()) {
+        auto action = events.begin()->second;
+        events.erase(events.begin());
+        action();
+    }
+}
+
+// 멈춘 채로 예약된 재출발도 없으면 (ACK 실패, 스탠드 실패, 시작 차단) 작업자가 다시 출발시킨다
+void PickSimulator::watchdog() {
+    if (!orderActive || cartMoving || resumePending) return;
+    const uint64_t now = native::nowMicros();
+    if (now - idleSinceUs < static_cast<uint64_t>(opt.operatorTimeoutSec * 1e6)) return;
+
+    ++report.operatorResumes;
+    sendCoreRequest(cartPos == 0 ? "/start" : "/go");
+}
+
+// ========== 난수 ===========================================================================================
+bool PickSimulator::chance(double probability) {
+    if (probability <= 0) return false;
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability;
+}
+
+uint32_t PickSimulator::jitter(uint32_t baseMs, uint32_t jitterMs) {
+    if (jitterMs == 0) return baseMs;
+    return baseMs + std::uniform_int_distribution<uint32_t>(0, jitterMs)(rng);
+}
+
+// ========== 결과 출력 ======================================================================================
+void SimReport::print() const {
+    const double hours = simulatedSec / 3600.0;
+    printf("\n[PickSim] 시뮬레이션 %.2f h (실제 %.2f s, %.0f배속)\n", hours, wallSec,
+           wallSec > 0 ? simulatedSec / wallSec : 0.0);
+    printf("  주문            : 시작 %u / 완료 %u\n", ordersStarted, ordersCompleted);
+    printf("  피킹            : %u (%.1f picks/h, 한 번 정지에 여러 상품 %u회)\n", picks, hours > 0 ? picks / hours : 0.0,
+           multiPickStops);
+    printf("  놓친 태그       : %u / %u (%.2f%%)\n", missedTags, targetTags,
+           targetTags ? 100.0 * missedTags / targetTags : 0.0);
+    printf("  늦은 정지       : %u\n", misalignedStops);
+    printf("  작업자 개입     : %u\n", operatorResumes);
+    printf("  주문 완료 복귀  : %u (건너뛴 통로 %.1f m)\n", finishedEarly, skippedAisleM);
+    printf("  태그 읽기       : %u (중복 억제 %u)\n", tagReads, tagsSuppressed);
+    printf("  리더기          : %u대 %s, 탐지 %u회, 감지 %u, IRQ %u (놓침 %u)\n", rfid.readerCount, rfid.modeName(),
+           rfid.probes, rfid.detections, rfid.irqEvents, rfid.irqMisses);
+    for (uint8_t r = 0; r < rfid.readerCount; ++r) {
+        printf("    리더기 %u      : %s, 탐지 %u회, 감지 %u\n", r, rfid.readers[r].irqMode ? "IRQ" : "폴링",
+               rfid.readers[r].probes, rfid.readers[r].detections);
+    }
+    printf("  감지 지연       : 평균 %.2f ms, 최대 %.2f ms, 유휴 리더기 부하 %.1f%%\n",
+           rfid.latencyAvgUs() / 1000.0, rfid.latencyMaxUs / 1000.0, rfidIdleLoadPct);
+    printf("  UID 읽기 시간   : 평균 %u us, 인벤토리 추가 읽기 %u\n", rfid.readAvgUs(), rfid.inventoryExtra);
+    printf("  바퀴 명령       : %u (ACK 유실 %u)\n", wheelCommands, acksLost);
+    printf("  서버 요청       : %u (오류 %u, 응답 없음 %u)\n", serverRequests, serverErrors, serverTimeouts);
+    printf("  결제 내역 응답  : 전체 %u / 304 %u / 변경분 %u (본문 %u B)\n", paymentFull, paymentNotModified,
+           paymentDelta, paymentBytes);
+    if (paymentMsgPack > 0) {
+        printf("  결제 내역 형식  : MessagePack %u회, 본문 %u B (JSON이었다면 %u B, %.0f%%)\n", paymentMsgPack,
+               paymentBytes, paymentJsonBytes, paymentJsonBytes ? paymentBytes * 100.0 / paymentJsonBytes : 0.0);
+    }
+    printf("  스탠드 요청     : %u (오류 %u)\n", standRequests, standErrors);
+    if (statusPolls > 0) {
+        printf("  대시보드 /status: %u회, 304 %u (%.0f%%), 본문 %u B, 코어가 본문을 만든 횟수 %u\n", statusPolls,
+               statusNotModified, statusNotModified * 100.0 / statusPolls, statusBytes, statusBuilds);
+    }
+    if (wsCommands > 0) {
+        std::vector<double> sorted = wsReplyMs;
+        std::sort(sorted.begin(), sorted.end());
+        const double p50 = sorted.empty() ? 0.0 : sorted[sorted.size() / 2];
+        const double maxMs = sorted.empty() ? 0.0 : sorted.back();
+        printf("  /ws 명령        : %u (응답 %u, 실패 %u), 응답까지 p50 %.1f ms, 최대 %.1f ms\n", wsCommands, wsReplies,
+               wsFailed, p50, maxMs);
+    }
+    if (!httpGoMs.empty() || udpCommands > 0) {
+        auto summary = [](std::vector<double> samples, double& p50, double& p99, double& maxMs) {
+            std::sort(samples.begin(), samples.end());
+            p50 = samples.empty() ? 0.0 : samples[samples.size() / 2];
+            p99 = samples.empty() ? 0.0 : samples[static_cast<size_t>(0.99 * (samples.size() - 1) + 0.5)];
+            maxMs = samples.empty() ? 0.0 : samples.back();
+        };
+        double p50, p99, maxMs;
+        if (!httpGoMs.empty()) {
+            summary(httpGoMs, p50, p99, maxMs);
+            printf("  HTTP /go        : n=%zu 응답까지 p50 %.1f ms, p99 %.1f, 최대 %.1f\n", httpGoMs.size(), p50, p99, maxMs);
+        }
+        if (udpCommands > 0) {
+            summary(udpAckMs, p50, p99, maxMs);
+            printf("  UDP 모션 명령   : %u (재전송 %u, 포기 %u), ACK %u (기억한 ACK %u, 실패 %u), ACK까지 p50 %.1f ms, p99 %.1f, 최대 %.1f\n",
+                   udpCommands, udpRetransmits, udpGaveUp, udpAcks, udpDuplicateAcks, udpFailed, p50, p99, maxMs);
+            printf("  코어 모션 수신  : 받음 %u, 실행 %u (실패 %u), 중복 %u, 지난 seq %u, MAC 불일치 %u\n", motion.received,
+                   motion.executed, motion.failed, motion.duplicates, motion.stale, motion.badMac);
+        }
+    }
+    if (burstRequests > 0) {
+        std::vector<double> sorted = burstMs;
+        std::sort(sorted.begin(), sorted.end());
+        const double p50 = sorted.empty() ? 0.0 : sorted[sorted.size() / 2];
+        const double maxMs = sorted.empty() ? 0.0 : sorted.back();
+        printf("  요청 폭주       : %u (200 %u, 503 %u), 응답까지 p50 %.1f ms, 최대 %.1f ms\n", burstRequests, burstServed,
+               burstShed, p50, maxMs);
+    }
+    printf("  내장 서버       : 받음 %u, 미룸 예산 %u / 토큰 %u / 스캔 %u, 예산 초과 바퀴 %u, 최대 %.1f ms\n",
+           http.admitted, http.shedBudget, http.shedQueue, http.shedScan, http.overruns, http.maxIterationUs / 1000.0);
+    printf("  RFID 스캔 간격  : 최대 %.1f ms, %u ms 초과 %u회\n", http.scanGapMaxUs / 1000.0, RFID_MAX_GAP_MS, http.scanLate);
+    if (sseOpened > 0) {
+        printf("  대시보드 /events: 연결 %u (503 %u), 이벤트 %u (status %u), %u B, 코어가 본문을 만든 횟수 %u\n",
+               sseOpened - sseRejected, sseRejected, sseEvents, sseStatusEvents, sseBytes, statusBuilds);
+    }
+    printf("  알림 보관함     : 전달 %u, 재시도 %u, 남음 %u\n", outboxDelivered, outboxRetries, outboxPending);
+    printf("  서킷 브레이커   : 열림 %u, 바로 실패 %u\n", breakerTrips, breakerRejected);
+    printf("  서버 인스턴스   : 느린 응답 %u, 대체 서버 요청 %u, 헤지 %u (먼저 응답 %u)\n", serverSlow, backupRequests,
+           hedges, hedgeWins);
+    printf("  서버 연결       : 새 연결 %u, keep-alive 재사용 %u\n", serverConnects, serverReuses);
+    if (tls.handshakes + tls.resumed > 0) {
+        printf("  TLS 핸드셰이크  : 전체 %u (평균 %u ms), 세션 재개 %u (평균 %u ms), 재개율 %u%% (모델: 왕복 × connect-ms + 계산 시간)\n", tls.handshakes,
+               tls.fullAvgMs(), tls.resumed, tls.resumedAvgMs(), tls.resumePct());
+    }
+    if (!serverCallMs.empty()) {
+        std::vector<double> calls = serverCallMs;
+        std::sort(calls.begin(), calls.end());
+        auto at = [&](double p) { return calls[static_cast<size_t>(p * (calls.size() - 1) + 0.5)]; };
+        printf("  서버 요청 지연  : n=%zu p50 %.0f ms, p95 %.0f, p99 %.0f, 최대 %.0f\n", calls.size(), at(0.50),
+               at(0.95), at(0.99), calls.back());
+    }
+    printf("  DNS             : 조회 %u, 캐시 적중 %u%%, 질의 %u (미리 갱신 %u)\n", dns.lookups, dns.hitPct(), dnsQueries,
+           dns.refreshes);
+
+    if (tagToStopMs.empty()) {
+        printf("  태그→정지 지연  : 표본 없음\n");
+        return;
+    }
+
+    std::vector<double> sorted = tagToStopMs;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        size_t idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[idx];
+    };
+    double sum = 0;
+    for (double v : sorted) sum += v;
+
+    printf("  태그→정지 지연  : n=%zu 평균 %.1f ms, p50 %.1f, p90 %.1f, p99 %.1f, 최대 %.1f\n",
+           sorted.size(), sum / sorted.size(), percentile(0.50), percentile(0.90), percentile(0.99), sorted.back());
+
+    const double bounds[] = { 5, 10, 20, 50, 100, 200, 500 };
+    size_t lower = 0;
+    double prev = 0;
+    for (double bound : bounds) {
+        size_t upper = std::lower_bound(sorted.begin(), sorted.end(), bound) - sorted.begin();
+        printf("    %4.0f ~ %4.0f ms : %zu\n", prev, bound, upper - lower);
+        lower = upper;
+        prev = bound;
+    }
+    printf("    %4.0f ms 이상   : %zu\n", prev, sorted.size() - lower);
+}
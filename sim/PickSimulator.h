@@ -0,0 +1,290 @@
+// PickSimulator.h
+#ifndef PICKSIMULATOR_H
+#define PICKSIMULATOR_H
+
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "AdmissionControl.h"
+#include "DnsCache.h"
+#include "NativeDevices.h"
+#include "FakeTagReader.h"
+#include "MotionListener.h"
+#include "RFIDController.h"
+#include "WebServer.h"
+
+/**
+ * 시뮬레이션 매개변수 (명령줄 옵션으로 덮어쓴다)
+ */
+struct SimOptions {
+    double hours = 1.0;                 // 시뮬레이션할 근무 시간
+    uint32_t seed = 1;                  // 난수 시드 (같은 시드 = 같은 결과)
+
+    // 통로 배치 / 카트
+    int tagCount = 40;                  // 통로에 붙은 상품 태그 수
+    int shelfSides = 1;                 // 태그가 붙은 선반 면 수 (2 = 양쪽 번갈아)
+    int tagsPerSpot = 1;                // 한 자리에 함께 놓인 태그 수 (같은 선반 칸의 여러 상품)
+    double firstTagM = 1.0;             // 출발점 ~ 첫 태그 거리
+    double tagSpacingM = 0.5;           // 태그 간격
+    double readRangeM = 0.03;           // 리더기 인식 거리 (태그 중심 ± 이 값)
+    double stopToleranceM = 0.05;       // 스탠드가 집을 수 있는 정지 오차
+    double cartSpeedMps = 0.3;          // 카트 속도
+    int orderItems = 5;                 // 주문 하나의 상품 수
+    double turnaroundSec = 20.0;        // 통로 끝 → 다음 주문 시작까지
+    double pickSec = 8.0;               // 스탠드 작업 시간 (정지 → /go)
+    double operatorTimeoutSec = 30.0;   // 멈춘 카트를 작업자가 다시 출발시키기까지
+    double amendRate = 0.0;             // 다음 주문이 직전 결제를 고친 것일 확률 (같은 결제 ID, 상품 교체 + 수량 변경)
+
+    // 리더기 비용 (가상 시간에 더해짐)
+    uint32_t pollCostUs = 1200;         // 카드 없음 (REQA 타임아웃 포함)
+    uint32_t readCostUs = 4000;         // 카드 있음 (선택 + UID 읽기)
+    uint32_t armCostUs = 60;            // 인터럽트 모드의 REQA 무장 (레지스터 쓰기만)
+    int readers = 1;                    // 코어의 리더기 수 (리더기 r은 선반 면 r % shelfSides를 본다)
+    int irqPin = -1;                    // 코어의 IRQ 핀 설정 (-1 = 폴링, 리더기마다 +1)
+    uint32_t rereadMs = 0;              // 인식 범위 안의 태그가 다시 읽히는 간격 (0 = 통과 1회당 1번)
+    int inventory = -1;                 // 코어의 다중 태그 인벤토리 (-1 = 펌웨어 기본값, 0 = 끔, 1 = 켬)
+    int dedupMs = -1;                   // 코어의 중복 억제 시간 (-1 = 펌웨어 기본값, 0 = 끔)
+
+    // 바퀴 보드
+    uint32_t ackLatencyMs = 5;
+    uint32_t ackJitterMs = 5;
+    double ackLoss = 0.0;               // ACK 유실 확률 (명령은 실행됨)
+
+    // tracego-server / 스탠드
+    uint32_t serverLatencyMs = 40;
+    uint32_t serverJitterMs = 20;
+    double serverErrorRate = 0.0;       // 500 응답 확률
+    double serverOutageAtMin = -1;      // 서버가 응답 없이 멈추는 시각 (분, 음수 = 없음)
+    double serverOutageMin = 0;         // 멈춰 있는 시간 (분)
+    int servers = 1;                    // tracego-server 인스턴스 수 (2 = 대체 서버 하나, 장애는 0번만)
+    double serverSlowRate = 0.0;        // 인스턴스마다 따로 뽑는 느린 응답 확률 (GC / 디스크 지연 같은 꼬리)
+    uint32_t serverSlowMs = 1200;       // 느린 응답에 더해지는 지연
+    int serverTls = 0;                  // 코어가 서버에 HTTPS로 연결 (server_tls)
+    uint32_t tlsFullCpuMs = 890;        // 전체 TLS 핸드셰이크의 ESP32 계산 시간 (RSA 2048 검증 + ECDHE, 왕복 제외)
+    uint32_t tlsResumeCpuMs = 10;       // 세션 재개의 계산 시간 (대칭키만, 왕복 제외)
+    uint32_t tlsSessionSec = 300;       // 서버가 세션을 받아 주는 시간 (0 = 재개 안 함)
+    uint32_t keepAliveSec = 15;         // 서버의 keep-alive 타임아웃 (0 = 응답마다 연결을 닫음)
+    uint32_t connectMs = 5;             // TCP 연결 왕복
+    uint32_t dnsTtlSec = 300;           // 서버 호스트 이름 응답 TTL
+    uint32_t dnsLatencyMs = 30;         // DNS 질의 한 번에 걸리는 시간
+    int serverEtag = 1;                 // 결제 내역 ETag / 304 / 변경분(226) 지원 (0 = 항상 전체 200)
+    int serverMsgPack = 0;              // Accept: application/msgpack이면 결제 내역을 MessagePack으로 (0 = 항상 JSON)
+    int serverChunked = 0;              // 서버 / 스탠드가 Content-Length 없이 Transfer-Encoding: chunked로 응답
+    uint32_t standLatencyMs = 30;
+    uint32_t standJitterMs = 10;
+    double standErrorRate = 0.0;
+    uint32_t dashboardMs = 0;           // 대시보드가 /status를 조건부로 묻는 주기 (0 = 묻지 않음)
+    uint32_t dashboardSse = 0;          // /events를 열어 두는 대시보드 수 (EVENT_MAX_CLIENTS를 넘으면 나머지는 503)
+    int commandWs = 0;                  // 작업자의 /start /go를 /ws 명령 채널로 보냄 (0 = HTTP GET)
+    int motionUdp = 0;                  // 스탠드의 /go를 UDP 모션 데이터그램으로 보냄 (/start는 그대로)
+    double motionLoss = 0.0;            // 모션 데이터그램 유실 확률 (명령 / ACK 각각)
+    uint32_t motionRetryMs = 100;       // ACK를 못 받으면 같은 seq로 다시 보내는 간격
+
+    // 내장 서버 비용 (가상 시간에 더해짐) / 요청 폭주
+    uint32_t httpCostUs = 1500;         // 요청 하나: 연결 수락 + 파싱 + 짧은 응답 쓰기 (제어 / 304 / 503)
+    uint32_t pageCostUs = 40000;        // 페이지 / /status 본문 생성 + 응답 쓰기 (수 KB를 WiFi로)
+    uint32_t httpBurst = 0;             // 한 번에 몰려오는 페이지 / 상태 요청 수 (0 = 없음)
+    double httpBurstSec = 10.0;         // 폭주 간격
+};
+
+/**
+ * 시뮬레이션 결과
+ */
+struct SimReport {
+    double simulatedSec = 0;
+    double wallSec = 0;
+    uint32_t ordersStarted = 0;
+    uint32_t ordersCompleted = 0;
+    uint32_t targetTags = 0;            // 주문에 포함되어 통과한 태그 수
+    uint32_t picks = 0;                 // 허용 오차 안에서 정지 + 스탠드 작업 완료
+    uint32_t multiPickStops = 0;        // 한 번 정지에 상품 2개 이상을 집은 정지
+    uint32_t missedTags = 0;            // 정지하지 못하고 지나친 대상 태그
+    uint32_t misalignedStops = 0;       // 대상 태그를 지나친 뒤 늦게 정지
+    uint32_t operatorResumes = 0;       // 작업자 개입으로 재출발
+    uint32_t finishedEarly = 0;         // FINISH를 받아 통로 나머지를 건너뛴 주문
+    double skippedAisleM = 0;           // FINISH로 건너뛴 통로 거리 합계
+    uint32_t wheelCommands = 0;
+    uint32_t acksLost = 0;
+    uint32_t serverRequests = 0;
+    uint32_t serverErrors = 0;
+    uint32_t serverTimeouts = 0;        // 서버가 멈춘 동안 들어온 요청 (코어는 타임아웃까지 기다림)
+    uint32_t serverSlow = 0;            // 느린 꼬리 응답
+    uint32_t backupRequests = 0;        // 대체 서버(1번 인스턴스)가 받은 요청
+    uint32_t hedges = 0;                // 코어가 보낸 헤지 요청
+    uint32_t hedgeWins = 0;             //            그중 먼저 응답한 것
+    std::vector<double> serverCallMs;   // 코어 쪽에서 본 서버 요청 하나의 전체 지연 (헤지 포함)
+    uint32_t serverConnects = 0;        // 코어가 서버로 새로 연 연결 (TLS면 핸드셰이크 포함)
+    uint32_t serverReuses = 0;          //            keep-alive 연결을 재사용한 요청
+    TlsStats tls;                       // 코어 TLS 핸드셰이크
+    uint32_t paymentFull = 0;           // 결제 내역 응답: 200 전체
+    uint32_t paymentNotModified = 0;    //                304
+    uint32_t paymentDelta = 0;          //                226 변경분
+    uint32_t paymentBytes = 0;          // 결제 내역 응답 본문 합계
+    uint32_t paymentMsgPack = 0;        //                그중 MessagePack으로 보낸 200/226
+    uint32_t paymentJsonBytes = 0;      //                같은 응답을 JSON으로 보냈다면의 본문 합계
+    uint32_t standRequests = 0;
+    uint32_t standErrors = 0;
+    uint32_t statusPolls = 0;           // 대시보드 /status 요청
+    uint32_t statusNotModified = 0;     //                 그중 304
+    uint32_t statusBytes = 0;           //                 받은 본문 합계
+    uint32_t statusBuilds = 0;          // 코어가 /status 본문을 다시 만든 횟수
+    uint32_t sseOpened = 0;             // 대시보드 /events 연결
+    uint32_t sseRejected = 0;           //                   그중 503
+    uint32_t sseEvents = 0;             //                   받은 이벤트 (연결 합계)
+    uint32_t sseStatusEvents = 0;       //                   그중 status
+    uint32_t sseBytes = 0;              //                   받은 바이트 (헤더 포함)
+    uint32_t wsCommands = 0;            // /ws로 보낸 명령
+    uint32_t wsReplies = 0;             //       받은 응답
+    uint32_t wsFailed = 0;              //       그중 ok:false (ACK 없음 / 시작 차단)
+    std::vector<double> wsReplyMs;      //       보낸 뒤 응답까지 (가상 시간, 바퀴 보드 ACK 대기 포함)
+    std::vector<double> httpGoMs;       // HTTP /go 요청 → 응답 (UDP와 비교용, 바퀴 보드 ACK 대기 포함)
+    uint32_t udpCommands = 0;           // UDP로 보낸 모션 명령
+    uint32_t udpRetransmits = 0;        //       ACK를 못 받아 같은 seq로 다시 보낸 횟수
+    uint32_t udpAcks = 0;               //       명령마다 처음 받은 ACK
+    uint32_t udpDuplicateAcks = 0;      //       그중 코어가 실행 없이 기억해 둔 ACK로 답한 것
+    uint32_t udpFailed = 0;             //       바퀴 보드 ACK 없음 / STALE
+    uint32_t udpGaveUp = 0;             //       재전송을 다 써도 ACK를 못 받음
+    std::vector<double> udpAckMs;       //       처음 보낸 뒤 ACK까지 (재전송 포함)
+    MotionStats motion;                 // 코어 모션 수신기
+    uint32_t burstRequests = 0;         // 폭주로 보낸 페이지 / 상태 요청
+    uint32_t burstServed = 0;           //       그중 200으로 받은 것
+    uint32_t burstShed = 0;             //       그중 503 (Retry-After)
+    std::vector<double> burstMs;        //       보낸 뒤 응답까지 (503 포함)
+    AdmissionStats http;                // 코어 내장 서버 수락 제어
+    uint32_t outboxDelivered = 0;       // 코어 보관함이 전달한 알림
+    uint32_t outboxRetries = 0;         //              실패 후 다시 보낸 횟수
+    uint32_t outboxPending = 0;         //              끝날 때 남은 알림
+    uint32_t breakerTrips = 0;          // 코어 서킷 브레이커가 열린 횟수 (엔드포인트 합계)
+    uint32_t breakerRejected = 0;       //                   보내지 않고 바로 실패시킨 요청
+    uint32_t dnsQueries = 0;            // 가짜 DNS 서버가 받은 질의
+    DnsStats dns;                       // 코어 DNS 캐시
+    uint32_t tagReads = 0;
+    uint32_t tagsSuppressed = 0;        // 코어의 중복 억제 캐시가 걸러낸 읽기
+    RFIDStats rfid;                     // 코어의 감지 통계
+    float rfidIdleLoadPct = 0;
+    std::vector<double> tagToStopMs;    // 태그 인식 범위 진입 → 바퀴 보드 STOP 수신
+
+    void print() const;
+};
+
+/**
+ * 가상 시간 기반 피킹 시뮬레이터
+ * - main.cpp의 setup()/loop()를 그대로 실행하고, 주변 장치는 가짜 장치로 모델링한다.
+ *   · 리더기: 카트 위치에서 인식 범위 안의 자기 쪽 선반 태그를 돌려줌 (통과 1회당 1번, rereadMs 지정 시 반복)
+ *   · 바퀴 보드: START/GO/STOP 수신 시 카트를 움직이거나 세우고, 지연 후 ACK (유실 가능)
+ *     FINISH를 받으면 다음 GO에서 통로 나머지를 건너뛰고 바로 복귀한다 (주문 완료)
+ *   · tracego-server / 스탠드: LoopbackTransport 엔드포인트 (지연/오류율). 서버는 대체 인스턴스를 더 둘 수 있다
+ * - 모든 상태는 조회 시점의 가상 시간으로 지연 계산한다 (별도 스레드 없음).
+ */
+class PickSimulator {
+public:
+    explicit PickSimulator(const SimOptions& options);
+
+    SimReport run();              // 가짜 장치 준비 → setup() → 지정한 시간만큼 loop() 반복
+
+private:
+    struct TagState {
+        double position;
+        int spot = 0;             // 자리 (같은 자리의 태그는 위치가 같음)
+        int side = 0;             // 선반 면
+        String uid;
+        bool target = false;      // 현재 주문에 포함된 상품
+        bool reported = false;    // 이번 통과에서 이미 읽힘
+        uint64_t lastReadUs = 0;  // 마지막으로 읽힌 시각 (rereadMs 용)
+        bool resolved = false;    // 정지 성공 또는 놓침으로 판정됨
+        bool staged = false;      // 이번 정지에서 스탠드 작업을 받음
+        uint64_t enteredUs = 0;   // 인식 범위에 들어온 시각 (0 = 아직)
+    };
+
+    // 카트 / 통로
+    void buildAisle();
+    void advanceCart();
+    int nearestSpot(double position) const;
+    int spotBegin(int spot) const;
+    int spotEnd(int spot) const;
+    bool readTag(TagUid& uid, FakeTagReader::Probe probe, int side);
+
+    // 바퀴 보드
+    void onWheelLine(const String& line);
+
+    // 서버 / 스탠드
+    LoopbackReply onServerRequest(const String& request, int instance);
+    LoopbackReply routeServerRequest(const String& request);
+    LoopbackReply onPaymentRequest(const String& request);
+    LoopbackReply onStandRequest(const String& request);
+    LoopbackReply reply(int code, const String& body, uint32_t latencyMs, uint32_t jitterMs,
+                        const String& extraHeaders = "", const char* contentType = "text/plain; charset=utf-8");
+    LoopbackReply paymentReply(int code, const String& json, const String& request, const String& extraHeaders);
+    String buildPaymentJson() const;
+    String buildPaymentDelta() const;
+
+    // 주문 흐름
+    void startOrder();
+    void finishOrder();
+    void finishStand();
+    void sendCoreRequest(const String& uri);
+    void schedule(uint64_t atUs, std::function<void()> action);
+    void runDueEvents();
+    void watchdog();
+    void pollDashboard();
+    void burstHttp();
+    void openEventStreams();
+    void readEventStreams();
+    void openCommandChannel();
+    void sendCommand(const String& command);
+    void readCommandReplies();
+    void sendMotion(uint8_t type);
+    void transmitMotion(uint32_t seq);
+    void onMotionAck(const FakeDatagram& datagram);
+
+    bool chance(double probability);
+    uint32_t jitter(uint32_t baseMs, uint32_t jitterMs);
+
+    SimOptions opt;
+    SimReport report;
+    std::mt19937 rng;
+
+    std::vector<TagState> tags;
+    double aisleEndM = 0;
+
+    // 서버의 결제 내역 (태그 번호 → 수량), 직전 버전은 변경분 계산용
+    std::map<int, int> orderItems;
+    std::map<int, int> previousItems;
+    String paymentId;
+    String paymentEtag;
+    String previousEtag;
+    uint32_t paymentRevision = 0;
+
+    double cartPos = 0;
+    bool cartMoving = false;
+    uint64_t cartUpdatedUs = 0;
+    bool orderActive = false;
+    int stoppedSpot = -1;         // 허용 오차 안에서 정지한 대상 자리 (-1 = 없음)
+    bool resumePending = false;   // /go 또는 /start가 예약됨
+    bool finishRequested = false; // FINISH 수신, 다음 GO에서 복귀
+    uint64_t standDoneUs = 0;     // 스탠드가 받은 작업을 모두 끝내는 시각
+    uint32_t stagedPicks = 0;     // 이번 정지에서 스탠드가 받은 대상 상품 수
+    uint64_t idleSinceUs = 0;
+    uint64_t startedUs = 0;       // 시뮬레이션 시작 시각 (서버 중단 구간 계산용)
+    String dashboardEtag;         // 대시보드가 마지막으로 받은 /status ETag
+    std::vector<std::shared_ptr<WebServer::ClientStream>> dashboardStreams;   // 열어 둔 /events 연결
+    std::shared_ptr<WebServer::ClientStream> commandStream;   // 열어 둔 /ws 연결 (101을 받은 뒤)
+    uint32_t commandSeq = 0;
+    std::map<uint32_t, uint64_t> commandSentUs;               // 응답을 기다리는 seq → 보낸 시각
+    struct MotionPending {
+        uint8_t type;
+        uint64_t sentUs;          // 처음 보낸 시각
+        uint32_t attempts;
+    };
+    uint8_t motionKey[MOTION_KEY_SIZE] = {};
+    uint32_t motionEpoch = 1;     // 중앙 서버 쪽 epoch (STALE을 받으면 올림)
+    uint32_t motionSeq = 0;
+    std::map<uint32_t, MotionPending> motionPending;          // ACK를 기다리는 seq
+
+    std::multimap<uint64_t, std::function<void()>> events;
+};
+
+#endif // PICKSIMULATOR_H
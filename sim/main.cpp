@@ -0,0 +1,119 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "PickSimulator.h"
+
+/**
+ * 가상 시간 피킹 시뮬레이터 진입점
+ * 사용법: sim [--hours 1] [--seed 1] [--speed 0.3] [--ack-loss 0.01] ...  (--help 로 전체 옵션)
+ */
+namespace {
+
+struct Option {
+    const char* name;
+    const char* help;
+    double* real;
+    uint32_t* count;
+    int* integer;
+};
+
+void printUsage(const Option* options, size_t n) {
+    printf("사용법: sim [옵션]\n");
+    for (size_t i = 0; i < n; ++i) printf("  --%-18s %s\n", options[i].name, options[i].help);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SimOptions opt;
+
+    const Option options[] = {
+        { "hours",            "시뮬레이션할 근무 시간",              &opt.hours, nullptr, nullptr },
+        { "seed",             "난수 시드",                          nullptr, &opt.seed, nullptr },
+        { "tags",             "통로의 상품 태그 수",                 nullptr, nullptr, &opt.tagCount },
+        { "stack",            "한 자리에 함께 놓인 태그 수",          nullptr, nullptr, &opt.tagsPerSpot },
+        { "sides",            "태그가 붙은 선반 면 수 (1~2)",        nullptr, nullptr, &opt.shelfSides },
+        { "spacing",          "태그 간격 (m)",                      &opt.tagSpacingM, nullptr, nullptr },
+        { "read-range",       "리더기 인식 거리 (m)",                &opt.readRangeM, nullptr, nullptr },
+        { "tolerance",        "정지 허용 오차 (m)",                  &opt.stopToleranceM, nullptr, nullptr },
+        { "speed",            "카트 속도 (m/s)",                    &opt.cartSpeedMps, nullptr, nullptr },
+        { "order-items",      "주문당 상품 수",                      nullptr, nullptr, &opt.orderItems },
+        { "amend",            "직전 결제를 고친 주문 확률 (0~1)",     &opt.amendRate, nullptr, nullptr },
+        { "pick-sec",         "스탠드 작업 시간 (s)",                &opt.pickSec, nullptr, nullptr },
+        { "turnaround-sec",   "주문 사이 대기 시간 (s)",             &opt.turnaroundSec, nullptr, nullptr },
+        { "operator-sec",     "작업자 개입까지 대기 시간 (s)",        &opt.operatorTimeoutSec, nullptr, nullptr },
+        { "poll-us",          "리더기 폴링 비용, 카드 없음 (us)",     nullptr, &opt.pollCostUs, nullptr },
+        { "read-us",          "리더기 UID 읽기 비용 (us)",           nullptr, &opt.readCostUs, nullptr },
+        { "arm-us",           "IRQ 모드 REQA 무장 비용 (us)",        nullptr, &opt.armCostUs, nullptr },
+        { "readers",          "코어 리더기 수 (같은 SPI 버스)",       nullptr, nullptr, &opt.readers },
+        { "irq-pin",          "코어 IRQ 핀 (-1 = 적응형 폴링)",       nullptr, nullptr, &opt.irqPin },
+        { "reread-ms",        "범위 안 태그 재인식 간격 (ms, 0=1회)", nullptr, &opt.rereadMs, nullptr },
+        { "inventory",        "다중 태그 인벤토리 (-1=기본, 0=끔, 1=켬)", nullptr, nullptr, &opt.inventory },
+        { "dedup-ms",         "코어 중복 억제 시간 (ms, 0=끔)",       nullptr, nullptr, &opt.dedupMs },
+        { "ack-ms",           "바퀴 보드 ACK 지연 (ms)",             nullptr, &opt.ackLatencyMs, nullptr },
+        { "ack-jitter-ms",    "바퀴 보드 ACK 지연 편차 (ms)",        nullptr, &opt.ackJitterMs, nullptr },
+        { "ack-loss",         "ACK 유실 확률 (0~1)",                 &opt.ackLoss, nullptr, nullptr },
+        { "server-ms",        "서버 응답 지연 (ms)",                 nullptr, &opt.serverLatencyMs, nullptr },
+        { "server-jitter-ms", "서버 응답 지연 편차 (ms)",            nullptr, &opt.serverJitterMs, nullptr },
+        { "server-error",     "서버 오류 확률 (0~1)",                &opt.serverErrorRate, nullptr, nullptr },
+        { "outage-at",        "서버가 응답을 멈추는 시각 (분)",       &opt.serverOutageAtMin, nullptr, nullptr },
+        { "outage-min",       "서버가 멈춰 있는 시간 (분)",          &opt.serverOutageMin, nullptr, nullptr },
+        { "servers",          "서버 인스턴스 수 (1~4, 2번째부터 대체 서버)", nullptr, nullptr, &opt.servers },
+        { "server-slow",      "인스턴스별 느린 응답 확률 (0~1)",     &opt.serverSlowRate, nullptr, nullptr },
+        { "server-slow-ms",   "느린 응답에 더해지는 지연 (ms)",      nullptr, &opt.serverSlowMs, nullptr },
+        { "tls",              "서버에 HTTPS로 연결 (0/1)",           nullptr, nullptr, &opt.serverTls },
+        { "tls-full-cpu-ms",  "전체 TLS 핸드셰이크 계산 시간 (ms, 왕복 2번은 따로)", nullptr, &opt.tlsFullCpuMs, nullptr },
+        { "tls-resume-cpu-ms","TLS 세션 재개 계산 시간 (ms, 왕복 1번은 따로)", nullptr, &opt.tlsResumeCpuMs, nullptr },
+        { "tls-session-sec",  "서버가 세션을 받아 주는 시간 (s, 0=재개 안 함)", nullptr, &opt.tlsSessionSec, nullptr },
+        { "keepalive-sec",    "서버 keep-alive 타임아웃 (s, 0=매번 닫음)", nullptr, &opt.keepAliveSec, nullptr },
+        { "connect-ms",       "TCP 연결 왕복 (ms)",                  nullptr, &opt.connectMs, nullptr },
+        { "dns-ttl",          "서버 호스트 이름 TTL (s)",            nullptr, &opt.dnsTtlSec, nullptr },
+        { "dns-ms",           "DNS 질의 지연 (ms)",                  nullptr, &opt.dnsLatencyMs, nullptr },
+        { "server-etag",      "결제 내역 ETag/304/변경분 지원 (0=끔)", nullptr, nullptr, &opt.serverEtag },
+        { "server-msgpack",   "결제 내역 MessagePack 응답 지원 (0/1)", nullptr, nullptr, &opt.serverMsgPack },
+        { "server-chunked",   "서버 / 스탠드 응답 본문을 청크로 보냄 (0/1)", nullptr, nullptr, &opt.serverChunked },
+        { "stand-ms",         "스탠드 응답 지연 (ms)",               nullptr, &opt.standLatencyMs, nullptr },
+        { "stand-jitter-ms",  "스탠드 응답 지연 편차 (ms)",          nullptr, &opt.standJitterMs, nullptr },
+        { "stand-error",      "스탠드 오류 확률 (0~1)",              &opt.standErrorRate, nullptr, nullptr },
+        { "dashboard-ms",     "대시보드 /status 조건부 요청 주기 (ms, 0=끔)", nullptr, &opt.dashboardMs, nullptr },
+        { "dashboard-sse",    "/events를 열어 두는 대시보드 수 (0=끔)", nullptr, &opt.dashboardSse, nullptr },
+        { "command-ws",       "작업자 명령을 /ws 명령 채널로 (0/1)",  nullptr, nullptr, &opt.commandWs },
+        { "motion-udp",       "스탠드의 /go를 UDP 모션 데이터그램으로 (0/1)", nullptr, nullptr, &opt.motionUdp },
+        { "motion-loss",      "모션 데이터그램 / ACK 유실 확률 (0~1)", &opt.motionLoss, nullptr, nullptr },
+        { "motion-retry-ms",  "ACK를 못 받으면 같은 seq로 다시 보내는 간격 (ms)", nullptr, &opt.motionRetryMs, nullptr },
+        { "http-us",          "내장 서버 요청 하나의 비용 (us, 제어 / 304 / 503)", nullptr, &opt.httpCostUs, nullptr },
+        { "page-us",          "페이지 / /status 본문 생성 + 쓰기 비용 (us)", nullptr, &opt.pageCostUs, nullptr },
+        { "http-burst",       "한 번에 몰려오는 페이지 / 상태 요청 수 (0=끔)", nullptr, &opt.httpBurst, nullptr },
+        { "http-burst-sec",   "요청 폭주 간격 (s)",                  &opt.httpBurstSec, nullptr, nullptr },
+    };
+    const size_t optionCount = sizeof(options) / sizeof(options[0]);
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--help") == 0) {
+            printUsage(options, optionCount);
+            return 0;
+        }
+
+        bool matched = false;
+        for (const Option& o : options) {
+            if (strncmp(argv[i], "--", 2) != 0 || strcmp(argv[i] + 2, o.name) != 0 || i + 1 >= argc) continue;
+            const char* value = argv[++i];
+            if (o.real) *o.real = atof(value);
+            if (o.count) *o.count = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            if (o.integer) *o.integer = atoi(value);
+            matched = true;
+            break;
+        }
+        if (!matched) {
+            fprintf(stderr, "알 수 없는 옵션: %s\n", argv[i]);
+            printUsage(options, optionCount);
+            return 2;
+        }
+    }
+
+    PickSimulator sim(opt);
+    SimReport report = sim.run();
+    report.print();
+    return 0;
+}
@@ -1,41 +1,97 @@
 #include <Arduino.h>
-#include <Preferences.h>
-#include <HTTPClient.h>
 
+#include "Platform.h"
+#include "BackgroundTask.h"
 #include "Config.h"
 #include "ConfigWebServer.h"
 #include "CommLink.h"
+#include "MotionListener.h"
 #include "ServerService.h"
 #include "RFIDController.h"
 #include "WiFiConnector.h"
+#include "TraceLog.h"
 
 #include "model/PaymentData.h" // 구조체, 클래스
+#include "model/PaymentBoard.h" // 결제 내역 스냅샷 게시 (RCU)
+#include "model/PaymentCache.h" // 결제 내역 플래시 보관
+#include "model/PaymentPrefetcher.h" // 결제 내역 백그라운드 프리페치
+#include "model/Outbox.h"     // 서버/스탠드 알림 저장 후 전달
+#include "model/BackgroundRequest.h" // 작업 리스트 설정 백그라운드 요청
+#include "web/WebPages.h"     // 페이지/상태 JSON 생성
+#include "web/StatusCache.h"  // /status 본문 캐시 (ETag / 304)
 // 함수 선언부 ===========================================================================================================
 bool sendWithRetry(const String& cmd, const int retries = 3);       // [UTILITY-1] 명령 전송 함수 (재시도 포함)
 void simpleMessage(String message);                                 // [UTILITY-2] 간편 메시지 사용 메서드
-void sendStartStandRequest(const String& detectedUid);              // [UTILITY-3] /start-stand?uid= 요청을 전송하는 함수
 void sendUpRfidCardRequest(const String& detectedUid);              // [UTILITY-4] /up-rfid?uid= 요청을 전송하는 함수
+void publishEvent(const char* type, const std::function<void(JsonObject)>& fill);   // [UTILITY-5] /events 대시보드에 이벤트를 보내는 함수
 bool isAdminCard(const String& uid);                                // [LOOP-1] 관리자 카드 여부 판별
-bool refreshPaymentData(int maxRetries = 3);                        // [LOOP-2] 결제 내역 초기화 및 재요청 로직
-bool fetchPaymentDataUntilSuccess(const int count);                 // [LOOP-3] 외부 서버로 GET 요청 전송해 결제 내역을 받아온다.
-void handleMatchedProduct(const String& matchedName);               // [LOOP-4] 상품 매칭 시 동작을 처리하는 함수
+void refreshPaymentData(int maxRetries = 3);                        // [LOOP-2] 결제 내역 재요청 로직 (백그라운드)
+void startPicking();                                                // [LOOP-3] 작업 리스트 설정을 백그라운드로 넘긴다 (이어서 [LOOP-7]에서 출발).
+void handleMatchedProducts(const String* names, const String* uids, uint8_t count);   // [LOOP-4] 상품 매칭 시 동작을 처리하는 함수
 void checkDetectedUid();                                            // [LOOP-5] UID를 인식해서 결제내역 확인 하는 함수
+void pollPaymentPrefetch();                                         // [LOOP-6] 프리페치 결과 반영 및 대기 중인 시작 작업 처리
+void pollStartJob();                                                // [LOOP-7] 작업 리스트 설정 응답을 이어받아 로봇을 출발시킨다.
+void pollRejectedPicks();                                           // [LOOP-8] 보관함이 거절되어 버린 작업의 집은 수량을 되돌린다.
+void pollWorklistReset();                                           // [LOOP-9] 작업 리스트 초기화 응답을 이어받아 로봇을 정지시킨다.
+HandlerReply startJobReply();                                       // [UTILITY-6] /start 작업의 202 응답을 만드는 함수
+void scanWhileWaiting();                                            // [UTILITY-7] 바퀴 보드 ACK를 기다리는 동안 RFID 스캔을 이어가는 함수
+bool takeHeldScan(TagInventory& inventory);                         // [UTILITY-8] 기다리는 동안 읽어 둔 태그를 꺼내는 함수
 void modulsSetting();                                               // [SETUP-1] 모듈을 초기 설정 하는 함수입니다.
 void setServerHandler();                                            // [SETUP-2] 핸들러 등록을 진행하는 함수입니다.
+void restorePaymentData();                                          // [SETUP-3] 결제 내역 복원 및 프리페처를 시작하는 함수입니다.
+void startOutbox();                                                 // [SETUP-4] 알림 보관함을 복원하고 전달 태스크를 시작하는 함수입니다.
+void startMotionListener();                                         // [SETUP-5] UDP 모션 명령 수신기를 시작하는 함수입니다.
+void startWorklistInit();                                           // [SETUP-6] 작업 리스트 설정 / 초기화 백그라운드 요청을 준비하는 함수입니다.
 
 // 객체 생성 =============================================================================================================
 WiFiConnector wifi;                             // WiFiConnect 객체 생성
 ServerService* serverService = nullptr;         // WebService 객체 생성
 RFIDController* rfidController = nullptr;       // RFIDController 객체 생성
 ConfigWebServer* configWebServer = nullptr;     // ConfigWebServer 객체 생성
-PaymentData payment;                            // 결제 내역 저장
+CommLink* wheelLink = nullptr;                  // 바퀴 보드 유선 통신 객체 생성
+MotionListener* motionListener = nullptr;       // UDP 모션 명령(GO/STOP) 수신기 (motion_port가 0이면 꺼 둠)
+PaymentBoard payment;                           // 결제 내역 (불변 스냅샷 + 집은 수량 카운터)
+PaymentCache* paymentCache = nullptr;           // 결제 내역 플래시 보관 (변경을 모아 저장 태스크가 씀)
+bool paymentSavesInLoop = false;                // 저장 태스크를 못 띄웠으면 loop가 flush()
+bool paymentWarm = false;                       // 플래시에서 복원한 내역을 /start가 아직 쓰지 않음
+PaymentPrefetcher* paymentPrefetcher = nullptr; // 결제 내역 백그라운드 프리페치 (이중 버퍼)
+Outbox* outbox = nullptr;                       // 워킹 리스트 추가 / 스탠드 요청 보관함 (플래시 보관, 백그라운드 전달)
+StatusCache* statusCache = nullptr;             // /status 본문 캐시 (상태가 바뀔 때만 다시 만듦)
+BackgroundRequest* worklistInit = nullptr;      // /start의 작업 리스트 설정 (백그라운드, 응답은 loop에서 이어받음)
+BackgroundRequest* worklistReset = nullptr;     // /reset의 작업 리스트 초기화 (백그라운드, 응답은 loop에서 이어받음)
+
+// 결제 내역 저장 태스크: 이 주기 동안의 집은 수량 / 새 버전을 한 번에 쓴다 (loop는 플래시를 기다리지 않음)
+#define PAYMENT_SAVE_PERIOD_MS 1000
+
+// /start 작업: 202 + 작업 ID로 바로 응답하고 loop에서 이어서 진행 ------------------------------------------------------
+// 결제 내역 대기(PENDING) → 작업 리스트 설정(LISTING, 백그라운드) → START (STARTED / FAILED)
+#define START_FETCH_ATTEMPTS 5
+enum StartJobState : uint8_t { JOB_NONE, JOB_PENDING, JOB_LISTING, JOB_STARTED, JOB_FAILED };
+const char* const startJobStateNames[] = { "none", "pending", "listing", "started", "failed" };
+uint32_t startJobId = 0;
+StartJobState startJobState = JOB_NONE;
+uint32_t listingJobId = 0;                      // worklistInit에 넘긴 요청의 작업 ID (0 = 넘긴 요청 없음)
+
+// 바퀴 보드 ACK를 기다리는 동안 읽은 태그: 기다림이 끝난 뒤 loop가 차례로 처리 ----------------------------------------------
+// (ACK 대기는 /go, /stop, /ws, UDP 핸들러와 정지 처리 안에서 일어나므로 그 자리에서 처리하지 않고 모아 둔다)
+#define HELD_SCAN_CAPACITY 4
+TagInventory heldScans[HELD_SCAN_CAPACITY];
+uint8_t heldScanHead = 0;
+uint8_t heldScanCount = 0;
+
+// 집은 수량 장부: 다 집은 상품은 다시 세우지 않고, 주문이 끝나면 서버를 거치지 않고 바로 FINISH ------------------------
+uint32_t pickSkips = 0;                         // 다 집은 상품이라 정지하지 않은 인식
+uint32_t ordersFinished = 0;                    // 장부로 완료를 감지해 FINISH를 보낸 주문
+
 
 // 프로그램 설정 및 시작 ====================================================================================================
 
 void setup() {
+    config.begin(hal::settings());  // 플랫폼 저장소 연결 (ESP32: Preferences)
     config.load(); // EEPROM 또는 Preferences에서 구성 불러오기
 
     Serial.begin(config.serialBaudrate);  // 시리얼 초기화 (최우선)
+    TraceLog::begin(Serial);              // 지연 로그 출력 태스크 시작
 
     // 객체 동적 생성
     wifi = WiFiConnector(config.ssid.c_str(), config.password.c_str());
@@ -50,10 +106,31 @@ void setup() {
         configWebServer->begin();
         return; // loop에서 configWeb 핸들러로 진입하게 됨
     }
-    serverService = new ServerService(config.innerPort);
-    rfidController = new RFIDController(config.rcSdaPin, config.rcRstPin);
+    serverService = new ServerService(config.innerPort, hal::transport(), hal::clock());
+    if (config.serverTls) {
+        if (!hal::transport().setTrustAnchor(config.serverCa, config.serverTlsInsecure)) {
+            LOG_ERROR("[ServerService][TLS] server_ca가 없거나 읽을 수 없어 서버에 연결하지 않습니다 (검증 없이 쓰려면 tls_insecure)");
+        } else if (config.serverCa.isEmpty()) {
+            LOG_WARN("[ServerService][TLS] tls_insecure: 서버 인증서를 검증하지 않습니다 (암호화만)");
+        }
+    }
+    for (uint8_t i = 0; i < config.serverCount; ++i) {    // 주 서버 + 대체 서버 (죽은 곳은 타임아웃 없이 건너뜀)
+        serverService->watchEndpoint("server", config.serverHosts[i], config.serverPorts[i], config.serverTls);
+        hal::dns().prefetch(config.serverHosts[i].c_str());   // 첫 요청이 DNS를 기다리지 않도록 미리 풀어 둔다
+    }
+    serverService->watchEndpoint("stand", config.serverIP, config.standPort);
+    hal::dns().begin();                             // TTL이 끝나기 전에 백그라운드에서 다시 질의
+    rfidController = new RFIDController(createTagReader(config.rcSdaPins[0], config.rcRstPin));
+    for (uint8_t i = 1; i < config.rcReaderCount; ++i) {
+        rfidController->addReader(createTagReader(config.rcSdaPins[i], config.rcRstPin));   // 같은 SPI 버스, SS만 다름
+    }
+    wheelLink = new CommLink(hal::wheelSerial(config.commRxPin, config.commTxPin), hal::clock());
 
     modulsSetting();           // 모듈 초기 설정 (Serial2, RFID, WiFi 등)
+    restorePaymentData();      // 저장된 결제 내역 복원 + 백그라운드 프리페치
+    startOutbox();             // 전달하지 못한 알림 복원 + 백그라운드 전달
+    startMotionListener();     // UDP 모션 명령 수신 (설정했을 때만)
+    startWorklistInit();       // /start의 작업 리스트 설정 태스크
     setServerHandler();        // 서버 핸들러 등록
     serverService->begin();    // 서버 시작
 
@@ -67,9 +144,17 @@ void loop() {
         return;
     }
 
-    if (serverService) {serverService->handle();} // 1. 내장 서버 구동
-    checkDetectedUid();         // 2. UID를 인식해서 결제내역 확인 하는 함수
-    delay(1);                   // 3. WDT 리셋 방지
+    if (serverService) {serverService->handle();} // 1. 내장 서버 구동 (한 바퀴 시간 예산 안에서만)
+    if (motionListener) {motionListener->poll();} // 2. UDP 모션 명령 (GO/STOP 데이터그램)
+    checkDetectedUid();         // 3. UID를 인식해서 결제내역 확인 하는 함수
+    if (serverService && rfidController) {serverService->markScanned();}   // 스캔 간격 → 늦으면 일반 HTTP 요청을 미룸
+    pollPaymentPrefetch();      // 4. 프리페치 결과 반영 + 대기 중인 /start 진행
+    pollStartJob();             // 5. 작업 리스트 설정이 끝난 /start → START
+    pollRejectedPicks();        //    거절된 알림 → 장부 되돌림
+    pollWorklistReset();        //    작업 리스트 초기화가 끝난 /reset → STOP
+    if (paymentSavesInLoop) payment.flush();
+    payment.quiescent();        // 6. 이번 바퀴에 읽은 스냅샷 놓음 → 이전 스냅샷 회수 (집은 수량은 저장 태스크가 씀)
+    delay(1);                   // 7. WDT 리셋 방지
 }
 
 // SETUP FUNCTION =====================================================================================================
@@ -83,10 +168,15 @@ void modulsSetting() {
     simpleMessage("시작선");
     if (config.useRFID) {
         rfidController->begin(Serial); // RFID 리더기 초기화
+        rfidController->setDedupWindow(config.tagDedupMs);  // 중복 태그 억제 시간
+        rfidController->setInventoryMode(config.rfidInventory);   // 범위 안의 태그를 한 주기에 모두 읽음
+        for (uint8_t i = 0; i < rfidController->readerCount(); ++i) {
+            rfidController->useIrq(config.rcIrqPins[i], i); // IRQ 감지 (미연결 시 적응형 폴링)
+        }
     } else {
         Serial.println("[INFO] RFID 리더기 비활성화됨 (하드웨어 없음)");
     }
-    Serial2.begin(config.serial2Baudrate);
+    wheelLink->begin(config.serial2Baudrate);
 
     wifi.connect();             // wifi 연결
 }
@@ -95,337 +185,89 @@ void modulsSetting() {
 void setServerHandler() {
 
     // [봇 조작 핸들러] 자동화 카트에게 시작 명령을 내리는 핸들러입니다.
-    serverService->setStartHandler([]() {
-        Serial.println("[ServerService][GET /start] 로봇 시작 명령 수신");
-        
-        payment.clear();
-
-        // 결제 내역이 없으면 수신 시도
-        if (payment.getPaymentId() == "") {
-            Serial.println("[ServerService] 결제 내역 없음 → 새로 요청");
-            const bool result = fetchPaymentDataUntilSuccess(5);
-            if (!result || payment.getPaymentId() == "") {
-                Serial.println("[ServerService][BLOCKED] 서버에 결제 내역 없음 → 시작 차단됨");
-                return;
-            }
+    serverService->setStartHandler([]() -> HandlerReply {
+        LOG_INFO("[ServerService][GET /start] 로봇 시작 명령 수신");
+        pollPaymentPrefetch();   // 완료된 프리페치가 있으면 먼저 반영
+
+        // 진행 중인 작업이 있으면 같은 작업 ID를 돌려준다 (작업 리스트 설정 / START를 두 번 보내지 않음)
+        if (startJobState == JOB_PENDING || startJobState == JOB_LISTING) {
+            if (startJobState == JOB_PENDING) paymentPrefetcher->request(START_FETCH_ATTEMPTS);
+            return startJobReply();   // 함수: [UTILITY-6]
         }
-
-        // 작업 리스트 전송 (GET 방식)
-        String getResponse = ServerService::sendGETRequest(config.serverIP.c_str(), config.serverPort, config.firstSetWoringLists);
-        Serial.println("[응답] " + getResponse);
-
-        if (getResponse.indexOf("초기 작업 리스트 생성 완료") == -1 && getResponse.indexOf("200 OK") == -1) {
-            Serial.println("[ServerService][BLOCKED] 작업 리스트 설정 실패 → 로봇 시작 차단됨");
-            return;
+        ++startJobId;
+
+        // 프리페치된(또는 플래시에서 복원한) 내역이 있으면 결제 내역을 기다리지 않고 바로 작업 리스트 설정으로 넘어가고,
+        // 최신인지는 백그라운드에서 다시 확인해 바뀐 부분만 반영한다.
+        // 모두 집은 주문은 끝난 것이므로 다음 결제 내역을 기다린다 (이어서 [LOOP-6]에서 시작).
+        const PaymentSnapshot& snapshot = payment.current();
+        if (snapshot.getPaymentId() != "" && !snapshot.progress().complete()) {
+            if (paymentWarm) {
+                LOG_INFO("[ServerService][PaymentCache] 복원한 결제 내역({})으로 바로 시작", snapshot.getPaymentId());
+            } else {
+                LOG_INFO("[ServerService][Prefetch] 준비된 결제 내역({}, {}ms 전 확인)으로 바로 시작",
+                         snapshot.getPaymentId(), static_cast<unsigned>(paymentPrefetcher->ageMs()));
+            }
+            paymentWarm = false;
+            paymentPrefetcher->request();
+            startPicking();   // 함수: [LOOP-3]
+        } else {
+            startJobState = JOB_PENDING;
+            paymentPrefetcher->request(START_FETCH_ATTEMPTS);
+            LOG_INFO("[ServerService][202] 결제 내역 수신 대기 → 시작 작업 {} 예약", static_cast<unsigned>(startJobId));
         }
-
-        // 결제 내역도 존재하고, 작업 리스트도 성공적으로 설정된 경우
-        Serial.println("[ServerService][START] 결제 내역 및 작업 리스트 준비 완료 → 로봇 시작");
-        sendWithRetry("START");  // 로봇 시작 명령
+        return startJobReply();   // 함수: [UTILITY-6]
     });
     
     // [봇 조작 핸들러] 자동화 카트에게 이동 명령을 내리는 핸들러입니다.
-    serverService->setGoHandler([]() {
-        Serial.println("[ServerService][GET /go] 로봇 이동 명령 수신");
-        sendWithRetry("GO"); // 함수: [UTILITY-1]
+    serverService->setGoHandler([]() -> HandlerReply {
+        LOG_INFO("[ServerService][GET /go] 로봇 이동 명령 수신");
+        HandlerReply reply;
+        reply.ok = sendWithRetry("GO"); // 함수: [UTILITY-1]
+        return reply;
     });
 
     // [봇 조작 핸들러] 자동화 카트에게 정지 명령을 내리는 핸들러입니다.
-    serverService->setStopHandler([]() {
-        Serial.println("[ServerService][GET /stop] 로봇 정지 명령 수신");
-        sendWithRetry("STOP"); // 함수: [UTILITY-1]
+    serverService->setStopHandler([]() -> HandlerReply {
+        LOG_INFO("[ServerService][GET /stop] 로봇 정지 명령 수신");
+        HandlerReply reply;
+        reply.ok = sendWithRetry("STOP"); // 함수: [UTILITY-1]
+        return reply;
     });
 
     // [봇 조작 핸들러] 자동화 카트에게 초기화 명령을 내리는 핸들러입니다.
-    serverService->setResetHandler([]() {
-        Serial.println("[ServerService][GET /reset] 로봇 정지 명령 수신");
+    // 진행 중인 /start 작업을 취소하고(설정 중이던 작업 리스트 응답은 버림) 결제 내역을 비운 뒤,
+    // 작업 리스트 초기화는 백그라운드로 넘기고 바로 202로 답한다. 응답은 [LOOP-9]가 이어받아 STOP을 보낸다.
+    serverService->setResetHandler([]() -> HandlerReply {
+        LOG_INFO("[ServerService][GET /reset] 로봇 정지 명령 수신");
+        HandlerReply reply;
+        reply.code = 202;
+        reply.body = "{\"message\":\"작업 리스트 초기화 중\"}";
+
+        if (startJobState == JOB_PENDING || startJobState == JOB_LISTING) {
+            LOG_INFO("[ServerService][RESET] 시작 작업 {} 취소 ({})", static_cast<unsigned>(startJobId),
+                     startJobStateNames[startJobState]);
+        }
+        startJobState = JOB_NONE;
 
         // 결제 내역 초기화
+        paymentWarm = false;
         payment.clear();
 
-        // 서버에 작업 리스트 초기화 요청
-        String getResponse = ServerService::sendGETRequest(config.serverIP.c_str(), config.serverPort, config.resetWorkingLists);
-        Serial.println("[응답] " + getResponse);
-
-        // 응답 메시지 기반 판단
-        if (getResponse.indexOf("초기화했습니다") == -1 && getResponse.indexOf("200 OK") == -1) {
-            Serial.println("[ServerService][BLOCKED] 작업 리스트 초기화 실패 → 로봇 정지 차단됨");
-            return;
+        // 서버에 작업 리스트 초기화 요청 (이미 진행 중이면 그 응답으로 정지)
+        if (worklistReset->request()) {
+            LOG_INFO("[ServerService][RESET] 작업 리스트 초기화 요청 (백그라운드)");
         }
-
-        sendWithRetry("STOP");  // 로봇 정지 명령 전송
+        return reply;
     });
     
     // [메인 페이지 핸들러] 기본 설정 페이지를 반환하는 핸들러입니다.
     serverService->setMainPageHandler([]() -> String {
-        return R"rawliteral(
-            <!DOCTYPE html>
-            <html lang="ko">
-            <head>
-                <meta charset="utf-8">
-                <title>TraceGo 설정 페이지</title>
-                <style>
-                    * { box-sizing: border-box; }
-                    body {
-                        font-family: 'Segoe UI', sans-serif;
-                        background-color: #f4f7f8;
-                        margin: 0;
-                        padding: 0;
-                        display: flex;
-                        justify-content: center;
-                        align-items: center;
-                        height: 100vh;
-                    }
-                    .container {
-                        background-color: #fff;
-                        padding: 40px;
-                        border-radius: 12px;
-                        box-shadow: 0 4px 12px rgba(0, 0, 0, 0.1);
-                        text-align: center;
-                        width: 100%;
-                        max-width: 400px;
-                    }
-                    h2 {
-                        margin-bottom: 30px;
-                        color: #00c4c4;
-                    }
-                    a {
-                        display: block;
-                        margin: 12px 0;
-                        padding: 12px;
-                        background-color: #00c4c4;
-                        color: #fff;
-                        text-decoration: none;
-                        border-radius: 8px;
-                        font-size: 16px;
-                        transition: background-color 0.3s ease;
-                    }
-                    a:hover {
-                        background-color: #00a0a0;
-                    }
-                </style>
-            </head>
-            <body>
-                <div class="container">
-                    <h2>TraceGo 설정 페이지</h2>
-                    <a href="/advanced">고급 설정</a>
-                    <a href="/status-view">상태 확인</a>
-                    <a href="/reset-config">설정 초기화</a>
-                </div>
-            </body>
-            </html>
-        )rawliteral";
+        return renderMainPage();
     });
 
     // [고급 설정 핸들러] 고급 설정 페이지를 반환하는 핸들러입니다.
     serverService->setAdvancedPageHandler([]() -> String {
-        String html = R"rawliteral(
-            <!DOCTYPE html>
-            <html lang="ko">
-            <head>
-                <meta charset="utf-8">
-                <title>고급 설정</title>
-                <style>
-                    * { box-sizing: border-box; }
-                    body {
-                        font-family: 'Segoe UI', sans-serif;
-                        background-color: #f4f7f8;
-                        margin: 0;
-                        padding: 0;
-                        display: flex;
-                        justify-content: center;
-                        align-items: flex-start;
-                        min-height: 100vh;
-                    }
-                    .container {
-                        width: 100%;
-                        max-width: 600px;
-                        background: #fff;
-                        padding: 30px;
-                        margin: 40px auto;
-                        border-radius: 12px;
-                        box-shadow: 0 4px 10px rgba(0,0,0,0.1);
-                    }
-                    h2 {
-                        text-align: center;
-                        color: #00c4c4;
-                        margin-bottom: 20px;
-                    }
-                    fieldset {
-                        border: none;
-                        margin-bottom: 20px;
-                        padding: 0;
-                    }
-                    legend {
-                        font-weight: bold;
-                        color: #00a0a0;
-                        margin-bottom: 10px;
-                    }
-                    label {
-                        display: block;
-                        margin-bottom: 6px;
-                        font-weight: 500;
-                    }
-                    input[type=text],
-                    input[type=password],
-                    input[type=number] {
-                        width: 100%;
-                        padding: 10px;
-                        margin-bottom: 14px;
-                        border: 1px solid #ccc;
-                        border-radius: 6px;
-                        font-size: 14px;
-                    }
-                    input[type=checkbox] {
-                        transform: scale(1.2);
-                        margin-left: 4px;
-                    }
-                    button {
-                        width: 100%;
-                        padding: 14px;
-                        background-color: #00c4c4;
-                        color: #fff;
-                        border: none;
-                        border-radius: 6px;
-                        font-size: 16px;
-                        cursor: pointer;
-                        transition: background-color 0.3s;
-                    }
-                    button:hover {
-                        background-color: #00a0a0;
-                    }
-                </style>
-                <script>
-                function saveConfig() {
-                    const config = {
-                        server_ip: document.getElementById("server_ip").value,
-                        server_port: parseInt(document.getElementById("server_port").value),
-                        inner_port: parseInt(document.getElementById("inner_port").value),
-                        stand_port: parseInt(document.getElementById("stand_port").value),
-                        admin_uid: document.getElementById("admin_uid").value,
-                        master_key: document.getElementById("master_key").value,
-                        test_key: document.getElementById("test_key").value,
-                        use_rfid: document.getElementById("use_rfid").checked,
-                        comm_rx: parseInt(document.getElementById("comm_rx").value),
-                        comm_tx: parseInt(document.getElementById("comm_tx").value),
-                        rc_sda: parseInt(document.getElementById("rc_sda").value),
-                        rc_rst: parseInt(document.getElementById("rc_rst").value),
-                        baudrate: parseInt(document.getElementById("baudrate").value),
-                        baudrate2: parseInt(document.getElementById("baudrate2").value),
-                        firstSetWoringLists: document.getElementById("fswl").value,
-                        resetWorkingLists: document.getElementById("rwl").value,
-                        getPayment: document.getElementById("getpay").value,
-                        addWorkingList: document.getElementById("awl").value
-                    };
-
-                    fetch("/update-config", {
-                        method: "POST",
-                        headers: { "Content-Type": "application/json" },
-                        body: JSON.stringify(config)
-                    })
-                    .then(res => res.json())
-                    .then(data => alert(data.message));
-                }
-                </script>
-            </head>
-            <body>
-                <div class="container">
-                    <h2>고급 설정</h2>
-
-                    <fieldset>
-                        <legend>서버 설정</legend>
-                        <label for="server_ip">Server IP</label>
-                        <input id="server_ip" value="%SERVER_IP%" type="text">
-
-                        <label for="server_port">Server Port</label>
-                        <input id="server_port" value="%SERVER_PORT%" type="number">
-
-                        <label for="inner_port">Inner Port</label>
-                        <input id="inner_port" value="%INNER_PORT%" type="number">
-
-                        <label for="stand_port">Stand Port</label>
-                        <input id="stand_port" value="%STAND_PORT%" type="number">
-                    </fieldset>
-
-                    <fieldset>
-                        <legend>보안 설정</legend>
-                        <label for="admin_uid">Admin UID</label>
-                        <input id="admin_uid" value="%ADMIN_UID%" type="text">
-
-                        <label for="master_key">Master Key</label>
-                        <input id="master_key" value="%MASTER_KEY%" type="text">
-
-                        <label for="test_key">Test Key</label>
-                        <input id="test_key" value="%TEST_KEY%" type="text">
-                    </fieldset>
-
-                    <fieldset>
-                        <legend>하드웨어 설정</legend>
-                        <label for="use_rfid">
-                            <input id="use_rfid" type="checkbox" %USE_RFID%> Use RFID
-                        </label>
-
-                        <label for="comm_rx">Comm RX Pin</label>
-                        <input id="comm_rx" value="%COMM_RX%" type="number">
-
-                        <label for="comm_tx">Comm TX Pin</label>
-                        <input id="comm_tx" value="%COMM_TX%" type="number">
-
-                        <label for="rc_sda">RC SDA Pin</label>
-                        <input id="rc_sda" value="%RC_SDA%" type="number">
-
-                        <label for="rc_rst">RC RST Pin</label>
-                        <input id="rc_rst" value="%RC_RST%" type="number">
-
-                        <label for="baudrate">Baudrate</label>
-                        <input id="baudrate" value="%BAUDRATE%" type="number">
-
-                        <label for="baudrate2">Baudrate2</label>
-                        <input id="baudrate2" value="%BAUDRATE2%" type="number">
-                    </fieldset>
-
-                    <fieldset>
-                        <legend>엔드포인트 설정</legend>
-                        <label for="fswl">FirstSetWorkingLists</label>
-                        <input id="fswl" value="%FSWL%" type="text">
-
-                        <label for="rwl">ResetWorkingLists</label>
-                        <input id="rwl" value="%RWL%" type="text">
-
-                        <label for="getpay">Get Payment</label>
-                        <input id="getpay" value="%GETPAY%" type="text">
-
-                        <label for="awl">Add Working List</label>
-                        <input id="awl" value="%AWL%" type="text">
-                    </fieldset>
-
-                    <button onclick="saveConfig()">설정 저장</button>
-                </div>
-            </body>
-            </html>
-        )rawliteral";
-
-        // 치환
-        html.replace("%SERVER_IP%", config.serverIP);
-        html.replace("%SERVER_PORT%", String(config.serverPort));
-        html.replace("%INNER_PORT%", String(config.innerPort));
-        html.replace("%STAND_PORT%", String(config.standPort));
-        html.replace("%ADMIN_UID%", config.adminUID);
-        html.replace("%MASTER_KEY%", config.masterKey);
-        html.replace("%TEST_KEY%", config.testKey);
-        html.replace("%USE_RFID%", config.useRFID ? "checked" : "");
-        html.replace("%COMM_RX%", String(config.commRxPin));
-        html.replace("%COMM_TX%", String(config.commTxPin));
-        html.replace("%RC_SDA%", String(config.rcSdaPin));
-        html.replace("%RC_RST%", String(config.rcRstPin));
-        html.replace("%BAUDRATE%", String(config.serialBaudrate));
-        html.replace("%BAUDRATE2%", String(config.serial2Baudrate));
-        html.replace("%FSWL%", config.firstSetWoringLists);
-        html.replace("%RWL%", config.resetWorkingLists);
-        html.replace("%GETPAY%", config.getPayment);
-        html.replace("%AWL%", config.addWorkingList);
-
-        return html;
+        return renderAdvancedPage(config);
     });
 
     // [고급 설정 핸들러] 고급 설정 변경사항을 저장하는 핸들러입니다.
@@ -435,106 +277,101 @@ void setServerHandler() {
         DeserializationError err = deserializeJson(doc, body);
         if (err) return "{\"message\":\"JSON 파싱 실패\"}";
 
-        extern Preferences prefs;
+        KVStore& prefs = *config.store;
         prefs.begin("settings", false);
         prefs.putString("server_ip", doc["server_ip"] | "");
         prefs.putInt("server_port", doc["server_port"] | 8080);
+        prefs.putString("server_bak", doc["server_backups"] | "");   // "host:port,host" (순서대로 대체 서버)
+        prefs.putBool("server_tls", doc["server_tls"] | false);
+        prefs.putString("server_ca", doc["server_ca"] | "");
+        prefs.putBool("tls_insecure", doc["server_tls_insecure"] | false);
         prefs.putInt("inner_port", doc["inner_port"] | 8081);
         prefs.putInt("stand_port", doc["stand_port"] | 8082);
+        prefs.putInt("motion_port", doc["motion_port"] | 0);
+        const char* motionKey = doc["motion_key"] | "";
+        if (motionKey[0]) prefs.putString("motion_key", motionKey);  // 페이지에는 키를 싣지 않으므로 빈 값 = 그대로 둠
         prefs.putString("admin_uid", doc["admin_uid"] | "");
         prefs.putString("master_key", doc["master_key"] | "");
         prefs.putString("test_key", doc["test_key"] | "");
         prefs.putBool("use_rfid", doc["use_rfid"] | false);
         prefs.putInt("comm_rx", doc["comm_rx"] | 16);
         prefs.putInt("comm_tx", doc["comm_tx"] | 17);
-        prefs.putInt("rc_sda", doc["rc_sda"] | 5);
+        prefs.putString("rc_sdas", doc["rc_sda"] | "5");     // "5,21" (리더기마다 SS 핀)
         prefs.putInt("rc_rst", doc["rc_rst"] | 22);
+        prefs.putString("rc_irqs", doc["rc_irq"] | "-1");    // 리더기 순서대로, -1 = 폴링
+        prefs.putInt("dedup_ms", doc["dedup_ms"] | 2000);
+        prefs.putBool("rc_inventory", doc["rc_inventory"] | true);
         prefs.putInt("baudrate", doc["baudrate"] | 115200);
         prefs.putInt("baudrate2", doc["baudrate2"] | 9600);
         prefs.putString("fswl", doc["firstSetWoringLists"] | "");
         prefs.putString("rwl",  doc["resetWorkingLists"]   | "");
         prefs.putString("gpay", doc["getPayment"]          | "");
         prefs.putString("awl",  doc["addWorkingList"]      | "");
+        prefs.putInt("prefetch_ms", doc["prefetch_ms"] | 10000);
         prefs.end();
 
         return "{\"message\":\"설정이 저장되었습니다. 3초 후 재시작됩니다.\"}";
     });
 
-    // [상태 핸들러] 현재 시스템 상태를 JSON 형태로 반환하는 핸들러입니다.
-    serverService->setStatusHandler([]() -> String {
-        JsonDocument doc;  // 권장된 JsonDocument 타입 사용
-        doc.set(JsonObject());  // 명시적 초기화 (v7에서는 안전하게 사용하기 위해 권장됨)
-
-        doc["ssid"]                 = config.ssid;
-        doc["password"]             = config.password;
-        doc["server_ip"]            = config.serverIP;
-        doc["server_port"]          = config.serverPort;
-        doc["inner_port"]           = config.innerPort;
-        doc["stand_port"]           = config.standPort;
-        doc["admin_uid"]            = config.adminUID;
-        doc["master_key"]           = config.masterKey;
-        doc["test_key"]             = config.testKey;
-        doc["use_rfid"]             = config.useRFID;
-        doc["comm_rx"]              = config.commRxPin;
-        doc["comm_tx"]              = config.commTxPin;
-        doc["rc_sda"]               = config.rcSdaPin;
-        doc["rc_rst"]               = config.rcRstPin;
-        doc["baudrate"]             = config.serialBaudrate;
-        doc["baudrate2"]            = config.serial2Baudrate;
-        doc["firstSetWoringLists"]  = config.firstSetWoringLists;
-        doc["resetWorkingLists"]    = config.resetWorkingLists;
-        doc["getPayment"]           = config.getPayment;
-        doc["addWorkingList"]       = config.addWorkingList;
-        doc["localIP"]              = config.localIP;
-        
-        String output;
-        serializeJson(doc, output);
-        return output;
+    // [상태 핸들러] 현재 시스템 상태를 JSON 형태로 반환하는 핸들러입니다. (Accept: application/msgpack이면 MessagePack)
+    // 상태가 그대로면 지난번에 만든 본문을 그대로 보내고, 대시보드가 ETag로 물으면 304로 끝난다.
+    statusCache = new StatusCache();
+    serverService->setStatusHandler([](WireFormat format) -> CachedReply {
+        RuntimeStatus runtime;
+        if (rfidController) {
+            runtime.tagsAccepted      = rfidController->dedup().acceptedCount();
+            runtime.tagsSuppressed    = rfidController->dedup().suppressedCount();
+            runtime.tagDedupEvictions = rfidController->dedup().evictionCount();
+            runtime.rfid              = rfidController->stats();
+        }
+        const PaymentSnapshot& snapshot = payment.current();
+        runtime.paymentId        = snapshot.getPaymentId();
+        runtime.paymentItems     = snapshot.getItems().size();
+        runtime.paymentRemaining = snapshot.totalRemaining();
+        runtime.pickProgress     = snapshot.progress();
+        runtime.pickSkips        = pickSkips;
+        runtime.ordersFinished   = ordersFinished;
+        runtime.paymentRestored  = paymentWarm;
+        runtime.paymentVersion   = snapshot.getVersion();
+        runtime.paymentSerial    = snapshot.serial();
+        runtime.paymentRetired   = payment.retiredCount();
+        if (paymentPrefetcher) {
+            runtime.paymentSync    = PaymentPrefetcher::resultName(paymentPrefetcher->lastResult());
+            runtime.paymentPending = paymentPrefetcher->pending();
+            runtime.paymentFetch   = paymentPrefetcher->stats();
+        }
+        runtime.startJobId       = startJobId;
+        runtime.startJobState    = startJobStateNames[startJobState];
+        if (outbox) {
+            runtime.outbox         = outbox->stats();
+            runtime.outboxPending  = outbox->pending();
+        }
+        runtime.dns = hal::dns().stats();
+        runtime.tls = hal::transport().tlsStats();
+        runtime.endpointCount = serverService->endpointCount();
+        for (uint8_t i = 0; i < runtime.endpointCount && i < SERVER_MAX_ENDPOINTS; ++i) {
+            runtime.endpoints[i] = serverService->endpointStats(i);
+        }
+        if (paymentCache) {
+            runtime.paymentSaves = paymentCache->saveCount();
+            runtime.paymentBytes = paymentCache->storedBytes();
+        }
+        runtime.statusNotModified = serverService->statusNotModifiedCount();
+        runtime.events = serverService->eventStats();
+        runtime.commands = serverService->commandStats();
+        runtime.http = serverService->admissionStats();
+        if (motionListener) runtime.motion = motionListener->stats();
+        return statusCache->reply(format, config, runtime);
     });
 
     // [상태 뷰 핸들러] 시스템 상태를 HTML로 표시하는 핸들러입니다.
     serverService->setStatusViewHandler([]() -> String {
-        return  R"rawliteral(
-                <!DOCTYPE html>
-                <html lang="ko">
-                <head>
-                    <meta charset="utf-8">
-                    <title>시스템 상태</title>
-                    <style>
-                        body { font-family: 'Segoe UI', sans-serif; margin: 20px; background: #f4f7f8; }
-                        pre {
-                            background: #fff;
-                            padding: 20px;
-                            border-radius: 10px;
-                            box-shadow: 0 4px 8px rgba(0,0,0,0.1);
-                            overflow-x: auto;
-                            white-space: pre-wrap;
-                        }
-                        h2 { color: #00c4c4; }
-                    </style>
-                </head>
-                <body>
-                    <h2>시스템 상태</h2>
-                    <pre id="status">불러오는 중...</pre>
-
-                    <script>
-                        fetch("/status")
-                            .then(response => response.json())
-                            .then(data => {
-                                document.getElementById("status").textContent = JSON.stringify(data, null, 2);
-                            })
-                            .catch(error => {
-                                document.getElementById("status").textContent = "불러오기 실패: " + error;
-                            });
-                    </script>
-                </body>
-                </html>
-            )rawliteral";
+        return renderStatusViewPage();
     });
 
     // [설정 초기화 핸들러] 모든 설정을 초기화하는 핸들러입니다.
     serverService->setResetConfigHandler([]() {
-        Preferences prefs;
+        KVStore& prefs = *config.store;
         prefs.begin("settings", false);
         prefs.clear();  // 모든 설정 삭제
         prefs.end();
@@ -561,6 +398,86 @@ void setServerHandler() {
     Serial.println("[setServerHandler][2/2] 내장 서버 API 실행 함수 등록 절차 완료\n");
 }
 
+// [SETUP-3] 결제 내역 복원 및 프리페처를 시작하는 함수입니다.
+// 복원에 성공하면 바로 피킹할 수 있고, 서버 재확인과 주기적인 갱신은 프리페처의 백그라운드 태스크가 맡는다.
+void restorePaymentData() {
+    paymentCache = new PaymentCache(hal::journal());   // 저장은 백그라운드 태스크에서
+    paymentPrefetcher = new PaymentPrefetcher(payment, [](const String& headers) {
+        return serverService->sendGETRequest(config.serverIP.c_str(), config.serverPort, config.getPayment, headers, true);
+    }, hal::clock());
+
+    PaymentData restored;
+    if (paymentCache->load(restored)) {
+        payment.publish(restored);
+        LOG_INFO("[PaymentCache][1/2] 저장된 결제 내역 복원: {} (상품 {}개, 남은 수량 {})",
+                 restored.getPaymentId(), static_cast<int>(restored.getItems().size()), payment.current().totalRemaining());
+        paymentWarm = true;
+    } else {
+        LOG_INFO("[PaymentCache][1/2] 저장된 결제 내역 없음");
+    }
+
+    // 복원 이후의 변경만 저장 (복원한 내용은 체크섬이 같아 다시 쓰지 않음).
+    // 저장 태스크는 읽기 슬롯을 받아 flush()하는 동안 스냅샷을 붙잡는다. 슬롯이 없으면 loop가 직접 쓴다
+    payment.setChangeHandler([](const PaymentSnapshot& s) { paymentCache->save(s.toData()); });
+    const int saver = payment.registerReader();
+    if (saver > 0) {
+        hal::startBackgroundTask("payment-save", [saver]() {
+            payment.flush();
+            payment.quiescent(static_cast<uint8_t>(saver));
+        }, PAYMENT_SAVE_PERIOD_MS, 1, 4096);
+    } else {
+        LOG_WARN("[PaymentCache] 읽기 슬롯 없음 → loop에서 저장");
+        paymentSavesInLoop = true;
+    }
+    paymentPrefetcher->begin(config.paymentPrefetchMs);
+    paymentPrefetcher->request(START_FETCH_ATTEMPTS);   // 저장된 ETag로 조건부 요청 → 대부분 304
+    LOG_INFO("[PaymentCache][2/2] 결제 내역 변경 시 플래시 저장, {}ms 주기 프리페치 시작", config.paymentPrefetchMs);
+}
+
+// [SETUP-4] 알림 보관함을 복원하고 전달 태스크를 시작하는 함수입니다.
+// 워킹 리스트 추가와 스탠드 요청을 멱등 키와 함께 순서대로 보내고, 실패하면 간격을 늘려 다시 보낸다.
+void startOutbox() {
+    outbox = new Outbox(*config.store, hal::journal(), [](const OutboxEntry& entry, const String& headers) {
+        String response;
+        if (entry.kind == Outbox::WorkingList) {
+            String path = config.addWorkingList.c_str() + entry.uid;
+            response = serverService->sendGETRequest(config.serverIP.c_str(), config.serverPort, path, headers, true);
+        } else {
+            String path = "/start-stand?uid=" + entry.uid + "&qty=" + entry.quantity;
+            response = serverService->sendGETRequest(config.serverIP.c_str(), config.standPort, path, headers, true);
+        }
+        return Outbox::classify(ServerService::parseStatusCode(response));
+    }, hal::clock());
+    outbox->begin();
+    LOG_INFO("[Outbox] 알림 보관함 시작 (장치 ID {}, 전달 대기 {})", outbox->deviceId(), static_cast<unsigned>(outbox->pending()));
+}
+
+// [SETUP-5] UDP 모션 명령 수신기를 시작하는 함수입니다.
+// GO / STOP 데이터그램을 TCP 연결과 HTTP 파싱 없이 받아 바퀴 보드로 넘기고, ACK 결과를 데이터그램으로 돌려준다.
+void startMotionListener() {
+    motionListener = new MotionListener(hal::motionSocket(), hal::clock(), *config.store);
+    motionListener->setHandler([](MotionType type) {
+        return sendWithRetry(type == MOTION_GO ? "GO" : "STOP");   // 함수: [UTILITY-1]
+    });
+    if (!motionListener->begin(config.motionPort, config.motionKey)) {
+        LOG_INFO("[MotionListener][OFF] UDP 모션 명령 꺼짐 (motion_port {}) → /go, /stop, /ws만 사용", config.motionPort);
+    }
+}
+
+// [SETUP-6] 작업 리스트 설정 백그라운드 요청을 준비하는 함수입니다.
+// /start는 작업 리스트 설정을 이 태스크에 넘기고 바로 202로 답한다. 응답은 loop의 [LOOP-7]이 이어받아 START를 보낸다.
+// /reset도 같은 방식으로 작업 리스트 초기화를 넘기고, 응답은 [LOOP-9]가 이어받아 STOP을 보낸다.
+void startWorklistInit() {
+    worklistInit = new BackgroundRequest("worklist-init", []() {
+        return serverService->sendGETRequest(config.serverIP.c_str(), config.serverPort, config.firstSetWoringLists);
+    });
+    worklistInit->begin();
+    worklistReset = new BackgroundRequest("worklist-reset", []() {
+        return serverService->sendGETRequest(config.serverIP.c_str(), config.serverPort, config.resetWorkingLists);
+    });
+    worklistReset->begin();
+}
+
 // LOOP FUNCTION =======================================================================================================
 
 // [LOOP-1] 관리자 카드 여부 판별
@@ -568,135 +485,300 @@ bool isAdminCard(const String& uid) {
     return uid == config.adminUID || uid == config.masterKey;
 }
 
-// [LOOP-2] 결제 내역 초기화 및 재요청 로직
-bool refreshPaymentData(int maxRetries) {
-    Serial.println("\n[RFIDController][[2/3] 관리자 카드 감지됨 → 결제 내역 초기화");
-    payment.clear();
+// [LOOP-2] 결제 내역 재요청 로직
+// RFID 루프를 막지 않도록 프리페처에 맡긴다. 가진 내역은 지우지 않고 조건부로 요청 (변경 없으면 304, 일부만 바뀌었으면 변경분)
+void refreshPaymentData(int maxRetries) {
+    LOG_INFO("\n[RFIDController][[2/3] 관리자 카드 감지됨 → 결제 내역 갱신 요청 (백그라운드)");
+    paymentWarm = false;
+    paymentPrefetcher->request(maxRetries);
+}
 
-    if (!fetchPaymentDataUntilSuccess(maxRetries)) {
-        Serial.println("[ServerService][PaymentData][404] " + String(maxRetries) + "회 시도하였지만 결제내역 가져오는데 실패했습니다. 재시도 하려면 카드를 다시 찍어주세요.");
-        return false;
-    }
-    return true;
+// [LOOP-3] 작업 리스트 설정을 백그라운드로 넘긴다.
+// 서버 응답(타임아웃 + 헤지까지)을 기다리는 동안에도 내장 서버와 RFID 스캔은 계속 돌고, 응답은 [LOOP-7]이 이어받는다.
+// 취소된 작업의 요청이 아직 진행 중이면 그 응답을 버린 뒤 [LOOP-7]이 다시 넘긴다.
+void startPicking() {
+    startJobState = JOB_LISTING;
+    if (worklistInit->request()) listingJobId = startJobId;
+    LOG_INFO("[ServerService][LISTING] 시작 작업 {}: 작업 리스트 설정 요청 (백그라운드)", static_cast<unsigned>(startJobId));
 }
 
-// [LOOP-3] 외부 서버로 GET 요청 전송해 결제 내역을 받아온다.
-bool fetchPaymentDataUntilSuccess(const int count) {
-    int i = 0;
-    while ( i < count) {
-        Serial.println("[ServerService][PaymentData][1/3] 결제 내역을 가져오는 중입니다..");
-        String getResponse = ServerService::sendGETRequest(config.serverIP.c_str(), config.serverPort, config.getPayment);
-        //Serial.println(getResponse);
-
-        String responseBody = getResponse.substring(getResponse.indexOf("\r\n\r\n") + 4);
-
-        if (payment.parseFromJson(responseBody)) {
-            Serial.println("[ServerService][PaymentData][2/3] 가져온 결제 내역을 출력합니다.");
-            // Serial.println("[ServerService][INFO] 결제 ID: " + payment.getPaymentId());
-            // Serial.println("[ServerService][INFO] 결제 상품 목록:");
-            payment.printItems();
-            Serial.println("[ServerService][PaymentData][3/3] 결제 내역 수신 성공. 다음 단계로 진행합니다.");Serial.println("");
-            return true;
+// [LOOP-4] 상품 매칭 시 동작을 처리하는 함수
+// 한 주기에 여러 상품이 읽히면 STOP은 한 번만 보내고, 상품마다 워킹 리스트 추가 + 스탠드 작업을 보관함에 넣는다.
+// 전달은 보관함의 백그라운드 태스크가 순서대로 맡으므로 여기서는 네트워크를 기다리지 않는다.
+// 한 번 정지에 상품의 남은 수량을 모두 집는다: 스탠드 작업에 수량(qty)을 실어 보내고, 보관함에 넣은 만큼을 장부에 기록한다.
+// 주문이 끝났으면 바로 FINISH를 보낸다.
+void handleMatchedProducts(const String* names, const String* uids, uint8_t count) {
+    for (uint8_t i = 0; i < count; ++i) {
+        LOG_INFO("[RFIDController][2/3] 일치하는 상품: {}", names[i]);
+    }
+    LOG_INFO("[RFIDController][2/3] 모터 정지 명령 전송 ({}개)", count);
+
+    const bool stopped = sendWithRetry("STOP");
+    publishEvent("stop", [&](JsonObject e) { e["acked"] = stopped; e["items"] = count; });
+    if (stopped) {
+        LOG_INFO("[RFIDController][3/3] STOP 명령 전송 및 ACK 수신 성공");
+
+        for (uint8_t i = 0; i < count; ++i) {
+            const String& detectedUid = uids[i];
+
+            // 워킹 리스트 추가 → 스탠드 작업 한 쌍을 보관함(플래시)에 넣은 뒤에 집은 것으로 기록 (재부팅해도 잃지 않음)
+            const PaymentSnapshot& snapshot = payment.current();
+            const int index = snapshot.indexOf(detectedUid);
+            const int quantity = index < 0 ? 1 : std::min(std::max(snapshot.remaining(index), 1), OUTBOX_MAX_QUANTITY);
+            if (outbox->enqueuePick(detectedUid, static_cast<uint8_t>(quantity))) {
+                const int taken = index < 0 ? 0 : payment.consume(detectedUid, quantity);
+                LOG_INFO("[PickLedger] {} {}개 집음 (남은 수량 {}, 전달 대기 {})", names[i], taken, snapshot.totalRemaining(),
+                         static_cast<unsigned>(outbox->pending()));
+                publishEvent("worklist", [&](JsonObject e) {
+                    e["uid"] = detectedUid;
+                    e["name"] = names[i];
+                    e["taken"] = taken;
+                    e["remaining"] = snapshot.totalRemaining();
+                    e["pending"] = outbox->pending();
+                });
+            } else {
+                LOG_WARN("[Outbox] 보관함이 가득 차 알림을 넣지 못함: {}", detectedUid);
+                publishEvent("error", [&](JsonObject e) { e["source"] = "outbox"; e["message"] = "보관함 가득 참"; e["uid"] = detectedUid; });
+            }
         }
+    } else {
+        LOG_WARN("[RFIDController][3/3] STOP 명령 전송 실패 (ACK 없음)");
+    }
 
-        Serial.println("[ServerService][재시도] 결제 내역 파싱 실패. 2초 후 재시도...");Serial.println("");
-        delay(3000); i++;
+    const PickProgress progress = payment.current().progress();
+    if (progress.complete()) {
+        ++ordersFinished;
+        LOG_INFO("[PickLedger] 주문 완료 ({}개 상품, {}개) → FINISH 전송", static_cast<unsigned>(progress.items), progress.picked);
+        publishEvent("finish", [&](JsonObject e) { e["items"] = progress.items; e["picked"] = progress.picked; });
+        if (!sendWithRetry("FINISH")) {
+            LOG_WARN("[PickLedger] FINISH 명령 전송 실패 (ACK 없음)");
+        }
+        return;
     }
-    return false;
+
+    LOG_INFO("[RFIDController][3/3] 다음 상품으로 이동 합니다.\n");
 }
 
-// [LOOP-4] 상품 매칭 시 동작을 처리하는 함수
-void handleMatchedProduct(const String& matchedName, const String& detectedUid) {
-    Serial.println("[RFIDController][2/3] 일치하는 상품: " + matchedName + " → 모터 정지 명령 전송");
+// [LOOP-5] UID를 인식해서 결제내역 확인 하는 함수
+// 인벤토리 모드면 한 주기에 읽힌 태그를 모두 확인하고, 결제 내역에 있는 상품은 한 번의 정지로 함께 처리한다.
+// 관리자 카드가 함께 읽혀도 같은 주기의 상품은 그대로 처리하고, 결제 내역 갱신은 주기 끝에 한 번만 요청한다.
+void checkDetectedUid() {
+    TagInventory inventory;
+    if (!takeHeldScan(inventory) && rfidController->getUIDs(inventory) == 0) return;   // 함수: [UTILITY-8]
+
+    String matchedNames[RFID_INVENTORY_MAX];
+    String matchedUids[RFID_INVENTORY_MAX];
+    uint8_t matched = 0;
+    bool adminSeen = false;
+    const PaymentSnapshot& snapshot = payment.current();   // 이번 주기 동안 같은 스냅샷으로 확인 (잠금 없음)
 
-    if (sendWithRetry("STOP")) {
-        Serial.println("[RFIDController][3/3] STOP 명령 전송 및 ACK 수신 성공");
+    for (uint8_t i = 0; i < inventory.count; ++i) {
+        const String& detectedUid = inventory.uids[i];
 
-        // UID를 서버에 전송하여 워킹 리스트에 추가
-        // String path = "/bot/add-working-list?uid=" + detectedUid;
-        String path = config.addWorkingList.c_str() + detectedUid;
-        String response = ServerService::sendGETRequest(config.serverIP.c_str(), config.serverPort, path);
+        //TODO: 카드가 찍히면 해당하는 UID를 가지는 선반에 요청을 보내 rfid카드를 들어 올린다
+        //sendUpRfidCardRequest(detectedUid);
 
-        Serial.println("[Server 응답] " + response);
+        LOG_INFO("[RFIDController][1/3] 감지된 UID: {} (리더기 {})", detectedUid, inventory.readerId);
 
-        if (response.indexOf("작업 항목이 성공적으로 추가되었습니다.") != -1 || response.indexOf("200 OK") != -1) {
-            Serial.println("[RFIDController] 워킹 리스트 추가 성공");
-            // detectedUid 를 기반으로 /start-stand?uid=
-            sendStartStandRequest(detectedUid);
+        // 함수: [LOOP-1]
+        if (isAdminCard(detectedUid)) {
+            publishEvent("tag", [&](JsonObject e) { e["uid"] = detectedUid; e["reader"] = inventory.readerId; e["result"] = "admin"; });
+            adminSeen = true;
+            continue;
+        }
+
+        // test 카드로 작동 확인
+        if (detectedUid == config.testKey) {
+            publishEvent("tag", [&](JsonObject e) { e["uid"] = detectedUid; e["reader"] = inventory.readerId; e["result"] = "test"; });
+            if (sendWithRetry("TEST")) {
+                LOG_INFO("[RFIDController][3/3] TEST 명령 전송 및 ACK 수신 성공");
+            } else {
+                LOG_WARN("[RFIDController][3/3] TEST 명령 전송 실패 (ACK 없음)");
+            }
+            continue;
+        }
+
+        const int index = snapshot.indexOf(detectedUid);
+        const char* result = "matched";
+        if (index < 0) {
+            result = "unknown";
+            LOG_INFO("[RFIDController][2/3] 감지된 UID는 결제 내역에 없음 → 무시");
+        } else if (snapshot.remaining(index) == 0) {
+            result = "done";
+            ++pickSkips;
+            LOG_INFO("[RFIDController][2/3] 이미 다 집은 상품({}) → 정지하지 않음", snapshot.getItems()[index].name);
         } else {
-            Serial.println("[RFIDController] 워킹 리스트 추가 실패");
+            matchedNames[matched] = snapshot.getItems()[index].name;
+            matchedUids[matched] = detectedUid;
+            ++matched;
         }
-    } else {
-        Serial.println("[RFIDController][3/3] STOP 명령 전송 실패 (ACK 없음)");
+        publishEvent("tag", [&](JsonObject e) {
+            e["uid"] = detectedUid;
+            e["reader"] = inventory.readerId;
+            e["result"] = result;
+            if (index >= 0) e["name"] = snapshot.getItems()[index].name;
+        });
+    }
+
+    // 함수 [LOOP-4]
+    if (matched > 0) {
+        handleMatchedProducts(matchedNames, matchedUids, matched);
+    } else if (!adminSeen) {
+        LOG_INFO("[RFIDController][3/3] 다음 상품으로 이동 합니다.\n");
     }
 
-    Serial.println("[RFIDController][3/3] 다음 상품으로 이동 합니다.\n");
+    // 함수: [LOOP-2] (이번 주기의 상품을 처리한 뒤에 요청)
+    if (adminSeen) refreshPaymentData(); // 기본 3회 시도
 }
 
-// [LOOP-5] UID를 인식해서 결제내역 확인 하는 함수
-void checkDetectedUid() {
-    String detectedUid = rfidController->getUID();
-    if (detectedUid.isEmpty()) return;
-    
-    //TODO: 카드가 찍히면 해당하는 UID를 가지는 선반에 요청을 보내 rfid카드를 들어 올린다
-    //sendUpRfidCardRequest(detectedUid);
+// [LOOP-6] 프리페치 결과 반영 및 대기 중인 시작 작업 처리
+// 완료된 내역은 프리페처가 새 스냅샷으로 게시하고, 여기서는 결과를 기록한 뒤 202로 미뤄 둔 /start를 이어서 진행한다.
+void pollPaymentPrefetch() {
+    const PaymentPrefetcher::Result result = paymentPrefetcher->poll();
+    const PaymentSnapshot& snapshot = payment.current();
+    switch (result) {
+        case PaymentPrefetcher::Result::Full:
+            LOG_INFO("[PaymentPrefetch] 결제 내역 수신 ({}, 버전 {})", snapshot.getPaymentId(), snapshot.getVersion());
+            snapshot.printItems();
+            break;
+        case PaymentPrefetcher::Result::Delta:
+            LOG_INFO("[PaymentPrefetch] 바뀐 상품만 반영 ({}, 버전 {})", snapshot.getPaymentId(), snapshot.getVersion());
+            snapshot.printItems();
+            break;
+        case PaymentPrefetcher::Result::NotModified:
+            LOG_DEBUG("[PaymentPrefetch] 결제 내역 변경 없음 ({})", snapshot.getPaymentId());
+            break;
+        case PaymentPrefetcher::Result::Superseded:
+            // /reset이 내역을 비운 경우 등: 기다리는 시작 작업이 있으면 바뀐 내역을 기준으로 다시 받는다
+            LOG_INFO("[PaymentPrefetch] 받는 동안 다른 결제 내역이 게시되어 결과를 버림");
+            if (startJobState == JOB_PENDING) paymentPrefetcher->request(START_FETCH_ATTEMPTS);
+            break;
+        case PaymentPrefetcher::Result::Failed:
+            publishEvent("error", [](JsonObject e) {
+                e["source"] = "payment";
+                e["message"] = "결제 내역 수신 실패";
+                e["retrying"] = paymentPrefetcher->pending();
+            });
+            if (paymentPrefetcher->pending()) {
+                LOG_WARN("[PaymentPrefetch][재시도] 결제 내역 수신 실패 → 재시도 예약");
+            } else {
+                LOG_WARN("[PaymentPrefetch][404] 결제 내역 수신 실패. 재시도 하려면 관리자 카드를 다시 찍어주세요.");
+            }
+            break;
+        default:
+            break;
+    }
 
-    Serial.println("[RFIDController][1/3] 감지된 UID: " + detectedUid);
+    if (startJobState != JOB_PENDING) return;
+    if (snapshot.getPaymentId() != "" && !snapshot.progress().complete()) {
+        LOG_INFO("[ServerService][START] 시작 작업 {}: 결제 내역 준비 완료 → 시작 진행", static_cast<unsigned>(startJobId));
+        startPicking();   // 함수: [LOOP-3]
+    } else if (!paymentPrefetcher->pending()) {
+        LOG_WARN("[ServerService][BLOCKED] 시작 작업 {}: 서버에 남은 결제 내역 없음 → 시작 차단됨", static_cast<unsigned>(startJobId));
+        startJobState = JOB_FAILED;
+    }
+}
 
-    // 함수: [LOOP-2], [LOOP-3], [LOOP-4]
-    if (isAdminCard(detectedUid)) {
-        refreshPaymentData(); // 기본 3회 시도
+// [LOOP-7] 작업 리스트 설정 응답을 이어받아 로봇을 출발시킨다.
+// /reset으로 취소된 작업(또는 그 뒤 새로 시작한 작업)의 것이 아닌 응답은 버린다.
+void pollStartJob() {
+    String getResponse;
+    if (!worklistInit->poll(getResponse)) {
+        if (startJobState == JOB_LISTING && listingJobId == 0 && worklistInit->request()) listingJobId = startJobId;
+        return;
+    }
+    const uint32_t answered = listingJobId;
+    listingJobId = 0;
+    if (startJobState != JOB_LISTING || answered != startJobId) {
+        LOG_INFO("[ServerService][LISTING] 취소된 시작 작업 {}의 작업 리스트 응답 버림", static_cast<unsigned>(answered));
         return;
     }
+    LOG_DEBUG("[응답] {}", getResponse);
 
-    // test 카드로 작동 확인
-    if (detectedUid == config.testKey) {
-        if (sendWithRetry("TEST")) {
-            Serial.println("[RFIDController][3/3] TEST 명령 전송 및 ACK 수신 성공");
-            return;
-        } else {
-            Serial.println("[RFIDController][3/3] TEST 명령 전송 실패 (ACK 없음)");
-            return;
-        }
+    if (getResponse.indexOf("초기 작업 리스트 생성 완료") == -1 && getResponse.indexOf("200 OK") == -1) {
+        LOG_WARN("[ServerService][BLOCKED] 시작 작업 {}: 작업 리스트 설정 실패 → 로봇 시작 차단됨", static_cast<unsigned>(startJobId));
+        publishEvent("error", [](JsonObject e) { e["source"] = "server"; e["message"] = "작업 리스트 설정 실패"; });
+        startJobState = JOB_FAILED;
+        return;
     }
 
-    // 함수 [LOOP-5]
-    String matchedName;
-    if (payment.matchUID(detectedUid, matchedName)) {
-        handleMatchedProduct(matchedName,detectedUid);
-    } else {
-        Serial.println("[RFIDController][2/3] 감지된 UID는 결제 내역에 없음 → 무시");
-        Serial.println("[RFIDController][3/3] 다음 상품으로 이동 합니다.\n");
+    // 결제 내역도 존재하고, 작업 리스트도 성공적으로 설정된 경우
+    LOG_INFO("[ServerService][START] 시작 작업 {}: 결제 내역 및 작업 리스트 준비 완료 → 로봇 시작", static_cast<unsigned>(startJobId));
+    startJobState = sendWithRetry("START") ? JOB_STARTED : JOB_FAILED;   // 로봇 시작 명령
+}
+
+// [LOOP-8] 보관함이 거절되어 버린 작업의 집은 수량을 되돌린다.
+// 워킹 리스트 추가나 스탠드 작업이 4xx로 버려지면 그 상품은 실제로 집히지 않았으므로, 장부를 되돌려 다음 통과에서 다시 멈추게 한다.
+// 이미 FINISH를 보낸 주문이면 바퀴 보드는 복귀 중이므로 대시보드에 오류로 알려 작업자가 다시 시작하게 한다.
+void pollRejectedPicks() {
+    OutboxEntry rejected;
+    while (outbox && outbox->takeRejected(rejected)) {
+        const bool wasComplete = payment.current().progress().complete();
+        const int restored = payment.release(rejected.uid, rejected.quantity);
+        LOG_WARN("[PickLedger] {} 거절됨 ({}) → 집은 수량 {}개 되돌림{}", Outbox::kindName(rejected.kind), rejected.uid, restored,
+                 wasComplete && restored > 0 ? " (FINISH 이후)" : "");
+        publishEvent("error", [&](JsonObject e) {
+            e["source"] = "outbox";
+            e["message"] = "알림 거절됨";
+            e["kind"] = Outbox::kindName(rejected.kind);
+            e["uid"] = rejected.uid;
+            e["restored"] = restored;
+            e["after_finish"] = wasComplete && restored > 0;
+        });
+    }
+}
+
+// [LOOP-9] 작업 리스트 초기화 응답을 이어받아 로봇을 정지시킨다.
+void pollWorklistReset() {
+    String getResponse;
+    if (!worklistReset->poll(getResponse)) return;
+    LOG_DEBUG("[응답] {}", getResponse);
+
+    // 응답 메시지 기반 판단
+    if (getResponse.indexOf("초기화했습니다") == -1 && getResponse.indexOf("200 OK") == -1) {
+        LOG_WARN("[ServerService][BLOCKED] 작업 리스트 초기화 실패 → 로봇 정지 차단됨");
+        publishEvent("error", [](JsonObject e) { e["source"] = "server"; e["message"] = "작업 리스트 초기화 실패"; });
+        return;
+    }
+    if (!sendWithRetry("STOP")) {  // 로봇 정지 명령 전송
+        LOG_WARN("[ServerService][RESET] STOP 명령 전송 실패 (ACK 없음)");
     }
 }
 
 // UTILITY FUNCTION ====================================================================================================
 
 // [UTILITY-1] 명령 전송 함수 (재시도 포함)
+// ACK를 기다리는 동안(재시도 간격 포함)에도 RFID 스캔은 이어간다. 읽은 태그는 모아 두었다가 loop가 처리한다
 bool sendWithRetry(const String& cmd, const int retries) {
     for (int i = 0; i < retries; ++i) {
-        Serial2.println(cmd);  // 명령 전송
-        Serial.println("[Wired Comm][Serial2][1/2] " + cmd + " 명령 전송");
+        wheelLink->sendLine(cmd);  // 명령 전송
+        LOG_DEBUG("[Wired Comm][Serial2][1/2] {} 명령 전송", cmd);
 
-        unsigned long start = millis();
-        while (millis() - start < 1000) {  // 1초 이내 응답 대기
-            if (Serial2.available()) {
-                String response = Serial2.readStringUntil('\n');
+        unsigned long start = hal::clock().millis();
+        while (hal::clock().millis() - start < 1000) {  // 1초 이내 응답 대기
+            if (wheelLink->hasLine()) {
+                String response = wheelLink->receiveLine();
                 response.trim();
                 if (response == "ACK") {
-                    Serial.println("[Wired Comm][Serial2][2/2] ACK 수신 성공");
+                    LOG_DEBUG("[Wired Comm][Serial2][2/2] ACK 수신 성공");
                     return true;
                 } else {
-                    Serial.println("[Wired Comm][Serial2][2/2]  잘못된 응답: " + response);
+                    LOG_WARN("[Wired Comm][Serial2][2/2]  잘못된 응답: {}", response);
                 }
             }
+            scanWhileWaiting();   // 함수: [UTILITY-7]
         }
 
-        Serial.println("[Wired Comm][Serial2][RETRY]  ACK 수신 실패, 재시도 " + String(i + 1) + "\n");
-        delay(200);
+        LOG_WARN("[Wired Comm][Serial2][RETRY]  ACK 수신 실패, 재시도 {}\n", i + 1);
+        start = hal::clock().millis();
+        while (hal::clock().millis() - start < 200) {   // 재시도 간격
+            scanWhileWaiting();
+            delay(1);
+        }
     }
 
-    Serial.println("[Wired Comm][4/4]  " + cmd + " 명령 전송 실패 (ACK 없음)\n");
+    LOG_ERROR("[Wired Comm][4/4]  {} 명령 전송 실패 (ACK 없음)\n", cmd);
+    publishEvent("error", [&](JsonObject e) { e["source"] = "wheel"; e["message"] = "ACK 없음"; e["command"] = cmd; });
     return false;
 }
 
@@ -710,62 +792,72 @@ void simpleMessage(String message) {
     }
 }
 
-// [UTILITY-3] 감지된 UID를 기반으로 /start-stand 요청을 보냅니다.
-void sendStartStandRequest(const String& detectedUid) {
+// [UTILITY-4] 감지된 UID를 기반으로 /up-rfid? 요청을 보냅니다.
+void sendUpRfidCardRequest(const String& detectedUid) {
         if (detectedUid.length() == 0) {
-        Serial.println("[요청 실패] UID가 비어 있습니다.");
+        LOG_WARN("[요청 실패] UID가 비어 있습니다.");
         return;
     }
 
     for (int attempt = 1; attempt <= 3; ++attempt) {
-        HTTPClient http;
-        String url = "http://" + String(config.serverIP) + ":" + String(config.standPort) + "/start-stand?uid=" + detectedUid;
+        String path = "/up-rfid?uid=" + detectedUid;
+        if (!serverService->endpointAvailable(config.serverIP.c_str(), config.standPort)) {
+            LOG_WARN("[요청 차단] 스탠드 서킷 브레이커 열림 → 재시도 중단");
+            break;
+        }
 
-        Serial.println("[요청 전송] (" + String(attempt) + "회차): " + url);
-        http.begin(url);
+        LOG_INFO("[요청 전송] ({}회차): {}:{}{}", attempt, config.serverIP, config.standPort, path);
+        String response = serverService->sendGETRequest(config.serverIP.c_str(), config.standPort, path);
 
-        int httpCode = http.GET();
+        int httpCode = ServerService::parseStatusCode(response);
 
         if (httpCode == 200) {
-            String response = http.getString();
-            Serial.println("[응답 200] 작업 시작됨 → " + response);
-            http.end();
+            LOG_INFO("[응답 200] 작업 시작됨 → {}", ServerService::extractBody(response));
             break;
         } else {
-            Serial.println("[요청 실패] 응답 코드: " + String(httpCode));
+            LOG_WARN("[요청 실패] 응답 코드: {}", httpCode);
         }
 
-        http.end();
         delay(1000); // 1초 대기 후 재시도
     }
 }
 
-// [UTILITY-4] 감지된 UID를 기반으로 /up-rfid? 요청을 보냅니다.
-void sendUpRfidCardRequest(const String& detectedUid) {
-        if (detectedUid.length() == 0) {
-        Serial.println("[요청 실패] UID가 비어 있습니다.");
-        return;
-    }
-
-    for (int attempt = 1; attempt <= 3; ++attempt) {
-        HTTPClient http;
-        String url = "http://" + String(config.serverIP) + ":" + String(config.standPort) + "/up-rfid?uid=" + detectedUid;
-
-        Serial.println("[요청 전송] (" + String(attempt) + "회차): " + url);
-        http.begin(url);
+// [UTILITY-5] /events 대시보드에 이벤트를 보내는 함수
+// 열린 연결이 없으면 JSON을 만들지도 않는다 (태그 경로에 비용을 더하지 않음). 보내는 건 ServerService::handle()이 모아서
+void publishEvent(const char* type, const std::function<void(JsonObject)>& fill) {
+    if (!serverService || !serverService->eventsActive()) return;
+    JsonDocument doc;
+    fill(doc.to<JsonObject>());
+    String data;
+    serializeJson(doc, data);
+    serverService->publishEvent(type, data);
+}
 
-        int httpCode = http.GET();
+// [UTILITY-6] /start 작업의 202 응답을 만드는 함수
+// 결과는 /status의 start_job(같은 작업 ID)에서 확인한다
+HandlerReply startJobReply() {
+    HandlerReply reply;
+    reply.code = 202;
+    reply.body = String("{\"message\":\"") + (startJobState == JOB_PENDING ? "결제 내역 수신 중" : "작업 리스트 설정 중") +
+                 "\",\"job\":" + startJobId + ",\"status\":\"" + startJobStateNames[startJobState] + "\"}";
+    return reply;
+}
 
-        if (httpCode == 200) {
-            String response = http.getString();
-            Serial.println("[응답 200] 작업 시작됨 → " + response);
-            http.end();
-            break;
-        } else {
-            Serial.println("[요청 실패] 응답 코드: " + String(httpCode));
-        }
+// [UTILITY-7] 바퀴 보드 ACK를 기다리는 동안 RFID 스캔을 이어가는 함수
+// 리더기는 자기 주기가 되었을 때만 버스를 쓰므로 대기 루프에서 계속 불러도 된다. 모아 둘 자리가 없으면 읽지 않는다
+// (읽고 버리면 중복 억제 창 동안 같은 태그가 다시 나오지 않음)
+void scanWhileWaiting() {
+    if (!rfidController || heldScanCount >= HELD_SCAN_CAPACITY) return;
+    TagInventory& slot = heldScans[(heldScanHead + heldScanCount) % HELD_SCAN_CAPACITY];
+    if (rfidController->getUIDs(slot) > 0) ++heldScanCount;
+    if (serverService) serverService->markScanned();
+}
 
-        http.end();
-        delay(1000); // 1초 대기 후 재시도
-    }
-}
\ No newline at end of file
+// [UTILITY-8] 기다리는 동안 읽어 둔 태그를 꺼내는 함수 (없으면 false)
+bool takeHeldScan(TagInventory& inventory) {
+    if (heldScanCount == 0) return false;
+    inventory = heldScans[heldScanHead];
+    heldScanHead = (heldScanHead + 1) % HELD_SCAN_CAPACITY;
+    --heldScanCount;
+    return true;
+}
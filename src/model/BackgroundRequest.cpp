@@ -0,0 +1,31 @@
+#include "BackgroundRequest.h"
+#include "BackgroundTask.h"
+
+BackgroundRequest::BackgroundRequest(const char* name, FetchFn fetch) : name(name), fetch(fetch), state(IDLE) {}
+
+void BackgroundRequest::begin() {
+    hal::startBackgroundTask(name, [this]() { step(); }, 20, 1, 6144);
+}
+
+// ========== loop 쪽 =======================================================================================
+bool BackgroundRequest::request() {
+    if (state.load() != IDLE) return false;
+    response = "";
+    state = REQUESTED;
+    return true;
+}
+
+bool BackgroundRequest::poll(String& out) {
+    if (state.load() != DONE) return false;
+    out = response;
+    response = "";
+    state = IDLE;
+    return true;
+}
+
+// ========== 백그라운드 태스크 ===============================================================================
+void BackgroundRequest::step() {
+    if (state.load() != REQUESTED) return;
+    response = fetch();
+    state = DONE;
+}
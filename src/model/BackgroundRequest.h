@@ -0,0 +1,39 @@
+#ifndef BACKGROUNDREQUEST_H
+#define BACKGROUNDREQUEST_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+
+/**
+ * 백그라운드 요청 한 건 (응답을 loop가 이어받아 다음 단계를 진행)
+ * - loop가 request()하면 백그라운드 태스크가 fetch()를 호출하고, loop의 poll()이 끝난 응답을 넘겨받는다.
+ *   서버 타임아웃 / 헤지를 기다리는 동안 내장 서버와 RFID 스캔이 멈추지 않는다.
+ * - 한 번에 하나만 진행한다 (진행 중에 다시 request()하면 false).
+ * 응답 문자열은 상태 플래그로 소유권을 넘긴다: IDLE·DONE = loop, REQUESTED = 태스크.
+ */
+class BackgroundRequest {
+public:
+    // 요청 실행 (백그라운드 태스크에서 호출), 원시 HTTP 응답 반환
+    using FetchFn = std::function<String()>;
+
+    BackgroundRequest(const char* name, FetchFn fetch);
+
+    void begin();                           // 백그라운드 태스크 시작
+    bool request();                         // 요청 넘김 (진행 중이면 false)
+    bool poll(String& response);            // loop에서 호출: 끝났으면 응답을 넘기고 true
+
+    bool busy() const { return state.load() != IDLE; }
+
+private:
+    enum State : uint8_t { IDLE, REQUESTED, DONE };
+
+    void step();                            // 백그라운드 태스크 본문
+
+    const char* name;
+    FetchFn fetch;
+    std::atomic<uint8_t> state;
+    String response;                        // DONE일 때 loop가 읽음
+};
+
+#endif // BACKGROUNDREQUEST_H
@@ -0,0 +1,211 @@
+#include "Outbox.h"
+#include "BackgroundTask.h"
+#include "TraceLog.h"
+
+namespace {
+
+const char* NAMESPACE = "outbox";
+const char* ACK_KEY = "ack";                // 마지막으로 전달(또는 거절)한 seq
+const char* INSTANCE_KEY = "inst";          // 장치 ID
+
+const uint32_t RETRY_MIN_MS = 500;          // 첫 재시도 간격 (실패할 때마다 두 배)
+const uint32_t RETRY_MAX_MS = 8000;
+const size_t RECORD_HEADER = 6;             // seq(4) + 종류(1) + UID 길이(1), 그 뒤에 UID + 수량(1)
+
+void slotKey(uint32_t seq, char* key, size_t size) {
+    snprintf(key, size, "e%02u", static_cast<unsigned>(seq % OUTBOX_CAPACITY));
+}
+
+} // namespace
+
+Outbox::Outbox(KVStore& store, KVStore& journal, SendFn send, Clock& clock)
+    : store(store), journal(journal), send(send), clock(&clock), head(1), tail(1), returnHead(0), returnTail(0) {}
+
+void Outbox::begin() {
+    restore();
+    hal::startBackgroundTask("outbox", [this]() { step(); }, 20, 1, 6144);
+}
+
+// ========== loop 쪽 =======================================================================================
+// 두 항목을 플래시에 쓴 뒤에 tail을 한 번에 옮긴다 (태스크는 한 쌍을 모두 보거나 하나도 보지 않음)
+bool Outbox::enqueuePick(const String& uid, uint8_t quantity) {
+    const uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) > OUTBOX_CAPACITY - 2 || uid.length() > 255) {
+        counters.dropped += 2;
+        return false;
+    }
+
+    const uint32_t now = clock->millis();
+    put(t, WorkingList, uid, quantity, now);
+    put(t + 1, StandStart, uid, quantity, now);
+    store.begin(NAMESPACE, false);
+    if (!persist(ring[t % OUTBOX_CAPACITY]) || !persist(ring[(t + 1) % OUTBOX_CAPACITY])) {
+        LOG_WARN("[Outbox] 플래시 기록 실패 (seq {}) → 메모리에서만 전달", static_cast<unsigned>(t));
+    }
+    store.end();
+
+    tail.store(t + 2, std::memory_order_release);
+    counters.enqueued += 2;
+    return true;
+}
+
+void Outbox::put(uint32_t seq, Kind kind, const String& uid, uint8_t quantity, uint32_t now) {
+    OutboxEntry& entry = ring[seq % OUTBOX_CAPACITY];
+    entry.seq = seq;
+    entry.kind = kind;
+    entry.uid = uid;
+    entry.quantity = quantity;
+    entry.enqueuedAt = now;
+}
+
+bool Outbox::takeRejected(OutboxEntry& entry) {
+    const uint32_t h = returnHead.load(std::memory_order_relaxed);
+    if (h == returnTail.load(std::memory_order_acquire)) return false;
+    entry = returned[h % OUTBOX_RETURN_CAPACITY];
+    returnHead.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+uint32_t Outbox::pending() const {
+    return tail.load() - head.load();
+}
+
+uint32_t Outbox::oldestAgeMs() const {
+    const uint32_t h = head.load();
+    if (h == tail.load()) return 0;
+    return clock->millis() - ring[h % OUTBOX_CAPACITY].enqueuedAt;
+}
+
+// ========== 복원 ==========================================================================================
+// ack 다음 seq부터 슬롯이 이어지는 데까지 되살린다 (중간이 비면 그 뒤는 쓰다 만 것이므로 버림).
+// 수량 바이트가 없는 이전 형식의 슬롯은 수량 1로 읽는다
+void Outbox::restore() {
+    store.begin(NAMESPACE, false);
+    instance = store.getString(INSTANCE_KEY);
+    if (instance.isEmpty()) {
+        instance = String(static_cast<unsigned long>(random(1, 0x7FFFFFFF)), HEX);
+        store.putString(INSTANCE_KEY, instance);
+    }
+
+    journal.begin(NAMESPACE, true);
+    const uint32_t acked = static_cast<uint32_t>(journal.getInt(ACK_KEY, 0));
+    journal.end();
+    uint32_t next = acked + 1;
+    const uint32_t now = clock->millis();
+    for (uint32_t i = 0; i < OUTBOX_CAPACITY; ++i) {
+        char key[8];
+        slotKey(next, key, sizeof(key));
+        uint8_t record[RECORD_HEADER + 255 + 1];
+        const size_t length = store.getBytes(key, record, sizeof(record));
+        if (length < RECORD_HEADER) break;
+
+        const uint32_t seq = record[0] | (record[1] << 8) | (record[2] << 16) | (static_cast<uint32_t>(record[3]) << 24);
+        const size_t uidLength = record[5];
+        if (seq != next || (length != RECORD_HEADER + uidLength && length != RECORD_HEADER + uidLength + 1)) break;
+
+        OutboxEntry& entry = ring[seq % OUTBOX_CAPACITY];
+        entry.seq = seq;
+        entry.kind = record[4];
+        entry.uid = "";
+        entry.uid.reserve(uidLength);
+        for (size_t k = 0; k < uidLength; ++k) entry.uid += static_cast<char>(record[RECORD_HEADER + k]);
+        entry.quantity = length > RECORD_HEADER + uidLength ? record[RECORD_HEADER + uidLength] : 1;
+        entry.enqueuedAt = now;
+        ++next;
+    }
+    store.end();
+
+    head = acked + 1;
+    tail = next;
+    counters.restored = next - (acked + 1);
+    if (counters.restored > 0) {
+        LOG_INFO("[Outbox] 전달하지 못한 알림 {}개 복원 (seq {}부터)", static_cast<unsigned>(counters.restored),
+                 static_cast<unsigned>(acked + 1));
+    }
+}
+
+// ========== 백그라운드 태스크 ===============================================================================
+// 맨 앞 항목 하나를 보낸다 (실패하면 간격을 늘려 같은 항목을 다시 보냄).
+// 돌려줄 자리가 없으면 보내지 않는다 (거절된 작업을 loop에 알리지 못하고 버리지 않도록)
+void Outbox::step() {
+    const uint32_t t = tail.load(std::memory_order_acquire);
+    uint32_t h = head.load(std::memory_order_relaxed);
+    const uint32_t now = clock->millis();
+    if (h == t || static_cast<int32_t>(now - retryAt) < 0) return;
+    if (returnTail.load(std::memory_order_relaxed) - returnHead.load(std::memory_order_acquire) >= OUTBOX_RETURN_CAPACITY) return;
+
+    const OutboxEntry& entry = ring[h % OUTBOX_CAPACITY];
+    const String headers = String("Idempotency-Key: ") + instance + "-" + static_cast<unsigned long>(entry.seq) + "\r\n";
+    switch (send(entry, headers)) {
+        case Delivery::Retry:
+            ++counters.retries;
+            backoffMs = backoffMs ? (backoffMs * 2 > RETRY_MAX_MS ? RETRY_MAX_MS : backoffMs * 2) : RETRY_MIN_MS;
+            retryAt = now + backoffMs;
+            LOG_WARN("[Outbox] {} 전달 실패 ({}) → {}ms 후 재시도", kindName(entry.kind), entry.uid, static_cast<unsigned>(backoffMs));
+            return;
+        case Delivery::Rejected:
+            ++counters.rejected;
+            LOG_WARN("[Outbox] {} 거절됨 ({}) → 버림", kindName(entry.kind), entry.uid);
+            // 워킹 리스트에 없는 상품을 스탠드가 들어 올리지 않도록, 딸린 스탠드 작업도 함께 버린다 (ack 한 번)
+            if (entry.kind == WorkingList && h + 1 != t) {
+                const OutboxEntry& next = ring[(h + 1) % OUTBOX_CAPACITY];
+                if (next.kind == StandStart && next.uid == entry.uid) {
+                    ++counters.cancelled;
+                    LOG_WARN("[Outbox] {} 취소 ({}) → 워킹 리스트 추가가 거절됨", kindName(next.kind), next.uid);
+                    ++h;
+                }
+            }
+            giveBack(entry);
+            break;
+        case Delivery::Delivered:
+            ++counters.delivered;
+            LOG_DEBUG("[Outbox] {} 전달 ({}, 대기 {}ms)", kindName(entry.kind), entry.uid,
+                      static_cast<unsigned>(now - entry.enqueuedAt));
+            break;
+    }
+
+    backoffMs = 0;
+    acknowledge(h);
+    head.store(h + 1, std::memory_order_release);
+}
+
+bool Outbox::persist(const OutboxEntry& entry) {
+    uint8_t record[RECORD_HEADER + 255 + 1];
+    for (uint8_t i = 0; i < 4; ++i) record[i] = (entry.seq >> (8 * i)) & 0xFF;
+    record[4] = entry.kind;
+    record[5] = static_cast<uint8_t>(entry.uid.length());
+    memcpy(record + RECORD_HEADER, entry.uid.c_str(), entry.uid.length());
+    record[RECORD_HEADER + entry.uid.length()] = entry.quantity;
+
+    char key[8];
+    slotKey(entry.seq, key, sizeof(key));
+    const size_t length = RECORD_HEADER + entry.uid.length() + 1;
+    return store.putBytes(key, record, length) == length;
+}
+
+void Outbox::giveBack(const OutboxEntry& entry) {
+    const uint32_t t = returnTail.load(std::memory_order_relaxed);
+    returned[t % OUTBOX_RETURN_CAPACITY] = entry;
+    returnTail.store(t + 1, std::memory_order_release);
+}
+
+void Outbox::acknowledge(uint32_t seq) {
+    journal.begin(NAMESPACE, false);
+    journal.putInt(ACK_KEY, static_cast<int32_t>(seq));
+    journal.end();
+}
+
+// ========== 응답 분류 =====================================================================================
+Outbox::Delivery Outbox::classify(int httpCode) {
+    if (httpCode >= 200 && httpCode < 300) return Delivery::Delivered;
+    if (httpCode >= 400 && httpCode < 500 && httpCode != 408 && httpCode != 429) return Delivery::Rejected;
+    return Delivery::Retry;
+}
+
+const char* Outbox::kindName(uint8_t kind) {
+    switch (kind) {
+        case WorkingList: return "워킹 리스트 추가";
+        case StandStart:  return "스탠드 작업 요청";
+        default:          return "알 수 없는 알림";
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+
+#include "Clock.h"
+#include "KVStore.h"
+
+#define OUTBOX_CAPACITY 32          // 전달을 기다릴 수 있는 알림 수 (플래시 슬롯 수와 같음)
+#define OUTBOX_MAX_QUANTITY 255     // 스탠드 작업 하나가 집을 수 있는 최대 수량 (기록의 1바이트)
+#define OUTBOX_RETURN_CAPACITY 8    // loop가 아직 가져가지 않은 거절된 작업 수 (가득 차면 전달을 잠시 멈춤)
+
+// 서버/스탠드에 보낼 알림 하나
+struct OutboxEntry {
+    uint32_t seq = 0;                 // 단조 증가 (재부팅 후에도 이어짐), 멱등 키의 일부
+    uint8_t kind = 0;                 // Outbox::Kind
+    String uid;
+    uint8_t quantity = 1;             // 이번 정지에서 스탠드가 집을 수량 (한 쌍의 두 항목이 같은 값)
+    uint32_t enqueuedAt = 0;          // millis (복원한 항목은 복원 시각)
+};
+
+struct OutboxStats {
+    uint32_t enqueued = 0;
+    uint32_t delivered = 0;
+    uint32_t retries = 0;             // 실패 후 다시 보낸 횟수
+    uint32_t rejected = 0;            // 서버가 거절해 버린 항목 (4xx)
+    uint32_t cancelled = 0;           // 워킹 리스트 추가가 거절되어 보내지 않은 스탠드 작업
+    uint32_t dropped = 0;             // 가득 차서 넣지 못한 항목
+    uint32_t restored = 0;            // 부팅 시 플래시에서 되살린 항목
+};
+
+/**
+ * 저장 후 전달(store-and-forward) 알림 보관함
+ * - enqueuePick()은 상품 하나의 워킹 리스트 추가 + 스탠드 작업(집을 수량 포함)을 RAM 링과 플래시 슬롯에 함께 쓰고 돌아온다
+ *   (플래시 쓰기만 기다리고 네트워크는 기다리지 않음). 돌아온 뒤에는 재부팅해도 잃지 않으므로 호출한 쪽은 그때 집은 것으로 기록한다.
+ * - 백그라운드 태스크가 순서대로 보내며 실패하면 간격을 늘려 재시도한다.
+ * - 스탠드 작업은 바로 앞의 워킹 리스트 추가에 딸려 있다. 워킹 리스트 추가가 거절(4xx)되면 스탠드 작업도 보내지 않는다.
+ * - 거절되어 버린 작업(워킹 리스트 추가 또는 스탠드 작업, 한 쌍에 한 번)은 takeRejected()로 loop에 돌려준다.
+ *   loop는 장부의 집은 수량을 되돌려 다음 통과에서 그 상품에 다시 멈춘다.
+ * - 플래시 형식: NVS "outbox" 네임스페이스의 슬롯 "e<seq % 용량>"에 seq(4) + 종류(1) + UID 길이(1) + UID + 수량(1)을 돌아가며 덧붙이고,
+ *   전달한 마지막 seq만 "ack"에 기록한다 (지우지 않으므로 항목당 쓰기 2번, 슬롯을 고르게 사용).
+ *   부팅 시 ack보다 큰 seq의 슬롯만 되살린다. 슬롯은 loop의 저장소 핸들(store), ack는 태스크의 핸들(journal)로만 쓴다.
+ * - 요청마다 "Idempotency-Key: <장치 ID>-<seq>"를 붙여, 응답을 못 받고 다시 보낸 요청을 서버가 걸러낼 수 있게 한다.
+ * 링은 단일 생산자(loop) / 단일 소비자(태스크): tail은 loop, head·persisted는 태스크만 쓴다.
+ */
+class Outbox {
+public:
+    enum Kind : uint8_t {
+        WorkingList = 1,              // 서버 워킹 리스트 추가
+        StandStart = 2                // 스탠드 작업 시작
+    };
+
+    enum class Delivery : uint8_t {
+        Delivered,                    // 2xx
+        Retry,                        // 응답 없음 / 5xx / 408 / 429
+        Rejected                      // 그 밖의 4xx: 다시 보내도 소용없으므로 버림
+    };
+
+    // 항목 전달 (백그라운드 태스크에서 호출). headers: "Idempotency-Key: ...\r\n"
+    using SendFn = std::function<Delivery(const OutboxEntry& entry, const String& headers)>;
+
+    Outbox(KVStore& store, KVStore& journal, SendFn send, Clock& clock);
+
+    void begin();                               // 미전달 항목 복원 + 전달 태스크 시작
+    bool enqueuePick(const String& uid, uint8_t quantity);   // loop에서 호출: 워킹 리스트 추가 + 스탠드 작업 (플래시까지), 자리가 없으면 false
+
+    bool takeRejected(OutboxEntry& entry);      // loop에서 호출: 거절되어 버린 작업 하나 (없으면 false)
+
+    uint32_t pending() const;                   // 아직 전달하지 못한 항목 수
+    uint32_t oldestAgeMs() const;               // 가장 오래 기다린 항목의 대기 시간 (없으면 0)
+    const OutboxStats& stats() const { return counters; }
+    const String& deviceId() const { return instance; }
+
+    static Delivery classify(int httpCode);
+    static const char* kindName(uint8_t kind);
+
+private:
+    void restore();
+    void step();                                // 백그라운드 태스크 본문
+    void put(uint32_t seq, Kind kind, const String& uid, uint8_t quantity, uint32_t now);
+    bool persist(const OutboxEntry& entry);     // store가 열려 있을 때
+    void acknowledge(uint32_t seq);
+    void giveBack(const OutboxEntry& entry);    // 태스크: 거절된 작업을 loop에 돌려줌
+
+    KVStore& store;                             // 슬롯 / 장치 ID (loop)
+    KVStore& journal;                           // ack (태스크)
+    SendFn send;
+    Clock* clock;
+
+    OutboxEntry ring[OUTBOX_CAPACITY];          // 인덱스 = seq % 용량
+    std::atomic<uint32_t> head;                 // 다음에 전달할 seq (태스크)
+    std::atomic<uint32_t> tail;                 // 다음에 넣을 seq (loop)
+
+    OutboxEntry returned[OUTBOX_RETURN_CAPACITY];   // 거절된 작업 (태스크 → loop, 같은 단일 생산자/소비자)
+    std::atomic<uint32_t> returnHead;           // loop
+    std::atomic<uint32_t> returnTail;           // 태스크
+
+    String instance;                            // 장치 ID (최초 부팅 때 만들어 저장)
+    uint32_t retryAt = 0;
+    uint32_t backoffMs = 0;
+    OutboxStats counters;
+};
+
+#endif // OUTBOX_H
@@ -0,0 +1,200 @@
+#include "PaymentBoard.h"
+#include <algorithm>
+#include "TraceLog.h"
+
+// ========== 스냅샷 ========================================================================================
+PaymentSnapshot::PaymentSnapshot(const PaymentData& data, uint32_t serial, const PaymentSnapshot* previous)
+    : paymentId(data.getPaymentId()),
+      version(data.getVersion()),
+      items(data.getItems()),
+      serialNo(serial),
+      pickedCounts(new std::atomic<int>[data.getItems().size()]) {
+    const bool carry = previous && !paymentId.isEmpty() && previous->paymentId == paymentId;
+    for (size_t i = 0; i < items.size(); ++i) {
+        int count = items[i].picked;
+        if (carry) {
+            for (size_t j = 0; j < previous->items.size(); ++j) {
+                if (previous->items[j].name == items[i].name) {
+                    count = previous->picked(j);
+                    break;
+                }
+            }
+        }
+        pickedCounts[i].store(count, std::memory_order_relaxed);
+    }
+}
+
+int PaymentSnapshot::indexOf(const String& uid) const {
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].uid == uid) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int PaymentSnapshot::picked(size_t index) const {
+    return pickedCounts[index].load(std::memory_order_relaxed);
+}
+
+int PaymentSnapshot::remaining(size_t index) const {
+    const int left = items[index].quantity - picked(index);
+    return left > 0 ? left : 0;
+}
+
+int PaymentSnapshot::totalRemaining() const {
+    int total = 0;
+    for (size_t i = 0; i < items.size(); ++i) total += remaining(i);
+    return total;
+}
+
+PickProgress PaymentSnapshot::progress() const {
+    PickProgress p;
+    p.items = items.size();
+    for (size_t i = 0; i < items.size(); ++i) {
+        const int left = remaining(i);
+        if (left == 0) ++p.itemsDone;
+        p.quantity += items[i].quantity;
+        p.picked += items[i].quantity - left;
+        p.remaining += left;
+    }
+    return p;
+}
+
+bool PaymentSnapshot::matchUID(const String& uid, String& name) const {
+    const int index = indexOf(uid);
+    if (index < 0) return false;
+    name = items[index].name;
+    return true;
+}
+
+int PaymentSnapshot::consume(const String& uid, int count) const {
+    const int index = indexOf(uid);
+    if (index < 0 || count <= 0) return 0;
+
+    std::atomic<int>& counter = pickedCounts[index];
+    int current = counter.load(std::memory_order_relaxed);
+    while (current < items[index].quantity) {
+        const int taken = std::min(count, items[index].quantity - current);
+        if (counter.compare_exchange_weak(current, current + taken, std::memory_order_relaxed)) return taken;
+    }
+    return 0;
+}
+
+int PaymentSnapshot::release(const String& uid, int count) const {
+    const int index = indexOf(uid);
+    if (index < 0 || count <= 0) return 0;
+
+    std::atomic<int>& counter = pickedCounts[index];
+    int current = counter.load(std::memory_order_relaxed);
+    while (current > 0) {
+        const int returned = std::min(count, current);
+        if (counter.compare_exchange_weak(current, current - returned, std::memory_order_relaxed)) return returned;
+    }
+    return 0;
+}
+
+PaymentData PaymentSnapshot::toData() const {
+    std::vector<PaymentItem> copy = items;
+    for (size_t i = 0; i < copy.size(); ++i) copy[i].picked = picked(i);
+
+    PaymentData data;
+    data.assign(paymentId, copy, version);
+    return data;
+}
+
+void PaymentSnapshot::printItems() const {
+    LOG_INFO("[결제 ID] {}", paymentId);
+    for (size_t i = 0; i < items.size(); ++i) {
+        LOG_INFO(" - {}: UID={}, 수량={} (남음 {})", items[i].name, items[i].uid, items[i].quantity, remaining(i));
+    }
+}
+
+// ========== 게시판 ========================================================================================
+PaymentBoard::PaymentBoard()
+    : live(new PaymentSnapshot(PaymentData(), 0)), epoch(1), dirty(false) {
+    for (uint8_t i = 0; i < PAYMENT_MAX_READERS; ++i) {
+        seen[i].store(1);
+        inUse[i].store(i == 0);     // 0번 = loop
+    }
+}
+
+PaymentBoard::~PaymentBoard() {
+    for (const Retired& r : retired) delete r.snapshot;
+    delete live.load();
+}
+
+int PaymentBoard::consume(const String& uid, int count) {
+    const int taken = current().consume(uid, count);
+    if (taken > 0) dirty.store(true);
+    return taken;
+}
+
+int PaymentBoard::release(const String& uid, int count) {
+    const int returned = current().release(uid, count);
+    if (returned > 0) dirty.store(true);
+    return returned;
+}
+
+int PaymentBoard::registerReader() {
+    for (uint8_t i = 1; i < PAYMENT_MAX_READERS; ++i) {
+        bool expected = false;
+        if (inUse[i].compare_exchange_strong(expected, true)) {
+            seen[i].store(epoch.load());
+            return i;
+        }
+    }
+    return -1;
+}
+
+void PaymentBoard::quiescent(uint8_t reader) {
+    if (reader >= PAYMENT_MAX_READERS) return;
+    seen[reader].store(epoch.load());
+    if (reader == 0 && !retired.empty()) reclaim();
+}
+
+// consume()/publish() 이후 처음 부르면 현재 스냅샷으로 changeHandler를 한 번 부른다 (그 사이 변경은 한 번에 모임)
+void PaymentBoard::flush() {
+    if (dirty.exchange(false) && changeHandler) changeHandler(current());
+}
+
+// ========== 게시 / 회수 ====================================================================================
+void PaymentBoard::publish(const PaymentData& next) {
+    const PaymentSnapshot* old = live.load();
+    const PaymentSnapshot* fresh = new PaymentSnapshot(next, nextSerial++, old);
+
+    live.store(fresh, std::memory_order_release);
+    retired.push_back(Retired{old, epoch.fetch_add(1) + 1});
+    ++publishes;
+
+    dirty.store(true);     // 새 스냅샷에 집은 수량까지 담겨 있으므로 다음 flush() 한 번으로 충분
+}
+
+bool PaymentBoard::publishIf(uint32_t expectedSerial, const PaymentData& next) {
+    if (current().serial() != expectedSerial) return false;
+    publish(next);
+    return true;
+}
+
+void PaymentBoard::clear() {
+    if (current().empty()) return;
+    publish(PaymentData());
+}
+
+// 모든 읽는 태스크가 본 epoch 중 가장 작은 값보다 먼저 바뀐 스냅샷만 지운다
+void PaymentBoard::reclaim() {
+    uint32_t oldest = epoch.load();
+    for (uint8_t i = 0; i < PAYMENT_MAX_READERS; ++i) {
+        if (!inUse[i].load()) continue;
+        const uint32_t s = seen[i].load();
+        if (static_cast<int32_t>(s - oldest) < 0) oldest = s;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); ++i) {
+        if (static_cast<int32_t>(oldest - retired[i].epoch) >= 0) {
+            delete retired[i].snapshot;
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+}
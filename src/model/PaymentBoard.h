@@ -0,0 +1,116 @@
+#ifndef PAYMENTBOARD_H
+#define PAYMENTBOARD_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "PaymentData.h"
+
+#define PAYMENT_MAX_READERS 4       // 스냅샷을 읽는 태스크 수 (0번 = loop)
+
+// 주문 진행 현황 (집은 수량 장부 기준, 서버에 묻지 않음)
+struct PickProgress {
+    uint32_t items = 0;               // 상품 종류 수
+    uint32_t itemsDone = 0;           // 다 집은 상품 종류 수
+    int quantity = 0;                 // 주문 수량 합계
+    int picked = 0;                   // 집은 수량 합계
+    int remaining = 0;                // 남은 수량 합계
+
+    bool complete() const { return items > 0 && remaining == 0; }
+};
+
+/**
+ * 결제 내역 불변 스냅샷
+ * - 결제 ID/버전/상품 목록은 만든 뒤 바뀌지 않는다. 집은 수량만 상품별 원자 카운터에 따로 쌓는다.
+ * - 그래서 스캐너는 잠금 없이 읽고, consume()도 어느 태스크에서든 CAS 한 번으로 끝난다.
+ */
+class PaymentSnapshot {
+public:
+    // previous가 같은 결제 ID면 상품 이름이 같은 항목의 집은 수량을 그쪽에서 이어받는다
+    PaymentSnapshot(const PaymentData& data, uint32_t serial, const PaymentSnapshot* previous = nullptr);
+
+    const String& getPaymentId() const { return paymentId; }
+    const String& getVersion() const { return version; }
+    const std::vector<PaymentItem>& getItems() const { return items; }   // picked 필드는 생성 당시 값, 현재 값은 picked(i)
+    bool empty() const { return paymentId.isEmpty() && items.empty(); }
+    uint32_t serial() const { return serialNo; }
+
+    int indexOf(const String& uid) const;             // 상품 위치 (없으면 -1)
+    int picked(size_t index) const;
+    int remaining(size_t index) const;
+    int totalRemaining() const;
+    PickProgress progress() const;
+
+    bool matchUID(const String& uid, String& name) const;
+    int consume(const String& uid, int count = 1) const;   // 남은 수량 안에서 count만큼 집음, 실제로 집은 수량 반환
+    int release(const String& uid, int count) const;       // 집은 수량 안에서 count만큼 되돌림, 실제로 되돌린 수량 반환
+    PaymentData toData() const;                       // 현재 집은 수량을 반영한 값 (저장 / 다음 버전의 기준)
+    void printItems() const;
+
+private:
+    const String paymentId;
+    const String version;
+    const std::vector<PaymentItem> items;
+    const uint32_t serialNo;
+    std::unique_ptr<std::atomic<int>[]> pickedCounts;   // items와 같은 순서
+};
+
+/**
+ * 결제 내역 게시판 (RCU)
+ * - 현재 스냅샷을 원자 포인터 하나로 게시한다. current()는 포인터를 한 번 읽을 뿐이라 대기가 없다.
+ * - 새 버전은 PaymentData로 따로 만들어 publish()로 포인터만 바꾼다. 같은 결제 ID면 집은 수량을 이어받는다.
+ * - 바뀐 이전 스냅샷은 바로 지우지 않고, 모든 읽는 태스크가 quiescent()를 지난 뒤 loop에서 회수한다.
+ *   읽는 쪽은 quiescent() 사이에서만 스냅샷 참조를 들고 있으면 된다 (loop는 한 바퀴 = 한 구간).
+ * - 집은 수량과 새 버전은 dirty로만 표시하고, 저장 태스크가 flush()로 모아서 changeHandler에 넘긴다.
+ * 게시/초기화/회수는 loop에서만 호출한다. 읽기, consume(), flush()는 어느 태스크에서든 된다.
+ */
+class PaymentBoard {
+public:
+    using ChangeHandler = std::function<void(const PaymentSnapshot&)>;
+
+    PaymentBoard();
+    ~PaymentBoard();
+    PaymentBoard(const PaymentBoard&) = delete;
+    PaymentBoard& operator=(const PaymentBoard&) = delete;
+
+    // ========== 읽기 (대기 없음) ==========
+    const PaymentSnapshot& current() const { return *live.load(std::memory_order_acquire); }
+    int consume(const String& uid, int count = 1);   // 집은 수량 기록 (플래시 저장은 다음 flush()에서)
+    int release(const String& uid, int count);       // 전달하지 못한 작업의 집은 수량을 되돌림
+
+    int registerReader();                       // loop 외의 태스크가 읽으려면 슬롯을 받는다 (가득 차면 -1)
+    void quiescent(uint8_t reader = 0);         // 이 태스크는 이전 스냅샷을 더 들고 있지 않음. 0(loop)이면 회수도
+    void flush();                               // 바뀐 내용이 있으면 changeHandler 호출 (저장 태스크에서, quiescent() 사이)
+
+    // ========== 게시 (loop 전용) ==========
+    void publish(const PaymentData& next);
+    bool publishIf(uint32_t expectedSerial, const PaymentData& next);   // 그 사이 다른 버전이 게시됐으면 false
+    void clear();
+
+    void setChangeHandler(ChangeHandler handler) { changeHandler = handler; }
+    uint32_t publishCount() const { return publishes; }
+    size_t retiredCount() const { return retired.size(); }   // 회수 대기 중인 이전 스냅샷 수
+
+private:
+    struct Retired {
+        const PaymentSnapshot* snapshot;
+        uint32_t epoch;                         // 이 값 이상을 본 읽는 태스크는 이미 놓았음
+    };
+
+    void reclaim();
+
+    std::atomic<const PaymentSnapshot*> live;
+    std::atomic<uint32_t> epoch;
+    std::atomic<uint32_t> seen[PAYMENT_MAX_READERS];   // 읽는 태스크가 마지막 quiescent()에서 본 epoch
+    std::atomic<bool> inUse[PAYMENT_MAX_READERS];
+    std::atomic<bool> dirty;                           // consume() / publish() 이후 아직 flush()하지 않음
+    std::vector<Retired> retired;
+    uint32_t nextSerial = 1;
+    uint32_t publishes = 0;
+    ChangeHandler changeHandler;
+};
+
+#endif // PAYMENTBOARD_H
@@ -0,0 +1,165 @@
+#include "PaymentCache.h"
+#include "TraceLog.h"
+
+namespace {
+
+const char* NAMESPACE = "payment";
+const char* KEY = "manifest";
+
+const uint8_t MAGIC_0 = 'P';
+const uint8_t MAGIC_1 = 'M';
+const uint8_t VERSION = 3;          // 2: 결제 ID 뒤에 ETag 추가, 3: 상품별 집은 수량 추가 (1, 2도 읽음)
+const size_t HEADER_SIZE = 4;
+const size_t CHECKSUM_SIZE = 4;
+
+bool putString(std::vector<uint8_t>& out, const String& value) {
+    if (value.length() > 255) return false;
+    out.push_back(static_cast<uint8_t>(value.length()));
+    out.insert(out.end(), value.c_str(), value.c_str() + value.length());
+    return true;
+}
+
+void putCount(std::vector<uint8_t>& out, int value) {
+    const uint16_t count = value < 0 ? 0 : (value > 0xFFFF ? 0xFFFF : value);
+    out.push_back(count & 0xFF);
+    out.push_back(count >> 8);
+}
+
+// 길이(1) + 바이트를 읽는다. 남은 길이가 모자라면 false
+bool getString(const uint8_t* data, size_t length, size_t& pos, String& value) {
+    if (pos >= length) return false;
+    const size_t n = data[pos++];
+    if (pos + n > length) return false;
+    value = "";
+    value.reserve(n);
+    for (size_t i = 0; i < n; ++i) value += static_cast<char>(data[pos + i]);
+    pos += n;
+    return true;
+}
+
+} // namespace
+
+PaymentCache::PaymentCache(KVStore& store)
+    : store(store) {}
+
+// ========== 플래시 입출력 ===================================================================================
+bool PaymentCache::load(PaymentData& payment) {
+    store.begin(NAMESPACE, true);
+    const size_t length = store.getBytesLength(KEY);
+    buffer.resize(length);
+    const size_t read = length ? store.getBytes(KEY, buffer.data(), length) : 0;
+    store.end();
+
+    String paymentId;
+    String version;
+    std::vector<PaymentItem> items;
+    if (read == 0 || !decode(buffer.data(), read, paymentId, version, items)) {
+        if (read > 0) LOG_WARN("[PaymentCache] 저장된 결제 내역 손상 ({}바이트) → 무시", static_cast<unsigned int>(read));
+        return false;
+    }
+
+    lastChecksum = checksum(buffer.data(), read - CHECKSUM_SIZE);
+    lastSize = read;
+    payment.assign(paymentId, items, version);
+    return true;
+}
+
+bool PaymentCache::save(const PaymentData& payment) {
+    if (payment.getPaymentId().isEmpty() && payment.getItems().empty()) {
+        if (lastChecksum != 0) erase();
+        return true;
+    }
+
+    if (!encode(payment, buffer)) {
+        LOG_WARN("[PaymentCache] 결제 내역이 너무 커서 저장하지 못했습니다");
+        return false;
+    }
+
+    const uint32_t sum = checksum(buffer.data(), buffer.size() - CHECKSUM_SIZE);
+    if (sum == lastChecksum && buffer.size() == lastSize) return true;   // 내용 변화 없음
+
+    store.begin(NAMESPACE, false);
+    const size_t written = store.putBytes(KEY, buffer.data(), buffer.size());
+    store.end();
+    if (written != buffer.size()) {
+        LOG_WARN("[PaymentCache] 플래시 저장 실패");
+        return false;
+    }
+
+    lastChecksum = sum;
+    lastSize = buffer.size();
+    ++saves;
+    return true;
+}
+
+void PaymentCache::erase() {
+    store.begin(NAMESPACE, false);
+    store.remove(KEY);
+    store.end();
+    lastChecksum = 0;
+    lastSize = 0;
+}
+
+// ========== 바이너리 변환 ===================================================================================
+bool PaymentCache::encode(const PaymentData& payment, std::vector<uint8_t>& out) {
+    const std::vector<PaymentItem>& items = payment.getItems();
+    if (items.size() > 255) return false;
+
+    out.clear();
+    out.push_back(MAGIC_0);
+    out.push_back(MAGIC_1);
+    out.push_back(VERSION);
+    out.push_back(static_cast<uint8_t>(items.size()));
+    if (!putString(out, payment.getPaymentId()) || !putString(out, payment.getVersion())) return false;
+
+    for (const PaymentItem& item : items) {
+        if (!putString(out, item.name) || !putString(out, item.uid)) return false;
+        putCount(out, item.quantity);
+        putCount(out, item.picked);
+    }
+
+    const uint32_t sum = checksum(out.data(), out.size());
+    for (uint8_t i = 0; i < 4; ++i) out.push_back((sum >> (8 * i)) & 0xFF);
+    return true;
+}
+
+bool PaymentCache::decode(const uint8_t* data, size_t length, String& paymentId, String& version,
+                          std::vector<PaymentItem>& items) {
+    if (length < HEADER_SIZE + 1 + CHECKSUM_SIZE) return false;
+    if (data[0] != MAGIC_0 || data[1] != MAGIC_1 || data[2] == 0 || data[2] > VERSION) return false;
+
+    const size_t body = length - CHECKSUM_SIZE;
+    uint32_t stored = 0;
+    for (uint8_t i = 0; i < 4; ++i) stored |= static_cast<uint32_t>(data[body + i]) << (8 * i);
+    if (stored != checksum(data, body)) return false;
+
+    const uint8_t count = data[3];
+    size_t pos = HEADER_SIZE;
+    if (!getString(data, body, pos, paymentId)) return false;
+    version = "";
+    if (data[2] >= 2 && !getString(data, body, pos, version)) return false;
+
+    items.clear();
+    items.reserve(count);
+    for (uint8_t i = 0; i < count; ++i) {
+        PaymentItem item;
+        if (!getString(data, body, pos, item.name) || !getString(data, body, pos, item.uid)) return false;
+        const size_t countBytes = data[2] >= 3 ? 4 : 2;
+        if (pos + countBytes > body) return false;
+        item.quantity = data[pos] | (data[pos + 1] << 8);
+        if (countBytes == 4) item.picked = data[pos + 2] | (data[pos + 3] << 8);
+        pos += countBytes;
+        items.push_back(item);
+    }
+    return pos == body;
+}
+
+// FNV-1a 32
+uint32_t PaymentCache::checksum(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,46 @@
+#ifndef PAYMENTCACHE_H
+#define PAYMENTCACHE_H
+
+#include <Arduino.h>
+#include <vector>
+
+#include "KVStore.h"
+#include "PaymentData.h"
+
+/**
+ * 결제 내역(상품별 집은 수량 포함)을 플래시에 바이너리로 보관하는 캐시
+ * - 재부팅 직후 load()로 바로 복원해 서버 응답을 기다리지 않고 피킹을 시작할 수 있게 한다.
+ * - 형식 (리틀 엔디언):
+ *     'P' 'M' | 형식 버전(1) | 상품 수(1) | ID 길이(1) + ID | ETag 길이(1) + ETag
+ *     상품마다: 이름 길이(1) + 이름 | UID 길이(1) + UID | 주문 수량(2) | 집은 수량(2)
+ *     (형식 1·2는 집은 수량 없이 남은 수량(2)만 있고, 그대로 주문 수량으로 읽는다)
+ *     FNV-1a 32 체크섬(4) — 앞의 모든 바이트
+ * - 직전에 저장한 내용과 같으면 쓰지 않는다 (플래시 쓰기 횟수 절약).
+ */
+class PaymentCache {
+public:
+    explicit PaymentCache(KVStore& store);
+
+    bool load(PaymentData& payment);            // 저장된 내역 복원 (없거나 손상되면 false, 내역은 그대로)
+    bool save(const PaymentData& payment);      // 변경 시 호출, 빈 내역이면 삭제
+    void erase();
+
+    uint32_t saveCount() const { return saves; }
+    size_t storedBytes() const { return lastSize; }
+
+    // 바이너리 변환 (문자열이 255바이트를 넘거나 상품이 255개를 넘으면 false)
+    static bool encode(const PaymentData& payment, std::vector<uint8_t>& out);
+    static bool decode(const uint8_t* data, size_t length, String& paymentId, String& version,
+                       std::vector<PaymentItem>& items);
+
+private:
+    static uint32_t checksum(const uint8_t* data, size_t length);
+
+    KVStore& store;
+    std::vector<uint8_t> buffer;
+    uint32_t lastChecksum = 0;                  // 마지막으로 저장/복원한 내용 (0 = 없음)
+    size_t lastSize = 0;
+    uint32_t saves = 0;
+};
+
+#endif // PAYMENTCACHE_H
@@ -1,21 +1,34 @@
 #include "PaymentData.h"
 #include <ArduinoJson.h>
+#include <utility>
+#include "TraceLog.h"
 
 bool PaymentData::parseFromJson(const String& json) {
     JsonDocument doc; 
     DeserializationError error = deserializeJson(doc, json);
     if (error) return false;
+    return parseDocument(doc);
+}
 
-    JsonObject obj = doc.as<JsonObject>();
+// MessagePack 본문은 0 바이트를 담을 수 있으므로 길이를 함께 넘긴다
+bool PaymentData::parseFromMsgPack(const String& body) {
+    JsonDocument doc;
+    DeserializationError error = deserializeMsgPack(doc, body.c_str(), body.length());
+    if (error) return false;
+    return parseDocument(doc);
+}
+
+bool PaymentData::parseDocument(const JsonDocument& doc) {
+    JsonObjectConst obj = doc.as<JsonObjectConst>();
     if (!obj["paymentId"].is<String>()) return false; 
     paymentId = obj["paymentId"].as<String>();
 
     items.clear();
-    for (JsonPair kv : obj) {
+    for (JsonPairConst kv : obj) {
         String key = kv.key().c_str();
         if (key == "paymentId") continue;
 
-        JsonArray arr = kv.value().as<JsonArray>();
+        JsonArrayConst arr = kv.value().as<JsonArrayConst>();
         if (arr.size() != 2) continue;
 
         PaymentItem item;
@@ -27,6 +40,62 @@ bool PaymentData::parseFromJson(const String& json) {
     return true;
 }
 
+/**
+ * 변경분 형식 (서버가 226 IM Used로 보냄):
+ *   {"paymentId":"...", "base":"<기준 ETag>",
+ *    "added":{"상품명":["uid",수량], ...}, "changed":{"상품명":["uid",수량], ...}, "removed":["상품명", ...]}
+ * 결제 ID나 기준 버전이 현재와 다르면 아무것도 바꾸지 않고 false (전체 내역을 다시 받아야 함).
+ * changed의 수량은 새 주문 수량으로 덮어쓰고, 로컬에서 집은 수량(picked)은 그대로 둔다.
+ * MessagePack으로 와도 구조는 같다 (applyDeltaMsgPack).
+ */
+bool PaymentData::applyDelta(const String& json, const String& newVersion) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, json);
+    if (error) return false;
+    return applyDeltaDocument(doc, newVersion);
+}
+
+bool PaymentData::applyDeltaMsgPack(const String& body, const String& newVersion) {
+    JsonDocument doc;
+    DeserializationError error = deserializeMsgPack(doc, body.c_str(), body.length());
+    if (error) return false;
+    return applyDeltaDocument(doc, newVersion);
+}
+
+bool PaymentData::applyDeltaDocument(const JsonDocument& doc, const String& newVersion) {
+    JsonObjectConst obj = doc.as<JsonObjectConst>();
+    if (paymentId.isEmpty() || obj["paymentId"].as<String>() != paymentId) return false;
+    if (obj["base"].as<String>() != version) return false;
+
+    for (const char* section : {"added", "changed"}) {
+        for (JsonPairConst kv : obj[section].as<JsonObjectConst>()) {
+            JsonArrayConst arr = kv.value().as<JsonArrayConst>();
+            if (arr.size() != 2) continue;
+
+            const String name = kv.key().c_str();
+            PaymentItem* item = findByName(name);
+            if (!item) {
+                items.push_back(PaymentItem{name, "", 0, 0});
+                item = &items.back();
+            }
+            item->uid = arr[0].as<String>();
+            item->quantity = arr[1].as<int>();
+        }
+    }
+    for (JsonVariantConst removed : obj["removed"].as<JsonArrayConst>()) {
+        const String name = removed.as<String>();
+        for (auto it = items.begin(); it != items.end(); ++it) {
+            if (it->name == name) {
+                items.erase(it);
+                break;
+            }
+        }
+    }
+
+    version = newVersion;
+    return true;
+}
+
 bool PaymentData::matchUID(const String& uid, String& name) {
     for (auto& item : items) {
         if (item.uid == uid) {
@@ -39,8 +108,8 @@ bool PaymentData::matchUID(const String& uid, String& name) {
 
 bool PaymentData::consumeItem(const String& uid) {
     for (auto& item : items) {
-        if (item.uid == uid && item.quantity > 0) {
-            item.quantity--;
+        if (item.uid == uid && item.remaining() > 0) {
+            item.picked++;
             return true;
         }
     }
@@ -48,9 +117,9 @@ bool PaymentData::consumeItem(const String& uid) {
 }
 
 void PaymentData::printItems() const {
-    Serial.println("[결제 ID] " + paymentId);
+    LOG_INFO("[결제 ID] {}", paymentId);
     for (const auto& item : items) {
-        Serial.println(" - " + item.name + ": UID=" + item.uid + ", 수량=" + String(item.quantity));
+        LOG_INFO(" - {}: UID={}, 수량={} (남음 {})", item.name, item.uid, item.quantity, item.remaining());
     }
 }
 
@@ -58,7 +127,39 @@ String PaymentData::getPaymentId() const {
     return paymentId;
 }
 
+void PaymentData::assign(const String& id, const std::vector<PaymentItem>& newItems, const String& newVersion) {
+    paymentId = id;
+    version = newVersion;
+    items = newItems;
+}
+
+void PaymentData::swapContents(PaymentData& other) {
+    std::swap(paymentId, other.paymentId);
+    std::swap(version, other.version);
+    items.swap(other.items);
+}
+
+// 집은 수량은 로컬 값이라 비교하지 않는다
+bool PaymentData::sameOrder(const PaymentData& other) const {
+    if (paymentId != other.paymentId || items.size() != other.items.size()) return false;
+    for (size_t i = 0; i < items.size(); ++i) {
+        const PaymentItem& a = items[i];
+        const PaymentItem& b = other.items[i];
+        if (a.name != b.name || a.uid != b.uid || a.quantity != b.quantity) return false;
+    }
+    return true;
+}
+
 void PaymentData::clear() {
+    if (paymentId.isEmpty() && items.empty()) return;
     items.clear();
     paymentId = "";
-}
\ No newline at end of file
+    version = "";
+}
+
+PaymentItem* PaymentData::findByName(const String& name) {
+    for (auto& item : items) {
+        if (item.name == name) return &item;
+    }
+    return nullptr;
+}
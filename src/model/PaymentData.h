@@ -2,25 +2,49 @@
 #define PAYMENTDATA_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <vector>
 
 struct PaymentItem {
     String name;
     String uid;
-    int quantity;
+    int quantity;                     // 서버가 준 주문 수량
+    int picked = 0;                   // 로컬에서 집은 수량 (서버 응답으로 바뀌지 않음)
+
+    int remaining() const { return quantity > picked ? quantity - picked : 0; }
 };
 
+/**
+ * 결제 내역 값 (파싱 / 변경분 반영 / 플래시 복원용 작업 버퍼)
+ * 스캐너가 읽는 실제 내역은 PaymentBoard가 이 값으로 만든 불변 스냅샷이다.
+ */
 class PaymentData {
 private:
     String paymentId;
+    String version;                   // 서버가 준 ETag (따옴표 제외, 없으면 빈 문자열)
     std::vector<PaymentItem> items;
 
+    PaymentItem* findByName(const String& name);
+    bool parseDocument(const JsonDocument& doc);
+    bool applyDeltaDocument(const JsonDocument& doc, const String& newVersion);
+
 public:
     bool parseFromJson(const String& json);
+    bool parseFromMsgPack(const String& body);                        // 같은 구조의 MessagePack (Accept 협상)
+    bool applyDelta(const String& json, const String& newVersion);   // 바뀐 상품만 반영 (기준 버전이 다르면 false)
+    bool applyDeltaMsgPack(const String& body, const String& newVersion);
     bool matchUID(const String& uid, String& name);
     bool consumeItem(const String& uid);
     void printItems() const;
     String getPaymentId() const;
+    const String& getVersion() const { return version; }
+    void setVersion(const String& newVersion) { version = newVersion; }   // 다음 parseFromJson에 함께 반영
+    const std::vector<PaymentItem>& getItems() const { return items; }
+
+    void assign(const String& id, const std::vector<PaymentItem>& newItems,
+                const String& newVersion = "");                            // 통째로 교체 (복원 / 재검증)
+    void swapContents(PaymentData& other);                                   // 결제 ID/버전/상품 맞바꿈
+    bool sameOrder(const PaymentData& other) const;                          // 결제 ID와 상품(이름/UID/주문 수량)이 같음
 
     void clear();
 };
@@ -0,0 +1,162 @@
+#include "PaymentPrefetcher.h"
+#include "BackgroundTask.h"
+#include "ServerService.h"
+
+namespace {
+
+const uint32_t RETRY_MS = 3000;                     // 실패 후 재시도 간격
+const char* DELTA_IM = "payment-delta";             // A-IM / IM 헤더의 변경분 형식 이름
+// MessagePack을 먼저, 모르는 서버는 JSON으로 답하면 된다 (q 값이 낮을 뿐 둘 다 받음)
+const char* PAYMENT_ACCEPT = "Accept: application/msgpack, application/json;q=0.5\r\n";
+
+} // namespace
+
+PaymentPrefetcher::PaymentPrefetcher(PaymentBoard& board, FetchFn fetch, Clock& clock)
+    : board(board), fetch(fetch), clock(&clock), state(IDLE) {}
+
+void PaymentPrefetcher::begin(uint32_t period) {
+    periodMs = period;
+    nextAt = clock->millis() + periodMs;
+    hal::startBackgroundTask("payment-prefetch", [this]() { step(); }, 50, 1, 6144);
+}
+
+// ========== loop 쪽 =======================================================================================
+bool PaymentPrefetcher::request(uint8_t attempts) {
+    if (attempts > attemptsLeft) attemptsLeft = attempts;
+    if (state.load() != IDLE) return false;     // 진행 중인 요청이 끝나면 남은 시도로 이어감
+
+    retryScheduled = false;
+    start();
+    return true;
+}
+
+// 현재 스냅샷을 작업 버퍼로 복사하고 태스크에 넘긴다 (IDLE에서만 호출)
+void PaymentPrefetcher::start() {
+    if (attemptsLeft > 0) --attemptsLeft;
+
+    const PaymentSnapshot& base = board.current();
+    back = base.toData();
+    baseSerial = base.serial();
+    headers = PAYMENT_ACCEPT;
+    if (!base.getVersion().isEmpty()) {
+        headers += String("If-None-Match: \"") + base.getVersion() + "\"\r\n" + "A-IM: " + DELTA_IM + "\r\n";
+    }
+    state = REQUESTED;
+}
+
+PaymentPrefetcher::Result PaymentPrefetcher::poll() {
+    const uint32_t now = clock->millis();
+    Result result = Result::None;
+
+    if (state.load() == DONE) {
+        result = backResult;
+        fetchStats.bytes += backBytes;
+        switch (result) {
+            case Result::Full:        ++fetchStats.full; break;
+            case Result::NotModified: ++fetchStats.notModified; break;
+            case Result::Delta:       ++fetchStats.delta; break;
+            default:                  ++fetchStats.failed; break;
+        }
+        if (backMsgPack && (result == Result::Full || result == Result::Delta)) ++fetchStats.msgpack;
+
+        // 받는 동안 다른 스냅샷이 게시됐으면 (초기화 등) 이 결과의 기준이 틀리므로 버린다
+        if ((result == Result::Full || result == Result::Delta) && !board.publishIf(baseSerial, back)) {
+            result = Result::Superseded;
+        }
+        state = IDLE;
+
+        if (result == Result::Failed && attemptsLeft > 0) {
+            retryScheduled = true;
+            nextAt = now + RETRY_MS;
+        } else {
+            if (result != Result::Failed) {
+                succeeded = true;
+                lastSuccessAt = now;
+            }
+            attemptsLeft = 0;
+            retryScheduled = false;
+            nextAt = now + periodMs;
+        }
+        last = result;
+    }
+
+    if (state.load() == IDLE && (retryScheduled || periodMs > 0) && static_cast<int32_t>(now - nextAt) >= 0) {
+        retryScheduled = false;
+        start();
+    }
+    return result;
+}
+
+bool PaymentPrefetcher::pending() const {
+    return state.load() != IDLE || retryScheduled;
+}
+
+uint32_t PaymentPrefetcher::ageMs() const {
+    return succeeded ? clock->millis() - lastSuccessAt : UINT32_MAX;
+}
+
+// ========== 백그라운드 태스크 ===============================================================================
+void PaymentPrefetcher::step() {
+    if (state.load() != REQUESTED) return;
+
+    String response = fetch(headers);
+    uint32_t bytes = response.length();
+    Result result = applyResponse(response, back);
+
+    if (result == Result::Stale) {
+        back.setVersion("");
+        response = fetch(PAYMENT_ACCEPT);
+        bytes += response.length();
+        result = applyResponse(response, back);
+    }
+
+    backBytes = bytes;
+    backMsgPack = isMsgPack(response);
+    backResult = result == Result::Stale ? Result::Failed : result;
+    state = DONE;
+}
+
+// ========== 응답 반영 =====================================================================================
+// 304는 그대로, 226은 제자리에서 변경분 반영, 200은 전체 교체. ETag 없는 200은 주문 내용까지 같을 때만 변경 없음으로 본다
+PaymentPrefetcher::Result PaymentPrefetcher::applyResponse(const String& response, PaymentData& target) {
+    const int status = ServerService::parseStatusCode(response);
+    if (status == 304) return Result::NotModified;
+
+    String etag = ServerService::extractHeader(response, "ETag");
+    if (etag.startsWith("W/")) etag.remove(0, 2);
+    etag.replace("\"", "");
+
+    const String body = ServerService::extractBody(response);
+    const bool msgpack = isMsgPack(response);
+    if (status == 226) {
+        const bool applied = msgpack ? target.applyDeltaMsgPack(body, etag) : target.applyDelta(body, etag);
+        return applied ? Result::Delta : Result::Stale;
+    }
+
+    PaymentData fresh;
+    fresh.setVersion(etag);
+    if (!(msgpack ? fresh.parseFromMsgPack(body) : fresh.parseFromJson(body))) return Result::Failed;
+    if (etag.isEmpty() && fresh.sameOrder(target)) return Result::NotModified;
+
+    target.swapContents(fresh);
+    return Result::Full;
+}
+
+// 서버가 Accept를 보고 고른 형식. 표준 이름 application/msgpack과 예전 이름 application/x-msgpack을 모두 받는다
+bool PaymentPrefetcher::isMsgPack(const String& response) {
+    String type = ServerService::extractHeader(response, "Content-Type");
+    type.toLowerCase();
+    return type.startsWith("application/msgpack") || type.startsWith("application/x-msgpack");
+}
+
+const char* PaymentPrefetcher::resultName(Result result) {
+    switch (result) {
+        case Result::Failed:      return "failed";
+        case Result::Full:        return "full";
+        case Result::NotModified: return "not_modified";
+        case Result::Delta:       return "delta";
+        case Result::Superseded:  return "superseded";
+        case Result::Stale:       return "stale";
+        default:                  return "none";
+    }
+}
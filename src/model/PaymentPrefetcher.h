@@ -0,0 +1,89 @@
+#ifndef PAYMENTPREFETCHER_H
+#define PAYMENTPREFETCHER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+
+#include "Clock.h"
+#include "PaymentBoard.h"
+#include "PaymentData.h"
+
+// 결제 내역 응답 종류별 횟수 (조건부 요청 효과 확인용)
+struct PaymentFetchStats {
+    uint32_t full = 0;                // 200 전체 내역
+    uint32_t notModified = 0;         // 304 변경 없음
+    uint32_t delta = 0;               // 226 변경분
+    uint32_t failed = 0;              // 응답 없음 / 파싱 실패
+    uint32_t bytes = 0;               // 받은 응답 크기 합계 (헤더 포함)
+    uint32_t msgpack = 0;             // 그중 MessagePack으로 받은 200/226 응답
+};
+
+/**
+ * 결제 내역 백그라운드 프리페처
+ * - loop가 request()하면 현재 스냅샷을 작업 버퍼에 복사하고, 백그라운드 태스크가 작업 버퍼로 조건부 GET → 파싱/변경분 반영까지 한다.
+ * - loop의 poll()이 완료된 버퍼를 새 스냅샷으로 게시한다. 그 사이 다른 스냅샷이 게시됐으면 결과를 버린다.
+ *   집은 수량은 게시 시점의 스냅샷에서 이어받으므로 받는 동안 집은 상품도 잃지 않는다.
+ * - 304 / ETag 없는 서버의 같은 결제 ID 응답은 게시하지 않는다.
+ * - periodMs마다 스스로 다시 확인해 /start 시점에 항상 최근 내역이 준비되어 있게 한다.
+ * 버퍼/헤더는 상태 플래그로 소유권을 넘긴다: IDLE·DONE = loop, REQUESTED = 태스크.
+ */
+class PaymentPrefetcher {
+public:
+    enum class Result : uint8_t {
+        None,           // 완료된 요청 없음
+        Failed,         // 응답 없음 / 파싱 실패 (남은 시도가 있으면 재시도 예약)
+        Full,           // 200: 전체 내역으로 교체
+        NotModified,    // 304 (또는 ETag 없는 서버의 같은 결제 ID)
+        Delta,          // 226: 바뀐 상품만 반영
+        Superseded,     // 받는 동안 로컬 내역이 바뀌어 결과를 버림
+        Stale           // (내부) 변경분의 기준 버전이 다름 → 태스크가 곧바로 전체 내역을 다시 요청
+    };
+
+    // 결제 내역 GET (백그라운드 태스크에서 호출). headers: "Name: value\r\n" 여러 줄, 원시 HTTP 응답 반환
+    using FetchFn = std::function<String(const String& headers)>;
+
+    PaymentPrefetcher(PaymentBoard& board, FetchFn fetch, Clock& clock);
+
+    void begin(uint32_t periodMs);          // 백그라운드 태스크 시작 (periodMs = 0 이면 요청 시에만)
+    bool request(uint8_t attempts = 1);     // 지금 바로 가져오기 (이미 진행 중이면 시도 횟수만 늘림)
+    Result poll();                          // loop에서 호출: 완료된 결과 반영 + 주기/재시도 예약 처리
+
+    bool pending() const;                   // 요청 진행 중이거나 재시도 예약됨
+    uint32_t ageMs() const;                 // 마지막 성공 이후 경과 시간 (성공한 적 없으면 UINT32_MAX)
+    Result lastResult() const { return last; }
+    const PaymentFetchStats& stats() const { return fetchStats; }
+
+    static const char* resultName(Result result);
+    static Result applyResponse(const String& response, PaymentData& target);   // 200/304/226 응답을 target에 반영
+    static bool isMsgPack(const String& response);                            // Content-Type이 MessagePack인 응답
+
+private:
+    enum State : uint8_t { IDLE, REQUESTED, DONE };
+
+    void start();
+    void step();                            // 백그라운드 태스크 본문
+
+    PaymentBoard& board;                    // 게시된 실제 내역
+    PaymentData back;                       // 가져오는 중인 내역
+    FetchFn fetch;
+    Clock* clock;
+
+    std::atomic<uint8_t> state;
+    String headers;                         // REQUESTED 동안 태스크가 읽음
+    Result backResult = Result::None;       // DONE일 때 loop가 읽음
+    uint32_t backBytes = 0;
+    bool backMsgPack = false;
+    uint32_t baseSerial = 0;                // 요청 시점에 게시돼 있던 스냅샷 번호
+
+    uint32_t periodMs = 0;
+    uint8_t attemptsLeft = 0;
+    uint32_t nextAt = 0;                    // 다음 요청 시각 (주기 또는 재시도)
+    bool retryScheduled = false;
+    uint32_t lastSuccessAt = 0;
+    bool succeeded = false;
+    Result last = Result::None;
+    PaymentFetchStats fetchStats;
+};
+
+#endif // PAYMENTPREFETCHER_H
@@ -0,0 +1,33 @@
+#include "StatusCache.h"
+
+StatusCache::StatusCache()
+    : bootId(String(static_cast<unsigned long>(random(1, 0x7FFFFFFF)), HEX)) {}   // ESP32: 하드웨어 난수
+
+CachedReply StatusCache::reply(WireFormat format, const Config& config, RuntimeStatus& runtime) {
+    const bool msgpack = format == WireFormat::MsgPack;
+    Entry& entry = entries[msgpack ? 1 : 0];
+    const uint32_t digest = statusDigest(runtime);
+
+    if (entry.generation != 0 && entry.digest == digest) {
+        ++hits;
+    } else {
+        entry.generation = ++currentGeneration;
+        entry.digest = digest;
+        entry.etag = String("\"") + bootId + "-s" + entry.generation + (msgpack ? "-m\"" : "-j\"");
+        ++builds;
+
+        runtime.statusGeneration = entry.generation;
+        runtime.statusBuilds = builds;
+        runtime.statusHits = hits;
+        entry.body = msgpack ? buildStatusMsgPack(config, runtime) : buildStatusJson(config, runtime);
+    }
+
+    CachedReply reply;
+    reply.body = &entry.body;
+    reply.etag = &entry.etag;
+    return reply;
+}
+
+void StatusCache::invalidate() {
+    for (Entry& entry : entries) entry.generation = 0;
+}
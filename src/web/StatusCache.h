@@ -0,0 +1,48 @@
+#ifndef STATUSCACHE_H
+#define STATUSCACHE_H
+
+#include <Arduino.h>
+
+#include "ServerService.h"
+#include "WebPages.h"
+
+/**
+ * /status 응답 본문 캐시 (형식별 버퍼 하나씩)
+ * - 요청마다 RuntimeStatus는 새로 모으되(카운터 읽기뿐), statusDigest()가 지난번과 같으면
+ *   JSON / MessagePack을 다시 만들지 않고 버퍼를 그대로 보낸다. 시간으로는 다시 만들지 않는다:
+ *   가만히 있는 동안에는 ETag가 그대로라 대시보드의 재검증은 모두 304, /events도 status를 다시 보내지 않는다.
+ *   그래서 본문에는 시간이 흐르기만 해도 바뀌는 값을 싣지 않고, 요청마다 오르는 카운터는 다음 사건 때 따라온다.
+ * - 다시 만들 때마다 세대가 하나 오르고 ETag("<부팅 ID>-s<세대>-j" / "-m")가 바뀐다. 대시보드가 If-None-Match로
+ *   물으면 본문 없이 304로 끝난다. 세대는 부팅마다 1부터 다시 세므로, 부팅 때 뽑은 난수를 앞에 붙여
+ *   재부팅 전에 받은 ETag가 다른 본문과 맞아떨어지지 않게 한다.
+ * - 설정은 다이제스트에 넣지 않는다. 저장한 설정은 재시작해야 반영되므로 부팅 후 처음 만든 본문이 계속 유효하고,
+ *   실행 중에 config를 바꾸는 코드는 invalidate()로 세대를 버려야 한다.
+ * loop의 /status 핸들러에서만 쓴다.
+ */
+class StatusCache {
+public:
+    StatusCache();
+
+    CachedReply reply(WireFormat format, const Config& config, RuntimeStatus& runtime);   // runtime에 캐시 통계를 채움
+    void invalidate();
+
+    uint32_t generation() const { return currentGeneration; }
+    uint32_t buildCount() const { return builds; }
+    uint32_t hitCount() const { return hits; }
+
+private:
+    struct Entry {
+        String body;
+        String etag;
+        uint32_t digest = 0;
+        uint32_t generation = 0;           // 0 = 비어 있음
+    };
+
+    String bootId;                         // 부팅마다 새로 뽑는 ETag 접두사 (16진수)
+    Entry entries[2];                      // WireFormat::Json, WireFormat::MsgPack
+    uint32_t currentGeneration = 0;
+    uint32_t builds = 0;
+    uint32_t hits = 0;
+};
+
+#endif // STATUSCACHE_H
@@ -0,0 +1,694 @@
+#include "WebPages.h"
+#include <ArduinoJson.h>
+
+// [PAGE-1] 기본 설정 페이지
+String renderMainPage() {
+    return R"rawliteral(
+        <!DOCTYPE html>
+        <html lang="ko">
+        <head>
+            <meta charset="utf-8">
+            <title>TraceGo 설정 페이지</title>
+            <style>
+                * { box-sizing: border-box; }
+                body {
+                    font-family: 'Segoe UI', sans-serif;
+                    background-color: #f4f7f8;
+                    margin: 0;
+                    padding: 0;
+                    display: flex;
+                    justify-content: center;
+                    align-items: center;
+                    height: 100vh;
+                }
+                .container {
+                    background-color: #fff;
+                    padding: 40px;
+                    border-radius: 12px;
+                    box-shadow: 0 4px 12px rgba(0, 0, 0, 0.1);
+                    text-align: center;
+                    width: 100%;
+                    max-width: 400px;
+                }
+                h2 {
+                    margin-bottom: 30px;
+                    color: #00c4c4;
+                }
+                a {
+                    display: block;
+                    margin: 12px 0;
+                    padding: 12px;
+                    background-color: #00c4c4;
+                    color: #fff;
+                    text-decoration: none;
+                    border-radius: 8px;
+                    font-size: 16px;
+                    transition: background-color 0.3s ease;
+                }
+                a:hover {
+                    background-color: #00a0a0;
+                }
+            </style>
+        </head>
+        <body>
+            <div class="container">
+                <h2>TraceGo 설정 페이지</h2>
+                <a href="/advanced">고급 설정</a>
+                <a href="/status-view">상태 확인</a>
+                <a href="/reset-config">설정 초기화</a>
+            </div>
+        </body>
+        </html>
+    )rawliteral";
+}
+
+// [PAGE-2] 고급 설정 페이지 (현재 설정값으로 템플릿 치환)
+String renderAdvancedPage(const Config& config) {
+    String html = R"rawliteral(
+        <!DOCTYPE html>
+        <html lang="ko">
+        <head>
+            <meta charset="utf-8">
+            <title>고급 설정</title>
+            <style>
+                * { box-sizing: border-box; }
+                body {
+                    font-family: 'Segoe UI', sans-serif;
+                    background-color: #f4f7f8;
+                    margin: 0;
+                    padding: 0;
+                    display: flex;
+                    justify-content: center;
+                    align-items: flex-start;
+                    min-height: 100vh;
+                }
+                .container {
+                    width: 100%;
+                    max-width: 600px;
+                    background: #fff;
+                    padding: 30px;
+                    margin: 40px auto;
+                    border-radius: 12px;
+                    box-shadow: 0 4px 10px rgba(0,0,0,0.1);
+                }
+                h2 {
+                    text-align: center;
+                    color: #00c4c4;
+                    margin-bottom: 20px;
+                }
+                fieldset {
+                    border: none;
+                    margin-bottom: 20px;
+                    padding: 0;
+                }
+                legend {
+                    font-weight: bold;
+                    color: #00a0a0;
+                    margin-bottom: 10px;
+                }
+                label {
+                    display: block;
+                    margin-bottom: 6px;
+                    font-weight: 500;
+                }
+                input[type=text],
+                input[type=password],
+                input[type=number],
+                textarea {
+                    width: 100%;
+                    padding: 10px;
+                    margin-bottom: 14px;
+                    border: 1px solid #ccc;
+                    border-radius: 6px;
+                    font-size: 14px;
+                }
+                input[type=checkbox] {
+                    transform: scale(1.2);
+                    margin-left: 4px;
+                }
+                button {
+                    width: 100%;
+                    padding: 14px;
+                    background-color: #00c4c4;
+                    color: #fff;
+                    border: none;
+                    border-radius: 6px;
+                    font-size: 16px;
+                    cursor: pointer;
+                    transition: background-color 0.3s;
+                }
+                button:hover {
+                    background-color: #00a0a0;
+                }
+            </style>
+            <script>
+            function saveConfig() {
+                const config = {
+                    server_ip: document.getElementById("server_ip").value,
+                    server_port: parseInt(document.getElementById("server_port").value),
+                    server_backups: document.getElementById("server_backups").value,
+                    server_tls: document.getElementById("server_tls").checked,
+                    server_ca: document.getElementById("server_ca").value,
+                    server_tls_insecure: document.getElementById("server_tls_insecure").checked,
+                    inner_port: parseInt(document.getElementById("inner_port").value),
+                    stand_port: parseInt(document.getElementById("stand_port").value),
+                    motion_port: parseInt(document.getElementById("motion_port").value),
+                    motion_key: document.getElementById("motion_key").value,
+                    admin_uid: document.getElementById("admin_uid").value,
+                    master_key: document.getElementById("master_key").value,
+                    test_key: document.getElementById("test_key").value,
+                    use_rfid: document.getElementById("use_rfid").checked,
+                    comm_rx: parseInt(document.getElementById("comm_rx").value),
+                    comm_tx: parseInt(document.getElementById("comm_tx").value),
+                    rc_sda: document.getElementById("rc_sda").value,
+                    rc_rst: parseInt(document.getElementById("rc_rst").value),
+                    rc_irq: document.getElementById("rc_irq").value,
+                    dedup_ms: parseInt(document.getElementById("dedup_ms").value),
+                    rc_inventory: document.getElementById("rc_inventory").checked,
+                    baudrate: parseInt(document.getElementById("baudrate").value),
+                    baudrate2: parseInt(document.getElementById("baudrate2").value),
+                    firstSetWoringLists: document.getElementById("fswl").value,
+                    resetWorkingLists: document.getElementById("rwl").value,
+                    getPayment: document.getElementById("getpay").value,
+                    addWorkingList: document.getElementById("awl").value,
+                    prefetch_ms: parseInt(document.getElementById("prefetch_ms").value)
+                };
+
+                fetch("/update-config", {
+                    method: "POST",
+                    headers: { "Content-Type": "application/json" },
+                    body: JSON.stringify(config)
+                })
+                .then(res => res.json())
+                .then(data => alert(data.message));
+            }
+            </script>
+        </head>
+        <body>
+            <div class="container">
+                <h2>고급 설정</h2>
+
+                <fieldset>
+                    <legend>서버 설정</legend>
+                    <label for="server_ip">Server IP</label>
+                    <input id="server_ip" value="%SERVER_IP%" type="text">
+
+                    <label for="server_port">Server Port</label>
+                    <input id="server_port" value="%SERVER_PORT%" type="number">
+
+                    <label for="server_backups">Backup Servers (순서대로, 예: 192.168.0.20:8080, backup.local)</label>
+                    <input id="server_backups" value="%SERVER_BACKUPS%" type="text">
+
+                    <label for="server_tls">
+                        <input id="server_tls" type="checkbox" %SERVER_TLS%> HTTPS (TLS)
+                    </label>
+
+                    <label for="server_ca">Server CA (PEM, 비어 있거나 읽을 수 없으면 HTTPS 연결 안 함)</label>
+                    <textarea id="server_ca" rows="4">%SERVER_CA%</textarea>
+
+                    <label for="server_tls_insecure">
+                        <input id="server_tls_insecure" type="checkbox" %SERVER_TLS_INSECURE%> CA 없이 검증하지 않고 연결 (암호화만, 중간자가 내용을 볼 수 있음)
+                    </label>
+
+                    <label for="inner_port">Inner Port</label>
+                    <input id="inner_port" value="%INNER_PORT%" type="number">
+
+                    <label for="stand_port">Stand Port</label>
+                    <input id="stand_port" value="%STAND_PORT%" type="number">
+
+                    <label for="motion_port">Motion UDP Port (GO/STOP 데이터그램, 0 = 끔)</label>
+                    <input id="motion_port" value="%MOTION_PORT%" type="number">
+                </fieldset>
+
+                <fieldset>
+                    <legend>보안 설정</legend>
+                    <label for="admin_uid">Admin UID</label>
+                    <input id="admin_uid" value="%ADMIN_UID%" type="text">
+
+                    <label for="master_key">Master Key</label>
+                    <input id="master_key" value="%MASTER_KEY%" type="text">
+
+                    <label for="test_key">Test Key</label>
+                    <input id="test_key" value="%TEST_KEY%" type="text">
+
+                    <label for="motion_key">Motion Key (16진수 32자, 중앙 서버와 같은 값. 비워 두면 저장된 키 유지)</label>
+                    <input id="motion_key" value="" placeholder="%MOTION_KEY_HINT%" type="password" autocomplete="off">
+                </fieldset>
+
+                <fieldset>
+                    <legend>하드웨어 설정</legend>
+                    <label for="use_rfid">
+                        <input id="use_rfid" type="checkbox" %USE_RFID%> Use RFID
+                    </label>
+
+                    <label for="comm_rx">Comm RX Pin</label>
+                    <input id="comm_rx" value="%COMM_RX%" type="number">
+
+                    <label for="comm_tx">Comm TX Pin</label>
+                    <input id="comm_tx" value="%COMM_TX%" type="number">
+
+                    <label for="rc_sda">RC SDA Pins (리더기마다, 예: 5,21)</label>
+                    <input id="rc_sda" value="%RC_SDA%" type="text">
+
+                    <label for="rc_rst">RC RST Pin</label>
+                    <input id="rc_rst" value="%RC_RST%" type="number">
+
+                    <label for="rc_irq">RC IRQ Pins (리더기 순서, -1 = 폴링)</label>
+                    <input id="rc_irq" value="%RC_IRQ%" type="text">
+
+                    <label for="dedup_ms">Tag Dedup Window (ms)</label>
+                    <input id="dedup_ms" value="%DEDUP_MS%" type="number">
+
+                    <label for="rc_inventory">
+                        <input id="rc_inventory" type="checkbox" %RC_INVENTORY%> Multi-tag Inventory
+                    </label>
+
+                    <label for="baudrate">Baudrate</label>
+                    <input id="baudrate" value="%BAUDRATE%" type="number">
+
+                    <label for="baudrate2">Baudrate2</label>
+                    <input id="baudrate2" value="%BAUDRATE2%" type="number">
+                </fieldset>
+
+                <fieldset>
+                    <legend>엔드포인트 설정</legend>
+                    <label for="fswl">FirstSetWorkingLists</label>
+                    <input id="fswl" value="%FSWL%" type="text">
+
+                    <label for="rwl">ResetWorkingLists</label>
+                    <input id="rwl" value="%RWL%" type="text">
+
+                    <label for="getpay">Get Payment</label>
+                    <input id="getpay" value="%GETPAY%" type="text">
+
+                    <label for="awl">Add Working List</label>
+                    <input id="awl" value="%AWL%" type="text">
+
+                    <label for="prefetch_ms">Payment Prefetch Interval (ms, 0 = 끔)</label>
+                    <input id="prefetch_ms" value="%PREFETCH_MS%" type="number">
+                </fieldset>
+
+                <button onclick="saveConfig()">설정 저장</button>
+            </div>
+        </body>
+        </html>
+    )rawliteral";
+
+    // 치환
+    html.replace("%SERVER_IP%", config.serverIP);
+    html.replace("%SERVER_PORT%", String(config.serverPort));
+    html.replace("%SERVER_BACKUPS%", Config::joinEndpoints(config.serverHosts + 1, config.serverPorts + 1, config.serverCount - 1));
+    html.replace("%SERVER_TLS%", config.serverTls ? "checked" : "");
+    html.replace("%SERVER_CA%", config.serverCa);
+    html.replace("%SERVER_TLS_INSECURE%", config.serverTlsInsecure ? "checked" : "");
+    html.replace("%INNER_PORT%", String(config.innerPort));
+    html.replace("%STAND_PORT%", String(config.standPort));
+    html.replace("%MOTION_PORT%", String(config.motionPort));
+    html.replace("%MOTION_KEY_HINT%", config.motionKey.length() ? "저장됨 (바꿀 때만 입력)" : "설정 안 됨");  // 키는 인증 없는 페이지에 싣지 않는다
+    html.replace("%ADMIN_UID%", config.adminUID);
+    html.replace("%MASTER_KEY%", config.masterKey);
+    html.replace("%TEST_KEY%", config.testKey);
+    html.replace("%USE_RFID%", config.useRFID ? "checked" : "");
+    html.replace("%COMM_RX%", String(config.commRxPin));
+    html.replace("%COMM_TX%", String(config.commTxPin));
+    html.replace("%RC_SDA%", Config::joinPins(config.rcSdaPins, config.rcReaderCount));
+    html.replace("%RC_RST%", String(config.rcRstPin));
+    html.replace("%RC_IRQ%", Config::joinPins(config.rcIrqPins, config.rcReaderCount));
+    html.replace("%DEDUP_MS%", String(config.tagDedupMs));
+    html.replace("%RC_INVENTORY%", config.rfidInventory ? "checked" : "");
+    html.replace("%BAUDRATE%", String(config.serialBaudrate));
+    html.replace("%BAUDRATE2%", String(config.serial2Baudrate));
+    html.replace("%FSWL%", config.firstSetWoringLists);
+    html.replace("%RWL%", config.resetWorkingLists);
+    html.replace("%GETPAY%", config.getPayment);
+    html.replace("%AWL%", config.addWorkingList);
+    html.replace("%PREFETCH_MS%", String(config.paymentPrefetchMs));
+
+    return html;
+}
+
+// [PAGE-3] 현재 시스템 상태 문서 (JSON / MessagePack 공용)
+// 본문은 사건이 있을 때만 다시 만들어지므로(StatusCache), 시간이 흐르기만 해도 바뀌는 값
+// (폴링 횟수 / 주기, 유휴 부하, 경과 시간, 남은 빚, 다음 탐침까지 남은 시간)은 싣지 않는다.
+static void fillStatusDocument(JsonDocument& doc, const Config& config, const RuntimeStatus& runtime) {
+    doc.set(JsonObject());  // 명시적 초기화 (v7에서는 안전하게 사용하기 위해 권장됨)
+
+    doc["ssid"]                 = config.ssid;
+    doc["password"]             = config.password;
+    doc["server_ip"]            = config.serverIP;
+    doc["server_port"]          = config.serverPort;
+    doc["server_backups"]       = Config::joinEndpoints(config.serverHosts + 1, config.serverPorts + 1, config.serverCount - 1);
+    doc["server_tls"]           = config.serverTls;
+    doc["server_tls_insecure"]  = config.serverTlsInsecure;
+    doc["inner_port"]           = config.innerPort;
+    doc["stand_port"]           = config.standPort;
+    doc["motion_port"]          = config.motionPort;
+    doc["admin_uid"]            = config.adminUID;
+    doc["master_key"]           = config.masterKey;
+    doc["test_key"]             = config.testKey;
+    doc["use_rfid"]             = config.useRFID;
+    doc["comm_rx"]              = config.commRxPin;
+    doc["comm_tx"]              = config.commTxPin;
+    doc["rc_sda"]               = Config::joinPins(config.rcSdaPins, config.rcReaderCount);
+    doc["rc_rst"]               = config.rcRstPin;
+    doc["rc_irq"]               = Config::joinPins(config.rcIrqPins, config.rcReaderCount);
+    doc["dedup_ms"]             = config.tagDedupMs;
+    doc["rc_inventory"]         = config.rfidInventory;
+    doc["baudrate"]             = config.serialBaudrate;
+    doc["baudrate2"]            = config.serial2Baudrate;
+    doc["firstSetWoringLists"]  = config.firstSetWoringLists;
+    doc["resetWorkingLists"]    = config.resetWorkingLists;
+    doc["getPayment"]           = config.getPayment;
+    doc["addWorkingList"]       = config.addWorkingList;
+    doc["prefetch_ms"]          = config.paymentPrefetchMs;
+    doc["localIP"]              = config.localIP;
+
+    JsonObject rfid = doc["rfid"].to<JsonObject>();
+    rfid["accepted"]            = runtime.tagsAccepted;
+    rfid["suppressed"]          = runtime.tagsSuppressed;
+    rfid["evictions"]           = runtime.tagDedupEvictions;
+    rfid["mode"]                = runtime.rfid.modeName();
+    rfid["irq_events"]          = runtime.rfid.irqEvents;
+    rfid["irq_misses"]          = runtime.rfid.irqMisses;
+    rfid["detections"]          = runtime.rfid.detections;
+    rfid["latency_avg_us"]      = runtime.rfid.latencyAvgUs();
+    rfid["latency_max_us"]      = runtime.rfid.latencyMaxUs;
+    rfid["read_avg_us"]         = runtime.rfid.readAvgUs();
+    rfid["inventory_extra"]     = runtime.rfid.inventoryExtra;
+
+    JsonArray readers = rfid["readers"].to<JsonArray>();
+    for (uint8_t i = 0; i < runtime.rfid.readerCount; ++i) {
+        const RFIDReaderStats& r = runtime.rfid.readers[i];
+        JsonObject reader = readers.add<JsonObject>();
+        reader["id"]                = i;
+        reader["mode"]              = r.irqMode ? "irq" : "poll";
+        reader["detections"]        = r.detections;
+    }
+
+    JsonObject paymentObj = doc["payment"].to<JsonObject>();
+    paymentObj["id"]            = runtime.paymentId;
+    paymentObj["items"]         = runtime.paymentItems;
+    paymentObj["remaining"]     = runtime.paymentRemaining;
+    paymentObj["restored"]      = runtime.paymentRestored;
+    paymentObj["sync"]          = runtime.paymentSync;
+    paymentObj["saves"]         = runtime.paymentSaves;
+    paymentObj["stored_bytes"]  = runtime.paymentBytes;
+    paymentObj["version"]       = runtime.paymentVersion;
+    paymentObj["pending"]       = runtime.paymentPending;
+    paymentObj["serial"]        = runtime.paymentSerial;
+    paymentObj["retired"]       = runtime.paymentRetired;
+
+    JsonObject fetchObj = paymentObj["fetch"].to<JsonObject>();
+    fetchObj["full"]            = runtime.paymentFetch.full;
+    fetchObj["not_modified"]    = runtime.paymentFetch.notModified;
+    fetchObj["delta"]           = runtime.paymentFetch.delta;
+    fetchObj["failed"]          = runtime.paymentFetch.failed;
+    fetchObj["bytes"]           = runtime.paymentFetch.bytes;
+    fetchObj["msgpack"]         = runtime.paymentFetch.msgpack;
+
+    JsonObject ledger = doc["ledger"].to<JsonObject>();
+    ledger["items"]             = runtime.pickProgress.items;
+    ledger["items_done"]        = runtime.pickProgress.itemsDone;
+    ledger["quantity"]          = runtime.pickProgress.quantity;
+    ledger["picked"]            = runtime.pickProgress.picked;
+    ledger["remaining"]         = runtime.pickProgress.remaining;
+    ledger["complete"]          = runtime.pickProgress.complete();
+    ledger["skipped"]           = runtime.pickSkips;
+    ledger["finished_orders"]   = runtime.ordersFinished;
+
+    JsonObject outboxObj = doc["outbox"].to<JsonObject>();
+    outboxObj["pending"]        = runtime.outboxPending;
+    outboxObj["enqueued"]       = runtime.outbox.enqueued;
+    outboxObj["delivered"]      = runtime.outbox.delivered;
+    outboxObj["retries"]        = runtime.outbox.retries;
+    outboxObj["rejected"]       = runtime.outbox.rejected;
+    outboxObj["cancelled"]      = runtime.outbox.cancelled;
+    outboxObj["dropped"]        = runtime.outbox.dropped;
+    outboxObj["restored"]       = runtime.outbox.restored;
+
+    JsonArray breakers = doc["breakers"].to<JsonArray>();
+    for (uint8_t i = 0; i < runtime.endpointCount; ++i) {
+        const EndpointStats& e = runtime.endpoints[i];
+        const BreakerStats& b = e.breaker;
+        JsonObject breaker = breakers.add<JsonObject>();
+        breaker["name"]         = b.name;
+        breaker["host"]         = e.host;
+        breaker["port"]         = b.port;
+        breaker["state"]        = CircuitBreaker::stateName(b.state);
+        breaker["calls"]        = b.calls;
+        breaker["failure_pct"]  = b.failurePct();
+        breaker["latency_ms"]   = b.lastLatencyMs;
+        breaker["ewma_ms"]      = e.ewmaMs;
+        breaker["p95_ms"]       = e.p95Ms;
+        breaker["health_pct"]   = e.healthPct;
+        breaker["selected"]     = e.selected;
+        breaker["hedges"]       = e.hedges;
+        breaker["hedge_wins"]   = e.hedgeWins;
+        breaker["tls"]          = e.secure;
+        breaker["connects"]     = e.connects;
+        breaker["reused"]       = e.reuses;
+        breaker["trips"]        = b.trips;
+        breaker["probes"]       = b.probes;
+        breaker["rejected"]     = b.rejected;
+    }
+
+    JsonObject dns = doc["dns"].to<JsonObject>();
+    dns["entries"]              = runtime.dns.entries;
+    dns["lookups"]              = runtime.dns.lookups;
+    dns["hits"]                 = runtime.dns.hits;
+    dns["hit_pct"]              = runtime.dns.hitPct();
+    dns["misses"]               = runtime.dns.misses;
+    dns["refreshes"]            = runtime.dns.refreshes;
+    dns["refresh_failures"]     = runtime.dns.refreshFailures;
+    dns["stale_served"]         = runtime.dns.staleServed;
+    dns["failures"]             = runtime.dns.failures;
+
+    JsonObject tls = doc["tls"].to<JsonObject>();
+    tls["handshakes"]           = runtime.tls.handshakes;
+    tls["resumed"]              = runtime.tls.resumed;
+    tls["resume_pct"]           = runtime.tls.resumePct();
+    tls["full_avg_ms"]          = runtime.tls.fullAvgMs();
+    tls["resumed_avg_ms"]       = runtime.tls.resumedAvgMs();
+    tls["last_ms"]              = runtime.tls.lastMs;
+    tls["failures"]             = runtime.tls.failures;
+
+    JsonObject startJob = doc["start_job"].to<JsonObject>();
+    startJob["id"]              = runtime.startJobId;
+    startJob["state"]           = runtime.startJobState;
+
+    JsonObject cache = doc["status_cache"].to<JsonObject>();
+    cache["generation"]         = runtime.statusGeneration;
+    cache["builds"]             = runtime.statusBuilds;
+    cache["hits"]               = runtime.statusHits;
+    cache["not_modified"]       = runtime.statusNotModified;
+
+    JsonObject events = doc["events"].to<JsonObject>();
+    events["clients"]           = runtime.events.clients;
+    events["max_clients"]       = EVENT_MAX_CLIENTS;
+    events["accepted"]          = runtime.events.accepted;
+    events["rejected"]          = runtime.events.rejected;
+    events["disconnects"]       = runtime.events.disconnects;
+    events["published"]         = runtime.events.published;
+    events["coalesced"]         = runtime.events.coalesced;
+    events["dropped"]           = runtime.events.dropped;
+    events["flushes"]           = runtime.events.flushes;
+    events["bytes"]             = runtime.events.bytes;
+
+    JsonObject commands = doc["commands"].to<JsonObject>();
+    commands["clients"]         = runtime.commands.clients;
+    commands["max_clients"]     = COMMAND_MAX_CLIENTS;
+    commands["accepted"]        = runtime.commands.accepted;
+    commands["rejected"]        = runtime.commands.rejected;
+    commands["disconnects"]     = runtime.commands.disconnects;
+    commands["executed"]        = runtime.commands.commands;
+    commands["failed"]          = runtime.commands.failed;
+    commands["duplicates"]      = runtime.commands.duplicates;
+    commands["invalid"]         = runtime.commands.invalid;
+    commands["last_ms"]         = runtime.commands.lastMs;
+    commands["max_ms"]          = runtime.commands.maxMs;
+
+    JsonObject motion = doc["motion"].to<JsonObject>();
+    motion["enabled"]           = runtime.motion.enabled;
+    motion["port"]              = runtime.motion.port;
+    motion["epoch"]             = runtime.motion.epoch;
+    motion["received"]          = runtime.motion.received;
+    motion["executed"]          = runtime.motion.executed;
+    motion["failed"]            = runtime.motion.failed;
+    motion["duplicates"]        = runtime.motion.duplicates;
+    motion["stale"]             = runtime.motion.stale;
+    motion["bad_mac"]           = runtime.motion.badMac;
+    motion["malformed"]         = runtime.motion.malformed;
+    motion["last_ms"]           = runtime.motion.lastMs;
+    motion["max_ms"]            = runtime.motion.maxMs;
+
+    JsonObject http = doc["http"].to<JsonObject>();
+    http["budget_us"]           = HTTP_BUDGET_US;
+    http["admitted"]            = runtime.http.admitted;
+    http["shed_budget"]         = runtime.http.shedBudget;
+    http["shed_queue"]          = runtime.http.shedQueue;
+    http["shed_scan"]           = runtime.http.shedScan;
+    http["overruns"]            = runtime.http.overruns;
+    http["max_iteration_us"]    = runtime.http.maxIterationUs;
+    http["scan_gap_limit_ms"]   = RFID_MAX_GAP_MS;
+    http["scan_gap_max_us"]     = runtime.http.scanGapMaxUs;
+    http["scan_late"]           = runtime.http.scanLate;
+}
+
+String buildStatusJson(const Config& config, const RuntimeStatus& runtime) {
+    JsonDocument doc;  // 권장된 JsonDocument 타입 사용
+    fillStatusDocument(doc, config, runtime);
+
+    String output;
+    serializeJson(doc, output);
+    return output;
+}
+
+// 같은 문서를 MessagePack으로 (키/구조는 JSON과 동일, 숫자는 가장 작은 정수형으로 담겨 더 짧다)
+String buildStatusMsgPack(const Config& config, const RuntimeStatus& runtime) {
+    JsonDocument doc;
+    fillStatusDocument(doc, config, runtime);
+
+    String output;
+    serializeMsgPack(doc, output);
+    return output;
+}
+
+// FNV-1a 32. 필드를 하나씩 섞는다 (구조체를 통째로 섞으면 패딩 바이트가 끼어든다)
+namespace {
+
+struct Digest {
+    uint32_t h = 2166136261u;
+
+    void bytes(const void* data, size_t length) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; ++i) h = (h ^ p[i]) * 16777619u;
+    }
+    Digest& operator<<(uint32_t v) { bytes(&v, sizeof(v)); return *this; }
+    Digest& operator<<(int v) { return *this << static_cast<uint32_t>(v); }
+    Digest& operator<<(bool v) { return *this << static_cast<uint32_t>(v); }
+    Digest& operator<<(const String& v) { bytes(v.c_str(), v.length() + 1); return *this; }
+    Digest& operator<<(const char* v) { bytes(v, strlen(v) + 1); return *this; }
+};
+
+} // namespace
+
+/**
+ * fillStatusDocument에 나가는 실행 상태 중 "사건"으로 바뀌는 값만 섞는다 (태그 인식, 결제 내역 변경, 실패 / 차단 ...).
+ * 요청마다 오르는 값은 빼고 본문에만 싣는다. 다음 사건으로 본문을 다시 만들 때 함께 따라온다.
+ * - 결제 내역 재확인(304)과 보관함 전달이 남기는 값: 304 수, 받은 바이트, 진행 중 여부, 엔드포인트의 지연 / 선택 / 연결 / 재사용,
+ *   DNS 조회 / 적중, TLS 핸드셰이크 (가만히 있어도 프리페치 주기마다 오르므로 넣으면 ETag가 계속 바뀜)
+ * - /status 캐시 자신의 통계, 보낸 이벤트 / 바이트, 받은 요청 수 / 스캔 간격
+ * fillStatusDocument에 사건으로 바뀌는 필드를 더하면 여기에도 더한다.
+ */
+uint32_t statusDigest(const RuntimeStatus& runtime) {
+    Digest d;
+    d << runtime.tagsAccepted << runtime.tagsSuppressed << runtime.tagDedupEvictions;
+    const RFIDStats& rfid = runtime.rfid;
+    d << rfid.irqEvents << rfid.irqMisses << rfid.detections << rfid.latencyMaxUs << rfid.inventoryExtra
+      << static_cast<uint32_t>(rfid.readerCount);
+    for (uint8_t i = 0; i < rfid.readerCount; ++i) d << rfid.readers[i].irqMode << rfid.readers[i].detections;
+
+    d << runtime.paymentId << runtime.paymentItems << runtime.paymentRemaining << runtime.paymentRestored
+      << runtime.paymentSync << runtime.paymentVersion << runtime.paymentSerial
+      << runtime.paymentRetired << runtime.paymentSaves << runtime.paymentBytes;
+    const PaymentFetchStats& fetch = runtime.paymentFetch;
+    d << fetch.full << fetch.delta << fetch.failed << fetch.msgpack;
+
+    const PickProgress& ledger = runtime.pickProgress;
+    d << ledger.items << ledger.itemsDone << ledger.quantity << ledger.picked << ledger.remaining
+      << runtime.pickSkips << runtime.ordersFinished;
+
+    const OutboxStats& outbox = runtime.outbox;
+    d << runtime.outboxPending << outbox.enqueued << outbox.delivered << outbox.retries << outbox.rejected
+      << outbox.cancelled << outbox.dropped << outbox.restored;
+
+    d << static_cast<uint32_t>(runtime.endpointCount);
+    for (uint8_t i = 0; i < runtime.endpointCount; ++i) {
+        const EndpointStats& e = runtime.endpoints[i];
+        const BreakerStats& b = e.breaker;
+        d << e.host << static_cast<uint32_t>(b.port) << static_cast<uint32_t>(b.state) << b.failures << b.trips
+          << b.probes << b.rejected << e.hedges << e.hedgeWins << e.secure;
+    }
+
+    const DnsStats& dns = runtime.dns;
+    d << static_cast<uint32_t>(dns.entries) << dns.refreshFailures << dns.staleServed << dns.failures;
+    d << runtime.tls.failures;
+
+    d << runtime.startJobId << runtime.startJobState;
+
+    // 보낸 이벤트 / 바이트는 status 이벤트를 보낼 때마다 바뀌므로 넣지 않는다 (넣으면 매번 새 본문 → 다시 보냄)
+    const EventStreamStats& events = runtime.events;
+    d << static_cast<uint32_t>(events.clients) << events.accepted << events.rejected << events.disconnects
+      << events.dropped;
+    const CommandChannelStats& commands = runtime.commands;
+    d << static_cast<uint32_t>(commands.clients) << commands.accepted << commands.rejected << commands.disconnects
+      << commands.commands << commands.failed << commands.duplicates << commands.invalid << commands.lastMs;
+    const MotionStats& motion = runtime.motion;
+    d << motion.epoch << motion.received << motion.executed << motion.failed << motion.duplicates << motion.stale
+      << motion.badMac << motion.malformed << motion.lastMs;
+    // 받은 요청 수 / 쓴 시간 / 스캔 간격은 /status를 물을 때마다 바뀌므로 넣지 않는다 (미룬 요청 수만)
+    const AdmissionStats& http = runtime.http;
+    d << http.shedBudget << http.shedQueue << http.shedScan;
+    return d.h;
+}
+
+// [PAGE-4] 시스템 상태 HTML 페이지
+String renderStatusViewPage() {
+    return  R"rawliteral(
+            <!DOCTYPE html>
+            <html lang="ko">
+            <head>
+                <meta charset="utf-8">
+                <title>시스템 상태</title>
+                <style>
+                    body { font-family: 'Segoe UI', sans-serif; margin: 20px; background: #f4f7f8; }
+                    pre {
+                        background: #fff;
+                        padding: 20px;
+                        border-radius: 10px;
+                        box-shadow: 0 4px 8px rgba(0,0,0,0.1);
+                        overflow-x: auto;
+                        white-space: pre-wrap;
+                    }
+                    h2 { color: #00c4c4; }
+                    #live { color: #888; font-size: 0.9em; }
+                </style>
+            </head>
+            <body>
+                <h2>시스템 상태 <span id="live"></span></h2>
+                <pre id="log"></pre>
+                <pre id="status">불러오는 중...</pre>
+
+                <script>
+                    const statusBox = document.getElementById("status");
+                    const logBox = document.getElementById("log");
+                    const live = document.getElementById("live");
+                    const show = (data) => { statusBox.textContent = JSON.stringify(data, null, 2); };
+
+                    // 연결을 열어 두면 코어가 바뀔 때만 밀어 준다 (폴링하지 않음). 가득 차 503이면 한 번만 읽어 온다
+                    if (window.EventSource) {
+                        const source = new EventSource("/events");
+                        source.addEventListener("status", (e) => show(JSON.parse(e.data)));
+                        ["tag", "stop", "worklist", "finish", "error"].forEach((type) => {
+                            source.addEventListener(type, (e) => {
+                                const lines = (new Date().toLocaleTimeString() + " " + type + " " + e.data + "\n" + logBox.textContent).split("\n");
+                                logBox.textContent = lines.slice(0, 20).join("\n");
+                            });
+                        });
+                        source.onopen = () => { live.textContent = "(실시간)"; };
+                        source.onerror = () => {
+                            live.textContent = source.readyState === EventSource.CLOSED ? "(실시간 연결 없음)" : "(재연결 중)";
+                        };
+                    }
+
+                    fetch("/status")
+                        .then(response => response.json())
+                        .then(show)
+                        .catch(error => {
+                            statusBox.textContent = "불러오기 실패: " + error;
+                        });
+                </script>
+            </body>
+            </html>
+        )rawliteral";
+}
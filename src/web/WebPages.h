@@ -0,0 +1,62 @@
+// WebPages.h
+#ifndef WEBPAGES_H
+#define WEBPAGES_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "DnsCache.h"
+#include "MotionListener.h"
+#include "RFIDController.h"
+#include "ServerService.h"
+#include "../model/Outbox.h"
+#include "../model/PaymentPrefetcher.h"
+
+// /status 에 함께 내보내는 실행 중 통계 (main.cpp가 각 모듈에서 모아 채운다)
+struct RuntimeStatus {
+    uint32_t tagsAccepted = 0;        // 중복 억제를 통과한 태그 읽기
+    uint32_t tagsSuppressed = 0;      // 억제 창 안에서 다시 읽혀 걸러진 횟수
+    uint32_t tagDedupEvictions = 0;   // 캐시가 가득 차 밀려난 태그 수
+    RFIDStats rfid;                   // 감지 방식 / 지연
+
+    String paymentId;                 // 현재 결제 내역
+    uint32_t paymentItems = 0;
+    int paymentRemaining = 0;         // 남은 수량 합계
+    bool paymentRestored = false;     // 플래시에서 복원, /start 전
+    const char* paymentSync = "none"; // 마지막 프리페치 결과
+    bool paymentPending = false;      // 프리페치 진행 중 / 재시도 예약
+    String paymentVersion;            // 서버 ETag
+    PaymentFetchStats paymentFetch;
+    uint32_t paymentSerial = 0;       // 게시된 스냅샷 번호
+    uint32_t paymentRetired = 0;      // 회수 대기 중인 이전 스냅샷 수
+    PickProgress pickProgress;        // 집은 수량 장부 기준 주문 진행 현황
+    uint32_t pickSkips = 0;           // 다 집은 상품이라 정지하지 않은 인식
+    uint32_t ordersFinished = 0;      // 장부로 완료를 감지해 FINISH를 보낸 주문
+    OutboxStats outbox;               // 워킹 리스트 / 스탠드 알림 보관함
+    uint32_t outboxPending = 0;
+    EndpointStats endpoints[SERVER_MAX_ENDPOINTS];  // 아웃바운드 엔드포인트별 서킷 브레이커 / 지연 / 헤지
+    uint8_t endpointCount = 0;
+    DnsStats dns;                     // 서버 호스트 이름 캐시
+    TlsStats tls;                     // 서버 HTTPS 핸드셰이크 (전체 / 세션 재개)
+    uint32_t startJobId = 0;          // 202로 응답한 마지막 /start 작업
+    const char* startJobState = "none";
+    uint32_t paymentSaves = 0;        // 부팅 후 플래시 저장 횟수
+    uint32_t paymentBytes = 0;        // 저장된 내역 크기
+    uint32_t statusGeneration = 0;    // /status 캐시: 지금 내보내는 본문 세대 (ETag)
+    uint32_t statusBuilds = 0;        //               다시 만든 횟수
+    uint32_t statusHits = 0;          //               만들지 않고 그대로 보낸 횟수
+    uint32_t statusNotModified = 0;   //               304로 답한 횟수
+    EventStreamStats events;          // /events (SSE) 연결 / 보낸 이벤트
+    CommandChannelStats commands;     // /ws 명령 채널 연결 / 실행한 명령
+    MotionStats motion;               // UDP 모션 명령 (GO / STOP 데이터그램)
+    AdmissionStats http;              // 내장 서버 시간 예산 / 503으로 미룬 요청 / RFID 스캔 간격
+};
+
+// 내장 서버 페이지/상태 응답 생성 함수 (핸들러와 벤치마크에서 공용으로 사용)
+String renderMainPage();                              // [PAGE-1] 기본 설정 페이지
+String renderAdvancedPage(const Config& config);      // [PAGE-2] 고급 설정 페이지
+String buildStatusJson(const Config& config, const RuntimeStatus& runtime);   // [PAGE-3] 현재 시스템 상태 JSON
+String buildStatusMsgPack(const Config& config, const RuntimeStatus& runtime);   // [PAGE-3] 같은 상태를 MessagePack으로
+uint32_t statusDigest(const RuntimeStatus& runtime);  // [PAGE-3] 본문을 다시 만들어야 하는지 가리는 값 (계속 바뀌는 값 제외)
+String renderStatusViewPage();                        // [PAGE-4] 시스템 상태 HTML 페이지
+
+#endif // WEBPAGES_H